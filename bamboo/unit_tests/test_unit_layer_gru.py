@@ -84,14 +84,6 @@ def setup_experiment(lbann):
 
     """
 
-    # Skip test on non-GPU systems
-    # Note: Test requires cuDNN (on GPU) or oneDNN (on CPU).
-    ### @todo Assume LBANN has been built with oneDNN?
-    if not tools.gpus_per_node(lbann):
-        message = f'{os.path.basename(__file__)} requires cuDNN or oneDNN'
-        print('Skip - ' + message)
-        pytest.skip(message)
-
     mini_batch_size = num_samples() // 2
     trainer = lbann.Trainer(mini_batch_size)
     model = construct_model(lbann)
@@ -260,6 +252,78 @@ def construct_model(lbann):
         error_on_failure=True,
         execution_modes='test'))
 
+    # ------------------------------------------
+    # Multi-layer, unidirectional GRU with hidden_size != input_size
+    # ------------------------------------------
+    # Note: oneDNN does not support this configuration, so the native
+    # implementation is used on CPU.
+
+    # Weights
+    rnn_weights_numpy = []
+    hidden_size = 3
+    num_layers = 2
+    for i in range(num_layers):
+        ih_matrix = np.random.uniform(
+            low=-1,
+            high=1,
+            size=(3*hidden_size,_input_size if i == 0 else hidden_size),
+        )
+        hh_matrix = np.random.uniform(
+            low=-1,
+            high=1,
+            size=(3*hidden_size,hidden_size),
+        )
+        ih_bias = np.random.uniform(low=-1, high=1, size=(3*hidden_size,))
+        hh_bias = np.random.uniform(low=-1, high=1, size=(3*hidden_size,))
+        rnn_weights_numpy.extend([ih_matrix, hh_matrix, ih_bias, hh_bias])
+    rnn_weights_numpy = [w.astype(np.float32) for w in rnn_weights_numpy]
+    rnn_weights_lbann = [
+        lbann.Weights(
+            initializer=lbann.ValueInitializer(
+                values=tools.str_list(np.nditer(w, order='F'))))
+        for w in rnn_weights_numpy
+    ]
+
+    # LBANN implementation
+    x = x_lbann
+    h = h_lbann
+    h = lbann.Reshape(
+        lbann.Slice(
+            lbann.Reshape(h, dims='-1'),
+            slice_points=tools.str_list([0, num_layers*hidden_size]),
+        ),
+        dims=tools.str_list([num_layers, hidden_size]),
+    )
+    y = lbann.GRU(
+        x,
+        h,
+        hidden_size=hidden_size,
+        num_layers=num_layers,
+        weights=rnn_weights_lbann,
+    )
+    z = lbann.L2Norm2(y)
+    obj.append(z)
+    metrics.append(lbann.Metric(z, name='Multi-layer, unidirectional, small hidden'))
+
+    # NumPy implementation
+    vals = []
+    for i in range(num_samples()):
+        input_ = get_sample(i).astype(np.float64)
+        x = input_[:_sequence_length*_input_size].reshape((_sequence_length,_input_size))
+        h = input_[_sequence_length*_input_size:].reshape((_num_layers,_input_size))
+        h = h.flatten()[:num_layers*hidden_size].reshape((num_layers,hidden_size))
+        y = numpy_gru(x, h, rnn_weights_numpy)
+        z = tools.numpy_l2norm2(y)
+        vals.append(z)
+    val = np.mean(vals)
+    tol = 8 * val * np.finfo(np.float32).eps
+    callbacks.append(lbann.CallbackCheckMetric(
+        metric=metrics[-1].name,
+        lower_bound=val-tol,
+        upper_bound=val+tol,
+        error_on_failure=True,
+        execution_modes='test'))
+
     # ------------------------------------------
     # Gradient checking
     # ------------------------------------------
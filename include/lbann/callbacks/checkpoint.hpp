@@ -33,6 +33,12 @@
 #include "lbann/execution_algorithms/training_algorithm.hpp"
 #include "lbann/utils/visitor_hooks.hpp"
 
+#include <deque>
+#include <future>
+
+// Forward declaration
+class CheckpointWhiteboxTester;
+
 namespace lbann {
 namespace callback {
 
@@ -62,6 +68,9 @@ public:
    *  @param per_rank_dir The directory into which to dump distributed checkpoints
    *  @param ckpt_dist_epochs The frequency of distributed checkpoints in epochs
    *  @param ckpt_dist_steps The frequence of distributed checkpoints in steps
+   *  @param async Write checkpoints from a background thread
+   *  @param max_in_flight Maximum number of asynchronous checkpoints
+   *                       being written at once
    */
   checkpoint(std::string checkpoint_dir,
              std::string restart_dir,
@@ -70,7 +79,9 @@ public:
              int checkpoint_secs,
              std::string per_rank_dir,
              int ckpt_dist_epochs,
-             int ckpt_dist_steps)
+             int ckpt_dist_steps,
+             bool async = false,
+             int max_in_flight = 1)
     : callback_base(),
       m_active_trainer(nullptr),
       m_active_training_algorithm(nullptr),
@@ -81,10 +92,20 @@ public:
       m_checkpoint_secs(checkpoint_secs),
       m_per_rank_dir(per_rank_dir),
       m_ckpt_dist_epochs(ckpt_dist_epochs),
-      m_ckpt_dist_steps(ckpt_dist_steps)
+      m_ckpt_dist_steps(ckpt_dist_steps),
+      m_async(async),
+      m_max_in_flight(std::max(max_in_flight, 1))
   {}
   checkpoint(const checkpoint&) = default;
   checkpoint& operator=(const checkpoint&) = default;
+  /** @brief Waits for outstanding asynchronous checkpoints
+   *
+   *  Writes that were never finished with
+   *  @c finish_async_checkpoints (e.g. after an exception) are
+   *  joined but not recorded in the "latest" files, since the other
+   *  ranks may not have completed their part.
+   */
+  ~checkpoint() override;
   checkpoint* copy() const override { return new checkpoint(*this); }
   void setup(model *m) override;
   void setup(trainer *t) override;
@@ -165,6 +186,14 @@ public:
     m_ckpt_dist_steps = ckpt_dist_steps;
   }
 
+  inline void set_async(bool async){
+    m_async = async;
+  }
+
+  inline bool is_async() const {
+    return m_async;
+  }
+
   inline std::string get_shared_checkpoint_rootdir() {
     return get_restart_dir();
   }
@@ -197,10 +226,35 @@ public:
   bool reload_model(model *m);
   bool reload_trainer(trainer *t);
   bool restart(model *m);
+  /** @brief Wait for outstanding asynchronous checkpoints
+   *
+   *  Blocks until at most @c max_remaining checkpoints are still
+   *  being written. Each completed checkpoint is then recorded in
+   *  the "latest" files. Must be called on every rank of the
+   *  trainer.
+   */
+  void finish_async_checkpoints(lbann_comm& comm, size_t max_remaining = 0);
   std::string name() const override { return "checkpoint"; }
 private:
+  /** @brief Checkpoint being written by a background thread */
+  struct async_checkpoint {
+    /** @brief Bytes written and seconds spent writing */
+    std::shared_future<std::pair<uint64_t, EvalType>> write;
+    /** @brief "latest" files to update once all ranks are done */
+    std::vector<std::string> latest_files;
+    std::string label;
+    visitor_hook hook;
+    execution_mode mode;
+    size_t epoch;
+    size_t step;
+    /** @brief Time training was blocked by this checkpoint */
+    EvalType stall_secs;
+  };
+
   bool do_checkpoint(model *m, visitor_hook hook);
-  void do_distributed_checkpoint(
+  /** @returns Name of the "latest" file to update on the trainer
+   *  master, otherwise an empty string */
+  std::string do_distributed_checkpoint(
     lbann_comm& comm,
     trainer& t,
     model& m,
@@ -209,7 +263,9 @@ private:
     persist& p,
     size_t epoch,
     size_t step);
-  void do_shared_checkpoint(
+  /** @returns Name of the "latest" file to update on the trainer
+   *  master, otherwise an empty string */
+  std::string do_shared_checkpoint(
     lbann_comm& comm,
     trainer& t,
     model& m,
@@ -234,6 +290,12 @@ private:
   EvalType m_checkpoint_last;
   bool m_checkpoint_dist;
   bool m_checkpoint_shared;
+  /** @brief Write checkpoints from a background thread */
+  bool m_async;
+  /** @brief Maximum number of asynchronous checkpoints in flight */
+  int m_max_in_flight;
+  /** @brief Asynchronous checkpoints, oldest first */
+  std::deque<async_checkpoint> m_in_flight;
 
   template<size_t _max_dir_len>
   struct header_t {
@@ -244,6 +306,9 @@ private:
     int shared;
     char dirname[_max_dir_len];
   };
+
+  // Designate a whitebox testing friend
+  friend class ::CheckpointWhiteboxTester;
 };
 
 inline std::string get_trainer_checkpoint_dirname(const std::string& trainer_name, const std::string& dir) {
@@ -0,0 +1,185 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_CALLBACKS_CALLBACK_TRACE_HPP_INCLUDED
+#define LBANN_CALLBACKS_CALLBACK_TRACE_HPP_INCLUDED
+
+#include "lbann/callbacks/callback.hpp"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace lbann {
+namespace callback {
+
+/** @brief Record a per-layer profile of training.
+ *
+ *  Records, for every training step, the time spent in each layer's
+ *  forward and backward pass, in each weights' optimizer step, waiting
+ *  for gradient allreduces and waiting for the data coordinator, along
+ *  with the activation and error signal bytes held by each layer.
+ *
+ *  At the end of training, every rank writes its events to
+ *  trace.t\<trainer\>.r\<rank\>.json in the Chrome trace-event
+ *  format (load it in chrome://tracing or Perfetto). The trainer
+ *  master also writes trace.t\<trainer\>.summary.txt with the
+ *  minimum, mean and maximum time of each layer across the ranks of
+ *  the trainer, sorted by mean time, and the slowest rank. The top
+ *  entries of the summary are printed to standard output.
+ */
+class trace : public callback_base {
+public:
+  /** @param outdir Directory to write output to.
+   *  @param top_n Number of summary entries to print.
+   *  @param start_step First training step to record.
+   *  @param num_steps Number of steps to record (0 for all).
+   */
+  trace(std::string outdir,
+        size_t top_n = 10,
+        size_t start_step = 0,
+        size_t num_steps = 0)
+    : callback_base(1),
+      m_outdir(std::move(outdir)),
+      m_top_n(top_n),
+      m_start_step(start_step),
+      m_num_steps(num_steps)
+  {}
+  trace(const trace&) = default;
+  trace& operator=(const trace&) = default;
+  trace* copy() const override { return new trace(*this); }
+  std::string name() const override { return "trace"; }
+  void on_train_begin(model *m) override;
+  void on_train_end(model *m) override;
+  void on_batch_begin(model *m) override;
+  void on_batch_end(model *m) override;
+
+  using callback_base::on_forward_prop_begin;
+  using callback_base::on_forward_prop_end;
+  using callback_base::on_backward_prop_begin;
+  using callback_base::on_backward_prop_end;
+  using callback_base::on_optimize_begin;
+  using callback_base::on_optimize_end;
+
+  void on_forward_prop_begin(model *m, Layer *l) override;
+  void on_forward_prop_end(model *m, Layer *l) override;
+  void on_backward_prop_begin(model *m, Layer *l) override;
+  void on_backward_prop_end(model *m, Layer *l) override;
+  void on_optimize_begin(model *m, weights *w) override;
+  void on_optimize_end(model *m, weights *w) override;
+
+  /** @name Serialization */
+  ///@{
+
+  /** @brief Store state to archive for checkpoint and restart */
+  template <class Archive> void serialize(Archive & ar);
+
+  ///@}
+
+private:
+
+  friend class cereal::access;
+  trace();
+
+  /** @brief Kinds of recorded events */
+  enum class event_type : unsigned char {
+    step,
+    forward,
+    backward,
+    optimize,
+    allreduce_wait,
+    data_wait,
+  };
+
+  /** @brief A timed region on this rank */
+  struct event {
+    /** @brief Index into m_names */
+    size_t name;
+    event_type type;
+    /** @brief Start time relative to the start of training (s) */
+    EvalType start;
+    /** @brief Duration (s) */
+    EvalType duration;
+    /** @brief Bytes held by the layer or weights */
+    size_t bytes;
+  };
+
+  /** @brief Get time relative to the start time. */
+  EvalType get_rel_time() const;
+
+  /** @brief Write this rank's events as Chrome trace JSON. */
+  void write_chrome_trace(const std::string& path, int pid) const;
+
+  /** @brief Reduce per-layer totals and write the summary. */
+  void write_summary(model& m) const;
+
+  /** @brief Human-readable name of an event type. */
+  static std::string event_type_name(event_type type);
+  /** @brief Column of a per-layer or per-weights event type in the
+   *  summary table. */
+  static size_t summary_index(event_type type);
+  /** @brief Event type stored in a column of the summary table. */
+  static event_type summary_type(size_t index);
+
+  /** @brief Directory to write output to. */
+  std::string m_outdir;
+  /** @brief Number of summary entries to print. */
+  size_t m_top_n;
+  /** @brief First training step to record. */
+  size_t m_start_step;
+  /** @brief Number of steps to record (0 for all). */
+  size_t m_num_steps;
+
+  /** @brief Whether the current step is being recorded. */
+  bool m_recording = false;
+  /** @brief Number of steps seen so far. */
+  size_t m_step = 0;
+  /** @brief Time training started; all times are relative to this. */
+  EvalType m_start_time = EvalType(0);
+  EvalType m_step_start_time = EvalType(0);
+  EvalType m_fp_start_time = EvalType(0);
+  EvalType m_bp_start_time = EvalType(0);
+  EvalType m_opt_start_time = EvalType(0);
+  /** @brief Optimizer allreduce wait time when its step started. */
+  EvalType m_opt_start_allreduce_wait = EvalType(0);
+
+  /** @brief Names of layers and weights, in model order. */
+  std::vector<std::string> m_names;
+  std::unordered_map<std::string, size_t> m_layer_ids;
+  std::unordered_map<std::string, size_t> m_weights_ids;
+  /** @brief Events recorded on this rank. */
+  std::vector<event> m_events;
+};
+
+// Builder function
+std::unique_ptr<callback_base>
+build_trace_callback_from_pbuf(
+  const google::protobuf::Message&, std::shared_ptr<lbann_summary> const&);
+
+} // namespace callback
+} // namespace lbann
+
+#endif  // LBANN_CALLBACKS_CALLBACK_TRACE_HPP_INCLUDED
@@ -30,6 +30,10 @@
 #include "lbann/data_coordinator/data_coordinator.hpp"
 #include "lbann/data_coordinator/io_data_buffer.hpp"
 
+#include <deque>
+#include <future>
+#include <mutex>
+
 namespace lbann {
 
 template <typename TensorDataType>
@@ -50,11 +54,22 @@ class buffered_data_coordinator : public data_coordinator {
  public:
   typedef std::map<execution_mode, std::unique_ptr<data_buffer<IODataType>>> data_buffer_map_t;
  public:
-  buffered_data_coordinator(lbann_comm *comm) :
+  /** @brief Constructor
+   *  @param comm           Communicator
+   *  @param prefetch_depth Number of mini-batches fetched in the
+   *                        background ahead of the one being consumed.
+   */
+  buffered_data_coordinator(lbann_comm *comm, size_t prefetch_depth = 1) :
     data_coordinator(comm) {
 
-    // Initialize two buffers
-    m_data_buffers.resize(2);
+    if (prefetch_depth < 1) {
+      LBANN_ERROR("buffered data coordinator requires a prefetch depth of at "
+                  "least 1 (got ", prefetch_depth, ")");
+    }
+
+    // Initialize one buffer for the active mini-batch and one for
+    // each mini-batch being prefetched
+    m_data_buffers.resize(prefetch_depth + 1);
     for(size_t i = 0; i < m_data_buffers.size(); i++) {
       for(auto m : execution_mode_iterator()) {
         if(m != execution_mode::invalid) {
@@ -121,6 +136,9 @@ class buffered_data_coordinator : public data_coordinator {
   const data_buffer<IODataType>& get_active_buffer(execution_mode mode) const;
   data_buffer<IODataType>& get_active_buffer(execution_mode mode);
 
+  /** @brief Number of mini-batches fetched ahead of the active one */
+  size_t get_prefetch_depth() const { return m_data_buffers.size() - 1; }
+
   const El::Matrix<El::Int>* get_sample_indices_per_mb(execution_mode mode) const override;
   El::Matrix<El::Int>* get_sample_indices_per_mb(execution_mode mode) override;
 
@@ -138,9 +156,44 @@ class buffered_data_coordinator : public data_coordinator {
                                     AbsDistMatrixType& input_buffer);
 
 protected:
-  int fetch_to_local_matrix(data_buffer_map_t& buffer_map, const execution_mode mode);
-
-  void fetch_data_in_background(int future_active_buffer, execution_mode mode);
+  /** @brief Pending background fetch */
+  struct prefetch_request {
+    /** @brief Index of the buffer that will hold the mini-batch */
+    int future_active_buffer;
+    execution_mode mode;
+    /** @brief Data reader position of the mini-batch */
+    generic_data_reader::fetch_cursor cursor;
+    /** @brief Fulfilled once the mini-batch has been fetched */
+    std::promise<void> done;
+  };
+
+  int fetch_to_local_matrix(data_buffer_map_t& buffer_map,
+                            const execution_mode mode,
+                            const generic_data_reader::fetch_cursor& cursor);
+
+  void fetch_data_in_background(int future_active_buffer,
+                                execution_mode mode,
+                                const generic_data_reader::fetch_cursor& cursor);
+
+  /** @brief Queue a background fetch into a buffer
+   *
+   *  Must be called from the main thread since it reads the data
+   *  reader state. @c lookahead is the number of mini-batches past
+   *  the data reader's current position.
+   *
+   *  @returns False if the mini-batch is past the end of the epoch.
+   */
+  bool schedule_background_fetch(int future_active_buffer,
+                                 execution_mode mode,
+                                 int lookahead);
+
+  /** @brief Process queued background fetches in order
+   *
+   *  Runs on the I/O thread pool. Fetches are performed one at a
+   *  time since each fetch uses every I/O thread and data store
+   *  exchanges must happen in the same order on every rank.
+   */
+  void process_prefetch_queue();
 
   int get_active_buffer_idx(execution_mode m) const { return m_active_buffer.at(m).load(); }
 
@@ -178,12 +231,20 @@ protected:
   io_buffer_map_t m_active_buffer;
 
   /** Vector of input data buffers
-   *  There are two sets of buffer maps to allow for double buffered execution
+   *  There is one buffer map for the active mini-batch and one for
+   *  each prefetched mini-batch (two for double buffered execution)
    *  Within each buffer map there is a buffer for each phase of execution.
    *  Each matrix column corresponds to a flattened mini-batch sample
    *  or label or responase.
    */
   std::vector<data_buffer_map_t> m_data_buffers;
+
+  /** @brief Background fetches that have not started yet */
+  std::deque<prefetch_request> m_prefetch_queue;
+  /** @brief Protects the prefetch queue */
+  std::mutex m_prefetch_mutex;
+  /** @brief Whether a job is processing the prefetch queue */
+  bool m_prefetch_in_progress = false;
 };
 
 } // namespace lbann
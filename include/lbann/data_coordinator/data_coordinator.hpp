@@ -60,6 +60,18 @@ class data_coordinator {
   using data_reader_map_t = std::map<execution_mode, generic_data_reader *>;
   using io_buffer_map_t = std::map<execution_mode, std::atomic<int>>;
 
+  /** @brief Time spent blocked waiting for mini-batches to be fetched. */
+  struct data_wait_statistics {
+    /** @brief Number of mini-batches that have been requested. */
+    size_t num_mini_batches = 0;
+    /** @brief Total time blocked waiting on data (seconds). */
+    EvalType total_time = 0;
+    /** @brief Longest time blocked on a single mini-batch (seconds). */
+    EvalType max_time = 0;
+    /** @brief Time blocked on the most recent mini-batch (seconds). */
+    EvalType last_time = 0;
+  };
+
  public:
   data_coordinator(lbann_comm *comm) :
     m_trainer(nullptr),
@@ -180,6 +192,12 @@ class data_coordinator {
 
   virtual int get_current_world_master_mini_batch_adjustment(execution_mode mode, int model_rank) const;
 
+  /** @brief Statistics on time spent waiting for data. */
+  data_wait_statistics get_data_wait_statistics(execution_mode mode) const;
+
+  /** @brief Reset statistics on time spent waiting for data. */
+  void reset_data_wait_statistics(execution_mode mode);
+
   //************************************************************************
   // Helper functions to access the data readers
   //************************************************************************
@@ -501,6 +519,12 @@ class data_coordinator {
 
   std::set<data_field_type> m_active_data_fields;
 
+  /** @brief Record time spent blocked waiting for a mini-batch. */
+  void record_data_wait_time(execution_mode mode, EvalType time);
+
+  /** @brief Time spent blocked waiting for data in each execution mode. */
+  std::map<execution_mode, data_wait_statistics> m_data_wait_statistics;
+
 public:  // @todo BVE FIXME
   bool m_data_set_processed;
   std::mutex dr_mutex;
@@ -42,6 +42,7 @@
 #include "lbann/utils/options.hpp"
 #include "lbann/utils/random_number_generators.hpp"
 
+#include <atomic>
 #include <cassert>
 #include <algorithm>
 #include <string>
@@ -82,6 +83,7 @@ class generic_data_reader {
       m_comm(nullptr),
       m_mini_batch_size(0),
       m_current_pos(0),
+      m_fetch_pos(0),
       m_stride_to_next_mini_batch(0),
       m_base_offset(0),
       m_model_offset(0),
@@ -304,10 +306,43 @@ class generic_data_reader {
   /** Return this data_reader's type */
   virtual std::string get_type() const = 0;
 
+  /** @brief Position of a mini-batch within the shuffled indices.
+   *
+   *  Captures the reader state needed to fetch a mini-batch, so that
+   *  mini-batches ahead of the current one can be fetched while the
+   *  reader continues to advance.
+   */
+  struct fetch_cursor {
+    /** @brief Position of the first sample in the shuffled indices. */
+    int position = 0;
+    /** @brief Number of samples loaded by this reader. */
+    int loaded_mini_batch_size = 0;
+    /** @brief Mini-batch size seen by the model. */
+    int mini_batch_size = 0;
+  };
+
+  /** @brief Get the cursor for a mini-batch after the current one.
+   *
+   *  @param lookahead Number of mini-batches after the current one.
+   *  @param cursor    Output cursor.
+   *  @return False if the mini-batch is past the end of the epoch.
+   */
+  bool get_fetch_cursor(int lookahead, fetch_cursor& cursor) const;
+
   /** @brief Fetch a mini-batch worth of data, including samples, labels, responses (as appropriate) */
   int fetch(std::map<data_field_type, CPUMat*>& input_buffers,
             El::Matrix<El::Int>& indices_fetched);
 
+  /** @brief Fetch the mini-batch at a cursor.
+   *
+   *  The reader state is not modified, so this may be called from a
+   *  background thread while the reader is advanced. Only one fetch
+   *  may be in progress at a time.
+   */
+  int fetch(std::map<data_field_type, CPUMat*>& input_buffers,
+            El::Matrix<El::Int>& indices_fetched,
+            const fetch_cursor& cursor);
+
   /** @brief Check to see if the data reader supports this specific data field
    */
   virtual bool has_data_field(data_field_type data_field) const
@@ -771,6 +806,33 @@ class generic_data_reader {
                    El::Int mb_size,
                    El::Matrix<El::Int>& indices_fetched);
 
+  /** @brief Fetch chunks of samples until the mini-batch is exhausted
+   *
+   *  Each I/O thread repeatedly claims the next @c chunk_size
+   *  samples from @c next_sample, so the mini-batch fetch is not
+   *  held up by a thread that was assigned expensive samples.
+   */
+  bool fetch_data_chunks(std::map<data_field_type, CPUMat*>& input_buffers,
+                         El::Int thread_id,
+                         std::atomic<El::Int>& next_sample,
+                         El::Int chunk_size,
+                         El::Int mb_size,
+                         El::Matrix<El::Int>& indices_fetched);
+
+  /** @brief Whether fetch may distribute samples with fetch_data_chunks
+   *
+   *  Data readers that override fetch_data_block must return false.
+   */
+  virtual bool supports_chunked_fetch() const { return true; }
+
+  /** @brief Number of samples claimed at a time by an I/O thread */
+  static El::Int get_fetch_chunk_size(El::Int mb_size, El::Int num_threads);
+
+  /** @brief Fetch all data fields of one sample in the mini-batch */
+  void fetch_sample(std::map<data_field_type, CPUMat*>& input_buffers,
+                    El::Int mb_idx,
+                    El::Matrix<El::Int>& indices_fetched);
+
   /** @brief Called by fetch_data, fetch_label, fetch_response
    *
    * Fetch data from a single data field into a matrix.
@@ -838,6 +900,8 @@ class generic_data_reader {
 
   int m_mini_batch_size;
   int m_current_pos;
+  /// Position of the mini-batch that is currently being fetched
+  int m_fetch_pos;
   /// Batch Stride is typically batch_size, but may be a multiple of batch size if there are multiple readers
   int m_stride_to_next_mini_batch;
   /// If there are multiple instances of the reader,
@@ -103,6 +103,42 @@ public:
     return m_data_schema_filename;
   }
 
+  /** @brief Read samples in blocks, with one HDF5 read per field
+   *
+   *  In this mode each field is a single dataset on disk, named by
+   *  its path in the data schema, whose first dimension indexes
+   *  samples; sample names in the sample list are row indices into
+   *  these datasets. Samples are grouped by file, and each field of a
+   *  block of samples is read with one selection that merges runs of
+   *  consecutive rows. Coercion, normalization and packing are then
+   *  applied to the whole block rather than sample by sample.
+   *
+   *  Must be set before load().
+   */
+  void set_batched_reads(bool b) { m_batched_reads = b; }
+
+  /** @brief Returns true if samples are read in blocks */
+  bool get_batched_reads() const { return m_batched_reads; }
+
+  /** @brief Sets the number of samples per batched read
+   *
+   *  Zero reads a mini-batch worth of samples per block, or all of a
+   *  file's samples if the mini-batch size is not yet known.
+   */
+  void set_read_block_size(size_t n) { m_read_block_size = n; }
+
+  /** @brief Sets the raw data chunk cache for batched reads
+   *
+   *  Applied to every dataset opened for a batched read; see
+   *  H5Pset_chunk_cache. Zero keeps the HDF5 default for that
+   *  parameter (1 MiB and 521 slots).
+   */
+  void set_chunk_cache(size_t num_bytes, size_t num_slots)
+  {
+    m_chunk_cache_bytes = num_bytes;
+    m_chunk_cache_slots = num_slots;
+  }
+
   const std::vector<int> get_data_dims() const override
   {
     return get_data_dims("datum");
@@ -177,6 +213,15 @@ private:
   // penalty
   bool m_delete_packed_fields = true;
 
+  /** See set_batched_reads() */
+  bool m_batched_reads = false;
+  /** Samples per batched read; see set_read_block_size() */
+  size_t m_read_block_size = 0;
+  /** Chunk cache size in bytes for batched reads (0 for default) */
+  size_t m_chunk_cache_bytes = 0;
+  /** Number of chunk cache slots for batched reads (0 for default) */
+  size_t m_chunk_cache_slots = 0;
+
   struct PackingGroup
   {
     std::string group_name;
@@ -295,6 +340,30 @@ private:
   void
   load_sample(conduit::Node& node, size_t index, bool ignore_failure = false);
 
+  /** Loads samples that are rows of per-field datasets in one file;
+   *  see set_batched_reads(). Each field is read, coerced, normalized
+   *  and repacked for the whole block; the samples are then packed
+   *  directly from the block into 'nodes.'
+   */
+  void load_sample_block(const std::vector<size_t>& indices,
+                         const std::vector<conduit::Node*>& nodes,
+                         bool ignore_failure = false);
+
+  /** Reads the given rows (sorted, without duplicates) of the dataset
+   *  at 'path' into 'block', with one HDF5 read. The data type is
+   *  coerced on read if the metadata requests it. Returns false if the
+   *  dataset doesn't exist and 'ignore_failure' is set.
+   */
+  bool read_field_block(hid_t file_handle,
+                        const std::string& path,
+                        const conduit::Node& metadata,
+                        const std::vector<hsize_t>& rows,
+                        conduit::Node& block,
+                        bool ignore_failure = false);
+
+  /** Preloads this rank's samples using batched reads */
+  void preload_sample_blocks();
+
   /** Performs packing, normalization, etc. Called by load_sample. */
   void pack_data(conduit::Node& node_in_out);
 
@@ -314,10 +383,25 @@ private:
   /** Fills in m_packing_groups data structure */
   void build_packing_map(conduit::Node& node);
 
-  /** repacks from HWC to CHW */
+  /** pack row 'row' of a block of 'num_rows' samples read by
+   *  load_sample_block; this is for all 'groups'
+   */
+  void pack_block(const conduit::Node& block,
+                  size_t row,
+                  size_t num_rows,
+                  conduit::Node& node,
+                  size_t index);
+
+  /** Adds a packed group to the schemas as a composite node */
+  void add_composite_node(const std::string& group_name);
+
+  /** repacks from HWC to CHW; 'num_images' images stored back to back
+   *  are repacked independently
+   */
   void repack_image(conduit::Node& node,
                     const std::string& path,
-                    const conduit::Node& metadata);
+                    const conduit::Node& metadata,
+                    size_t num_images = 1);
 
   /** called from load_sample */
   void coerce(const conduit::Node& metadata,
@@ -348,6 +432,15 @@ private:
   template <typename T>
   void pack(std::string const& group_name, conduit::Node& node, size_t index);
 
+  /** Block variant of pack(); packs one sample of 'block' */
+  template <typename T>
+  void pack_block(std::string const& group_name,
+                  const conduit::Node& block,
+                  size_t row,
+                  size_t num_rows,
+                  conduit::Node& node,
+                  size_t index);
+
   /** Returns true if this is a node that was constructed from one or more
    * original data fields
    */
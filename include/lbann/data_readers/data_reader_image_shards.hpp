@@ -0,0 +1,116 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+//
+// data_reader_image_shards .hpp .cpp - data reader for packed image shards
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_DATA_READER_IMAGE_SHARDS_HPP
+#define LBANN_DATA_READER_IMAGE_SHARDS_HPP
+
+#include "data_reader_image.hpp"
+
+#include <cstdint>
+#include <istream>
+#include <memory>
+
+namespace lbann {
+
+/** @brief Image data reader for packed shard files.
+ *
+ *  Encoded images (e.g. JPEG) are concatenated into a few large shard
+ *  files. A text index lists the shard files followed by the shard,
+ *  byte offset, byte size, and label of every sample:
+ *
+ *  @code
+ *  LBANN_IMAGE_SHARDS 1
+ *  <num shards> <num samples>
+ *  <shard file, relative to the index file's directory>
+ *  ...
+ *  <shard> <offset> <size> <label>
+ *  ...
+ *  @endcode
+ *
+ *  The index is set with the reader's data_filedir and data_filename.
+ *  Shards are opened once and samples are read with pread, so a
+ *  fetch does not touch the filesystem metadata server. Shards can
+ *  be built with tools/image_shards/pack_image_shards.py.
+ */
+class image_shard_reader : public image_data_reader {
+ public:
+  /** @brief Location of one encoded sample */
+  struct shard_sample {
+    uint32_t shard;
+    uint64_t offset;
+    uint64_t size;
+  };
+
+  image_shard_reader(bool shuffle = true);
+  image_shard_reader(const image_shard_reader&) = default;
+  image_shard_reader& operator=(const image_shard_reader&) = default;
+  ~image_shard_reader() override;
+
+  image_shard_reader* copy() const override { return new image_shard_reader(*this); }
+
+  std::string get_type() const override {
+    return "image_shard_reader";
+  }
+
+  void load() override;
+
+  void setup(int num_io_threads, observer_ptr<thread_pool> io_thread_pool) override;
+
+  /** @brief Parse a shard index
+   *  @param istrm   Index contents
+   *  @param shards  Shard file names, as written in the index
+   *  @param samples Location of each sample
+   *  @param labels  Label of each sample
+   */
+  static void read_index(std::istream& istrm,
+                         std::vector<std::string>& shards,
+                         std::vector<shard_sample>& samples,
+                         labels_t& labels);
+
+ protected:
+  bool fetch_datum(CPUMat& X, int data_id, int mb_idx) override;
+
+ private:
+  /** @brief Open file descriptors for the shard files
+   *
+   *  Shared between copies of the reader since pread does not move
+   *  the file offset.
+   */
+  class shard_handles;
+
+  /** @brief Location of each sample */
+  std::vector<shard_sample> m_samples;
+  /** @brief Open shard files */
+  std::shared_ptr<shard_handles> m_shards;
+  /** @brief Per I/O thread buffers for encoded samples */
+  std::vector<std::vector<uint8_t>> m_thread_buffers;
+};
+
+}  // namespace lbann
+
+#endif  // LBANN_DATA_READER_IMAGE_SHARDS_HPP
@@ -31,12 +31,16 @@
 
 #include "data_reader_image.hpp"
 
+#include <mutex>
+#include <unordered_map>
+
 namespace lbann {
 class imagenet_reader : public image_data_reader {
  public:
   imagenet_reader(bool shuffle = true);
-  imagenet_reader(const imagenet_reader&) = default;
-  imagenet_reader& operator=(const imagenet_reader&) = default;
+  /** @details Files opened for readahead are not copied. */
+  imagenet_reader(const imagenet_reader&);
+  imagenet_reader& operator=(const imagenet_reader&);
   ~imagenet_reader() override;
 
   imagenet_reader* copy() const override { return new imagenet_reader(*this); }
@@ -49,6 +53,30 @@ class imagenet_reader : public image_data_reader {
   void set_defaults() override;
   virtual CPUMat create_datum_view(CPUMat& X, const int mb_idx) const;
   bool fetch_datum(CPUMat& X, int data_id, int mb_idx) override;
+
+ private:
+  /** @brief Load an image file with the configured I/O method
+   *  @details Uses the descriptor opened by readahead_image_file, if
+   *  there is one, so each file is only opened once.
+   */
+  void load_image_file(int data_id,
+                       const std::string& image_path,
+                       El::Matrix<uint8_t>& image,
+                       std::vector<size_t>& dims) const;
+  /** @brief Prefetch the image that will occupy the same mini-batch
+   *  slot @c m_image_readahead mini-batches from now */
+  void readahead_image_file(int mb_idx) const;
+  /** @brief Close descriptors opened by readahead_image_file */
+  void close_readahead_files() const;
+
+  /** @brief Memory-map image files instead of reading them */
+  bool m_use_mmap = false;
+  /** @brief Number of mini-batches ahead to prefetch image files */
+  int m_image_readahead = 0;
+  /** @brief Descriptors of prefetched files that have not been loaded,
+   *  indexed by data ID */
+  mutable std::unordered_map<int, int> m_readahead_files;
+  mutable std::mutex m_readahead_mutex;
 };
 
 }  // namespace lbann
@@ -64,6 +64,8 @@ protected:
                         El::Int block_stride,
                         El::Int mb_size,
                         El::Matrix<El::Int>& indices_fetched) override;
+  /** @brief The whole mini-batch is loaded by the first I/O thread */
+  bool supports_chunked_fetch() const override { return false; }
   bool fetch_label(CPUMat& Y, int data_id, int mb_idx) override;
 
 private:
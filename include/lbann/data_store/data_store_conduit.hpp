@@ -33,11 +33,18 @@
 #include "lbann/base.hpp"
 #include "lbann/comm.hpp"
 #include "lbann/utils/exception.hpp"
+#include "lbann/utils/random_number_generators.hpp"
+#include "lbann/data_store/tiered_sample_cache.hpp"
 #include "conduit/conduit_node.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
 #include <unordered_map>
 #include <unordered_set>
 #include <mutex>
 
+// Forward declaration
+class DataStoreConduitWhiteboxTester;
 
 namespace lbann {
 
@@ -94,6 +101,20 @@ class data_store_conduit {
   //! convenience handle
   void set_shuffled_indices(const std::vector<int> *indices);
 
+  /** @brief Reorders shuffled indices so that most samples are
+   * consumed by the rank that owns them
+   *
+   * Each position takes, with probability --data_store_locality, the
+   * next sample in shuffled order that is owned by the rank that will
+   * consume it, and otherwise the next unused sample in shuffled
+   * order. Does nothing if the locality is zero or the owner map is
+   * not yet complete. When explicitly loading, the owner maps are
+   * exchanged after the shuffle that precedes the 2nd epoch, so
+   * localization takes effect from the 3rd epoch. Must be called
+   * with the same generator state on all ranks.
+   */
+  void localize_shuffled_indices(std::vector<int> &indices, rng_gen &gen) const;
+
   /** @brief Returns the number of samples summed over all ranks */
   size_t get_num_global_indices() const;
 
@@ -340,6 +361,79 @@ private :
   /** @brief maps data_id to m_m_cur_spill_dir_integer. */
   map_ii_t m_spilled_nodes;
 
+  /** @brief Base directory for samples evicted by the tiered cache
+   *
+   * Empty if the tiered cache is not used; see: --data_store_tiered_cache
+   */
+  std::string m_tiered_cache_dir_base;
+
+  /** @brief Memory budget of the tiered cache, in bytes */
+  size_t m_tiered_cache_memory_budget = 0;
+
+  /** @brief Holds the samples owned by this rank, instead of m_data,
+   * if the tiered cache is used
+   *
+   * Created on first use, since its spill directory depends on the
+   * data reader's role. Must be mutable since it is created in
+   * get_conduit_node(), which is const.
+   */
+  mutable std::unique_ptr<tiered_sample_cache> m_tiered_cache;
+  mutable std::mutex m_tiered_cache_mutex;
+
+  /** @brief Probability that a mini-batch position is filled with a
+   * sample owned by its consumer; see localize_shuffled_indices()
+   */
+  double m_locality = 0;
+
+  /// Exchange statistics; see print_exchange_statistics()
+  size_t m_num_local_samples = 0;
+  size_t m_num_remote_samples = 0;
+  size_t m_remote_bytes = 0;
+
+  /** @brief Prefix of a compressed sample; see pack_sample() */
+  struct compressed_sample_header {
+    /// Size of the node built by build_node_for_sending()
+    uint64_t raw_size;
+    /// Bytes at the start of that node that are stored uncompressed,
+    /// i.e, "schema_len" and "schema"
+    uint64_t schema_size;
+    /// Element size used to shuffle the bytes of the data part
+    uint64_t element_size;
+  };
+
+  /** @brief Whether samples are stored and exchanged compressed
+   *
+   * A compressed sample is a uint8 array holding a short header, the
+   * schema part of the node built by build_node_for_sending(), and the
+   * shuffle-RLE compressed data part; see: --data_store_compress
+   */
+  bool m_compress_samples = false;
+
+  /** @brief A compressed sample that has been decompressed by an
+   * I/O thread; released at the next exchange
+   */
+  struct decompressed_sample {
+    std::once_flag decoded;
+    /// The node built by build_node_for_sending()
+    conduit::Node buffer;
+    /// "schema_len", "schema", and "data" children that refer to buffer
+    conduit::Node node;
+  };
+  mutable std::unordered_map<int, decompressed_sample> m_decompressed_samples;
+  mutable std::mutex m_decompression_mutex;
+
+  /// maps data_id -> index in m_recv_buffer of a compressed sample
+  map_ii_t m_compressed_recv_indices;
+
+  /// Compression statistics; see print_compression_statistics()
+  std::atomic<size_t> m_stored_raw_bytes{0};
+  std::atomic<size_t> m_stored_compressed_bytes{0};
+  size_t m_sent_raw_bytes = 0;
+  size_t m_sent_compressed_bytes = 0;
+  /// guarded by m_decompression_mutex
+  mutable size_t m_num_decompressed = 0;
+  mutable double m_decompression_time = 0;
+
   /// used in set_conduit_node(...)
   std::mutex m_mutex;
   std::mutex m_mutex_2;
@@ -513,11 +607,48 @@ private :
   void setup_data_store_buffers();
 
   /// called by exchange_data
-  void build_node_for_sending(const conduit::Node &node_in, conduit::Node &node_out);
+  static void build_node_for_sending(const conduit::Node &node_in, conduit::Node &node_out);
+
+  /** @brief Unpacks a buffer written by build_node_for_sending()
+   *
+   * node_out gets "schema_len", "schema", and "data" children that
+   * refer to the buffer.
+   */
+  static void unpack_node(conduit::uint8 *buffer, conduit::Node &node_out);
+
+  /** @brief Finds the element size of the leaf with the most bytes */
+  static void find_largest_leaf(const conduit::Node &node, size_t &largest_bytes, size_t &element_size);
+
+  /** @brief Calls build_node_for_sending(), then compresses node_out
+   * if m_compress_samples is set
+   *
+   * node_in and node_out may be the same node if compressing.
+   */
+  void pack_sample(const conduit::Node &node_in, conduit::Node &node_out);
+
+  /** @brief Decompresses a sample written by pack_sample()
+   *
+   * @param buffer holds the node built by build_node_for_sending()
+   * @param node_out refers to buffer; see unpack_node()
+   */
+  void decompress_sample(const conduit::Node &compressed, conduit::Node &buffer, conduit::Node &node_out) const;
+
+  /** @brief Returns the unpacked node of a compressed sample,
+   * decompressing it on first access
+   *
+   * Called by the I/O threads. The node remains valid until the
+   * next exchange.
+   */
+  const conduit::Node& get_decompressed_sample(int data_id) const;
 
   /// for use when conduit Nodes have non-uniform size, e.g, imagenet
   void exchange_sample_sizes();
 
+  /** @brief Returns the rank that consumes the sample at position
+   * 'pos' in the shuffled indices
+   */
+  int get_consumer_rank(int pos) const;
+
   /// fills in m_indices_to_send and returns the number of samples
   /// that will be sent
   int build_indices_i_will_send(int current_pos, int mb_size);
@@ -609,6 +740,37 @@ private :
   /** @brief Creates a directory for spilling conduit nodes */
   void open_next_conduit_spill_directory();
 
+  /** @brief Sets up a memory-bounded cache of owned samples that
+   * evicts least recently used samples to files in 'dir'
+   */
+  void setup_tiered_cache(std::string dir);
+
+  bool using_tiered_cache() const { return !m_tiered_cache_dir_base.empty(); }
+
+  /** @brief Returns the tiered cache, creating it if needed */
+  tiered_sample_cache& get_tiered_cache() const;
+
+  /** @brief Starts reading owned samples from disk, in shuffled order,
+   * for the mini-batch that starts at 'current_pos'
+   */
+  void prefetch_tiered_cache(size_t current_pos, size_t mb_size);
+
+  /** @brief Prints the tiered cache's hit, miss, and eviction counts,
+   * summed over the trainer, then resets them
+   */
+  void print_tiered_cache_statistics();
+
+  /** @brief Prints the compression ratios of stored and exchanged
+   * samples, summed over the trainer, and the time spent
+   * decompressing since the last call
+   */
+  void print_compression_statistics();
+
+  /** @brief Prints the fraction of exchanged samples that were sent
+   * to another rank, and their volume, since the last call
+   */
+  void print_exchange_statistics();
+
   /** @brief Write timing data for data exchange to the profile file, if it's opened */
   void profile_timing();
 
@@ -660,6 +822,9 @@ private :
     DEBUG_DS(var2...) ;
     flush_debug_file();
   }
+
+  // Designate a whitebox testing friend
+  friend class ::DataStoreConduitWhiteboxTester;
 };
 
 }  // namespace lbann
@@ -0,0 +1,74 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_DATA_STORE_SAMPLE_COMPRESSION_HPP_INCLUDED
+#define LBANN_DATA_STORE_SAMPLE_COMPRESSION_HPP_INCLUDED
+
+#include <cstddef>
+#include <vector>
+
+namespace lbann {
+
+/** @brief Lossless compression for buffers of numerical data.
+ *
+ *  Bytes are shuffled so that the k-th bytes of all elements are
+ *  contiguous, then run-length encoded. The sign, exponent, and
+ *  high-order mantissa bytes of floating-point data that varies
+ *  smoothly, as well as zero padding, form long runs after
+ *  shuffling. Trailing bytes that do not form a full element are
+ *  not shuffled.
+ *
+ *  Encoded data is a sequence of blocks, each starting with a
+ *  control byte @f$ c @f$. If @f$ c < 128 @f$, it is followed by
+ *  @f$ c+1 @f$ literal bytes. Otherwise, it is followed by one byte
+ *  that is repeated @f$ c-125 @f$ times. Incompressible data grows
+ *  by at most 1/128.
+ *
+ *  @param data Buffer to compress.
+ *  @param size Size of buffer in bytes.
+ *  @param element_size Size of data elements in bytes.
+ */
+std::vector<unsigned char> shuffle_rle_compress(const unsigned char* data,
+                                                size_t size,
+                                                size_t element_size);
+
+/** @brief Decompress data from @c shuffle_rle_compress.
+ *
+ *  @param data Compressed buffer.
+ *  @param size Size of compressed buffer in bytes.
+ *  @param output Buffer for decompressed data.
+ *  @param output_size Size of decompressed data in bytes.
+ *  @param element_size Element size used during compression.
+ */
+void shuffle_rle_decompress(const unsigned char* data,
+                            size_t size,
+                            unsigned char* output,
+                            size_t output_size,
+                            size_t element_size);
+
+} // namespace lbann
+
+#endif // LBANN_DATA_STORE_SAMPLE_COMPRESSION_HPP_INCLUDED
@@ -0,0 +1,171 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_DATA_STORE_TIERED_SAMPLE_CACHE_HPP_INCLUDED
+#define LBANN_DATA_STORE_TIERED_SAMPLE_CACHE_HPP_INCLUDED
+
+#include "conduit/conduit_node.hpp"
+
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace lbann {
+
+/** @brief Access counts of a tiered sample cache. */
+struct tiered_sample_cache_statistics {
+  /** @brief Accesses served from memory. */
+  size_t hits = 0;
+  /** @brief Accesses served by samples that were prefetched from disk. */
+  size_t prefetch_hits = 0;
+  /** @brief Accesses that blocked on reading a sample from disk. */
+  size_t misses = 0;
+  /** @brief Samples dropped from memory to stay within the budget. */
+  size_t evictions = 0;
+  size_t bytes_read = 0;
+  size_t bytes_written = 0;
+};
+
+/** @brief Memory-bounded sample cache backed by local disk.
+ *
+ *  Samples are held in memory up to a byte budget. Beyond that, the
+ *  least recently used samples are evicted to files in a spill
+ *  directory, ideally on node-local SSD, and are read back when they
+ *  are next accessed. Samples are immutable, so each one is written
+ *  to disk at most once.
+ *
+ *  Samples that will be needed soon can be read from disk in a
+ *  background thread with prefetch(). All methods are thread-safe.
+ */
+class tiered_sample_cache {
+public:
+  /** @brief Post-processing for nodes read back from disk. */
+  using restore_function = std::function<void(conduit::Node&)>;
+
+  /** @param memory_budget Maximum number of bytes held in memory.
+   *  @param spill_dir Directory for evicted samples. It is created
+   *                   if needed.
+   *  @param restore Applied to each node after it is read from disk,
+   *                 e.g. to recover a contiguous layout.
+   */
+  tiered_sample_cache(size_t memory_budget,
+                      std::string spill_dir,
+                      restore_function restore = nullptr);
+  /** @details Removes the files written to the spill directory. */
+  ~tiered_sample_cache();
+
+  tiered_sample_cache(const tiered_sample_cache&) = delete;
+  tiered_sample_cache& operator=(const tiered_sample_cache&) = delete;
+
+  /** @brief Add a new sample. */
+  void insert(int data_id, std::unique_ptr<conduit::Node> node);
+
+  /** @brief Whether a sample is in memory or on disk. */
+  bool contains(int data_id) const;
+
+  /** @brief Access a sample, reading it from disk if needed.
+   *  @details The sample is pinned in memory, so the returned
+   *  reference remains valid until unpin_all() is called.
+   */
+  const conduit::Node& get(int data_id);
+
+  /** @brief Allow all samples to be evicted again. */
+  void unpin_all();
+
+  /** @brief Start reading samples from disk in the background.
+   *  @details Samples that are already in memory are ignored. Waits
+   *  for any earlier prefetch to finish.
+   */
+  void prefetch(std::vector<int> data_ids);
+
+  std::vector<int> get_data_ids() const;
+  size_t get_num_samples() const;
+  size_t get_memory_usage() const;
+  size_t get_memory_budget() const noexcept { return m_memory_budget; }
+
+  tiered_sample_cache_statistics get_statistics() const;
+  void reset_statistics();
+
+private:
+
+  struct entry {
+    std::unique_ptr<conduit::Node> node;
+    size_t bytes = 0;
+    bool pinned = false;
+    /** @brief Read by prefetch() and not yet accessed. */
+    bool prefetched = false;
+    /** @brief Position in @c m_lru. */
+    std::list<int>::iterator lru_pos;
+  };
+
+  using prefetch_result =
+    std::vector<std::pair<int, std::unique_ptr<conduit::Node>>>;
+
+  size_t m_memory_budget;
+  std::string m_spill_dir;
+  restore_function m_restore;
+
+  /** @brief Samples held in memory. */
+  std::unordered_map<int, entry> m_resident;
+  /** @brief Resident samples, most recently used first. */
+  std::list<int> m_lru;
+  /** @brief Samples that have been written to disk. */
+  std::unordered_set<int> m_on_disk;
+  size_t m_memory_usage = 0;
+
+  /** @brief Samples being read by the background prefetch. */
+  std::unordered_set<int> m_prefetching;
+  std::future<prefetch_result> m_prefetch;
+
+  tiered_sample_cache_statistics m_statistics;
+
+  mutable std::mutex m_mutex;
+
+  std::string get_filename(int data_id) const;
+  /** @brief Read a sample from disk. Does not modify cache state. */
+  std::unique_ptr<conduit::Node> read_sample(int data_id) const;
+  /** @brief Evict unpinned samples until memory usage fits within
+   *  the budget.
+   */
+  void evict_to_budget();
+  entry& add_resident(int data_id, std::unique_ptr<conduit::Node> node);
+  /** @brief Move samples from the background prefetch into memory.
+   *  @param wait Whether to block until the prefetch has finished.
+   */
+  void collect_prefetch(bool wait);
+
+};
+
+} // namespace lbann
+
+#endif // LBANN_DATA_STORE_TIERED_SAMPLE_CACHE_HPP_INCLUDED
@@ -0,0 +1,155 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_EXECUTION_ALGORITHMS_LOCAL_SGD_HPP_INCLUDED
+#define LBANN_EXECUTION_ALGORITHMS_LOCAL_SGD_HPP_INCLUDED
+
+#include "lbann/execution_algorithms/sgd_training_algorithm.hpp"
+#include "lbann/utils/cloneable.hpp"
+
+#include <google/protobuf/message.h>
+#include <memory>
+
+namespace lbann {
+
+/** @brief SGD with periodic model averaging between trainers.
+ *
+ *  Each trainer takes optimization steps on its own data without
+ *  communicating with the other trainers. Every few steps, the
+ *  weights values (and optionally the optimizer state) are averaged
+ *  over all trainers with a single fused allreduce. Gradients are
+ *  still allreduced every step within a trainer, so trainers act as
+ *  the sub-groups that communicate frequently. With one rank per
+ *  trainer, this is classic per-rank local SGD.
+ *
+ *  If the averaging interval is adaptive, it is scaled by the square
+ *  root of the ratio between the current training loss and the loss
+ *  at the first averaging step, so that communication becomes more
+ *  frequent as training converges.
+ *
+ *  Lin, Tao, et al. "Don't use large mini-batches, use local SGD."
+ *  ICLR 2020.
+ *
+ *  Wang, Jianyu, and Gauri Joshi. "Adaptive communication strategies
+ *  to achieve the best error-runtime trade-off in local-update SGD."
+ *  SysML 2019.
+ */
+class local_sgd final : public Cloneable<local_sgd, sgd_training_algorithm>
+{
+  using BaseType = Cloneable<local_sgd, sgd_training_algorithm>;
+
+public:
+
+  /** @param name                    Algorithm name.
+   *  @param stop                    Termination criteria.
+   *  @param averaging_interval      Number of local steps between
+   *                                 model averages.
+   *  @param average_optimizer_state Whether to also average optimizer
+   *                                 state (SGD velocity, Adam moments).
+   *  @param adaptive_interval       Whether to adapt the averaging
+   *                                 interval to the training loss.
+   *  @param max_averaging_interval  Upper bound on the adaptive
+   *                                 averaging interval.
+   *  @param print_time              Whether to report time spent
+   *                                 averaging models at the end of
+   *                                 training.
+   */
+  local_sgd(std::string name,
+            std::unique_ptr<sgd_termination_criteria> stop,
+            size_t averaging_interval,
+            bool average_optimizer_state,
+            bool adaptive_interval,
+            size_t max_averaging_interval,
+            bool print_time = false);
+
+  local_sgd(const local_sgd& other) = default;
+  local_sgd& operator=(const local_sgd& other) = default;
+  ~local_sgd() = default;
+
+  std::string get_type() const override;
+
+  /** @brief Current number of local steps between model averages. */
+  size_t get_averaging_interval() const noexcept { return m_current_interval; }
+  /** @brief Number of model averages performed. */
+  size_t get_num_averages() const noexcept { return m_num_averages; }
+  /** @brief Time spent averaging models. */
+  EvalType get_averaging_time() const noexcept { return m_averaging_time; }
+
+  /** @brief Average weights over all trainers. */
+  void average_models(model& m);
+
+protected:
+
+  bool train_mini_batch(sgd_execution_context& c,
+                        model& model,
+                        data_coordinator& dc) override;
+
+  void do_train_end_cbs(model& model) override;
+
+private:
+
+  /** @brief Update averaging interval from the training loss. */
+  void adapt_interval(model& m);
+
+  /** @brief Initial number of local steps between model averages. */
+  size_t m_averaging_interval;
+  /** @brief Whether to also average optimizer state. */
+  bool m_average_optimizer_state;
+  /** @brief Whether to adapt the averaging interval. */
+  bool m_adaptive_interval;
+  /** @brief Upper bound on the adaptive averaging interval. */
+  size_t m_max_averaging_interval;
+  /** @brief Whether to report time spent averaging models. */
+  bool m_print_time;
+
+  /** @brief Current number of local steps between model averages. */
+  size_t m_current_interval;
+  /** @brief Local steps since the last model average. */
+  size_t m_steps_since_average = 0;
+  /** @brief Training loss at the first model average.
+   *  @details Negative if not yet recorded.
+   */
+  EvalType m_initial_loss = -1;
+  /** @brief Sum of training loss at the last model average. */
+  EvalType m_last_loss_sum = 0;
+  /** @brief Number of samples in training loss at the last model
+   *  average.
+   */
+  int m_last_loss_samples = 0;
+
+  /** @brief Number of model averages performed. */
+  size_t m_num_averages = 0;
+  /** @brief Time spent averaging models. */
+  EvalType m_averaging_time = 0;
+};
+
+template <>
+std::unique_ptr<local_sgd>
+make<local_sgd>(google::protobuf::Message const& params);
+
+} // namespace lbann
+
+#endif // LBANN_EXECUTION_ALGORITHMS_LOCAL_SGD_HPP_INCLUDED
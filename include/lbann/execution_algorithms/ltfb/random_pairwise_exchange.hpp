@@ -252,6 +252,43 @@ private:
   bool exchange_hyperparams_;
 }; // class SendRecvWeights
 
+/** @class StreamWeights
+ *  @brief Stream weights values directly between partner ranks.
+ *
+ *  Each rank sends the local part of every exchanged weights matrix
+ *  to the rank with the same rank-in-trainer in the partner trainer,
+ *  split into fixed-size chunks with non-blocking sends and
+ *  receives. Nothing is funneled through the trainer master and the
+ *  model is never serialized. Only weights values are exchanged; the
+ *  optimizer state of the partner model is the local one.
+ *
+ *  Like SendRecvWeights, this assumes the model topology and weights
+ *  distributions are identical across trainers. Only weights with the
+ *  default data type are supported.
+ */
+class StreamWeights final
+  : public Cloneable<StreamWeights, RandomPairwiseExchange::ExchangeStrategy>
+{
+  using BaseType =
+    Cloneable<StreamWeights, RandomPairwiseExchange::ExchangeStrategy>;
+
+public:
+  /** @brief Construct from weights names
+   *  @param[in] weights_names Names of weights to exchange. If empty,
+   *                           then all weights are exchanged.
+   *  @param[in] chunk_bytes Maximum size of a single message in
+   *                         bytes.
+   */
+  StreamWeights(std::set<std::string> weights_names, size_t chunk_bytes);
+
+  std::unique_ptr<model> get_partner_model(model const& m,
+                                           El::Int partner_trainer,
+                                           size_t /*step*/) final;
+
+private:
+  size_t m_chunk_bytes;
+}; // class StreamWeights
+
 /// See @c lbann::callbacks::ltfb::communication_algorithm::checkpoint_file
 class CheckpointFile final
   : public Cloneable<CheckpointFile, RandomPairwiseExchange::ExchangeStrategy>
@@ -34,6 +34,8 @@
 #include "lbann/utils/enum_iterator.hpp"
 #include "El.hpp"
 #include <sstream>
+#include <string>
+#include <vector>
 
 namespace lbann {
 
@@ -111,11 +113,21 @@ enum class callback_type {
   invalid
 };
 
+/** @brief Contents of a checkpoint file held in host memory */
+struct staged_file {
+  std::string filename;
+  std::string contents;
+};
+
 class persist {
  private:
   std::map<persist_type, uint64_t> m_bytes;
   std::map<persist_type, std::string> m_filenames;
   callback_type ckpt_type;
+  /** @brief Whether large checkpoint files are kept in host memory */
+  bool m_staging = false;
+  /** @brief Files waiting to be written by write_staged_files */
+  std::vector<staged_file> m_staged_files;
  public:
   std::string m_checkpoint_dir;
 
@@ -169,8 +181,33 @@ class persist {
   const std::string& get_checkpoint_dir() const { return m_checkpoint_dir; }
 
   std::string get_filename(persist_type type) const;
+
+  /** @brief Keep large checkpoint files in host memory
+   *
+   *  While staging is enabled, objects that support it (currently
+   *  the model archive with the weights and optimizer state) hand
+   *  their serialized bytes to stage_file instead of writing to
+   *  disk. The caller is responsible for writing them out.
+   */
+  void set_staging(bool staging) { m_staging = staging; }
+  bool is_staging() const { return m_staging; }
+
+  /** @brief Hold a checkpoint file in host memory */
+  void stage_file(persist_type type, std::string filename, std::string contents);
+
+  /** @brief Remove and return all staged files */
+  std::vector<staged_file> take_staged_files();
 };
 
+/** @brief Write staged checkpoint files to disk
+ *
+ *  Does not communicate, so it is safe to call from a background
+ *  thread.
+ *
+ *  @returns The number of bytes written
+ */
+uint64_t write_staged_files(const std::vector<staged_file>& files);
+
 bool write_bytes(int fd, const char *name, const void *buf, size_t size);
 bool read_bytes(int fd, const char *name, void *buf, size_t size);
 
@@ -56,6 +56,8 @@ public:
   std::string get_type() const override { return "ELU"; }
   data_layout get_data_layout() const override { return Layout; }
   El::Device get_device_allocation() const override { return Device; }
+  bool supports_strided_tensors() const override { return true; }
+  bool bp_reads_outputs() const override { return false; }
 
   description get_description() const override {
     auto desc = data_type_layer<TensorDataType>::get_description();
@@ -60,6 +60,8 @@ public:
   std::string get_type() const override { return "identity"; }
   data_layout get_data_layout() const override { return Layout; }
   El::Device get_device_allocation() const override { return Device; }
+  bool bp_reads_inputs() const override { return false; }
+  bool bp_reads_outputs() const override { return false; }
 
   /** @name Serialization */
   ///@{
@@ -88,6 +88,7 @@ public:
   std::string get_type() const override { return "log softmax"; }
   data_layout get_data_layout() const override { return Layout; }
   El::Device get_device_allocation() const override { return Device; }
+  bool bp_reads_inputs() const override { return false; }
 
   void setup_dims(DataReaderMetaData& dr_metadata) override {
     data_type_layer<TensorDataType>::setup_dims(dr_metadata);
@@ -112,6 +112,7 @@ public:
   std::string get_type() const final { return "softmax"; }
   data_layout get_data_layout() const final { return Layout; }
   El::Device get_device_allocation() const final { return Device; }
+  bool bp_reads_inputs() const final { return false; }
 
   void setup_dims(DataReaderMetaData& dr_metadata) final {
     data_type_layer<TensorDataType>::setup_dims(dr_metadata);
@@ -115,6 +115,21 @@ public:
    */
   void forward_prop() final;
 
+  bool supports_activation_recompute() const override;
+  size_t discard_activations() override;
+  void recompute_forward_prop() override;
+  void reattach_inputs() override;
+  bool has_viewing_outputs() const override;
+
+  size_t get_planned_output_bytes(int child_index) const override;
+  size_t get_planned_error_signal_bytes(int parent_index) const override;
+  void set_planned_output_buffer(int child_index,
+                                 void* buffer,
+                                 size_t bytes) override;
+  void set_planned_error_signal_buffer(int parent_index,
+                                       void* buffer,
+                                       size_t bytes) override;
+
   void summarize_matrices(lbann_summary& summarizer, int step) override;
 
   /** Check that the setup is reasonable. */
@@ -167,6 +182,9 @@ public:
    *  false means to dynamically reallocate them.
    */
   void set_keep_error_signals(bool) override;
+  bool get_keep_error_signals() const override {
+    return m_persistent_error_signals;
+  }
 
 
   El::mpi::Comm& get_subgrid_comm() { return *m_interSubGridVCComm; }
@@ -422,6 +440,31 @@ private:
    */
   bool m_persistent_error_signals = false;
 
+  /** @brief Whether each gradient w.r.t. input is a view into the
+   *  parent's storage (see Layer::view_shared_output_gradient_storage).
+   *
+   *  Reset at the start of every back prop.
+   */
+  std::vector<bool> m_shared_gradient_wrt_inputs;
+
+  /** @brief Host storage owned by the model (see
+   *  model::set_layer_memory_planning).
+   */
+  struct planned_buffer {
+    void* data = nullptr;
+    size_t bytes = 0;
+  };
+  /** @brief Planned storage for each output tensor.
+   *  @details Missing or null entries use regular allocation.
+   */
+  std::vector<planned_buffer> m_planned_outputs;
+  /** @brief Planned storage for each gradient w.r.t. input. */
+  std::vector<planned_buffer> m_planned_gradient_wrt_inputs;
+  /** @brief Whether each output tensor was allocated by
+   *  fp_setup_outputs rather than made a view.
+   */
+  std::vector<bool> m_allocated_outputs;
+
 #ifdef LBANN_HAS_DISTCONV
   friend class data_type_distconv_adapter<InputTensorDataType,OutputTensorDataType>;
  public:
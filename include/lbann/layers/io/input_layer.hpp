@@ -122,6 +122,7 @@ class input_layer : public data_type_layer<TensorDataType> {
   }
 
   std::string get_type() const override { return "input"; }
+  bool supports_activation_recompute() const override { return false; }
   // description get_description() const override {
   //   auto desc = io_layer<TensorDataType>::get_description();
   //   return desc;
@@ -141,6 +142,11 @@ class input_layer : public data_type_layer<TensorDataType> {
   void fp_compute() override;
 
   /** @brief Places samples in input tensors
+   *
+   *  The data coordinator is no longer used afterwards. The number of
+   *  samples should match the current mini-batch size in the
+   *  execution context.
+   *
    *  @param samples Distributed Matrix of samples
    */
   void set_samples(const El::AbstractDistMatrix<TensorDataType>& samples);
@@ -402,6 +402,132 @@ public:
    */
   void back_prop();
 
+  /** @name Activation recomputation */
+  ///@{
+
+  /** @brief Whether forward prop can be repeated during backward prop.
+   *  @details Layers whose forward prop has side effects, e.g.
+   *  fetching data, drawing random numbers, or updating running
+   *  statistics, must return false.
+   */
+  virtual bool supports_activation_recompute() const { return false; }
+  /** @brief Release output tensors until they are recomputed.
+   *  @returns Local bytes released.
+   */
+  virtual size_t discard_activations() { return 0; }
+  /** @brief Repeat the forward prop computation.
+   *  @details Unlike forward_prop, this does not register the layer
+   *  as a gradient source for its weights' optimizers.
+   */
+  virtual void recompute_forward_prop() {}
+  /** @brief Refresh views of the parent layers' output tensors.
+   *  @details Called after a parent layer recomputes its outputs.
+   */
+  virtual void reattach_inputs() {}
+  /** @brief Whether an output tensor is a view into storage owned
+   *  by another layer.
+   *  @details The owner must not release that storage while this
+   *  layer's outputs are in use. Only meaningful after setup.
+   */
+  virtual bool has_viewing_outputs() const { return false; }
+
+  ///@}
+
+  /** @name Shared tensor storage */
+  ///@{
+
+  /** @brief Whether the layer accepts tensors stored in matrices
+   *  whose leading dimension exceeds their height.
+   *  @details Such tensors are views into the rows of a larger
+   *  matrix, e.g. the output of a zero-copy concatenate layer. The
+   *  layer must honor the leading dimension of its inputs, outputs,
+   *  and their gradients in every kernel, so layers opt in
+   *  explicitly.
+   */
+  virtual bool supports_strided_tensors() const { return false; }
+  /** @brief Let a parent layer write its output into this layer's
+   *  storage.
+   *  @details Called while the parent sets up its output tensors.
+   *  If this returns true, @c parent_output has been made a view
+   *  and the parent must not reallocate it.
+   */
+  virtual bool view_shared_input_storage(const Layer& parent,
+                                         BaseDistMat& parent_output,
+                                         El::Int mini_batch_size) {
+    return false;
+  }
+  /** @brief Let a child layer write its gradient w.r.t. input into
+   *  this layer's storage.
+   *  @details Called while the child sets up its gradients w.r.t.
+   *  inputs. If this returns true, @c child_input_grad has been made
+   *  a view into this layer's persistent gradient w.r.t. input, and
+   *  the child must not reallocate it.
+   */
+  virtual bool view_shared_output_gradient_storage(
+    const Layer& child,
+    BaseDistMat& child_input_grad,
+    El::Int mini_batch_size) {
+    return false;
+  }
+
+  ///@}
+
+  /** @name Memory planning */
+  ///@{
+
+  /** @brief Whether backward prop reads the input tensors.
+   *  @details If false, the model may reuse the storage of an input
+   *  tensor once forward prop no longer needs it.
+   */
+  virtual bool bp_reads_inputs() const { return true; }
+  /** @brief Whether backward prop reads the output tensors. */
+  virtual bool bp_reads_outputs() const { return true; }
+  /** @brief Local bytes needed to store an output tensor in storage
+   *  owned by the model.
+   *  @details Zero if the output cannot be stored in a planned
+   *  buffer, e.g. if it is a view or it is not in host memory. Only
+   *  meaningful after setup.
+   */
+  virtual size_t get_planned_output_bytes(int /*child_index*/) const {
+    return 0;
+  }
+  /** @brief Local bytes needed to store a gradient w.r.t. input in
+   *  storage owned by the model.
+   *  @details Zero if the gradient cannot be stored in a planned
+   *  buffer. Only meaningful after setup.
+   */
+  virtual size_t get_planned_error_signal_bytes(int /*parent_index*/) const {
+    return 0;
+  }
+  /** @brief Store an output tensor in storage owned by the model.
+   *  @details Takes effect at the next forward prop. A null buffer
+   *  restores regular allocation.
+   */
+  virtual void set_planned_output_buffer(int /*child_index*/,
+                                         void* /*buffer*/,
+                                         size_t /*bytes*/) {}
+  /** @brief Store a gradient w.r.t. input in storage owned by the
+   *  model.
+   *  @details Takes effect at the next backward prop. A null buffer
+   *  restores regular allocation.
+   */
+  virtual void set_planned_error_signal_buffer(int /*parent_index*/,
+                                               void* /*buffer*/,
+                                               size_t /*bytes*/) {}
+
+  ///@}
+
+  /** @brief Merge an entry-wise child layer into this layer.
+   *  @details Used by the model's operator fusion pass. If the merge
+   *  succeeds, this layer computes the composition of its own and
+   *  the child's operations. The model is responsible for rewiring
+   *  the child's children and removing the child.
+   *  @returns Whether the child was merged.
+   */
+  virtual bool absorb_elementwise_child(const Layer& /*child*/) {
+    return false;
+  }
+
   /** @brief Update step.
    *  Update the layer's internal members. Note that the optimization
    *  step for the weights happens elsewhere.
@@ -594,6 +720,8 @@ public:
    *  false means to dynamically reallocate them.
    */
   virtual void set_keep_error_signals(bool) = 0;
+  /** @brief Whether error signals are kept between steps. */
+  virtual bool get_keep_error_signals() const = 0;
 
   /** @name Serialization */
   ///@{
@@ -613,6 +741,11 @@ protected:
   Layer& operator=(Layer const& other);
   ///@}
 
+  /** @brief Number of micro-batches per optimization step.
+   *  @details One if the layer is not attached to a model.
+   */
+  size_t get_gradient_accumulation_steps() const;
+
   /** @name Weights-related accessors */
   ///@{
   void add_weights(ViewingWeightsPtr w) {
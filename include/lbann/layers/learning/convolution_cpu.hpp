@@ -0,0 +1,131 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_LAYERS_LEARNING_CONVOLUTION_CPU_HPP_INCLUDED
+#define LBANN_LAYERS_LEARNING_CONVOLUTION_CPU_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+
+#include <vector>
+
+namespace lbann {
+namespace convolution_cpu {
+
+/** @brief Convolution on CPU with im2col and GEMM.
+ *
+ *  Samples are processed in blocks. The im2col matrices for a block
+ *  are constructed in parallel and then multiplied with the kernel
+ *  in one GEMM, which is much more efficient than one small GEMM per
+ *  sample when images are small. Convolutions with 1x1 windows, no
+ *  padding, and unit strides skip im2col entirely since each sample
+ *  can be viewed as the im2col matrix.
+ *
+ *  Tensor dimensions include the channel dimension. Window
+ *  parameters only include the spatial dimensions.
+ *
+ *  @param input  Input tensors, one per column.
+ *  @param output Output tensors, one per column.
+ *  @param kernel Kernel matrix, (input_channels*window_size) x
+ *                output_channels.
+ */
+template <typename TensorDataType>
+void apply_convolution(const CPUMatDT<TensorDataType>& input,
+                       CPUMatDT<TensorDataType>& output,
+                       const CPUMatDT<TensorDataType>& kernel,
+                       const std::vector<int>& input_dims,
+                       const std::vector<int>& output_dims,
+                       const int* window_dims,
+                       const int* pads,
+                       const int* strides,
+                       const int* dilations);
+
+/** @brief Transposed convolution on CPU with GEMM and col2im.
+ *
+ *  Samples are processed in blocks, with one GEMM per block followed
+ *  by a parallel col2im. See apply_convolution.
+ *
+ *  @param kernel Kernel matrix, (output_channels*window_size) x
+ *                input_channels.
+ */
+template <typename TensorDataType>
+void apply_transposed_convolution(const CPUMatDT<TensorDataType>& input,
+                                  CPUMatDT<TensorDataType>& output,
+                                  const CPUMatDT<TensorDataType>& kernel,
+                                  const std::vector<int>& input_dims,
+                                  const std::vector<int>& output_dims,
+                                  const int* window_dims,
+                                  const int* pads,
+                                  const int* strides,
+                                  const int* dilations);
+
+/** @brief Accumulate kernel gradient on CPU with im2col and GEMM.
+ *
+ *  Computes
+ *  @f$ G \leftarrow G + \alpha \sum_i \text{im2col}(X_i) Y_i @f$,
+ *  where @f$ Y_i @f$ is sample @f$ i @f$ of @c mat viewed as a
+ *  num_window_offsets x mat_channels matrix. For convolution, @c im
+ *  is the input and @c mat is the output gradient. For transposed
+ *  convolution, they are swapped.
+ *
+ *  @param kernel_gradient (im_channels*window_size) x mat_channels
+ */
+template <typename TensorDataType>
+void accumulate_kernel_gradient(const CPUMatDT<TensorDataType>& im,
+                                const CPUMatDT<TensorDataType>& mat,
+                                CPUMatDT<TensorDataType>& kernel_gradient,
+                                const std::vector<int>& im_dims,
+                                int mat_channels,
+                                const int* window_dims,
+                                const int* pads,
+                                const int* strides,
+                                const int* dilations,
+                                TensorDataType scale);
+
+#ifndef LBANN_CONVOLUTION_CPU_INSTANTIATE
+#define PROTO(T)                                                        \
+  extern template void apply_convolution<T>(                            \
+    const CPUMatDT<T>&, CPUMatDT<T>&, const CPUMatDT<T>&,               \
+    const std::vector<int>&, const std::vector<int>&,                   \
+    const int*, const int*, const int*, const int*);                    \
+  extern template void apply_transposed_convolution<T>(                 \
+    const CPUMatDT<T>&, CPUMatDT<T>&, const CPUMatDT<T>&,               \
+    const std::vector<int>&, const std::vector<int>&,                   \
+    const int*, const int*, const int*, const int*);                    \
+  extern template void accumulate_kernel_gradient<T>(                   \
+    const CPUMatDT<T>&, const CPUMatDT<T>&, CPUMatDT<T>&,               \
+    const std::vector<int>&, int,                                       \
+    const int*, const int*, const int*, const int*, T)
+
+#define LBANN_INSTANTIATE_CPU_HALF
+#include "lbann/macros/instantiate.hpp"
+#undef PROTO
+#undef LBANN_INSTANTIATE_CPU_HALF
+#endif // LBANN_CONVOLUTION_CPU_INSTANTIATE
+
+} // namespace convolution_cpu
+} // namespace lbann
+
+#endif // LBANN_LAYERS_LEARNING_CONVOLUTION_CPU_HPP_INCLUDED
@@ -76,10 +76,14 @@ public:
    *                        vector is initialized with zeros. The
    *                        objective function gradient w.r.t. this
    *                        embedding vector is always zero.
+   *  @param sparse_gradients Whether to send the optimizer a sparse
+   *                        gradient with only the embedding vectors
+   *                        in the mini-batch. Only supported on CPU.
    */
   embedding_layer(size_t num_embeddings,
                   size_t embedding_dim,
-                  El::Int padding_idx=-1);
+                  El::Int padding_idx=-1,
+                  bool sparse_gradients=false);
 
   embedding_layer(const embedding_layer& other);
   embedding_layer& operator=(const embedding_layer& other);
@@ -123,6 +127,11 @@ private:
    *  gradient w.r.t. this embedding vector is always zero.
    */
   El::Int m_padding_idx;
+  /** Whether to send the optimizer a sparse gradient. Momentum in
+   *  the SGD and Adam optimizers then only decays for embedding
+   *  vectors that appear in the mini-batch.
+   */
+  bool m_sparse_gradients;
 
   /** Gradient w.r.t. embedding weights. */
   std::unique_ptr<AbsDistMatrixType> m_embeddings_grad;
@@ -137,11 +146,13 @@ template <typename TensorDataType, data_layout Layout, El::Device Device>
 embedding_layer<TensorDataType,Layout,Device>::embedding_layer(
   size_t num_embeddings,
   size_t embedding_dim,
-  El::Int padding_idx)
+  El::Int padding_idx,
+  bool sparse_gradients)
   : data_type_layer<TensorDataType>(nullptr),
     m_num_embeddings{num_embeddings},
     m_embedding_dim{embedding_dim},
-    m_padding_idx{padding_idx} {}
+    m_padding_idx{padding_idx},
+    m_sparse_gradients{sparse_gradients} {}
 
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 embedding_layer<TensorDataType,Layout,Device>::embedding_layer()
@@ -155,6 +166,7 @@ embedding_layer<TensorDataType,Layout,Device>::embedding_layer(
     m_num_embeddings{other.m_num_embeddings},
     m_embedding_dim{other.m_embedding_dim},
     m_padding_idx{other.m_padding_idx},
+    m_sparse_gradients{other.m_sparse_gradients},
     m_embeddings_grad(other.m_embeddings_grad
                       ? other.m_embeddings_grad->Copy()
                       : nullptr) {}
@@ -166,6 +178,7 @@ embedding_layer<TensorDataType,Layout,Device>& embedding_layer<TensorDataType,La
   m_num_embeddings = other.m_num_embeddings;
   m_embedding_dim = other.m_embedding_dim;
   m_padding_idx = other.m_padding_idx;
+  m_sparse_gradients = other.m_sparse_gradients;
   m_embeddings_grad.reset(other.m_embeddings_grad
                           ? other.m_embeddings_grad->Copy()
                           : nullptr);
@@ -198,6 +211,7 @@ description embedding_layer<TensorDataType,Layout,Device>::get_description() con
   desc.add("Num embeddings", m_num_embeddings);
   desc.add("Embedding dim", m_embedding_dim);
   desc.add("Padding index", m_padding_idx);
+  desc.add("Sparse gradients", m_sparse_gradients);
   return desc;
 }
 
@@ -86,6 +86,8 @@ public:
   std::string get_type() const override { return "fully connected"; }
   data_layout get_data_layout() const override { return T_layout; }
   El::Device get_device_allocation() const override { return Dev; }
+  bool supports_strided_tensors() const override { return true; }
+  bool bp_reads_outputs() const override { return false; }
 
   description get_description() const override;
 
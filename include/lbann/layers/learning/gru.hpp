@@ -28,6 +28,7 @@
 #define LBANN_LAYERS_LEARNING_GRU_HPP_INCLUDED
 
 #include "lbann/layers/data_type_layer.hpp"
+#include "lbann/layers/learning/gru_cpu.hpp"
 #ifdef LBANN_HAS_DNN_LIB
 #include "lbann/utils/dnn_lib/helpers.hpp"
 #endif // LBANN_HAS_DNN_LIB
@@ -62,8 +63,12 @@ namespace lbann {
  *  "ih_bias" ( @f$ 3 \text{hidden\_size} @f$ ),
  *  "hh_bias" ( @f$ 3 \text{hidden\_size} @f$ ).
  *
- *  Currently only supported on GPU. Requires at least CUDA 11.0 and
- *  cuDNN 8.0.4.
+ *  On GPU, requires at least CUDA 11.0 and cuDNN 8.0.4. On CPU,
+ *  oneDNN is used if available. Otherwise, or if oneDNN does not
+ *  support the configuration (stacked GRU cells with
+ *  input\_size@f$\neq@f$hidden\_size), a native implementation is
+ *  used. The native implementation can be forced with
+ *  --use_native_cpu_gru.
  *
  *  @todo Support bidirectional RNNs
  */
@@ -170,6 +175,23 @@ private:
   ///@}
 #endif // LBANN_GRU_LAYER_ONEDNN_CPU_SUPPORTED
 
+  /** @name Native CPU implementation */
+  ///@{
+
+  /** @brief Workspaces for native CPU implementation
+   *  @details Null if another implementation is used.
+   */
+  std::unique_ptr<gru_cpu::workspace<TensorDataType>> m_native_cpu_objects;
+
+  /** @brief Setup native CPU implementation */
+  void setup_native_cpu();
+  /** @brief Forward prop with native CPU implementation */
+  void fp_compute_native_cpu();
+  /** @brief Back prop with native CPU implementation */
+  void bp_compute_native_cpu();
+
+  ///@}
+
 #ifdef LBANN_GRU_LAYER_CUDNN_SUPPORTED
   /** @name cuDNN implementation */
   ///@{
@@ -239,14 +261,12 @@ LBANN_DEFINE_LAYER_BUILDER(gru);
 // Explicit template instantiation
 #ifndef LBANN_GRU_LAYER_INSTANTIATE
 
-#ifdef LBANN_GRU_LAYER_ONEDNN_CPU_SUPPORTED
 #define PROTO(T)                                        \
   extern template class gru_layer<                      \
     T, data_layout::DATA_PARALLEL, El::Device::CPU>;
 #define LBANN_INSTANTIATE_CPU_HALF
 #include "lbann/macros/instantiate.hpp"
 #undef PROTO
-#endif // LBANN_GRU_LAYER_ONEDNN_CPU_SUPPORTED
 
 #ifdef LBANN_GRU_LAYER_CUDNN_SUPPORTED
 #define PROTO(T)                                        \
@@ -0,0 +1,158 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_LAYERS_LEARNING_GRU_CPU_HPP_INCLUDED
+#define LBANN_LAYERS_LEARNING_GRU_CPU_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+
+#include <vector>
+
+namespace lbann {
+namespace gru_cpu {
+
+/** @brief Workspaces for the native CPU GRU implementation.
+ *
+ *  Matrices with @f$ \text{sequence\_length}\times\text{mini\_batch\_size} @f$
+ *  columns store one column per time step and sample, with the time
+ *  step varying fastest. This matches the memory layout of the
+ *  layer's input and output sequences, so a contiguous sequence
+ *  matrix can be viewed without copying.
+ *
+ *  Forward prop fills the output sequence and gate values of each
+ *  GRU cell, which must be kept until back prop.
+ */
+template <typename TensorDataType>
+struct workspace {
+  using LocalMat = El::Matrix<TensorDataType, El::Device::CPU>;
+
+  /** @brief Output sequence of each GRU cell
+   *  @details hidden_size x (sequence_length*mini_batch_size)
+   */
+  std::vector<LocalMat> output_sequences;
+  /** @brief Gate values of each GRU cell
+   *  @details 4*hidden_size x (sequence_length*mini_batch_size).
+   *  Rows are the reset gate, the update gate, the new gate, and the
+   *  hidden-hidden contribution to the new gate (needed for back
+   *  prop since it is scaled by the reset gate).
+   */
+  std::vector<LocalMat> gates;
+
+  /** @brief Contiguous copy of the input sequence, if needed */
+  LocalMat input_sequence;
+  /** @brief Hidden-hidden contribution to gates for one time step */
+  LocalMat hh_gates;
+  /** @brief Gradient w.r.t. input-hidden contribution to gates */
+  LocalMat ih_gates_grad;
+  /** @brief Gradient w.r.t. hidden-hidden contribution to gates */
+  LocalMat hh_gates_grad;
+  /** @brief Hidden state before each time step */
+  LocalMat prev_hidden;
+  /** @brief Gradient w.r.t. output sequence of a GRU cell */
+  LocalMat output_sequence_grad;
+  /** @brief Contiguous gradient w.r.t. input sequence, if needed */
+  LocalMat input_sequence_grad;
+  /** @brief Gradient w.r.t. hidden state for one time step */
+  LocalMat hidden_grad;
+  /** @brief Vector of ones for bias gradients */
+  LocalMat ones;
+};
+
+/** @brief Forward prop for stacked GRU on CPU.
+ *
+ *  Follows the same conventions as the cuDNN GRU (reset gate
+ *  applied after the hidden-hidden matrix product). For each GRU
+ *  cell, the input-hidden matrix products for all time steps are
+ *  computed with one GEMM up front. Each time step then needs one
+ *  hidden-hidden GEMM and a fused pass that applies the gate
+ *  nonlinearities and updates the hidden state.
+ *
+ *  @param input_sequence (sequence_length*input_size) x mini_batch_size
+ *  @param init_hidden (num_layers*hidden_size) x mini_batch_size
+ *  @param weights 4*num_layers matrices per GRU cell: ih_matrix
+ *                 (3*hidden_size x input_size), hh_matrix
+ *                 (3*hidden_size x hidden_size), ih_bias and
+ *                 hh_bias (3*hidden_size x 1). Gates are ordered
+ *                 {reset, update, new}.
+ *  @param output_sequence (sequence_length*hidden_size) x mini_batch_size
+ */
+template <typename TensorDataType>
+void fp_compute(
+  const El::Matrix<TensorDataType, El::Device::CPU>& input_sequence,
+  const El::Matrix<TensorDataType, El::Device::CPU>& init_hidden,
+  const std::vector<El::Matrix<TensorDataType, El::Device::CPU>>& weights,
+  El::Matrix<TensorDataType, El::Device::CPU>& output_sequence,
+  workspace<TensorDataType>& ws);
+
+/** @brief Back prop for stacked GRU on CPU.
+ *
+ *  Must be called after fp_compute with the same inputs and
+ *  workspace. Gradients w.r.t. the gates are stored for all time
+ *  steps, so the weight gradients for each GRU cell are computed
+ *  with one GEMM each after the recurrence.
+ *
+ *  @param weights_grad Gradients w.r.t. weights, in the same order
+ *                      as @c weights. Resized if needed.
+ */
+template <typename TensorDataType>
+void bp_compute(
+  const El::Matrix<TensorDataType, El::Device::CPU>& input_sequence,
+  const El::Matrix<TensorDataType, El::Device::CPU>& init_hidden,
+  const std::vector<El::Matrix<TensorDataType, El::Device::CPU>>& weights,
+  const El::Matrix<TensorDataType, El::Device::CPU>& output_sequence_grad,
+  El::Matrix<TensorDataType, El::Device::CPU>& input_sequence_grad,
+  El::Matrix<TensorDataType, El::Device::CPU>& init_hidden_grad,
+  std::vector<El::Matrix<TensorDataType, El::Device::CPU>>& weights_grad,
+  workspace<TensorDataType>& ws);
+
+#ifndef LBANN_GRU_CPU_INSTANTIATE
+#define PROTO(T)                                                        \
+  extern template void fp_compute<T>(                                   \
+    const El::Matrix<T, El::Device::CPU>&,                              \
+    const El::Matrix<T, El::Device::CPU>&,                              \
+    const std::vector<El::Matrix<T, El::Device::CPU>>&,                 \
+    El::Matrix<T, El::Device::CPU>&,                                    \
+    workspace<T>&);                                                     \
+  extern template void bp_compute<T>(                                   \
+    const El::Matrix<T, El::Device::CPU>&,                              \
+    const El::Matrix<T, El::Device::CPU>&,                              \
+    const std::vector<El::Matrix<T, El::Device::CPU>>&,                 \
+    const El::Matrix<T, El::Device::CPU>&,                              \
+    El::Matrix<T, El::Device::CPU>&,                                    \
+    El::Matrix<T, El::Device::CPU>&,                                    \
+    std::vector<El::Matrix<T, El::Device::CPU>>&,                       \
+    workspace<T>&)
+
+#define LBANN_INSTANTIATE_CPU_HALF
+#include "lbann/macros/instantiate.hpp"
+#undef PROTO
+#undef LBANN_INSTANTIATE_CPU_HALF
+#endif // LBANN_GRU_CPU_INSTANTIATE
+
+} // namespace gru_cpu
+} // namespace lbann
+
+#endif // LBANN_LAYERS_LEARNING_GRU_CPU_HPP_INCLUDED
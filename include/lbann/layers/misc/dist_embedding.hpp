@@ -85,6 +85,7 @@ public:
   dist_embedding_layer* copy() const override;
 
   std::string get_type() const override;
+  bool supports_activation_recompute() const override { return false; }
   data_layout get_data_layout() const override;
   El::Device get_device_allocation() const override;
 
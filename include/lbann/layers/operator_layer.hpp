@@ -28,6 +28,7 @@
 
 #include "lbann/layers/data_type_layer.hpp"
 #include "lbann/layers/layer.hpp"
+#include "lbann/operators/elementwise_operator.hpp"
 #include "lbann/operators/operator.hpp"
 #include "lbann/utils/describable.hpp"
 #include "lbann/utils/tensor.hpp"
@@ -76,10 +77,18 @@ public:
   std::string get_type() const final;
   data_layout get_data_layout() const final;
   El::Device get_device_allocation() const final;
+  bool bp_reads_outputs() const final { return false; }
 
   void fp_compute() final;
   void bp_compute() final;
 
+  /** @brief Append the operators of an entry-wise operator layer.
+   *  @details Merging is possible if both layers have the same type
+   *  and all of their operators are entry-wise. The operators are
+   *  then applied in a single pass over memory.
+   */
+  bool absorb_elementwise_child(const Layer& child) final;
+
   description get_description() const final;
 
   template <typename ArchiveT>
@@ -94,6 +103,12 @@ private:
 
   static std::vector<size_t> fix_type(std::vector<int> const& in);
 
+  /** @brief Operators as entry-wise operators.
+   *  @details Throws if any operator is not entry-wise.
+   */
+  std::vector<ElementwiseOperator<InputT, OutputT, D> const*>
+  get_elementwise_ops() const;
+
   std::vector<utils::ConstDistTensorView<InputT, D>> get_inputs() const;
   std::vector<utils::DistTensorView<OutputT, D>> get_outputs();
   std::vector<utils::ConstDistTensorView<OutputT, D>>
@@ -57,8 +57,12 @@ OperatorLayer<InputT, OutputT, Layout, D>::OperatorLayer(
   std::vector<OperatorPtr> operators)
   : DataTypeLayer(&comm), m_ops{std::move(operators)}
 {
-  LBANN_ASSERT(m_ops.size() == 1UL); // For starters.
-  LBANN_ASSERT(m_ops[0]);
+  LBANN_ASSERT(!m_ops.empty());
+  for (auto const& op : m_ops)
+    LBANN_ASSERT(op);
+  // Multiple operators are applied as a fused entry-wise chain
+  if (m_ops.size() > 1UL)
+    (void)get_elementwise_ops();
   this->m_expected_num_parent_layers = -1; // No limit on parents
 }
 
@@ -106,17 +110,50 @@ OperatorLayer<InputT, OutputT, Layout, D>::get_device_allocation() const
 template <typename InputT, typename OutputT, data_layout Layout, El::Device D>
 void OperatorLayer<InputT, OutputT, Layout, D>::fp_compute()
 {
+  if (m_ops.size() > 1UL) {
+    return ElementwiseOperator<InputT, OutputT, D>::fp_compute_chain(
+      get_elementwise_ops(),
+      this->get_inputs(),
+      this->get_outputs().front());
+  }
   return m_ops[0]->fp_compute(this->get_inputs(), this->get_outputs());
 }
 
 template <typename InputT, typename OutputT, data_layout Layout, El::Device D>
 void OperatorLayer<InputT, OutputT, Layout, D>::bp_compute()
 {
+  if (m_ops.size() > 1UL) {
+    return ElementwiseOperator<InputT, OutputT, D>::bp_compute_chain(
+      get_elementwise_ops(),
+      this->get_inputs(),
+      this->get_grad_wrt_outputs().front(),
+      this->get_grad_wrt_inputs());
+  }
   return m_ops[0]->bp_compute(this->get_inputs(),
                               this->get_grad_wrt_outputs(),
                               this->get_grad_wrt_inputs());
 }
 
+template <typename InputT, typename OutputT, data_layout Layout, El::Device D>
+bool OperatorLayer<InputT, OutputT, Layout, D>::absorb_elementwise_child(
+  const Layer& child)
+{
+  auto const* other = dynamic_cast<OperatorLayer const*>(&child);
+  if (other == nullptr || this->get_num_children() != 1 ||
+      other->get_num_parents() != 1 || other->get_num_children() != 1)
+    return false;
+  auto const is_elementwise = [](OperatorPtr const& op) {
+    return dynamic_cast<ElementwiseOperator<InputT, OutputT, D> const*>(
+             op.get()) != nullptr;
+  };
+  if (!std::all_of(cbegin(m_ops), cend(m_ops), is_elementwise) ||
+      !std::all_of(cbegin(other->m_ops), cend(other->m_ops), is_elementwise))
+    return false;
+  for (auto const& op : other->m_ops)
+    m_ops.emplace_back(op->clone());
+  return true;
+}
+
 template <typename InputT, typename OutputT, data_layout Layout, El::Device D>
 description OperatorLayer<InputT, OutputT, Layout, D>::get_description() const
 {
@@ -159,6 +196,28 @@ OperatorLayer<InputT, OutputT, Layout, D>::fix_type(std::vector<int> const& in)
   return std::vector<size_t>{cbegin(in), cend(in)};
 }
 
+template <typename InputT, typename OutputT, data_layout Layout, El::Device D>
+std::vector<ElementwiseOperator<InputT, OutputT, D> const*>
+OperatorLayer<InputT, OutputT, Layout, D>::get_elementwise_ops() const
+{
+  std::vector<ElementwiseOperator<InputT, OutputT, D> const*> out;
+  out.reserve(m_ops.size());
+  for (auto const& op : m_ops) {
+    auto const* ew_op =
+      dynamic_cast<ElementwiseOperator<InputT, OutputT, D> const*>(op.get());
+    if (ew_op == nullptr) {
+      LBANN_ERROR("operator layer \"",
+                  this->get_name(),
+                  "\" has multiple operators, ",
+                  "but \"",
+                  op->get_type(),
+                  "\" is not entry-wise");
+    }
+    out.push_back(ew_op);
+  }
+  return out;
+}
+
 template <typename InputT, typename OutputT, data_layout Layout, El::Device D>
 std::vector<utils::ConstDistTensorView<InputT, D>>
 OperatorLayer<InputT, OutputT, Layout, D>::get_inputs() const
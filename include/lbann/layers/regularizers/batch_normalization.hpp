@@ -31,6 +31,8 @@
 #include "lbann/models/model.hpp"
 #include "lbann/utils/distconv.hpp"
 
+#include <cmath>
+
 namespace lbann {
 
 enum class batch_normalization_stats_aggregation {
@@ -110,6 +112,18 @@ private:
   TensorDataType m_decay;
   /** Small number to avoid division by zero. */
   TensorDataType m_epsilon;
+
+  /** @brief Decay rate for the running statistics per forward prop.
+   *  @details With gradient accumulation, the running statistics are
+   *  updated once per micro-batch. The decay is adjusted so that they
+   *  decay by @c m_decay per optimization step.
+   */
+  TensorDataType get_running_decay() const {
+    const auto steps = this->get_gradient_accumulation_steps();
+    if (steps <= 1) { return m_decay; }
+    return El::To<TensorDataType>(
+      std::pow(El::To<double>(m_decay), 1.0 / steps));
+  }
   /** @brief Size of group to aggregate statistics over.
    *
    * If this is 1, the group consists of one process and aggregation
@@ -219,6 +233,7 @@ public:
 
   batch_normalization_layer* copy() const override { return new batch_normalization_layer(*this); }
   std::string get_type() const override { return "batch normalization"; }
+  bool supports_activation_recompute() const override { return false; }
   data_layout get_data_layout() const override { return T_layout; }
   El::Device get_device_allocation() const override { return Dev; }
 
@@ -529,7 +544,7 @@ void batch_normalization_distconv_adapter<TensorDataType, T_layout, Dev>::setup_
 
   m_bn = make_unique<dc::BatchNormalization<TensorDataType>>(
       dc::get_backend(), dc::get_num_dims(l),
-      l.m_decay, l.m_epsilon, global_stats);
+      l.get_running_decay(), l.m_epsilon, global_stats);
 }
 #endif // LBANN_HAS_DISTCONV
 
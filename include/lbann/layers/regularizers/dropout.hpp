@@ -109,6 +109,7 @@ public:
 
   dropout* copy() const override { return new dropout(*this); }
   std::string get_type() const override { return "dropout"; }
+  bool supports_activation_recompute() const override { return false; }
   data_layout get_data_layout() const override { return T_layout; }
   El::Device get_device_allocation() const override { return Dev; }
 
@@ -31,6 +31,8 @@
 #include "lbann/models/model.hpp"
 #include "lbann/utils/memory.hpp"
 
+#include <cmath>
+
 namespace lbann {
 
 /** @brief
@@ -99,6 +101,7 @@ public:
 
   entrywise_batch_normalization_layer* copy() const override { return new entrywise_batch_normalization_layer(*this); }
   std::string get_type() const override { return "entry-wise batch normalization"; }
+  bool supports_activation_recompute() const override { return false; }
   data_layout get_data_layout() const override { return Layout; }
   El::Device get_device_allocation() const override { return Device; }
 
@@ -236,6 +239,18 @@ private:
   /** Small number to avoid division by zero. */
   TensorDataType m_epsilon;
 
+  /** @brief Decay rate for the running statistics per forward prop.
+   *  @details With gradient accumulation, the running statistics are
+   *  updated once per micro-batch. The decay is adjusted so that they
+   *  decay by @c m_decay per optimization step.
+   */
+  TensorDataType get_running_decay() const {
+    const auto steps = this->get_gradient_accumulation_steps();
+    if (steps <= 1) { return m_decay; }
+    return El::To<TensorDataType>(
+      std::pow(El::To<double>(m_decay), 1.0 / steps));
+  }
+
   /** @brief Current mini-batch statistics.
    *
    *  These are fused for performance when doing non-local batchnorm.
@@ -102,6 +102,7 @@ public:
   selu_dropout* copy() const override { return new selu_dropout(*this); }
 
   std::string get_type() const override { return "selu dropout"; }
+  bool supports_activation_recompute() const override { return false; }
 
   data_layout get_data_layout() const override { return T_layout; }
 
@@ -65,6 +65,7 @@ class categorical_random_layer : public data_type_layer<TensorDataType> {
   ///@}
 
   std::string get_type() const override { return "categorical random"; }
+  bool supports_activation_recompute() const override { return false; }
   data_layout get_data_layout() const override { return T_layout; }
   El::Device get_device_allocation() const override { return Dev; }
 
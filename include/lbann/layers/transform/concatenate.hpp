@@ -34,6 +34,9 @@
 #include <lbann/proto/proto_common.hpp>
 #include <layers.pb.h>
 
+#include <algorithm>
+#include <numeric>
+
 namespace lbann {
 
 #ifdef LBANN_HAS_DISTCONV
@@ -51,14 +54,25 @@ class concatenate_distconv_adapter : public data_type_distconv_adapter<TensorDat
 };
 #endif // LBANN_HAS_DISTCONV
 
-/** @brief Concatenate tensors along specified dimension. */
+/** @brief Concatenate tensors along specified dimension.
+ *
+ *  If zero-copy mode is enabled and the concatenated tensors occupy
+ *  contiguous rows of the output matrix, i.e. all dimensions before
+ *  the concatenation dimension are 1, parent layers write their
+ *  outputs directly into views of the output matrix and receive
+ *  views of the output gradient. Parents that cannot operate on
+ *  strided tensors fall back to copies. Zero-copy mode is only
+ *  supported with the data-parallel layout.
+ */
 template <typename TensorDataType,
           data_layout Layout = data_layout::DATA_PARALLEL,
           El::Device Device = El::Device::CPU>
 class concatenate_layer : public data_type_layer<TensorDataType> {
 public:
 
-  concatenate_layer(lbann_comm *comm, size_t concat_dim);
+  concatenate_layer(lbann_comm *comm,
+                    size_t concat_dim,
+                    bool zero_copy = false);
   concatenate_layer(const concatenate_layer& other) = default;
   concatenate_layer& operator=(const concatenate_layer& other) = default;
 
@@ -75,9 +89,17 @@ public:
   std::string get_type() const override;
   data_layout get_data_layout() const override;
   El::Device get_device_allocation() const override;
+  bool bp_reads_inputs() const override { return false; }
+  bool bp_reads_outputs() const override { return false; }
 
   description get_description() const override;
 
+  bool view_shared_input_storage(const Layer& parent,
+                                 BaseDistMat& parent_output,
+                                 El::Int mini_batch_size) override;
+  /** @details Output storage is kept while parents share it. */
+  size_t discard_activations() override;
+
 protected:
   El::SyncInfo<Device> syncSubGridCommunication = El::SyncInfo<Device>();
 
@@ -88,6 +110,7 @@ protected:
 
   void setup_pointers() override;
   void setup_dims(DataReaderMetaData& dr_metadata) override;
+  void setup_data(size_t max_mini_batch_size) override;
 
   void fp_setup_outputs(El::Int mini_batch_size) override;
   void bp_setup_gradient_wrt_inputs(El::Int mini_batch_size) override;
@@ -98,6 +121,8 @@ private:
 
   /** @brief Tensor dimension to concatenate along. */
   size_t m_concat_dim;
+  /** @brief Whether parents may share the output storage. */
+  bool m_zero_copy;
 
 #ifdef LBANN_HAS_GPU
   /** @brief Workspace buffer.
@@ -125,6 +150,18 @@ private:
 
   void bp_compute_subgrid();
 
+  /** @brief Whether zero-copy mode applies to this layer.
+   *  @details Requires each input tensor to occupy contiguous rows
+   *  of the output matrix.
+   */
+  bool shares_storage();
+  /** @brief First row of an input tensor in the output matrix. */
+  El::Int get_input_offset(size_t parent_index) const;
+
+  void fp_compute_shared();
+  void bp_setup_gradient_wrt_inputs_shared();
+  void bp_compute_shared();
+
 #ifdef LBANN_HAS_DISTCONV
   friend class concatenate_distconv_adapter<TensorDataType, Layout, Device>;
  protected:
@@ -149,9 +186,11 @@ private:
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 concatenate_layer<TensorDataType,Layout,Device>::concatenate_layer(
   lbann_comm *comm,
-  size_t concat_dim)
+  size_t concat_dim,
+  bool zero_copy)
   : data_type_layer<TensorDataType>(comm),
-    m_concat_dim{concat_dim} {
+    m_concat_dim{concat_dim},
+    m_zero_copy{zero_copy} {
   this->m_expected_num_parent_layers = -1; // No limit on parents
 }
 
@@ -179,9 +218,93 @@ template <typename TensorDataType, data_layout Layout, El::Device Device>
 description concatenate_layer<TensorDataType,Layout,Device>::get_description() const {
   auto desc = data_type_layer<TensorDataType>::get_description();
   desc.add("Concatenation dimension", m_concat_dim);
+  desc.add("Zero-copy", m_zero_copy);
   return desc;
 }
 
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+bool concatenate_layer<TensorDataType,Layout,Device>::shares_storage() {
+  if (!m_zero_copy
+      || Layout != data_layout::DATA_PARALLEL
+      || this->get_num_parents() < 2
+      || this->is_subgraph_parallelism_enabled()) {
+    return false;
+  }
+#ifdef LBANN_HAS_DISTCONV
+  if (this->distconv_enabled()) { return false; }
+#endif // LBANN_HAS_DISTCONV
+  const auto& output_dims = this->get_output_dims();
+  return std::accumulate(output_dims.begin(),
+                         output_dims.begin() + m_concat_dim,
+                         1,
+                         std::multiplies<int>()) == 1;
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+El::Int concatenate_layer<TensorDataType,Layout,Device>::get_input_offset(
+  size_t parent_index) const {
+  El::Int offset = 0;
+  for (size_t j=0; j<parent_index; ++j) {
+    offset += this->get_input_size(j);
+  }
+  return offset;
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+bool concatenate_layer<TensorDataType,Layout,Device>::view_shared_input_storage(
+  const Layer& parent,
+  BaseDistMat& parent_output,
+  El::Int mini_batch_size) {
+  using MatrixType = El::DistMatrix<TensorDataType, El::STAR, El::VC, El::ELEMENT, Device>;
+  if (!shares_storage() || !parent.supports_strided_tensors()) {
+    return false;
+  }
+
+  // Parents that appear more than once need separate buffers
+  const auto& parents = this->get_parent_layers();
+  if (std::count(parents.begin(), parents.end(), &parent) != 1) {
+    return false;
+  }
+
+  // Both matrices must have the same distribution
+  auto* parent_output_ptr = dynamic_cast<MatrixType*>(&parent_output);
+  auto* output_ptr = dynamic_cast<MatrixType*>(&this->get_activations());
+  if (parent_output_ptr == nullptr || output_ptr == nullptr
+      || &parent_output_ptr->Grid() != &output_ptr->Grid()) {
+    return false;
+  }
+
+  // Allocate output matrix on first request of this step
+  auto& output = *output_ptr;
+  const El::Int output_size = this->get_output_size();
+  if (output.Viewing()
+      || output.Height() != output_size
+      || output.Width() != mini_batch_size) {
+    output.Empty(false);
+    output.AlignWith(parent_output_ptr->DistData());
+    output.Resize(output_size, mini_batch_size);
+  }
+  else if (output.RowAlign() != parent_output_ptr->RowAlign()
+           || output.Root() != parent_output_ptr->Root()) {
+    return false;
+  }
+
+  // Parent output is a view into the output matrix
+  const auto j = this->find_parent_layer_index(parent);
+  const auto offset = get_input_offset(j);
+  El::View(*parent_output_ptr, output,
+           El::IR(offset, offset + this->get_input_size(j)), El::ALL);
+  return true;
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+size_t concatenate_layer<TensorDataType,Layout,Device>::discard_activations() {
+  if (shares_storage()) {
+    return 0;
+  }
+  return data_type_layer<TensorDataType>::discard_activations();
+}
+
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 void concatenate_layer<TensorDataType,Layout,Device>::setup_pointers() {
   data_type_layer<TensorDataType>::setup_pointers();
@@ -254,6 +377,17 @@ void concatenate_layer<TensorDataType,Layout,Device>::setup_dims(DataReaderMetaD
 
 }
 
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void concatenate_layer<TensorDataType,Layout,Device>::setup_data(size_t max_mini_batch_size) {
+  data_type_layer<TensorDataType>::setup_data(max_mini_batch_size);
+
+  // Parents hold views into the gradient w.r.t. inputs, so it must
+  // persist after back prop
+  if (shares_storage()) {
+    this->set_keep_error_signals(true);
+  }
+}
+
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 void concatenate_layer<TensorDataType,Layout,Device>::fp_setup_outputs(El::Int mini_batch_size) {
 #ifdef LBANN_HAS_DISTCONV
@@ -261,6 +395,19 @@ void concatenate_layer<TensorDataType,Layout,Device>::fp_setup_outputs(El::Int m
 #endif // LBANN_HAS_DISTCONV
   const auto& input0 = this->get_prev_activations(0);
   auto& output = this->get_activations();
+
+  // Keep storage that parents have already written into
+  if (shares_storage()) {
+    if (output.Viewing()
+        || output.Height() != this->get_output_size()
+        || output.Width() != input0.Width()) {
+      output.Empty(false);
+      output.AlignWith(input0);
+      output.Resize(this->get_output_size(), input0.Width());
+    }
+    return;
+  }
+
   output.Empty(false);
   if (this->get_num_parents() == 1) {
     El::LockedView(output, input0);
@@ -332,6 +479,12 @@ void concatenate_layer<TensorDataType,Layout,Device>::fp_compute() {
     return;
   }
 
+  // Only copy inputs that were not written in place
+  if (shares_storage()) {
+    fp_compute_shared();
+    return;
+  }
+
   // Perform concatenation
   if(m_concat_dim==num_dims-1 && this->is_subgraph_parallelism_enabled() && this->get_parallel_strategy().enable_subgraph==true)
   {
@@ -345,6 +498,59 @@ void concatenate_layer<TensorDataType,Layout,Device>::fp_compute() {
 
 }
 
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void concatenate_layer<TensorDataType,Layout,Device>::fp_compute_shared() {
+  auto& output = this->get_activations();
+  std::unique_ptr<El::AbstractDistMatrix<TensorDataType>> output_v(
+    output.Construct(output.Grid(), output.Root()));
+  for (int j=0; j<this->get_num_parents(); ++j) {
+    const auto& input = this->get_prev_activations(j);
+    const auto offset = get_input_offset(j);
+    El::View(*output_v, output,
+             El::IR(offset, offset + input.Height()), El::ALL);
+    const bool in_place = (input.LockedBuffer() == output_v->LockedBuffer()
+                           && input.LDim() == output_v->LDim()
+                           && input.RowAlign() == output_v->RowAlign());
+    if (!in_place) {
+      El::Copy(input, *output_v);
+    }
+  }
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void concatenate_layer<TensorDataType,Layout,Device>::bp_setup_gradient_wrt_inputs_shared() {
+  const auto& output_grad = this->get_prev_error_signals();
+  for (int j=0; j<this->get_num_parents(); ++j) {
+    auto& input_grad = this->get_error_signals(j);
+    const auto offset = get_input_offset(j);
+    const auto input_size = this->get_input_size(j);
+    input_grad.Empty(false);
+    if (this->get_parent_layer(j).supports_strided_tensors()) {
+      El::LockedView(input_grad, output_grad,
+                     El::IR(offset, offset + input_size), El::ALL);
+    }
+    else {
+      input_grad.AlignWith(output_grad);
+      input_grad.Resize(input_size, output_grad.Width());
+    }
+  }
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void concatenate_layer<TensorDataType,Layout,Device>::bp_compute_shared() {
+  const auto& output_grad = this->get_prev_error_signals();
+  std::unique_ptr<El::AbstractDistMatrix<TensorDataType>> output_grad_v(
+    output_grad.Construct(output_grad.Grid(), output_grad.Root()));
+  for (int j=0; j<this->get_num_parents(); ++j) {
+    auto& input_grad = this->get_error_signals(j);
+    if (input_grad.Viewing()) { continue; }
+    const auto offset = get_input_offset(j);
+    El::LockedView(*output_grad_v, output_grad,
+                   El::IR(offset, offset + input_grad.Height()), El::ALL);
+    El::Copy(*output_grad_v, input_grad);
+  }
+}
+
 template <typename TensorDataType, El::Device Device>
 void bp_setup_gradient_wrt_inputs_impl(
   concatenate_layer<TensorDataType,data_layout::MODEL_PARALLEL,Device>& l) {
@@ -396,6 +602,10 @@ void bp_setup_gradient_wrt_inputs_impl(
 
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 void concatenate_layer<TensorDataType,Layout,Device>::bp_setup_gradient_wrt_inputs(El::Int mini_batch_size) {
+  if (shares_storage()) {
+    bp_setup_gradient_wrt_inputs_shared();
+    return;
+  }
   bp_setup_gradient_wrt_inputs_impl(*this);
 }
 
@@ -418,6 +628,12 @@ void concatenate_layer<TensorDataType,Layout,Device>::bp_compute() {
     return;
   }
 
+  // Only copy gradients for parents that cannot take views
+  if (shares_storage()) {
+    bp_compute_shared();
+    return;
+  }
+
   // Perform slice
   if(m_concat_dim==num_dims-1 && this->is_subgraph_parallelism_enabled() &&  this->get_parallel_strategy().enable_subgraph==true)
   {
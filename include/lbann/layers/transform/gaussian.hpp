@@ -73,6 +73,7 @@ public:
   ///@}
 
   std::string get_type() const override { return "Gaussian"; }
+  bool supports_activation_recompute() const override { return false; }
   data_layout get_data_layout() const override { return T_layout; }
   El::Device get_device_allocation() const override { return Dev; }
 
@@ -33,6 +33,10 @@
 #include "lbann/models/model.hpp"
 #include "lbann/trainers/trainer.hpp"
 
+#include <algorithm>
+#include <memory>
+#include <numeric>
+
 namespace lbann {
 
 /** @brief Slice tensor along a specified dimension.
@@ -46,6 +50,14 @@ namespace lbann {
  *    \times D_{i-1}\times (s_i - s_{i-1}) \times D_{i+1} \times
  *    \cdots\times D_n @f$
  *  tensor.
+ *
+ *  If zero-copy mode is enabled and the slices occupy contiguous
+ *  rows of the input matrix, i.e. all dimensions before the slice
+ *  dimension are 1, the output tensors are views into the input
+ *  tensor and children write their gradients w.r.t. inputs directly
+ *  into views of the input gradient. Children that cannot operate on
+ *  strided tensors fall back to copies. Zero-copy mode is only
+ *  supported with the data-parallel layout.
  */
 template <typename TensorDataType,
           data_layout Layout = data_layout::DATA_PARALLEL,
@@ -70,9 +82,15 @@ public:
   std::string get_type() const override;
   data_layout get_data_layout() const override;
   El::Device get_device_allocation() const override;
+  bool bp_reads_inputs() const override { return false; }
+  bool bp_reads_outputs() const override { return false; }
 
   description get_description() const override;
 
+  bool view_shared_output_gradient_storage(const Layer& child,
+                                           BaseDistMat& child_input_grad,
+                                           El::Int mini_batch_size) override;
+
   void setup_slice_points(size_t slice_dim,
                           std::vector<size_t> slice_points) {
     m_slice_dim = slice_dim;
@@ -87,6 +105,11 @@ public:
     m_var_category = var_category;
   }
 
+  /** @brief Make output tensors views into the input tensor when
+   *  possible.
+   */
+  void set_zero_copy(bool zero_copy) { m_zero_copy = zero_copy; }
+
 protected:
 
   El::SyncInfo<Device> syncSubGridCommunication = El::SyncInfo<Device>();
@@ -97,6 +120,7 @@ protected:
   {}
 
   void setup_dims(DataReaderMetaData& dr_metadata) override;
+  void setup_data(size_t max_mini_batch_size) override;
 
   void fp_setup_outputs(El::Int mini_batch_size) override;
   void bp_setup_gradient_wrt_inputs(El::Int mini_batch_size) override;
@@ -104,6 +128,16 @@ protected:
   void bp_compute() override;
   void fp_compute_subgrid();
   void bp_compute_subgrid();
+  /** @brief Copy output gradients that were not written in place. */
+  void bp_compute_shared();
+
+  /** @brief Whether zero-copy mode applies to this layer.
+   *  @details Requires each output tensor to occupy contiguous rows
+   *  of the input matrix.
+   */
+  bool shares_storage();
+  /** @brief First row of an output tensor in the input matrix. */
+  El::Int get_output_offset(size_t child_index) const;
 
 private:
 
@@ -115,6 +149,8 @@ private:
   bool m_set_slice_points_from_data_reader;
   /** Category for retrieving slice points from data reader */
   slice_points_mode m_var_category;
+  /** Whether output tensors may be views into the input tensor */
+  bool m_zero_copy;
 
 #ifdef LBANN_HAS_GPU
   /** @brief Workspace buffer.
@@ -148,7 +184,8 @@ template <typename TensorDataType, data_layout Layout, El::Device Device>
 slice_layer<TensorDataType,Layout,Device>::slice_layer(lbann_comm *comm)
   : data_type_layer<TensorDataType>(comm),
   m_set_slice_points_from_data_reader(false),
-  m_var_category(slice_points_mode::NA) {
+  m_var_category(slice_points_mode::NA),
+  m_zero_copy(false) {
   this->m_expected_num_child_layers = -1; // No limit on children
 }
 
@@ -181,9 +218,87 @@ description slice_layer<TensorDataType,Layout,Device>::get_description() const {
     ss << (i > 0 ? ", " : "") << m_slice_points[i];
   }
   desc.add("Slice points", ss.str());
+  desc.add("Zero-copy", m_zero_copy);
   return desc;
 }
 
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+bool slice_layer<TensorDataType,Layout,Device>::shares_storage() {
+  if (!m_zero_copy
+      || Layout != data_layout::DATA_PARALLEL
+      || this->is_subgraph_parallelism_enabled()) {
+    return false;
+  }
+#ifdef LBANN_HAS_DISTCONV
+  if (this->distconv_enabled()) { return false; }
+#endif // LBANN_HAS_DISTCONV
+  const auto& input_dims = this->get_input_dims();
+  return std::accumulate(input_dims.begin(),
+                         input_dims.begin() + m_slice_dim,
+                         1,
+                         std::multiplies<int>()) == 1;
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+El::Int slice_layer<TensorDataType,Layout,Device>::get_output_offset(
+  size_t child_index) const {
+  const auto& input_dims = this->get_input_dims();
+  const El::Int inner_size = std::accumulate(input_dims.begin() + m_slice_dim + 1,
+                                             input_dims.end(),
+                                             1,
+                                             std::multiplies<int>());
+  return m_slice_points[child_index] * inner_size;
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+bool slice_layer<TensorDataType,Layout,Device>::view_shared_output_gradient_storage(
+  const Layer& child,
+  BaseDistMat& child_input_grad,
+  El::Int mini_batch_size) {
+  using MatrixType = El::DistMatrix<TensorDataType, El::STAR, El::VC, El::ELEMENT, Device>;
+  if (!shares_storage() || !child.supports_strided_tensors()) {
+    return false;
+  }
+
+  // Children that appear more than once need separate buffers
+  const auto& children = this->get_child_layers();
+  if (std::count(children.begin(), children.end(), &child) != 1) {
+    return false;
+  }
+
+  // Both matrices must have the same distribution
+  auto* child_input_grad_ptr = dynamic_cast<MatrixType*>(&child_input_grad);
+  auto* input_grad_ptr = dynamic_cast<MatrixType*>(&this->get_error_signals());
+  if (child_input_grad_ptr == nullptr || input_grad_ptr == nullptr
+      || &child_input_grad_ptr->Grid() != &input_grad_ptr->Grid()) {
+    return false;
+  }
+
+  // Allocate input gradient on first request of this step
+  // Note: Rows outside the slice points stay zero since no child
+  // writes to them.
+  auto& input_grad = *input_grad_ptr;
+  const El::Int input_size = this->get_input_size();
+  if (input_grad.Viewing()
+      || input_grad.Height() != input_size
+      || input_grad.Width() != mini_batch_size) {
+    input_grad.Empty(false);
+    input_grad.AlignWith(child_input_grad_ptr->DistData());
+    El::Zeros(input_grad, input_size, mini_batch_size);
+  }
+  else if (input_grad.RowAlign() != child_input_grad_ptr->RowAlign()
+           || input_grad.Root() != child_input_grad_ptr->Root()) {
+    return false;
+  }
+
+  // Child gradient is a view into the input gradient
+  const auto j = this->find_child_layer_index(child);
+  const auto offset = get_output_offset(j);
+  El::View(*child_input_grad_ptr, input_grad,
+           El::IR(offset, offset + this->get_output_size(j)), El::ALL);
+  return true;
+}
+
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 void slice_layer<TensorDataType,Layout,Device>::setup_dims(DataReaderMetaData& dr_metadata) {
   data_type_layer<TensorDataType>::setup_dims(dr_metadata);
@@ -252,6 +367,17 @@ void slice_layer<TensorDataType,Layout,Device>::setup_dims(DataReaderMetaData& d
 
 }
 
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void slice_layer<TensorDataType,Layout,Device>::setup_data(size_t max_mini_batch_size) {
+  data_type_layer<TensorDataType>::setup_data(max_mini_batch_size);
+
+  // Children hold views into the gradient w.r.t. input, so it must
+  // persist after back prop
+  if (shares_storage()) {
+    this->set_keep_error_signals(true);
+  }
+}
+
 template <typename TensorDataType, El::Device Device>
 void fp_setup_outputs_impl(
   slice_layer<TensorDataType,data_layout::MODEL_PARALLEL,Device>& l) {
@@ -287,6 +413,27 @@ void fp_setup_outputs_impl(
 
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 void slice_layer<TensorDataType,Layout,Device>::fp_setup_outputs(El::Int mini_batch_size) {
+
+  // View slices of input tensor for children that accept them
+  if (shares_storage()) {
+    const auto& input = this->get_prev_activations();
+    for (int j=0; j<this->get_num_children(); ++j) {
+      auto& output = this->get_activations(j);
+      const auto offset = get_output_offset(j);
+      const auto output_size = this->get_output_size(j);
+      output.Empty(false);
+      if (this->get_child_layer(j).supports_strided_tensors()) {
+        El::LockedView(output, input,
+                       El::IR(offset, offset + output_size), El::ALL);
+      }
+      else {
+        output.AlignWith(input);
+        output.Resize(output_size, input.Width());
+      }
+    }
+    return;
+  }
+
   fp_setup_outputs_impl(*this);
 }
 
@@ -337,6 +484,22 @@ void slice_layer<TensorDataType,Layout,Device>::fp_compute() {
   const auto& input_dims = this->get_input_dims();
   const size_t num_dims = input_dims.size();
 
+  // Only copy slices for children that cannot take views
+  if (shares_storage()) {
+    const auto& input = this->get_prev_activations();
+    std::unique_ptr<El::AbstractDistMatrix<TensorDataType>> input_v(
+      input.Construct(input.Grid(), input.Root()));
+    for (int j=0; j<this->get_num_children(); ++j) {
+      auto& output = this->get_activations(j);
+      if (output.Viewing()) { continue; }
+      const auto offset = get_output_offset(j);
+      El::LockedView(*input_v, input,
+                     El::IR(offset, offset + output.Height()), El::ALL);
+      El::Copy(*input_v, output);
+    }
+    return;
+  }
+
   if(this->m_slice_dim==num_dims-1 && this->get_parallel_strategy().enable_subgraph==true)
   {
     fp_compute_subgrid();
@@ -372,6 +535,19 @@ template <typename TensorDataType, data_layout Layout, El::Device Device>
 void slice_layer<TensorDataType,Layout,Device>::bp_setup_gradient_wrt_inputs(El::Int mini_batch_size) {
   const auto& output0_grad = this->get_prev_error_signals(0);
   auto& input_grad = this->get_error_signals();
+
+  // Keep storage that children have already written into
+  if (shares_storage()) {
+    if (input_grad.Viewing()
+        || input_grad.Height() != this->get_input_size()
+        || input_grad.Width() != output0_grad.Width()) {
+      input_grad.Empty(false);
+      input_grad.AlignWith(this->get_prev_activations());
+      El::Zeros(input_grad, this->get_input_size(), output0_grad.Width());
+    }
+    return;
+  }
+
   input_grad.Empty(false);
   input_grad.Resize(this->get_input_size(), output0_grad.Width());
   El::Zeros(input_grad, this->get_input_size(), output0_grad.Width());
@@ -381,6 +557,12 @@ void slice_layer<TensorDataType,Layout,Device>::bp_setup_gradient_wrt_inputs(El:
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 void slice_layer<TensorDataType,Layout,Device>::bp_compute() {
 
+  // Only copy gradients for children that did not write in place
+  if (shares_storage()) {
+    bp_compute_shared();
+    return;
+  }
+
   const auto& input_dims = this->get_input_dims();
   const size_t num_dims = input_dims.size();
 
@@ -395,6 +577,25 @@ void slice_layer<TensorDataType,Layout,Device>::bp_compute() {
   
 }
 
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void slice_layer<TensorDataType,Layout,Device>::bp_compute_shared() {
+  auto& input_grad = this->get_error_signals();
+  std::unique_ptr<El::AbstractDistMatrix<TensorDataType>> input_grad_v(
+    input_grad.Construct(input_grad.Grid(), input_grad.Root()));
+  for (int j=0; j<this->get_num_children(); ++j) {
+    const auto& output_grad = this->get_prev_error_signals(j);
+    const auto offset = get_output_offset(j);
+    El::View(*input_grad_v, input_grad,
+             El::IR(offset, offset + output_grad.Height()), El::ALL);
+    const bool in_place = (output_grad.LockedBuffer() == input_grad_v->LockedBuffer()
+                           && output_grad.LDim() == input_grad_v->LDim()
+                           && output_grad.RowAlign() == input_grad_v->RowAlign());
+    if (!in_place) {
+      El::Copy(output_grad, *input_grad_v);
+    }
+  }
+}
+
 #ifndef LBANN_SLICE_LAYER_INSTANTIATE
 #define PROTO_DEVICE(T, Device)             \
   extern template class slice_layer<        \
@@ -71,6 +71,8 @@ public:
   std::string get_type() const override { return "split"; }
   data_layout get_data_layout() const override { return T_layout; }
   El::Device get_device_allocation() const override { return Dev; }
+  bool bp_reads_inputs() const override { return false; }
+  bool bp_reads_outputs() const override { return false; }
 
 
 
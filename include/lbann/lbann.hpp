@@ -136,6 +136,7 @@
 #include "lbann/data_readers/data_reader_python.hpp"
 #ifdef LBANN_HAS_OPENCV
 #include "lbann/data_readers/data_reader_imagenet.hpp"
+#include "lbann/data_readers/data_reader_image_shards.hpp"
 #endif // LBANN_HAS_OPENCV
 #ifdef LBANN_HAS_CNPY
 #include "lbann/data_readers/data_reader_npz_ras_lipid.hpp"
@@ -193,6 +194,7 @@
 #include "lbann/callbacks/summary.hpp"
 #include "lbann/callbacks/sync_layers.hpp"
 #include "lbann/callbacks/timeline.hpp"
+#include "lbann/callbacks/trace.hpp"
 #include "lbann/callbacks/timer.hpp"
 #include "lbann/callbacks/variable_minibatch.hpp"
 
@@ -0,0 +1,106 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_MODELS_MEMORY_PLANNER_HPP_INCLUDED
+#define LBANN_MODELS_MEMORY_PLANNER_HPP_INCLUDED
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace lbann {
+
+/** @brief Liveness-based assignment of tensors to reusable buffers.
+ *
+ *  Each tensor is live over a closed interval of execution steps. Two
+ *  tensors may share a buffer if their intervals do not overlap. The
+ *  planner visits tensors from largest to smallest and places each
+ *  one in the smallest existing buffer that is free over its
+ *  interval, creating a new buffer if there is none. Since larger
+ *  tensors are placed first, a tensor always fits in any buffer it
+ *  is placed in.
+ *
+ *  The naive footprint, where every tensor has its own buffer, is
+ *  the sum of all tensor sizes. The live peak, the largest total size
+ *  of tensors that are live at the same step, is a lower bound for
+ *  any plan.
+ */
+class memory_planner {
+public:
+
+  /** @brief A tensor and its lifetime. */
+  struct tensor {
+    /** @brief Human-readable name */
+    std::string name;
+    /** @brief Size in bytes */
+    size_t bytes;
+    /** @brief First step where the tensor is live */
+    size_t first_use;
+    /** @brief Last step where the tensor is live */
+    size_t last_use;
+    /** @brief Index of assigned buffer, valid after plan() */
+    size_t buffer;
+  };
+
+  /** @brief Register a tensor.
+   *  @returns Tensor index.
+   */
+  size_t add_tensor(std::string name,
+                    size_t bytes,
+                    size_t first_use,
+                    size_t last_use);
+
+  /** @brief Assign tensors to buffers. */
+  void plan();
+
+  /** @brief Remove all tensors and buffers. */
+  void clear();
+
+  const std::vector<tensor>& get_tensors() const noexcept {
+    return m_tensors;
+  }
+  /** @brief Sizes of planned buffers in bytes. */
+  const std::vector<size_t>& get_buffer_sizes() const noexcept {
+    return m_buffer_sizes;
+  }
+
+  /** @brief Footprint if every tensor has its own buffer. */
+  size_t get_naive_bytes() const;
+  /** @brief Footprint of the planned buffers. */
+  size_t get_planned_bytes() const;
+  /** @brief Largest total size of simultaneously live tensors. */
+  size_t get_live_peak_bytes() const;
+
+private:
+
+  std::vector<tensor> m_tensors;
+  std::vector<size_t> m_buffer_sizes;
+
+};
+
+} // namespace lbann
+
+#endif // LBANN_MODELS_MEMORY_PLANNER_HPP_INCLUDED
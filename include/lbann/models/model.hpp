@@ -36,8 +36,10 @@
 #include "lbann/utils/graph.hpp"
 #include "lbann/io/file_io.hpp"
 #include "lbann/io/persist.hpp"
+#include "lbann/models/memory_planner.hpp"
 #include "lbann/metrics/metric.hpp"
 #include "lbann/objective_functions/objective_function.hpp"
+#include "lbann/optimizers/gradient_bucket_manager.hpp"
 #include "lbann/optimizers/optimizer.hpp"
 #include "lbann/proto/factories.hpp"
 #include "lbann/weights/weights.hpp"
@@ -50,6 +52,8 @@
 // `IncompleteType*`, which is annoying.
 #include <optimizers.pb.h>
 
+#include <set>
+#include <utility>
 #include <vector>
 #include <string>
 #include <unordered_map>
@@ -285,6 +289,135 @@ public:
   /** @brief Are background I/O activities enabled by the input layers */
   bool background_io_activity_allowed() { return m_background_io_allowed; }
 
+  /** @brief Pack gradient allreduces into fused buckets.
+   *
+   *  Must be called before setup.
+   *
+   *  @param bucket_size_bytes Target size of fusion buffers. Zero
+   *                           disables gradient bucketing.
+   *  @param order             Order in which gradients are packed.
+   */
+  void set_gradient_bucketing(size_t bucket_size_bytes,
+                              gradient_bucket_order order);
+
+  /** @brief Recompute activations during backward prop.
+   *
+   *  Must be called before setup. The layers are split into segments
+   *  that end at checkpoint layers, whose outputs are kept. During
+   *  training, the outputs of the other layers in a segment are
+   *  released once the segment's forward prop is done and are
+   *  recomputed just before the segment's backward prop. Outputs are
+   *  kept if they are consumed outside of their segment.
+   *
+   *  A checkpoint is placed at every @c every_n_layers -th layer in
+   *  execution order, at each of the @c checkpoint_layers, and at
+   *  every layer that does not support recomputation.
+   *
+   *  @param every_n_layers    Segment length. Zero disables the
+   *                           periodic checkpoints.
+   *  @param checkpoint_layers Names of additional checkpoint layers.
+   */
+  void set_activation_recompute(size_t every_n_layers,
+                                std::set<std::string> checkpoint_layers);
+
+  /** @brief Fuse chains of entry-wise operator layers at setup.
+   *
+   *  Must be called before setup. An operator layer whose only child
+   *  is an operator layer with no other parents absorbs the child's
+   *  operators, so the chain is applied in a single pass over
+   *  memory. The absorbed layers are removed from the model, so they
+   *  must not be referenced by name, e.g. by callbacks.
+   */
+  void set_elementwise_operator_fusion(bool fuse);
+
+  /** @brief Reuse activation and error signal storage across layers.
+   *
+   *  Must be called before setup. At setup, each layer output and
+   *  gradient w.r.t. input is given a lifetime from the step that
+   *  writes it to the last step that reads it, based on the layer
+   *  execution order and on which tensors each layer's backward prop
+   *  reads (see Layer::bp_reads_inputs). Tensors with disjoint
+   *  lifetimes share a buffer. Training and the other execution
+   *  modes, which have no backward prop, get separate plans drawing
+   *  on one pool of host buffers.
+   *
+   *  Only host-memory tensors that layers allocate themselves are
+   *  planned. Tensors are overwritten once their last reader is
+   *  done, so callbacks must not read intermediate activations or
+   *  error signals after the step that consumes them. Not supported
+   *  with activation recomputation or sub-graph parallelism.
+   */
+  void set_layer_memory_planning(bool plan);
+
+  /** @brief Buffer reuse plan for an execution mode.
+   *  @details Empty unless layer memory planning is enabled.
+   */
+  const memory_planner& get_layer_memory_plan(execution_mode mode) const;
+
+  /** @brief Train with 32-bit master weights and loss scaling.
+   *
+   *  Must be called before setup. Layers are expected to store
+   *  activations and gradients in 16-bit (see
+   *  proto::construct_layer_graph). Weights with another data type
+   *  than @c DataType are replaced at setup by @c DataType weights,
+   *  so the optimizers update 32-bit values and keep 32-bit state
+   *  while gradient contributions and allreduces stay in 16-bit.
+   *
+   *  Gradients are computed for the loss multiplied by the loss
+   *  scale. If any gradient entry overflows, the optimization step is
+   *  skipped for all weights and the loss scale is halved. With
+   *  dynamic loss scaling, the loss scale is doubled after
+   *  @c growth_interval consecutive steps without overflow.
+   *
+   *  @param initial_loss_scale Initial loss scaling factor.
+   *  @param growth_interval    Number of steps without overflow
+   *                            before the loss scale is doubled.
+   *  @param dynamic            Whether to adjust the loss scale.
+   */
+  void set_mixed_precision(EvalType initial_loss_scale,
+                           size_t growth_interval,
+                           bool dynamic);
+
+  /** @brief Whether training uses 32-bit master weights and loss
+   *  scaling.
+   */
+  bool is_mixed_precision() const noexcept { return m_mixed_precision; }
+  /** @brief Current loss scaling factor. */
+  EvalType get_loss_scale() const noexcept { return m_loss_scale; }
+  /** @brief Number of optimization steps skipped due to overflow. */
+  size_t get_num_skipped_steps() const noexcept {
+    return m_num_skipped_steps;
+  }
+
+  /** @brief Accumulate gradients over micro-batches.
+   *
+   *  The training algorithm runs forward and backward prop on @c
+   *  steps micro-batches before each optimization step. Gradients
+   *  are accumulated locally and allreduced once, and the
+   *  optimization step uses their mean. Batch normalization layers
+   *  compute statistics per micro-batch and adjust the decay of their
+   *  running statistics so that they advance at the same rate per
+   *  optimization step.
+   */
+  void set_gradient_accumulation_steps(size_t steps);
+  /** @brief Number of micro-batches per optimization step. */
+  size_t get_gradient_accumulation_steps() const noexcept {
+    return m_gradient_accumulation_steps;
+  }
+  /** @brief Whether to delay gradient allreduces until the
+   *  optimization step.
+   *  @details Set while accumulating all but the last micro-batch.
+   */
+  void set_defer_gradient_allreduces(bool defer);
+
+  /** @brief Gradient bucket manager.
+   *  @details Null if gradient bucketing is disabled or the model
+   *  has not been setup.
+   */
+  observer_ptr<gradient_bucket_manager> get_gradient_bucket_manager() const {
+    return m_gradient_buckets.get();
+  }
+
   void swap_layers(model& other);
   void swap_weights(model& other);
   void swap_metrics(model& other);
@@ -441,6 +574,71 @@ protected:
    *  weights are deleted.
    */
   virtual void setup_weights();
+  /** @brief Replace 16-bit weights with 32-bit master weights.
+   *
+   *  Called in setup_weights function when training with mixed
+   *  precision. Returns the replaced weights, paired with their
+   *  replacements, so that values can be copied once all weights
+   *  have been setup.
+   */
+  std::vector<std::pair<OwningWeightsPtr,OwningWeightsPtr>> setup_master_weights();
+  /** @brief Set up fused gradient allreduces.
+   *
+   *  Called in setup function, after weights are setup.
+   */
+  virtual void setup_gradient_bucketing();
+  /** @brief Merge chains of entry-wise operator layers.
+   *
+   *  Called in setup function, after the layer graph is checked and
+   *  before the execution order is determined.
+   */
+  virtual void fuse_elementwise_operator_layers();
+  /** @brief Set up segments for activation recomputation.
+   *
+   *  Called in setup function, after layers are setup. A layer is
+   *  never discarded while a kept layer's outputs view its outputs,
+   *  e.g. for identity, reshape or split layers.
+   */
+  virtual void setup_activation_recompute();
+  /** @brief Plan reuse of activation and error signal storage.
+   *
+   *  Called in setup function, after layers are setup.
+   */
+  virtual void setup_layer_memory_plan();
+
+  /** @brief Layer tensors assigned to buffers by a memory planner. */
+  struct layer_memory_plan {
+    /** @brief Layer tensor with a planned buffer. */
+    struct tensor_owner {
+      /** @brief Layer that writes the tensor. */
+      ViewingLayerPtr layer;
+      /** @brief Whether the tensor is a gradient w.r.t. input rather
+       *  than an output. */
+      bool error_signal;
+      /** @brief Parent index for error signals, child index for
+       *  outputs. */
+      int index;
+    };
+    memory_planner planner;
+    /** @brief Owner of each planned tensor, by tensor index. */
+    std::vector<tensor_owner> owners;
+  };
+  /** @brief Compute tensor lifetimes and assign buffers.
+   *
+   *  Forward prop of layer i is step i and backward prop is step
+   *  2n-1-i. An output lives until its child's forward prop, until
+   *  the backward prop of whichever of the two layers reads it, and
+   *  as long as any view of it, e.g. the outputs of an identity
+   *  child. Outputs of layers referenced by metrics or the objective
+   *  function live until the end of the step. If @c training is
+   *  false, backward prop is ignored and no error signals are
+   *  planned.
+   */
+  layer_memory_plan plan_layer_memory(bool training) const;
+  /** @brief Attach layer tensors to the buffers of a plan.
+   *  @details A null plan restores regular allocation.
+   */
+  void bind_layer_memory_plan(const layer_memory_plan* plan);
 
 public:
   // ===========================================
@@ -592,6 +790,78 @@ private:
   /** @brief Flag that allows input layers to fetch data in the background */
   bool m_background_io_allowed = true;
 
+  /** @brief Target size of gradient fusion buffers in bytes.
+   *  @details Zero disables gradient bucketing.
+   */
+  size_t m_gradient_bucket_size = 0;
+
+  /** @brief Order in which gradients are packed into fusion buffers. */
+  gradient_bucket_order m_gradient_bucket_order = gradient_bucket_order::backward;
+
+  /** @brief Fused allreduces for weights gradients. */
+  std::unique_ptr<gradient_bucket_manager> m_gradient_buckets;
+
+  /** @brief Whether to fuse chains of entry-wise operator layers. */
+  bool m_fuse_elementwise_operators = false;
+
+  /** @brief Whether to train with master weights and loss scaling. */
+  bool m_mixed_precision = false;
+  /** @brief Loss scaling factor for mixed-precision training. */
+  EvalType m_loss_scale = 1;
+  /** @brief Steps without overflow before the loss scale is doubled. */
+  size_t m_loss_scale_growth_interval = 2000;
+  /** @brief Whether the loss scale is adjusted during training. */
+  bool m_dynamic_loss_scale = true;
+  /** @brief Consecutive steps without gradient overflow. */
+  size_t m_num_finite_steps = 0;
+  /** @brief Optimization steps skipped due to gradient overflow. */
+  size_t m_num_skipped_steps = 0;
+
+  /** @brief Micro-batches per optimization step. */
+  size_t m_gradient_accumulation_steps = 1;
+  /** @brief Backward props since the gradients were cleared. */
+  size_t m_num_micro_batches = 0;
+
+  /** @brief Layers whose activations are recomputed in backprop. */
+  struct recompute_segment {
+    /** @brief Position of the checkpoint layer ending the segment. */
+    El::Int last;
+    /** @brief Positions of layers whose outputs are discarded. */
+    std::vector<El::Int> discarded;
+    /** @brief Positions of kept layers with discarded parents. */
+    std::vector<El::Int> reattached;
+    /** @brief Local bytes released by the last discard. */
+    size_t bytes_released = 0;
+    /** @brief Whether outputs are waiting to be recomputed. */
+    bool pending = false;
+    /** @brief Time spent recomputing since last summary. */
+    EvalType recompute_time = 0;
+  };
+
+  /** @brief Segment length for activation recomputation.
+   *  @details Zero disables periodic checkpoint layers.
+   */
+  size_t m_recompute_every_n_layers = 0;
+  /** @brief Names of user-specified checkpoint layers. */
+  std::set<std::string> m_recompute_checkpoint_layers;
+  /** @brief Segments for activation recomputation. */
+  std::vector<recompute_segment> m_recompute_segments;
+  /** @brief Segment index for each checkpoint layer position.
+   *  @details Negative for layers that do not end a segment.
+   */
+  std::vector<int> m_recompute_segment_index;
+
+  /** @brief Whether to reuse activation and error signal storage. */
+  bool m_plan_layer_memory = false;
+  /** @brief Buffer reuse plan for training. */
+  layer_memory_plan m_training_memory_plan;
+  /** @brief Buffer reuse plan for forward prop without backprop. */
+  layer_memory_plan m_inference_memory_plan;
+  /** @brief Host buffers shared by both plans. */
+  std::vector<std::vector<unsigned char>> m_layer_memory_pool;
+  /** @brief Plan whose buffers are attached to layer tensors. */
+  const layer_memory_plan* m_bound_memory_plan = nullptr;
+
   /** @brief Is the model setup
    *  @details Flag to indicate if the setup function has been called
    */
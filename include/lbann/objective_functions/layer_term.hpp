@@ -55,6 +55,8 @@ public:
 
   void compute_weight_regularization() override {};
 
+  void set_loss_scale(EvalType loss_scale) override;
+
   template <typename ArchiveT>
   void serialize(ArchiveT& ar);
 
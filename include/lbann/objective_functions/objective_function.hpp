@@ -83,6 +83,12 @@ class objective_function {
    */
   void compute_weight_regularization();
 
+  /** Set the loss scaling factor for all terms.
+   *  Gradients are multiplied by this factor, but the objective
+   *  function value is not.
+   */
+  void set_loss_scale(EvalType loss_scale);
+
   /** Clear all statistics. */
   void reset_statistics() {
     for (auto& stats : m_statistics) {
@@ -78,6 +78,15 @@ class objective_function_term {
    */
   virtual void compute_weight_regularization() = 0;
 
+  /** Set the loss scaling factor.
+   *  Gradients are multiplied by this factor in addition to the
+   *  scaling factor, but the objective function value is not. Used to
+   *  keep 16-bit gradients in range in mixed-precision training.
+   */
+  virtual void set_loss_scale(EvalType loss_scale) { m_loss_scale = loss_scale; }
+  /** Get the loss scaling factor. */
+  EvalType get_loss_scale() const noexcept { return m_loss_scale; }
+
   /** Get list of pointers to layers. */
   std::vector<ViewingLayerPtr> get_layer_pointers() const;
   /** Set list of pointers to layers. */
@@ -91,6 +100,8 @@ class objective_function_term {
 
   /** Scaling factor for objective function term. */
   EvalType m_scale_factor;
+  /** Loss scaling factor for gradients. */
+  EvalType m_loss_scale = EvalType(1);
 
   /** Layers used to compute objective function term. */
   std::vector<ViewingLayerPtr> m_layers;
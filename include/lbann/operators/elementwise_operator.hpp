@@ -31,6 +31,7 @@
 
 #include <cereal/cereal.hpp>
 
+#include <algorithm>
 #include <functional>
 #include <iterator>
 #include <type_traits>
@@ -132,6 +133,41 @@ public:
 
   ///@}
 
+  /** @name Fused compute interface */
+  ///@{
+
+  /** @brief Apply a chain of operators in one pass over memory.
+   *
+   *  Equivalent to applying each operator's forward operation in
+   *  turn. The first operator takes @c inputs and each subsequent
+   *  operator takes the previous operator's output as its only
+   *  input. The local data is processed in tiles of at most
+   *  @c chain_tile_size entries, so on CPU the intermediate results
+   *  stay in cache and only the inputs and the final output are
+   *  streamed through memory.
+   */
+  static void
+  fp_compute_chain(std::vector<ElementwiseOperator const*> const& ops,
+                   std::vector<ConstInputTensorType> const& inputs,
+                   OutputTensorType const& output);
+
+  /** @brief Back prop through a chain of operators in one pass.
+   *  @details The intermediate forward values are recomputed for
+   *           each tile, so only the inputs, the gradient w.r.t. the
+   *           final output and the gradients w.r.t. the inputs are
+   *           streamed through memory.
+   */
+  static void
+  bp_compute_chain(std::vector<ElementwiseOperator const*> const& ops,
+                   std::vector<ConstInputTensorType> const& inputs,
+                   ConstOutputTensorType const& gradient_wrt_output,
+                   std::vector<InputTensorType> const& gradient_wrt_inputs);
+
+  /** @brief Maximum number of entries in a tile of a fused chain. */
+  static constexpr El::Int chain_tile_size = 8192;
+
+  ///@}
+
 protected:
   /** @name Lifecycle management. */
   ///@{
@@ -159,5 +195,200 @@ protected:
 
 }; // class ElementwiseOperator
 
+namespace details {
+
+/** @brief Tiling of a local matrix for fused operator chains.
+ *  @details On GPU, the whole matrix is a single tile.
+ */
+struct ChainTiling
+{
+  ChainTiling(El::Int height, El::Int width, El::Int tile_size, bool tiled)
+    : m_height{height}, m_width{width}
+  {
+    if (!tiled || height * width <= tile_size) {
+      m_tile_height = height;
+      m_tile_width = width;
+    }
+    else {
+      m_tile_height = std::min(height, tile_size);
+      m_tile_width = std::max(El::Int(1), tile_size / m_tile_height);
+    }
+    m_num_row_tiles =
+      (m_tile_height > 0 ? (height + m_tile_height - 1) / m_tile_height : 0);
+    m_num_col_tiles =
+      (m_tile_width > 0 ? (width + m_tile_width - 1) / m_tile_width : 0);
+  }
+  El::Int num_tiles() const noexcept
+  {
+    return m_num_row_tiles * m_num_col_tiles;
+  }
+  El::IR rows(El::Int tile) const
+  {
+    auto const begin = (tile % m_num_row_tiles) * m_tile_height;
+    return El::IR(begin, std::min(begin + m_tile_height, m_height));
+  }
+  El::IR cols(El::Int tile) const
+  {
+    auto const begin = (tile / m_num_row_tiles) * m_tile_width;
+    return El::IR(begin, std::min(begin + m_tile_width, m_width));
+  }
+
+  El::Int m_height, m_width;
+  El::Int m_tile_height, m_tile_width;
+  El::Int m_num_row_tiles, m_num_col_tiles;
+};
+
+} // namespace details
+
+template <typename InputT, typename OutputT, El::Device D>
+void ElementwiseOperator<InputT, OutputT, D>::fp_compute_chain(
+  std::vector<ElementwiseOperator const*> const& ops,
+  std::vector<ConstInputTensorType> const& inputs,
+  OutputTensorType const& output)
+{
+  static_assert(std::is_same<InputT, OutputT>::value,
+                "Operator chains require matching input and output types");
+  using MatrixType = El::Matrix<OutputT, D>;
+  LBANN_ASSERT(!ops.empty());
+
+  auto& output_mat = output.local_data().data();
+  details::ChainTiling const tiling(output_mat.Height(),
+                                    output_mat.Width(),
+                                    chain_tile_size,
+                                    D == El::Device::CPU);
+  auto const num_inputs = inputs.size();
+
+  // Each thread works on a strided subset of the tiles, so the
+  // operators' internal loops run sequentially on cache-resident data
+  LBANN_OMP_PARALLEL_ARGS(if (D == El::Device::CPU))
+  {
+    auto const thread = omp_get_thread_num();
+    auto const num_threads = omp_get_num_threads();
+    MatrixType scratch[2];
+    for (auto& m : scratch) {
+      m.Resize(tiling.m_tile_height, tiling.m_tile_width);
+    }
+    std::vector<MatrixType> input_tiles(num_inputs);
+    MatrixType output_tile, temp_tiles[2];
+    for (El::Int tile = thread; tile < tiling.num_tiles();
+         tile += num_threads) {
+      auto const rows = tiling.rows(tile);
+      auto const cols = tiling.cols(tile);
+      std::vector<ConstLocalInputTensorType> tile_inputs;
+      tile_inputs.reserve(num_inputs);
+      for (size_t i = 0; i < num_inputs; ++i) {
+        El::LockedView(input_tiles[i],
+                       inputs[i].local_data().data(),
+                       rows,
+                       cols);
+        tile_inputs.emplace_back(input_tiles[i]);
+      }
+      El::View(output_tile, output_mat, rows, cols);
+      for (size_t i = 0; i < ops.size(); ++i) {
+        auto& out = (i + 1 == ops.size() ? output_tile : temp_tiles[i % 2]);
+        if (i + 1 < ops.size()) {
+          El::View(out,
+                   scratch[i % 2],
+                   El::IR(0, rows.end - rows.beg),
+                   El::IR(0, cols.end - cols.beg));
+        }
+        if (i == 0) {
+          ops[i]->fp_compute_local(tile_inputs, {out});
+        }
+        else {
+          ops[i]->fp_compute_local({temp_tiles[(i - 1) % 2]}, {out});
+        }
+      }
+    }
+  }
+}
+
+template <typename InputT, typename OutputT, El::Device D>
+void ElementwiseOperator<InputT, OutputT, D>::bp_compute_chain(
+  std::vector<ElementwiseOperator const*> const& ops,
+  std::vector<ConstInputTensorType> const& inputs,
+  ConstOutputTensorType const& gradient_wrt_output,
+  std::vector<InputTensorType> const& gradient_wrt_inputs)
+{
+  static_assert(std::is_same<InputT, OutputT>::value,
+                "Operator chains require matching input and output types");
+  using MatrixType = El::Matrix<OutputT, D>;
+  LBANN_ASSERT(!ops.empty());
+  LBANN_ASSERT(inputs.size() == gradient_wrt_inputs.size());
+
+  auto const& grad_out_mat = gradient_wrt_output.local_data().data();
+  details::ChainTiling const tiling(grad_out_mat.Height(),
+                                    grad_out_mat.Width(),
+                                    chain_tile_size,
+                                    D == El::Device::CPU);
+  auto const num_inputs = inputs.size();
+  auto const num_ops = ops.size();
+
+  LBANN_OMP_PARALLEL_ARGS(if (D == El::Device::CPU))
+  {
+    auto const thread = omp_get_thread_num();
+    auto const num_threads = omp_get_num_threads();
+
+    // Scratch for recomputed intermediate values and for two
+    // ping-ponged intermediate gradients
+    std::vector<MatrixType> scratch(num_ops + 1);
+    for (auto& m : scratch) {
+      m.Resize(tiling.m_tile_height, tiling.m_tile_width);
+    }
+    std::vector<MatrixType> value_tiles(num_ops + 1);
+    std::vector<MatrixType> input_tiles(num_inputs), grad_in_tiles(num_inputs);
+    MatrixType grad_out_tile;
+    for (El::Int tile = thread; tile < tiling.num_tiles();
+         tile += num_threads) {
+      auto const rows = tiling.rows(tile);
+      auto const cols = tiling.cols(tile);
+      auto const local_rows = El::IR(0, rows.end - rows.beg);
+      auto const local_cols = El::IR(0, cols.end - cols.beg);
+      std::vector<ConstLocalInputTensorType> tile_inputs;
+      std::vector<LocalInputTensorType> tile_grad_inputs;
+      tile_inputs.reserve(num_inputs);
+      tile_grad_inputs.reserve(num_inputs);
+      for (size_t i = 0; i < num_inputs; ++i) {
+        El::LockedView(input_tiles[i],
+                       inputs[i].local_data().data(),
+                       rows,
+                       cols);
+        El::View(grad_in_tiles[i],
+                 gradient_wrt_inputs[i].local_data().data(),
+                 rows,
+                 cols);
+        tile_inputs.emplace_back(input_tiles[i]);
+        tile_grad_inputs.emplace_back(grad_in_tiles[i]);
+      }
+
+      // Recompute the inputs to operators 1, ..., n-1
+      for (size_t i = 0; i + 1 < num_ops; ++i) {
+        El::View(value_tiles[i], scratch[i], local_rows, local_cols);
+        if (i == 0) {
+          ops[i]->fp_compute_local(tile_inputs, {value_tiles[i]});
+        }
+        else {
+          ops[i]->fp_compute_local({value_tiles[i - 1]}, {value_tiles[i]});
+        }
+      }
+
+      // Back prop from the last operator to the first
+      El::LockedView(grad_out_tile, grad_out_mat, rows, cols);
+      MatrixType grad_tiles[2];
+      MatrixType const* grad = &grad_out_tile;
+      for (size_t i = num_ops - 1; i > 0; --i) {
+        auto& next_grad = grad_tiles[i % 2];
+        El::View(next_grad,
+                 scratch[num_ops - 1 + i % 2],
+                 local_rows,
+                 local_cols);
+        ops[i]->bp_compute_local({value_tiles[i - 1]}, {*grad}, {next_grad});
+        grad = &next_grad;
+      }
+      ops[0]->bp_compute_local(tile_inputs, {*grad}, tile_grad_inputs);
+    }
+  }
+}
+
 } // namespace lbann
 #endif // LBANN_OPERATORS_ELEMENTWISE_OPERATOR_HPP_INCLUDED
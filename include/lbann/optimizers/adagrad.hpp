@@ -59,6 +59,9 @@ public:
   /** @brief The concrete weights type used by this object. */
   using WeightsType = data_type_weights<TensorDataType>;
 
+  /** @brief The sparse gradient type used by this object. */
+  using SparseGradientType = sparse_gradient<TensorDataType>;
+
   ///@}
 
 public:
@@ -75,6 +78,7 @@ public:
   std::string get_type() const override { return "AdaGrad"; }
   /** Human-readable description. */
   description get_description() const override;
+  void write_proto(lbann_data::Optimizer* proto) const override;
 
   using OptimizerType::setup;
   void setup(WeightsType* w = nullptr) override;
@@ -96,6 +100,15 @@ protected:
   void step_compute(AbsDistMatrixType& values,
                     const AbsDistMatrixType& gradient) override;
 
+  /** @brief Computation for an optimization step with a sparse
+   *  gradient.
+   *  @details Only the nonzero columns are updated. Since columns
+   *  with zero gradient are unchanged by the dense step, this matches
+   *  the dense step exactly.
+   */
+  void step_compute_sparse(AbsDistMatrixType& values,
+                           const SparseGradientType& gradient) override;
+
 private:
 
   /** Small factor to avoid division by zero. */
@@ -61,6 +61,9 @@ public:
   /** @brief The concrete weights type used by this object. */
   using WeightsType = data_type_weights<TensorDataType>;
 
+  /** @brief The sparse gradient type used by this object. */
+  using SparseGradientType = sparse_gradient<TensorDataType>;
+
   ///@}
 
 public:
@@ -88,6 +91,7 @@ public:
   std::string get_type() const override { return "Adam"; }
   /** Human-readable description. */
   description get_description() const override;
+  void write_proto(lbann_data::Optimizer* proto) const override;
 
   ///@}
 
@@ -162,6 +166,16 @@ protected:
   void step_compute(AbsDistMatrixType& values,
                     const AbsDistMatrixType& gradient) override;
 
+  /** @brief Computation for an optimization step with a sparse
+   *  gradient.
+   *  @details Only the nonzero columns are updated. The moment
+   *  estimates of a column only decay in steps where it has a nonzero
+   *  gradient ("lazy" Adam). The bias correction still advances every
+   *  step.
+   */
+  void step_compute_sparse(AbsDistMatrixType& values,
+                           const SparseGradientType& gradient) override;
+
 private:
 
   /** Update factor for first moment estimate. */
@@ -28,6 +28,7 @@
 #define LBANN_OPTIMIZERS_DATA_TYPE_OPTIMIZER_HPP_INCLUDED
 
 #include "lbann/optimizers/optimizer.hpp"
+#include "lbann/optimizers/sparse_gradient.hpp"
 
 // Forward declarations
 namespace cereal {
@@ -62,6 +63,9 @@ public:
   /** @brief The concrete weights type used by this object. */
   using WeightsType = data_type_weights<TensorDataType>;
 
+  /** @brief The sparse gradient type used by this object. */
+  using SparseGradientType = sparse_gradient<TensorDataType>;
+
   ///@}
 
 public:
@@ -99,8 +103,27 @@ public:
    */
   AbsDistMatrixType& get_gradient();
 
+  /** @brief Get the sparse gradient buffer.
+   *
+   *  Objects that only touch a few columns of the weights matrix
+   *  (e.g. embedding tables) can add their contributions here instead
+   *  of to a dense gradient buffer. Contributions are summed over the
+   *  redundant communicator of the weights matrix, like dense
+   *  contributions with @c allreduce_needed set. Calling this marks
+   *  the sparse gradient as contributed, so it must be called on
+   *  every rank even if the local contribution is empty.
+   *
+   *  If only sparse contributions are made, the optimization step
+   *  exchanges the nonzero columns with an allgather and calls
+   *  step_compute_sparse. Otherwise, the sparse contributions are
+   *  added to the dense gradient when it is accessed.
+   */
+  SparseGradientType& get_sparse_gradient_buffer();
+
   /** @brief Optimization step. */
   void step() override;
+
+  bool gradient_is_finite() override;
   ///@}
 
   /** @brief Access the scaling factor for optimization step sizes. */
@@ -128,6 +151,19 @@ protected:
   virtual void step_compute(AbsDistMatrixType& values,
                             const AbsDistMatrixType& gradient) = 0;
 
+  /** @brief Computation for an optimization step with a sparse
+   *  gradient.
+   *
+   *  @c gradient has been summed over the redundant communicator of
+   *  @c values. The default implementation converts it to a dense
+   *  matrix and calls step_compute. Optimizers that only need to
+   *  touch the nonzero columns should override this.
+   */
+  virtual void step_compute_sparse(AbsDistMatrixType& values,
+                                   const SparseGradientType& gradient);
+
+  void clear_sparse_gradient() override { m_sparse_gradient.clear(); }
+
   /** @brief Get the info needed to construct a new gradient matrix.
    *  @return Tuple of height, width, and DistData.
    */
@@ -148,6 +184,9 @@ private:
    */
   std::unique_ptr<AbsDistMatrixType> m_gradient_v;
 
+  /** @brief Sparse contributions to the objective function gradient. */
+  SparseGradientType m_sparse_gradient;
+
   /** @brief Communication request object for gradient allreduce.
    *
    *  Used to synchronize non-blocking allreduce.
@@ -33,6 +33,10 @@
 
 #include "lbann/optimizers/data_type_optimizer.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
 namespace lbann {
 
 template <typename TensorDataType>
@@ -48,6 +52,7 @@ data_type_optimizer<TensorDataType>::data_type_optimizer(
     m_weights(other.m_weights),
     m_gradient(other.m_gradient ? other.m_gradient->Copy() : nullptr),
     m_gradient_v(other.m_gradient_v ? other.m_gradient_v->Copy() : nullptr),
+    m_sparse_gradient(other.m_sparse_gradient),
     m_learning_rate(other.m_learning_rate)
 {}
 
@@ -60,6 +65,7 @@ data_type_optimizer<TensorDataType>::operator=(
   m_weights = other.m_weights;
   m_gradient.reset(other.m_gradient ? other.m_gradient->Copy() : nullptr);
   m_gradient_v.reset(other.m_gradient_v ? other.m_gradient_v->Copy() : nullptr);
+  m_sparse_gradient = other.m_sparse_gradient;
   m_learning_rate = other.m_learning_rate;
   return *this;
 }
@@ -100,9 +106,20 @@ auto data_type_optimizer<TensorDataType>::get_gradient() -> AbsDistMatrixType&
     LBANN_ERROR("attempted to access gradient before it is set up");
   }
 
+  // Add sparse contributions to dense gradient
+  if (m_sparse_gradient.has_contributions()) {
+    TensorDataType buf_scale, in_scale;
+    auto& buffer = this->get_gradient_buffer(buf_scale, in_scale, true);
+    El::Scale(buf_scale, buffer);
+    m_sparse_gradient.add_to(buffer, in_scale);
+    m_sparse_gradient.clear();
+  }
+
   // Make sure gradient values are ready
+  const auto start_time = get_time();
   this->start_gradient_allreduce();
   this->finish_gradient_allreduce();
+  this->inc_allreduce_wait_time(get_time() - start_time);
 
   // Gather all gradients to the master precision
   this->accumulate_all_gradient_contributions(*m_gradient);
@@ -147,6 +164,7 @@ void data_type_optimizer<TensorDataType>::setup_base(WeightsType* w)
   m_gradient.reset(AbsDistMatrixType::Instantiate(values.DistData()));
   m_gradient->AlignWith(values);
   m_gradient->Resize(height, width);
+  m_sparse_gradient.setup(height, width);
   m_gradient_v.reset(AbsDistMatrixType::Instantiate(values.DistData()));
   m_gradient_v->AlignWith(values);
 #ifdef HYDROGEN_HAVE_CUB
@@ -176,10 +194,109 @@ void data_type_optimizer<TensorDataType>::step()
     LBANN_ERROR("attempted to perform optimization step without weights");
   }
   const auto start_time = get_time();
-  this->step_compute(m_weights->get_values(), this->get_gradient());
+  auto& values = m_weights->get_values();
+
+  // Only sparse contributions have been made, so try exchanging the
+  // nonzero columns. Fall back to a dense allreduce if the ranks
+  // contribute more columns than half the width of the weights.
+  if (m_sparse_gradient.has_contributions()
+      && !this->has_gradient_contributions()) {
+    const auto exchange_start = get_time();
+    const bool exchanged = m_sparse_gradient.allgather(
+      values.RedundantComm(),
+      values.Width() / 2);
+    this->inc_allreduce_wait_time(get_time() - exchange_start);
+    if (exchanged) {
+      if (this->get_loss_scale() != EvalType(1)) {
+        m_sparse_gradient.scale(
+          El::To<TensorDataType>(EvalType(1) / this->get_loss_scale()));
+      }
+      this->step_compute_sparse(values, m_sparse_gradient);
+      m_sparse_gradient.clear();
+      this->inc_step_time(get_time() - start_time);
+      return;
+    }
+  }
+
+  // Remove loss scaling from gradient
+  // Note: The gradient may be a view into a gradient contribution, in
+  // which case it is copied before scaling.
+  auto& gradient = this->get_gradient();
+  if (this->get_loss_scale() == EvalType(1)) {
+    this->step_compute(values, gradient);
+  }
+  else {
+    const auto scale = El::To<TensorDataType>(EvalType(1)
+                                              / this->get_loss_scale());
+    if (gradient.Locked()) {
+      El::Copy(gradient, *m_gradient_v);
+      El::Scale(scale, *m_gradient_v);
+      this->step_compute(values, *m_gradient_v);
+    }
+    else {
+      El::Scale(scale, gradient);
+      this->step_compute(values, gradient);
+    }
+  }
   this->inc_step_time(get_time() - start_time);
 }
 
+template <typename TensorDataType>
+bool data_type_optimizer<TensorDataType>::gradient_is_finite()
+{
+  const auto is_finite = [](const TensorDataType& x) {
+    if constexpr (std::is_floating_point_v<TensorDataType>) {
+      return std::isfinite(x);
+    }
+    else {
+      return std::isfinite(static_cast<float>(x));
+    }
+  };
+
+  // Only sparse contributions have been made, so check the local
+  // contributions before they are exchanged
+  if (m_sparse_gradient.has_contributions()
+      && !this->has_gradient_contributions()) {
+    const auto& sparse_values = m_sparse_gradient.values();
+    return std::all_of(sparse_values.begin(), sparse_values.end(), is_finite);
+  }
+
+  // Check local entries of dense gradient
+  using ProxyType =
+    El::AbstractDistMatrixReadDeviceProxy<TensorDataType, El::Device::CPU>;
+  ProxyType proxy(this->get_gradient());
+  const auto& local_gradient = proxy.GetLocked().LockedMatrix();
+  const El::Int local_height = local_gradient.Height();
+  const El::Int local_width = local_gradient.Width();
+  for (El::Int col = 0; col < local_width; ++col) {
+    for (El::Int row = 0; row < local_height; ++row) {
+      if (!is_finite(local_gradient(row, col))) { return false; }
+    }
+  }
+  return true;
+}
+
+template <typename TensorDataType>
+auto data_type_optimizer<TensorDataType>::get_sparse_gradient_buffer()
+  -> SparseGradientType&
+{
+  m_sparse_gradient.set_has_contributions();
+  return m_sparse_gradient;
+}
+
+template <typename TensorDataType>
+void data_type_optimizer<TensorDataType>::step_compute_sparse(
+  AbsDistMatrixType& values,
+  const SparseGradientType& gradient)
+{
+  std::unique_ptr<AbsDistMatrixType> dense_gradient(
+    AbsDistMatrixType::Instantiate(values.DistData()));
+  dense_gradient->AlignWith(values);
+  El::Zeros(*dense_gradient, values.Height(), values.Width());
+  gradient.add_to(*dense_gradient);
+  this->step_compute(values, *dense_gradient);
+}
+
 template <typename TensorDataType>
 std::tuple<El::Int, El::Int, El::DistData>
 data_type_optimizer<TensorDataType>::get_matrix_info() const
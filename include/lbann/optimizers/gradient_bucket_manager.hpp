@@ -0,0 +1,400 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_OPTIMIZERS_GRADIENT_BUCKET_MANAGER_HPP_INCLUDED
+#define LBANN_OPTIMIZERS_GRADIENT_BUCKET_MANAGER_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+#include "lbann/comm.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/memory.hpp"
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+namespace lbann {
+
+/** @brief Order in which gradients are packed into fusion buffers. */
+enum class gradient_bucket_order {
+  /** @brief Pack gradients as soon as back prop produces them.
+   *  @details Buckets are launched as soon as they fill, so
+   *  communication overlaps with the rest of back prop.
+   */
+  backward,
+  /** @brief Pack gradients in reverse order of the model's weights.
+   *  @details Packing is deferred to the end of back prop. Bucket
+   *  composition is independent of the order in which layers finish
+   *  back prop.
+   */
+  reverse_weights,
+};
+
+/** @brief Human-readable string for gradient bucket order. */
+std::string to_string(gradient_bucket_order order);
+
+/** @brief Parse gradient bucket order from string.
+ *  @details An empty string is interpreted as
+ *  @c gradient_bucket_order::backward.
+ */
+gradient_bucket_order gradient_bucket_order_from_string(std::string const& str);
+
+/** @brief Fusion buffer for gradient allreduces.
+ *
+ *  Gradients in the same bucket have the same data type, are stored
+ *  on the same device, and are allreduced over the same redundant
+ *  communicator. Their local data is packed contiguously so that a
+ *  single allreduce can be performed for the whole bucket.
+ */
+class gradient_bucket {
+public:
+  virtual ~gradient_bucket() = default;
+
+  /** @brief Number of gradients packed into bucket. */
+  virtual size_t get_num_gradients() const noexcept = 0;
+  /** @brief Size of packed local data in bytes. */
+  virtual size_t get_size_bytes() const noexcept = 0;
+
+  /** @brief Pack gradients and launch non-blocking allreduce. */
+  virtual void launch(lbann_comm& comm) = 0;
+  /** @brief Wait for allreduce and unpack into gradients.
+   *  @details Does nothing if the allreduce has already been
+   *  synchronized.
+   */
+  virtual void complete(lbann_comm& comm) = 0;
+  /** @brief Remove all gradients from bucket.
+   *  @details The fusion buffer is kept so it can be reused.
+   */
+  virtual void reset() = 0;
+
+  bool is_launched() const noexcept { return m_launched; }
+  bool is_complete() const noexcept { return m_complete; }
+
+protected:
+  bool m_launched = false;
+  bool m_complete = false;
+};
+
+template <typename TensorDataType, El::Device Device>
+class gradient_bucket_impl : public gradient_bucket {
+public:
+  using AbsDistMatrixType = El::AbstractDistMatrix<TensorDataType>;
+  using LocalMatrixType = El::Matrix<TensorDataType, Device>;
+
+public:
+  gradient_bucket_impl(El::mpi::Comm const& redundant_comm)
+    : m_redundant_comm(&redundant_comm)
+  {}
+
+  size_t get_num_gradients() const noexcept override {
+    return m_gradients.size();
+  }
+  size_t get_size_bytes() const noexcept override {
+    return m_size * sizeof(TensorDataType);
+  }
+
+  void add(AbsDistMatrixType& gradient) {
+    if (m_launched) {
+      LBANN_ERROR("attempted to add gradient to a gradient bucket "
+                  "that has already been launched");
+    }
+    m_gradients.push_back(&gradient);
+    m_size += gradient.LocalHeight() * gradient.LocalWidth();
+  }
+
+  void launch(lbann_comm& comm) override {
+    if (m_launched) { return; }
+    if (m_buffer.Height() < static_cast<El::Int>(m_size)) {
+      m_buffer.Resize(m_size, 1);
+    }
+    El::Int offset = 0;
+    for (auto* grad : m_gradients) {
+      auto& local_grad = static_cast<LocalMatrixType&>(grad->Matrix());
+      const auto height = local_grad.Height();
+      const auto width = local_grad.Width();
+      if (height > 0 && width > 0) {
+        LocalMatrixType packed;
+        packed.Attach(height, width, m_buffer.Buffer(offset, 0), height);
+        El::Copy(local_grad, packed);
+      }
+      offset += height * width;
+    }
+    El::View(m_buffer_v, m_buffer, El::IR(0, m_size), El::ALL);
+    comm.nb_allreduce(static_cast<El::AbstractMatrix<TensorDataType>&>(m_buffer_v),
+                      *m_redundant_comm,
+                      m_allreduce_req);
+    m_launched = true;
+  }
+
+  void complete(lbann_comm& comm) override {
+    if (m_complete) { return; }
+    if (!m_launched) {
+      LBANN_ERROR("attempted to complete a gradient bucket "
+                  "before launching its allreduce");
+    }
+    comm.wait(m_allreduce_req);
+    El::Int offset = 0;
+    for (auto* grad : m_gradients) {
+      auto& local_grad = static_cast<LocalMatrixType&>(grad->Matrix());
+      const auto height = local_grad.Height();
+      const auto width = local_grad.Width();
+      if (height > 0 && width > 0) {
+        LocalMatrixType packed;
+        packed.LockedAttach(height, width, m_buffer.LockedBuffer(offset, 0), height);
+        El::Copy(packed, local_grad);
+      }
+      offset += height * width;
+    }
+    m_complete = true;
+  }
+
+  void reset() override {
+    m_gradients.clear();
+    m_size = 0;
+    m_launched = false;
+    m_complete = false;
+  }
+
+private:
+  /** @brief Communicator over which gradients are redundant. */
+  El::mpi::Comm const* m_redundant_comm;
+  /** @brief Gradients packed into the fusion buffer. */
+  std::vector<AbsDistMatrixType*> m_gradients;
+  /** @brief Number of packed entries. */
+  size_t m_size = 0;
+  /** @brief Fusion buffer.
+   *  @details Only grows, so memory is reused across steps.
+   */
+  LocalMatrixType m_buffer;
+  /** @brief View into the packed part of the fusion buffer. */
+  LocalMatrixType m_buffer_v;
+  /** @brief Communication request object for the allreduce. */
+  Al::request m_allreduce_req;
+};
+
+/** @brief Gradient bucketing for fused allreduces.
+ *
+ *  Rather than launching an allreduce per weights gradient,
+ *  optimizers hand gradients to this object, which packs gradients of
+ *  matching data type, device, and redundant communicator into
+ *  fusion buffers of a configurable size. One non-blocking allreduce
+ *  is launched per bucket once it reaches the target size. Remaining
+ *  partially-filled buckets are launched with @c flush at the end of
+ *  back prop. Results are unpacked into the gradients when an
+ *  optimizer accesses its gradient before the optimization step.
+ *
+ *  This reduces the number of latency-bound collectives for models
+ *  with many small weights (e.g. biases and batch norm parameters).
+ */
+class gradient_bucket_manager {
+public:
+
+  /** @param comm              LBANN communicator.
+   *  @param bucket_size_bytes Target size of fusion buffers. A bucket
+   *                           is launched once it reaches this size.
+   *  @param order             Order in which gradients are packed.
+   */
+  gradient_bucket_manager(lbann_comm& comm,
+                          size_t bucket_size_bytes,
+                          gradient_bucket_order order);
+  ~gradient_bucket_manager();
+
+  gradient_bucket_manager(const gradient_bucket_manager&) = delete;
+  gradient_bucket_manager& operator=(const gradient_bucket_manager&) = delete;
+
+  size_t get_bucket_size() const noexcept { return m_bucket_size; }
+  gradient_bucket_order get_order() const noexcept { return m_order; }
+
+  /** @brief Set the packing order of gradient owners.
+   *  @details Only used with @c gradient_bucket_order::reverse_weights.
+   *  Gradients from owners that are not in the list are packed last.
+   */
+  void set_owner_order(std::vector<const void*> owners);
+
+  /** @brief Hand a gradient over for allreduce.
+   *
+   *  @param gradient Gradient matrix. Must not be accessed until
+   *                  @c wait has been called on it.
+   *  @param owner    Object that owns the gradient (typically an
+   *                  optimizer). Used to determine packing order.
+   */
+  template <typename TensorDataType>
+  void enqueue(El::AbstractDistMatrix<TensorDataType>& gradient,
+               const void* owner);
+
+  /** @brief Wait until the allreduce on a gradient has completed.
+   *  @details Any pending buckets are launched if needed.
+   */
+  void wait(const El::BaseDistMatrix& gradient);
+
+  /** @brief Launch allreduces for all pending gradients. */
+  void flush();
+
+  /** @brief Prepare for a new optimization step.
+   *  @details Outstanding allreduces are synchronized and the step
+   *  statistics are recorded.
+   */
+  void reset();
+
+  /** @name Statistics */
+  ///@{
+
+  /** @brief Number of allreduces launched in the last step. */
+  size_t get_num_allreduces() const noexcept { return m_last_num_allreduces; }
+  /** @brief Number of gradients allreduced in the last step.
+   *  @details This is the number of allreduces that would have
+   *  been launched without bucketing.
+   */
+  size_t get_num_gradients() const noexcept { return m_last_num_gradients; }
+  /** @brief Number of bytes allreduced in the last step. */
+  size_t get_num_bytes() const noexcept { return m_last_num_bytes; }
+
+  ///@}
+
+private:
+
+  /** @brief Gradient buckets are grouped by data type, device, and
+   *  redundant communicator.
+   */
+  using bucket_key = std::tuple<std::type_index, El::Device, MPI_Comm>;
+
+  /** @brief Pool of buckets with a matching key. */
+  struct bucket_pool {
+    /** @brief Allocated buckets. Reused across steps. */
+    std::vector<std::unique_ptr<gradient_bucket>> buckets;
+    /** @brief Number of buckets in use in the current step. */
+    size_t num_used = 0;
+    /** @brief Bucket that is currently being filled. */
+    gradient_bucket* open = nullptr;
+  };
+
+  /** @brief Gradient that has not yet been packed into a bucket. */
+  struct pending_gradient {
+    const El::BaseDistMatrix* gradient;
+    size_t rank;
+    std::function<void()> assign;
+  };
+
+  template <typename TensorDataType, El::Device Device>
+  void assign(El::AbstractDistMatrix<TensorDataType>& gradient);
+
+  void launch(gradient_bucket& bucket);
+
+  lbann_comm* m_comm;
+  size_t m_bucket_size;
+  gradient_bucket_order m_order;
+
+  std::map<bucket_key, bucket_pool> m_pools;
+  std::unordered_map<const void*, size_t> m_owner_ranks;
+  std::vector<pending_gradient> m_pending;
+  /** @brief Bucket assigned to each gradient in the current step. */
+  std::unordered_map<const El::BaseDistMatrix*, gradient_bucket*> m_assignments;
+
+  size_t m_num_allreduces = 0;
+  size_t m_num_gradients = 0;
+  size_t m_num_bytes = 0;
+  size_t m_last_num_allreduces = 0;
+  size_t m_last_num_gradients = 0;
+  size_t m_last_num_bytes = 0;
+
+};
+
+template <typename TensorDataType>
+void gradient_bucket_manager::enqueue(
+  El::AbstractDistMatrix<TensorDataType>& gradient,
+  const void* owner)
+{
+  auto assign_func = [this, &gradient]() {
+    switch (gradient.GetLocalDevice()) {
+    case El::Device::CPU:
+      this->assign<TensorDataType, El::Device::CPU>(gradient);
+      break;
+#ifdef LBANN_HAS_GPU
+    case El::Device::GPU:
+      this->assign<TensorDataType, El::Device::GPU>(gradient);
+      break;
+#endif // LBANN_HAS_GPU
+    default:
+      LBANN_ERROR("invalid device for gradient bucketing");
+    }
+  };
+  switch (m_order) {
+  case gradient_bucket_order::backward:
+    assign_func();
+    break;
+  case gradient_bucket_order::reverse_weights:
+    {
+      auto it = m_owner_ranks.find(owner);
+      const size_t rank = (it != m_owner_ranks.end()
+                           ? it->second
+                           : m_owner_ranks.size());
+      m_pending.push_back({&gradient, rank, std::move(assign_func)});
+    }
+    break;
+  default:
+    LBANN_ERROR("invalid gradient bucket order");
+  }
+}
+
+template <typename TensorDataType, El::Device Device>
+void gradient_bucket_manager::assign(
+  El::AbstractDistMatrix<TensorDataType>& gradient)
+{
+  using BucketType = gradient_bucket_impl<TensorDataType, Device>;
+
+  // Get bucket that is currently being filled
+  const auto& redundant_comm = gradient.RedundantComm();
+  bucket_key key(std::type_index(typeid(TensorDataType)),
+                 Device,
+                 redundant_comm.GetMPIComm());
+  auto& pool = m_pools[key];
+  if (pool.open == nullptr) {
+    if (pool.num_used >= pool.buckets.size()) {
+      pool.buckets.emplace_back(make_unique<BucketType>(redundant_comm));
+    }
+    pool.open = pool.buckets[pool.num_used].get();
+    ++pool.num_used;
+  }
+
+  // Add gradient to bucket and launch if it is full
+  auto& bucket = static_cast<BucketType&>(*pool.open);
+  bucket.add(gradient);
+  m_assignments[&gradient] = &bucket;
+  ++m_num_gradients;
+  if (bucket.get_size_bytes() >= m_bucket_size) {
+    pool.open = nullptr;
+    launch(bucket);
+  }
+}
+
+} // namespace lbann
+
+#endif // LBANN_OPTIMIZERS_GRADIENT_BUCKET_MANAGER_HPP_INCLUDED
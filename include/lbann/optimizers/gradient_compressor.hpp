@@ -0,0 +1,198 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_OPTIMIZERS_GRADIENT_COMPRESSOR_HPP_INCLUDED
+#define LBANN_OPTIMIZERS_GRADIENT_COMPRESSOR_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+#include "lbann/comm.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/timer.hpp"
+
+#include <memory>
+#include <string>
+
+namespace lbann {
+
+/** @brief Lossy compression scheme for gradient allreduces. */
+enum class gradient_compression_type {
+  /** @brief Uncompressed allreduce. */
+  none,
+  /** @brief Only exchange the largest-magnitude entries. */
+  topk,
+  /** @brief Exchange entries quantized to 8 or 1 bits. */
+  quantize,
+  /** @brief Exchange a low-rank approximation (PowerSGD). */
+  powersgd,
+};
+
+/** @brief Human-readable string for gradient compression type. */
+std::string to_string(gradient_compression_type type);
+
+/** @brief Parse gradient compression type from string.
+ *  @details An empty string is interpreted as
+ *  @c gradient_compression_type::none.
+ */
+gradient_compression_type
+gradient_compression_type_from_string(std::string const& str);
+
+/** @brief Parameters for gradient compression. */
+struct gradient_compression_params {
+  gradient_compression_type type = gradient_compression_type::none;
+  /** @brief Fraction of entries exchanged with top-k sparsification. */
+  double topk_ratio = 0.01;
+  /** @brief Bits per entry with quantization. Must be 1 or 8. */
+  int quantization_bits = 8;
+  /** @brief Rank of PowerSGD approximation. */
+  int powersgd_rank = 4;
+};
+
+/** @brief Communication volume and time of compressed allreduces. */
+struct gradient_compression_statistics {
+  /** @brief Bytes that an uncompressed allreduce would have sent. */
+  size_t uncompressed_bytes = 0;
+  /** @brief Bytes sent after compression. */
+  size_t compressed_bytes = 0;
+  /** @brief Time spent in compressed allreduces. */
+  EvalType time = 0;
+
+  /** @brief Ratio of uncompressed to compressed size. */
+  EvalType get_ratio() const noexcept {
+    return (compressed_bytes > 0
+            ? EvalType(uncompressed_bytes) / EvalType(compressed_bytes)
+            : EvalType(1));
+  }
+  gradient_compression_statistics&
+  operator+=(gradient_compression_statistics const& other) noexcept {
+    uncompressed_bytes += other.uncompressed_bytes;
+    compressed_bytes += other.compressed_bytes;
+    time += other.time;
+    return *this;
+  }
+};
+
+/** @brief Lossy compression for gradient allreduces.
+ *
+ *  Replaces the allreduce of a gradient over its redundant
+ *  communicator with an exchange of compressed data. The compression
+ *  error on each rank is stored and added to the next gradient (error
+ *  feedback), so that small gradient entries are delayed rather than
+ *  dropped.
+ *
+ *  Compressed allreduces are blocking and operate on host memory.
+ *  GPU gradients are staged through the host.
+ */
+class gradient_compressor {
+public:
+  virtual ~gradient_compressor() = default;
+
+  /** @brief Human-readable type name. */
+  virtual std::string get_type() const = 0;
+
+  const gradient_compression_statistics& get_statistics() const noexcept {
+    return m_statistics;
+  }
+  void reset_statistics() noexcept {
+    m_statistics = gradient_compression_statistics{};
+  }
+
+protected:
+  gradient_compression_statistics m_statistics;
+};
+
+template <typename TensorDataType>
+class data_type_gradient_compressor : public gradient_compressor {
+public:
+  using AbsDistMatrixType = El::AbstractDistMatrix<TensorDataType>;
+  using CPUMatrixType = El::Matrix<TensorDataType, El::Device::CPU>;
+
+public:
+
+  /** @brief Sum gradient over its redundant communicator.
+   *  @details Does nothing if the redundant communicator only has
+   *  one rank.
+   */
+  void allreduce(AbsDistMatrixType& gradient, lbann_comm& comm) {
+    const auto& redundant_comm = gradient.RedundantComm();
+    if (El::mpi::Size(redundant_comm) == 1
+        || gradient.LocalHeight() == 0
+        || gradient.LocalWidth() == 0) {
+      return;
+    }
+    const auto start = get_time();
+    CPUMatrixType local;
+    if (gradient.GetLocalDevice() == El::Device::CPU) {
+      El::View(local, dynamic_cast<CPUMatrixType&>(gradient.Matrix()));
+    }
+    else {
+      El::Copy(gradient.LockedMatrix(), local);
+    }
+    m_statistics.compressed_bytes += allreduce_local(local,
+                                                     redundant_comm,
+                                                     comm);
+    m_statistics.uncompressed_bytes +=
+      local.Height() * local.Width() * sizeof(TensorDataType);
+    if (gradient.GetLocalDevice() != El::Device::CPU) {
+      El::Copy(local, gradient.Matrix());
+    }
+    m_statistics.time += get_time() - start;
+  }
+
+protected:
+
+  /** @brief Sum local gradient entries over a communicator.
+   *  @returns Number of bytes sent by this rank.
+   */
+  virtual size_t allreduce_local(CPUMatrixType& local_gradient,
+                                 El::mpi::Comm const& redundant_comm,
+                                 lbann_comm& comm) = 0;
+
+};
+
+/** @brief Construct a gradient compressor.
+ *  @returns Null if the compression type is
+ *  @c gradient_compression_type::none.
+ */
+template <typename TensorDataType>
+std::unique_ptr<data_type_gradient_compressor<TensorDataType>>
+make_gradient_compressor(gradient_compression_params const& params);
+
+#ifndef LBANN_GRADIENT_COMPRESSOR_INSTANTIATE
+#define PROTO(T)                                                        \
+  extern template std::unique_ptr<data_type_gradient_compressor<T>>     \
+  make_gradient_compressor<T>(gradient_compression_params const&)
+
+#define LBANN_INSTANTIATE_CPU_HALF
+#define LBANN_INSTANTIATE_GPU_HALF
+#include "lbann/macros/instantiate.hpp"
+#undef PROTO
+#undef LBANN_INSTANTIATE_CPU_HALF
+#undef LBANN_INSTANTIATE_GPU_HALF
+#endif // LBANN_GRADIENT_COMPRESSOR_INSTANTIATE
+
+} // namespace lbann
+
+#endif // LBANN_OPTIMIZERS_GRADIENT_COMPRESSOR_HPP_INCLUDED
@@ -94,6 +94,7 @@ public:
   std::string get_type() const override { return "hypergradient Adam"; }
   /** @brief Human-readable description. */
   description get_description() const override;
+  void write_proto(lbann_data::Optimizer* proto) const override;
 
   using OptimizerType::setup;
   void setup(WeightsType* w = nullptr) override;
@@ -29,6 +29,8 @@
 
 #include "lbann/base.hpp"
 #include "lbann/comm.hpp"
+#include "lbann/optimizers/gradient_bucket_manager.hpp"
+#include "lbann/optimizers/gradient_compressor.hpp"
 #include "lbann/utils/cloneable.hpp"
 #include "lbann/utils/compiler_control.hpp"
 #ifdef LBANN_HAS_GPU
@@ -43,6 +45,10 @@
 #include <string>
 #include <unordered_set>
 
+namespace lbann_data {
+class Optimizer;
+}
+
 namespace lbann {
 
 /** @brief Status of values in objective function gradient. */
@@ -92,6 +98,12 @@ public:
   /** @brief Human-readable description. */
   virtual description get_description() const;
 
+  /** @brief Write hyperparameters to protobuf message.
+   *
+   *  Optimizer state is not written.
+   */
+  virtual void write_proto(lbann_data::Optimizer* proto) const = 0;
+
   virtual double get_learning_rate() const = 0;
   virtual void set_learning_rate(double) = 0;
 
@@ -131,6 +143,7 @@ public:
       }
       g.second->clear();
     }
+    this->clear_sparse_gradient();
     this->get_gradient_sources().clear();
   }
 
@@ -155,9 +168,56 @@ public:
    */
   void remove_gradient_source(const void* source);
 
+  /** @brief Do not launch the gradient allreduce when the last
+   *  gradient source is removed.
+   *
+   *  Used to accumulate gradients over several backward props. The
+   *  allreduce is launched once the gradient is accessed.
+   */
+  void set_defer_gradient_allreduce(bool defer) noexcept {
+    m_defer_gradient_allreduce = defer;
+  }
+
   /** @brief Perform optimization step. */
   virtual void step() = 0;
 
+  /** @brief Whether all gradient entries are finite.
+   *
+   *  Only checks the local entries. Finishes the gradient allreduce,
+   *  if needed.
+   */
+  virtual bool gradient_is_finite() = 0;
+
+  /** @brief Factor that gradient contributions are scaled by.
+   *
+   *  The gradient is divided by this factor in the optimization
+   *  step. Used for loss scaling in mixed-precision training.
+   */
+  EvalType get_loss_scale() const noexcept { return m_loss_scale; }
+  /** @brief Set factor that gradient contributions are scaled by. */
+  void set_loss_scale(EvalType loss_scale) noexcept {
+    m_loss_scale = loss_scale;
+  }
+
+  /** @brief Pack gradient allreduces into fused buckets.
+   *
+   *  If set, gradient allreduces are handed to the bucket manager
+   *  rather than being launched individually. The bucket manager is
+   *  not owned by the optimizer and must outlive it, or be unset.
+   */
+  void set_gradient_bucket_manager(gradient_bucket_manager* buckets);
+
+  /** @brief Compress gradient allreduces.
+   *
+   *  Compressed allreduces are blocking and bypass gradient
+   *  bucketing. Compression error is kept by the optimizer and added
+   *  to later gradients.
+   */
+  void set_gradient_compression(gradient_compression_params const& params);
+  gradient_compression_params const& get_gradient_compression() const noexcept {
+    return m_gradient_compression;
+  }
+
   /** @brief Get the gradient buffer.
    *
    *  This provides access to the underlying gradient buffer, which
@@ -204,8 +264,24 @@ public:
   /** @brief Time spent in optimization step. */
   EvalType get_step_time() const { return m_step_time; }
 
+  /** @brief Time spent waiting for gradient allreduces to finish. */
+  EvalType get_allreduce_wait_time() const { return m_allreduce_wait_time; }
+
+  /** @brief Communication volume and time of compressed gradient
+   *  allreduces.
+   */
+  gradient_compression_statistics get_gradient_compression_statistics() const;
+
   /** @brief Reset stats counters. */
-  virtual void reset_counters() { m_step_time = 0; }
+  virtual void reset_counters() {
+    m_step_time = 0;
+    m_allreduce_wait_time = 0;
+    for (auto& grad_mgr : gradients_) {
+      if (auto* compressor = grad_mgr.second->get_compressor()) {
+        compressor->reset_statistics();
+      }
+    }
+  }
 
   ///@}
   /** @name Checkpointing */
@@ -228,8 +304,23 @@ protected:
     virtual void start_allreduce(lbann_comm&) = 0;
     virtual void complete_allreduce(lbann_comm&) = 0;
     virtual void clear() = 0;
+    virtual void set_compression(gradient_compression_params const&) = 0;
+    virtual gradient_compressor* get_compressor() noexcept = 0;
+    virtual gradient_compressor const* get_compressor() const noexcept = 0;
+    void set_bucket_manager(gradient_bucket_manager* buckets,
+                            const void* owner) noexcept {
+      buckets_ = buckets;
+      owner_ = owner;
+    }
+  protected:
+    gradient_bucket_manager* get_bucket_manager() const noexcept {
+      return buckets_;
+    }
+    const void* get_owner() const noexcept { return owner_; }
   private:
     optimizer_gradient_status status_ = optimizer_gradient_status::cleared;
+    gradient_bucket_manager* buckets_ = nullptr;
+    const void* owner_ = nullptr;
   };// class GradientHelper
 
   template <typename TensorDataType>
@@ -249,9 +340,19 @@ protected:
     void start_allreduce(lbann_comm& comm) override {
       switch (this->get_status()) {
       case optimizer_gradient_status::allreduce_needed:
-        comm.nb_allreduce(*gradient_,
-                          gradient_->RedundantComm(),
-                          allreduce_req_);
+        if (compressor_ != nullptr) {
+          compressor_->allreduce(*gradient_, comm);
+          this->set_status(optimizer_gradient_status::ready);
+          break;
+        }
+        if (auto* buckets = this->get_bucket_manager()) {
+          buckets->enqueue(*gradient_, this->get_owner());
+        }
+        else {
+          comm.nb_allreduce(*gradient_,
+                            gradient_->RedundantComm(),
+                            allreduce_req_);
+        }
         this->set_status(optimizer_gradient_status::allreduce_started);
         break;
       case optimizer_gradient_status::ready:
@@ -265,7 +366,12 @@ protected:
     void complete_allreduce(lbann_comm& comm) override {
       switch (this->get_status()) {
       case optimizer_gradient_status::allreduce_started:
-        comm.wait(allreduce_req_);
+        if (auto* buckets = this->get_bucket_manager()) {
+          buckets->wait(*gradient_);
+        }
+        else {
+          comm.wait(allreduce_req_);
+        }
         this->set_status(optimizer_gradient_status::ready);
         break;
       case optimizer_gradient_status::ready:
@@ -283,8 +389,18 @@ protected:
     void clear() override {
       this->set_status(optimizer_gradient_status::cleared);
     }
+    void set_compression(gradient_compression_params const& params) override {
+      compressor_ = make_gradient_compressor<TensorDataType>(params);
+    }
+    gradient_compressor* get_compressor() noexcept override {
+      return compressor_.get();
+    }
+    gradient_compressor const* get_compressor() const noexcept override {
+      return compressor_.get();
+    }
   private:
     std::unique_ptr<AbsDistMatType> gradient_;
+    std::unique_ptr<data_type_gradient_compressor<TensorDataType>> compressor_;
     Al::request allreduce_req_;
   };// class GradientHelperImpl
 
@@ -308,8 +424,26 @@ protected:
 
   void inc_step_time(EvalType time) { m_step_time += time; }
 
+  void inc_allreduce_wait_time(EvalType time) { m_allreduce_wait_time += time; }
+
   virtual std::tuple<El::Int,El::Int,El::DistData> get_matrix_info() const = 0;
 
+  /** @brief Whether any dense gradient contributions have been made
+   *  since the gradient was last cleared.
+   */
+  bool has_gradient_contributions() const {
+    for (const auto& grad_mgr : gradients_) {
+      if (grad_mgr.second->get_status()
+          != optimizer_gradient_status::cleared) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /** @brief Zero out the sparse gradient, if any. */
+  virtual void clear_sparse_gradient() {}
+
   template <typename TensorDataType>
   void accumulate_all_gradient_contributions(
     El::AbstractDistMatrix<TensorDataType>& gradient);
@@ -358,6 +492,26 @@ private:
   /** @brief Time spent in optimization step. */
   EvalType m_step_time = 0;
 
+  /** @brief Time spent waiting for gradient allreduces to finish. */
+  EvalType m_allreduce_wait_time = 0;
+
+  /** @brief Factor that gradient contributions are scaled by. */
+  EvalType m_loss_scale = 1;
+
+  /** @brief Whether to skip launching the gradient allreduce in
+   *  remove_gradient_source.
+   */
+  bool m_defer_gradient_allreduce = false;
+
+  /** @brief Fused allreduces for gradients.
+   *  @details Not owned by the optimizer. If null, an allreduce is
+   *  launched for each gradient.
+   */
+  gradient_bucket_manager* m_gradient_buckets = nullptr;
+
+  /** @brief Compression for gradient allreduces. */
+  gradient_compression_params m_gradient_compression;
+
   /** @brief Map from data types to gradient contributions.
    *  @todo Refactor this out. It's a hack.
    */
@@ -386,6 +540,8 @@ El::AbstractDistMatrix<TensorDataType>& optimizer::get_gradient_buffer(
       std::get<WIDTH>(mat_info),
       std::get<DISTDATA>(mat_info));
     grad_mgr_ptr->set_status(optimizer_gradient_status::cleared);
+    grad_mgr_ptr->set_bucket_manager(m_gradient_buckets, this);
+    grad_mgr_ptr->set_compression(m_gradient_compression);
   }
   // Get the underlying matrix back out.
   auto& grad_mgr = static_cast<GradMgrType&>(*grad_mgr_ptr);
@@ -75,6 +75,7 @@ public:
   std::string get_type() const override { return "RMSprop"; }
   /** Human-readable description. */
   description get_description() const override;
+  void write_proto(lbann_data::Optimizer* proto) const override;
 
   using OptimizerType::setup;
   void setup(WeightsType* w = nullptr) override;
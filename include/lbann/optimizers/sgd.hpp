@@ -56,6 +56,9 @@ public:
   /** @brief The concrete weights type used by this object. */
   using WeightsType = data_type_weights<TensorDataType>;
 
+  /** @brief The sparse gradient type used by this object. */
+  using SparseGradientType = sparse_gradient<TensorDataType>;
+
   ///@}
 
 public:
@@ -86,6 +89,7 @@ public:
   std::string get_type() const override { return "SGD"; }
   /** Human-readable description. */
   description get_description() const override;
+  void write_proto(lbann_data::Optimizer* proto) const override;
 
   ///@}
 
@@ -136,6 +140,15 @@ protected:
   void step_compute(AbsDistMatrixType& values,
                     const AbsDistMatrixType& gradient) override;
 
+  /** @brief Computation for an optimization step with a sparse
+   *  gradient.
+   *  @details Only the nonzero columns are updated. With momentum,
+   *  the velocity of a column only decays in steps where it has a
+   *  nonzero gradient ("lazy" momentum).
+   */
+  void step_compute_sparse(AbsDistMatrixType& values,
+                           const SparseGradientType& gradient) override;
+
 private:
 
   /** @brief Decay rate for gradient accumulation.
@@ -0,0 +1,232 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_OPTIMIZERS_SPARSE_GRADIENT_HPP_INCLUDED
+#define LBANN_OPTIMIZERS_SPARSE_GRADIENT_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+#include "lbann/utils/exception.hpp"
+
+#include <numeric>
+#include <unordered_map>
+#include <vector>
+
+namespace lbann {
+
+/** @brief Gradient where only a few embedding vectors are nonzero.
+ *
+ *  Embedding tables are stored as
+ *  @f$ \text{embedding\_dim} \times \text{num\_embeddings} @f$
+ *  matrices, so a mini-batch only touches the columns that appear in
+ *  its input. This stores the indices of the touched columns and the
+ *  corresponding gradient vectors, packed contiguously in the order
+ *  the indices were first contributed. Contributions to the same
+ *  index are summed, so each index appears at most once.
+ *
+ *  The gradient lives in CPU memory and is fully replicated. Ranks
+ *  exchange their contributions with an allgather, after which every
+ *  rank holds the same sum in the same order.
+ */
+template <typename TensorDataType>
+class sparse_gradient {
+public:
+
+  /** @brief Set the dimensions of the dense gradient and clear. */
+  void setup(El::Int height, El::Int width) {
+    m_height = height;
+    m_width = width;
+    clear();
+  }
+
+  /** @brief Height of the dense gradient (size of each vector). */
+  El::Int height() const noexcept { return m_height; }
+  /** @brief Width of the dense gradient (number of vectors). */
+  El::Int width() const noexcept { return m_width; }
+
+  /** @brief Number of nonzero columns. */
+  size_t num_indices() const noexcept { return m_indices.size(); }
+  /** @brief Column indices of the nonzero vectors. */
+  const std::vector<El::Int>& indices() const noexcept { return m_indices; }
+  /** @brief Nonzero vectors, packed in the order of indices(). */
+  const std::vector<TensorDataType>& values() const noexcept {
+    return m_values;
+  }
+
+  /** @brief Whether any object has contributed since the last clear.
+   *
+   *  This is set even if the contributions were empty. It must agree
+   *  across ranks, since it decides whether the gradient is
+   *  exchanged.
+   */
+  bool has_contributions() const noexcept { return m_has_contributions; }
+  /** @brief Record that an object contributed to the gradient. */
+  void set_has_contributions() noexcept { m_has_contributions = true; }
+
+  /** @brief Remove all contributions. */
+  void clear() {
+    m_indices.clear();
+    m_values.clear();
+    m_slots.clear();
+    m_has_contributions = false;
+  }
+
+  /** @brief Add a contribution to one column.
+   *
+   *  @param index Column index. Must be in [0, width()).
+   *  @param contrib Buffer with height() contiguous entries.
+   *  @param scale Scaling factor for the contribution.
+   */
+  void add(El::Int index,
+           const TensorDataType* contrib,
+           TensorDataType scale = El::TypeTraits<TensorDataType>::One()) {
+    m_has_contributions = true;
+    auto* vals = get_column(index);
+    for (El::Int i = 0; i < m_height; ++i) {
+      vals[i] += scale * contrib[i];
+    }
+  }
+
+  /** @brief Scale all nonzero vectors. */
+  void scale(TensorDataType alpha) {
+    for (auto& x : m_values) { x *= alpha; }
+  }
+
+  /** @brief Sum contributions over a communicator.
+   *
+   *  The indices and vectors from all ranks are gathered, then
+   *  merged in rank order so that every rank ends up with the same
+   *  sum. If the ranks contribute more than @c max_indices indices in
+   *  total, the exchange is abandoned before any vectors are sent and
+   *  the local contributions are left unchanged, since a dense
+   *  allreduce is then cheaper.
+   *
+   *  @return Whether the exchange was performed.
+   */
+  bool allgather(const El::mpi::Comm& comm, El::Int max_indices) {
+    const int comm_size = El::mpi::Size(comm);
+    const int local_count = static_cast<int>(m_indices.size());
+    std::vector<int> counts(comm_size);
+    El::mpi::AllGather(&local_count, 1, counts.data(), 1, comm,
+                       El::SyncInfo<El::Device::CPU>{});
+    const El::Int total_count = std::accumulate(counts.begin(),
+                                                counts.end(),
+                                                El::Int(0));
+    if (total_count > max_indices) { return false; }
+    if (comm_size == 1 || total_count == 0) { return true; }
+
+    // Gather indices
+    std::vector<int> displs(comm_size, 0);
+    std::partial_sum(counts.begin(), counts.end()-1, displs.begin()+1);
+    std::vector<El::Int> all_indices(total_count);
+    El::mpi::AllGather(m_indices.data(), local_count,
+                       all_indices.data(), counts.data(), displs.data(),
+                       comm, El::SyncInfo<El::Device::CPU>{});
+
+    // Gather vectors
+    for (int rank = 0; rank < comm_size; ++rank) {
+      counts[rank] *= m_height;
+      displs[rank] *= m_height;
+    }
+    std::vector<TensorDataType> all_values(total_count * m_height);
+    El::mpi::AllGather(m_values.data(), local_count * m_height,
+                       all_values.data(), counts.data(), displs.data(),
+                       comm, El::SyncInfo<El::Device::CPU>{});
+
+    // Merge contributions in rank order
+    clear();
+    m_has_contributions = true;
+    for (El::Int k = 0; k < total_count; ++k) {
+      add(all_indices[k], &all_values[k*m_height]);
+    }
+    return true;
+  }
+
+  /** @brief Add to the local entries of a dense matrix.
+   *
+   *  @c dense must have height() rows and width() columns. Columns
+   *  that are not owned by this rank are skipped.
+   */
+  void add_to(El::AbstractDistMatrix<TensorDataType>& dense,
+              TensorDataType scale = El::TypeTraits<TensorDataType>::One()) const {
+    using CPUMatType = El::Matrix<TensorDataType, El::Device::CPU>;
+    CPUMatType local;
+    if (dense.GetLocalDevice() == El::Device::CPU) {
+      El::View(local, dynamic_cast<CPUMatType&>(dense.Matrix()));
+    }
+    else {
+      El::Copy(dense.LockedMatrix(), local);
+    }
+    const El::Int local_height = dense.LocalHeight();
+    const El::Int num_indices = m_indices.size();
+    for (El::Int k = 0; k < num_indices; ++k) {
+      const El::Int col = m_indices[k];
+      if (!dense.IsLocalCol(col)) { continue; }
+      const El::Int local_col = dense.LocalCol(col);
+      const auto* vals = &m_values[k*m_height];
+      for (El::Int local_row = 0; local_row < local_height; ++local_row) {
+        local(local_row, local_col) += scale * vals[dense.GlobalRow(local_row)];
+      }
+    }
+    if (dense.GetLocalDevice() != El::Device::CPU) {
+      El::Copy(local, dense.Matrix());
+    }
+  }
+
+private:
+
+  /** @brief Get the vector for a column, creating it if needed. */
+  TensorDataType* get_column(El::Int index) {
+    if (index < 0 || index >= m_width) {
+      LBANN_ERROR("attempted to access column ", index, " "
+                  "of a sparse gradient with ", m_width, " columns");
+    }
+    const auto slot = m_slots.emplace(index, m_indices.size());
+    if (slot.second) {
+      m_indices.push_back(index);
+      m_values.resize(m_values.size() + m_height,
+                      El::TypeTraits<TensorDataType>::Zero());
+    }
+    return &m_values[slot.first->second * m_height];
+  }
+
+  /** @brief Height of the dense gradient. */
+  El::Int m_height = 0;
+  /** @brief Width of the dense gradient. */
+  El::Int m_width = 0;
+  /** @brief Column indices of the nonzero vectors. */
+  std::vector<El::Int> m_indices;
+  /** @brief Nonzero vectors, packed in the order of m_indices. */
+  std::vector<TensorDataType> m_values;
+  /** @brief Map from column index to position in m_indices. */
+  std::unordered_map<El::Int, size_t> m_slots;
+  /** @brief Whether any object has contributed since the last clear. */
+  bool m_has_contributions = false;
+
+};
+
+} // namespace lbann
+
+#endif // LBANN_OPTIMIZERS_SPARSE_GRADIENT_HPP_INCLUDED
@@ -0,0 +1,88 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_UTILS_BATCHED_GEMM_HPP_INCLUDED
+#define LBANN_UTILS_BATCHED_GEMM_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+
+namespace lbann {
+
+/** @brief Strided batched GEMM on CPU.
+ *
+ *  Computes
+ *  @f$ C_i \leftarrow \alpha \text{op}(A_i) \text{op}(B_i) + \beta C_i @f$
+ *  for @c batch_count matrix triples, where @f$ A_i @f$ starts at
+ *  <tt>A + i*stride_A</tt>, etc. Matrices are in column-major
+ *  layout, with the same argument convention as
+ *  @c hydrogen::gpu_blas::GemmStridedBatched.
+ *
+ *  Hydrogen does not expose a batched BLAS on CPU. Small products
+ *  are computed with an in-house kernel that packs @f$ \text{op}(A)
+ *  @f$ into a contiguous per-thread buffer and parallelizes over the
+ *  batch, avoiding the per-call overhead of BLAS. Large products
+ *  are dispatched to BLAS one at a time.
+ *
+ *  If @f$ \beta = 0 @f$, the entries of @f$ C_i @f$ are not read.
+ *
+ *  @param m Height of @f$ \text{op}(A_i) @f$ and @f$ C_i @f$.
+ *  @param n Width of @f$ \text{op}(B_i) @f$ and @f$ C_i @f$.
+ *  @param k Width of @f$ \text{op}(A_i) @f$ and height of
+ *           @f$ \text{op}(B_i) @f$.
+ */
+template <typename TensorDataType>
+void gemm_strided_batched(El::Orientation transA,
+                          El::Orientation transB,
+                          El::Int m, El::Int n, El::Int k,
+                          TensorDataType alpha,
+                          const TensorDataType* A,
+                          El::Int lda, El::Int stride_A,
+                          const TensorDataType* B,
+                          El::Int ldb, El::Int stride_B,
+                          TensorDataType beta,
+                          TensorDataType* C,
+                          El::Int ldc, El::Int stride_C,
+                          El::Int batch_count);
+
+/** @brief Whether gemm_strided_batched uses the in-house kernel for
+ *  an m x n x k product.
+ */
+bool use_small_gemm_kernel(El::Int m, El::Int n, El::Int k) noexcept;
+
+#ifndef LBANN_UTILS_BATCHED_GEMM_INSTANTIATE
+#define PROTO(T)                                                        \
+  extern template void gemm_strided_batched<T>(                         \
+    El::Orientation, El::Orientation, El::Int, El::Int, El::Int,        \
+    T, const T*, El::Int, El::Int, const T*, El::Int, El::Int,          \
+    T, T*, El::Int, El::Int, El::Int)
+
+#include "lbann/macros/instantiate.hpp"
+#undef PROTO
+#endif // LBANN_UTILS_BATCHED_GEMM_INSTANTIATE
+
+} // namespace lbann
+
+#endif // LBANN_UTILS_BATCHED_GEMM_HPP_INCLUDED
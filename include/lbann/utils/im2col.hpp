@@ -134,6 +134,61 @@ void col2im(const CPUMatDT<TensorDataType>& col,
             const int * window_strides,
             std::function<TensorDataType(const TensorDataType&, const TensorDataType&)> reduction_op);
 
+/// Rearrange image blocks from several samples into matrix columns
+/** Batched version of im2col that also supports dilated windows.
+ *  Each column of im is one sample. The columns of col are grouped
+ *  by sample, so col has one block of columns per sample. Samples
+ *  are processed in parallel.
+ *  @param im               im tensors, one per column.
+ *  @param col              col matrix. Height should be equal to
+ *                          window size and width equal to number of
+ *                          window shifts times number of samples.
+ *  @param num_channels     Number of channels in im tensor.
+ *  @param im_num_dims      Number of dimensions in im tensor.
+ *  @param im_dims          im tensor dimensions.
+ *  @param im_pads          Zero pads for im tensor.
+ *  @param window_dims      Dimensions of window.
+ *  @param window_strides   Window shift strides.
+ *  @param window_dilations Spacing between window entries.
+ */
+template <typename TensorDataType>
+void im2col_batched(const CPUMatDT<TensorDataType>& im,
+                    CPUMatDT<TensorDataType>& col,
+                    int num_channels,
+                    int im_num_dims,
+                    const int * im_dims,
+                    const int * im_pads,
+                    const int * window_dims,
+                    const int * window_strides,
+                    const int * window_dilations);
+
+/// Rearrange matrix columns from several samples into image blocks
+/** Batched version of col2im that also supports dilated windows.
+ *  This is approximately the inverse of im2col_batched. Each entry
+ *  of im is overwritten with the sum of the corresponding col matrix
+ *  entries. Samples are processed in parallel.
+ *  @param col              col matrix, with one block of columns per
+ *                          sample.
+ *  @param im               im tensors, one per column.
+ *  @param num_channels     Number of channels in im tensor.
+ *  @param im_num_dims      Number of dimensions in im tensor.
+ *  @param im_dims          im tensor dimensions.
+ *  @param im_pads          Zero pads for im tensor.
+ *  @param window_dims      Dimensions of window.
+ *  @param window_strides   Window shift strides.
+ *  @param window_dilations Spacing between window entries.
+ */
+template <typename TensorDataType>
+void col2im_batched(const CPUMatDT<TensorDataType>& col,
+                    CPUMatDT<TensorDataType>& im,
+                    int num_channels,
+                    int im_num_dims,
+                    const int * im_dims,
+                    const int * im_pads,
+                    const int * window_dims,
+                    const int * window_strides,
+                    const int * window_dilations);
+
 /// Rearrange 1x1 image blocks into matrix columns
 /** This is an optimized implementation of im2col when the window has
  *  a size of one, there is no padding, and the window stride is
@@ -41,6 +41,58 @@ namespace lbann {
 void load_image(const std::string& filename, El::Matrix<uint8_t>& dst,
                 std::vector<size_t>& dims);
 
+/**
+ * @brief Load an image from filename by memory-mapping the file.
+ *
+ * The encoded image is decoded directly from the page cache instead
+ * of being read into an intermediate buffer.
+ *
+ * @param filename The path to the image to load.
+ * @param dst Image will be loaded into this matrix, in OpenCV format.
+ * @param dims Will contain the dimensions of the image as {channels, height,
+ * width}.
+ */
+void load_image_mmap(const std::string& filename, El::Matrix<uint8_t>& dst,
+                     std::vector<size_t>& dims);
+
+/**
+ * @brief Open an image file and ask the OS to start reading it into the
+ * page cache.
+ *
+ * This is only a hint and returns without waiting for I/O. The
+ * returned descriptor should later be passed to load_image or
+ * load_image_mmap, so the file is only opened once.
+ *
+ * @param filename The path to the image that will be loaded soon.
+ * @return An open file descriptor, or -1 if the file could not be
+ * opened.
+ */
+int prefetch_image_file(const std::string& filename);
+
+/**
+ * @brief Load an image from a file descriptor returned by
+ * prefetch_image_file.
+ * @param fd Open descriptor for the image file; it is closed.
+ * @param filename The path to the image, for error messages.
+ * @param dst Image will be loaded into this matrix, in OpenCV format.
+ * @param dims Will contain the dimensions of the image as {channels, height,
+ * width}.
+ */
+void load_image(int fd, const std::string& filename,
+                El::Matrix<uint8_t>& dst, std::vector<size_t>& dims);
+
+/**
+ * @brief Memory-map and decode an image from a file descriptor
+ * returned by prefetch_image_file.
+ * @param fd Open descriptor for the image file; it is closed.
+ * @param filename The path to the image, for error messages.
+ * @param dst Image will be loaded into this matrix, in OpenCV format.
+ * @param dims Will contain the dimensions of the image as {channels, height,
+ * width}.
+ */
+void load_image_mmap(int fd, const std::string& filename,
+                     El::Matrix<uint8_t>& dst, std::vector<size_t>& dims);
+
 /**
  * @brief Decode an image from buf.
  * @param src A buffer containing image data to be decoded.
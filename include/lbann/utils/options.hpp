@@ -26,6 +26,7 @@ namespace lbann {
 #define USE_CUBLAS_TENSOR_OPS "use_cublas_tensor_ops"
 #define USE_CUDNN_TENSOR_OPS "use_cudnn_tensor_ops"
 #define USE_DATA_STORE "use_data_store"
+#define USE_NATIVE_CPU_GRU "use_native_cpu_gru"
 #define USE_LTFB "ltfb"
 #define VERBOSE "verbose"
 #define WRITE_SAMPLE_LIST "write_sample_list"
@@ -58,6 +59,7 @@ namespace lbann {
 /****** datastore options ******/
 // Bool flags
 #define DATA_STORE_CACHE "data_store_cache"
+#define DATA_STORE_COMPRESS "data_store_compress"
 #define DATA_STORE_DEBUG "data_store_debug"
 #define DATA_STORE_FAIL "data_store_fail"
 #define DATA_STORE_MIN_MAX_TIMING "data_store_min_max_timing"
@@ -66,6 +68,9 @@ namespace lbann {
 #define DATA_STORE_SPILL "data_store_spill"
 #define DATA_STORE_TEST_CACHE "data_store_test_cache"
 #define DATA_STORE_TEST_CHECKPOINT "data_store_test_checkpoint"
+#define DATA_STORE_TIERED_CACHE "data_store_tiered_cache"
+#define DATA_STORE_MEMORY_BUDGET "data_store_memory_budget"
+#define DATA_STORE_LOCALITY "data_store_locality"
 
 /****** datareader options ******/
 // Bool flags
@@ -76,6 +81,7 @@ namespace lbann {
 #define DEBUG_CONCATENATE "debug_concatenate"
 #define EXIT_AFTER_SETUP "exit_after_setup"
 #define GENERATE_MULTI_PROTO "generate_multi_proto"
+#define IMAGE_MMAP "image_mmap"
 #define KEEP_SAMPLE_ORDER "keep_sample_order"
 #define KEEP_PACKED_FIELDS "keep_packed_fields"
 #define LOAD_FULL_SAMPLE_LIST_ONCE "load_full_sample_list_once"
@@ -98,6 +104,7 @@ namespace lbann {
 #define DATA_FILENAME_VALIDATE "data_filename_validate"
 #define DATA_READER_PERCENT "data_reader_percent"
 #define DELIMITER "delimiter"
+#define IMAGE_READAHEAD "image_readahead"
 #define IMAGE_SIZES_FILENAME "image_sizes_filename"
 #define LABEL_FILENAME_TEST "label_filename_test"
 #define LABEL_FILENAME_TRAIN "label_filename_train"
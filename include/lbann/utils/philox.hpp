@@ -0,0 +1,112 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_UTILS_PHILOX_HPP_INCLUDED
+#define LBANN_UTILS_PHILOX_HPP_INCLUDED
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+namespace lbann {
+
+/** @brief Philox-4x32-10 counter-based random number generator
+ *
+ *  A keyed bijection on 128-bit counters (Salmon et al., "Parallel
+ *  random numbers: as easy as 1, 2, 3", SC 2011). Each counter maps
+ *  to four independent 32-bit random values, so the random values
+ *  for an entry of a tensor can be computed directly from its global
+ *  index. Tensors can then be filled in parallel, by any number of
+ *  processes and threads, with results that do not depend on how
+ *  the tensor is distributed.
+ */
+class philox4x32
+{
+public:
+  using counter_type = std::array<uint32_t, 4>;
+  using key_type = std::array<uint32_t, 2>;
+
+  /** @brief Random values for a counter. */
+  static constexpr counter_type generate(counter_type ctr, key_type key)
+  {
+    for (int round = 0; round < 10; ++round) {
+      const uint64_t prod0 = uint64_t(M0) * ctr[0];
+      const uint64_t prod1 = uint64_t(M1) * ctr[2];
+      ctr = {uint32_t(prod1 >> 32) ^ ctr[1] ^ key[0],
+             uint32_t(prod1),
+             uint32_t(prod0 >> 32) ^ ctr[3] ^ key[1],
+             uint32_t(prod0)};
+      key[0] += W0;
+      key[1] += W1;
+    }
+    return ctr;
+  }
+
+  /** @brief Random values for an entry of a random stream.
+   *  @param seed  Key of the stream.
+   *  @param index Index of the entry in the stream.
+   */
+  static constexpr counter_type generate(uint64_t seed, uint64_t index)
+  {
+    return generate(
+      counter_type{uint32_t(index), uint32_t(index >> 32), 0u, 0u},
+      key_type{uint32_t(seed), uint32_t(seed >> 32)});
+  }
+
+private:
+  static constexpr uint32_t M0 = 0xD2511F53u;
+  static constexpr uint32_t M1 = 0xCD9E8D57u;
+  static constexpr uint32_t W0 = 0x9E3779B9u;
+  static constexpr uint32_t W1 = 0xBB67AE85u;
+};
+
+/** @brief Uniform random value in [0, 1) from 32 random bits. */
+inline float philox_uniform_float(uint32_t x)
+{
+  return (x >> 8) * (1.0f / 16777216.0f);
+}
+
+/** @brief Uniform random value in [0, 1) from 64 random bits. */
+inline double philox_uniform_double(uint32_t hi, uint32_t lo)
+{
+  const uint64_t x = (uint64_t(hi) << 32) | lo;
+  return (x >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/** @brief Standard normal random value from one Philox output.
+ *  @details Box-Muller transform with 53-bit uniform values.
+ */
+inline double philox_normal(philox4x32::counter_type const& x)
+{
+  constexpr double two_pi = 6.283185307179586476925286766559;
+  const double u1 = 1.0 - philox_uniform_double(x[0], x[1]); // (0, 1]
+  const double u2 = philox_uniform_double(x[2], x[3]);
+  return std::sqrt(-2.0 * std::log(u1)) * std::cos(two_pi * u2);
+}
+
+} // namespace lbann
+
+#endif // LBANN_UTILS_PHILOX_HPP_INCLUDED
@@ -148,7 +148,9 @@ void uniform_fill(El::AbstractDistMatrix<TensorDataType>& mat, El::Int m, El::In
  * Make mat into an m x n matrix where each entry is independently drawn from
  * a Gaussian distribution with given mean and standard deviation.
  * This always ensures that the entries of the matrix do not change as the grid
- * it is distributed over changes.
+ * it is distributed over changes. Entries are computed from a counter-based
+ * generator (Philox) indexed by their global position, so every process and
+ * thread fills its local entries in parallel.
  */
 template <typename TensorDataType>
 void gaussian_fill_procdet(El::AbstractDistMatrix<TensorDataType>& mat, El::Int m, El::Int n,
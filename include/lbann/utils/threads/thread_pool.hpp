@@ -5,6 +5,7 @@
 
 #include "thread_safe_queue.hpp"
 #include "type_erased_function.hpp"
+#include "work_stealing_queue.hpp"
 #include "lbann/utils/exception.hpp"
 
 #if defined(LBANN_TOPO_AWARE)
@@ -16,13 +17,26 @@
 
 #include <sched.h>
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <future>
+#include <memory>
+#include <mutex>
 #include <thread>
-#include <unordered_map>
 #include <vector>
 
 namespace lbann {
 
+/** @class thread_pool
+ *  @brief Pool of worker threads with work stealing.
+ *
+ *  Each worker owns a deque of jobs. Jobs submitted from a worker are
+ *  pushed onto that worker's deque and jobs submitted from any other
+ *  thread go to a shared FIFO queue. Idle workers first drain their
+ *  own deque, then the shared queue, and then steal the oldest job
+ *  from another worker's deque.
+ */
 class thread_pool {
 public:
   using thread_container_type = std::vector<std::thread>;
@@ -75,7 +89,7 @@ public:
 
     std::packaged_task<return_type()> task(std::move(func));
     auto future = task.get_future();
-    global_work_queue_.push(std::move(task));
+    push_job_(std::move(task));
     return future;
   }
 
@@ -88,15 +102,29 @@ public:
 
     std::packaged_task<return_type()> task(std::move(func));
     m_work_group.emplace_back(task.get_future());
-    global_work_queue_.push(std::move(task));
+    push_job_(std::move(task));
 
     return;
   }
 
-  /** @brief Wait for all of the jobs in a work group to finish */
+  /** @brief Wait for all of the jobs in a work group to finish
+   *
+   *  When called from a worker, the worker runs jobs from its own
+   *  deque while it waits. These are the work group jobs that no
+   *  other worker has stolen yet.
+   */
   bool finish_work_group() {
     std::string error_message;
     for (auto& f : m_work_group) {
+      while (f.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        auto task = try_pop_local_job_();
+        if (task) {
+          (*task)();
+        }
+        else {
+          f.wait();
+        }
+      }
       bool valid = f.get();
       if (!valid) {
         error_message = "invalid future in work group";
@@ -110,15 +138,29 @@ public:
   /** @brief Query the number of worker threads actually present */
   size_type get_num_threads() const noexcept { return threads_.size(); }
 
-  /** @brief Convert the C++ thread id into a local thread pool id */
+  /** @brief Convert the C++ thread id into a local thread pool id
+   *
+   *  Threads that are not part of the pool get id 0.
+   */
   int get_local_thread_id();
 
+  /** @brief Number of jobs that were stolen from another worker */
+  size_type get_num_stolen_jobs() const noexcept { return m_num_stolen_jobs; }
+
   /** @brief Convert the C++ thread id into a local thread pool id */
   int get_threads_offset() { return m_threads_offset; }
 
 private:
   /** @brief The task executed by each thread */
-  void do_thread_work_();
+  void do_thread_work_(int tid);
+  /** @brief Queue a job and wake a worker */
+  void push_job_(type_erased_function job);
+  /** @brief Find a job for a worker, stealing if necessary */
+  std::unique_ptr<type_erased_function> find_job_(int tid);
+  /** @brief Pop a job from the calling worker's own deque */
+  std::unique_ptr<type_erased_function> try_pop_local_job_();
+  /** @brief Pool id of the calling thread, or -1 if it is not a worker */
+  int get_worker_id_() const;
 #if defined(LBANN_TOPO_AWARE)
   void do_thread_work_pinned_thread_(int tid, hwloc_topology_t topo, hwloc_cpuset_t cpuset);
 #endif // LBANN_TOPO_AWARE
@@ -127,7 +169,8 @@ private:
   /** @brief Container holding the threads */
   thread_container_type threads_;
 
-  /** @brief The thread-safe work queue */
+  /** @brief The thread-safe work queue for jobs submitted by
+   *  threads outside the pool */
   thread_safe_queue<type_erased_function> global_work_queue_;
 
   /** @brief RAII "deleter" for the threads */
@@ -136,8 +179,20 @@ private:
   /** @brief Flag to track if more work is to be done */
   std::atomic<bool> all_work_done_;
 
-  std::mutex m_thread_map_mutex;
-  std::unordered_map<std::thread::id, int> m_thread_id_to_local_id_map;
+  /** @brief Per-worker deques of jobs submitted by workers */
+  std::vector<std::unique_ptr<work_stealing_queue<type_erased_function>>> m_local_queues;
+
+  /** @brief Mutex for sleeping and waking idle workers */
+  std::mutex m_wake_mutex;
+
+  /** @brief Condition variable tripped when a job is submitted */
+  std::condition_variable m_wake;
+
+  /** @brief Number of queued jobs that have not been started */
+  std::atomic<size_type> m_num_pending_jobs;
+
+  /** @brief Number of jobs taken from another worker's deque */
+  std::atomic<size_type> m_num_stolen_jobs;
 
   /** @brief Work Group */
   std::vector<std::future<bool>> m_work_group;
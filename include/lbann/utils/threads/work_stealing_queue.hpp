@@ -0,0 +1,81 @@
+#ifndef LBANN_UTILS_THREADS_WORK_STEALING_QUEUE_HPP_INCLUDED
+#define LBANN_UTILS_THREADS_WORK_STEALING_QUEUE_HPP_INCLUDED
+
+#include <lbann/utils/memory.hpp>
+
+#include <deque>
+#include <memory>
+#include <mutex>
+
+namespace lbann {
+
+/** @class work_stealing_queue
+ *  @brief A double-ended queue owned by one worker thread that other
+ *  threads may steal from.
+ *
+ *  The owner pushes and pops at the back of the queue (LIFO), which
+ *  keeps recently submitted work in cache. Thieves take from the
+ *  front of the queue (FIFO), so they pick up the oldest and
+ *  typically largest pieces of work.
+ *
+ *  This version uses a single lock. Contention is low since the
+ *  owner is usually the only thread touching the queue.
+ *
+ *  @tparam T A move-constructible type
+ */
+template <typename T>
+class work_stealing_queue {
+public:
+
+  /** @brief Adds a value to the back of the queue */
+  void push(T value)
+  {
+    std::lock_guard<std::mutex> lk(mtx_);
+    queue_.push_back(std::move(value));
+  }
+
+  /** @brief Try to remove the last value from the queue
+   *
+   *  @return nullptr if empty(); otherwise return a value
+   */
+  std::unique_ptr<T> try_pop()
+  {
+    std::lock_guard<std::mutex> lk(mtx_);
+    if (queue_.empty()) return nullptr;
+    auto value = make_unique<T>(std::move(queue_.back()));
+    queue_.pop_back();
+    return value;
+  }
+
+  /** @brief Try to remove the first value from the queue
+   *
+   *  @return nullptr if empty(); otherwise return a value
+   */
+  std::unique_ptr<T> try_steal()
+  {
+    std::lock_guard<std::mutex> lk(mtx_);
+    if (queue_.empty()) return nullptr;
+    auto value = make_unique<T>(std::move(queue_.front()));
+    queue_.pop_front();
+    return value;
+  }
+
+  /** @brief Check if queue is empty */
+  bool empty() const
+  {
+    std::lock_guard<std::mutex> lk(mtx_);
+    return queue_.empty();
+  }
+
+private:
+
+  /** @brief The mutex protecting the queue */
+  mutable std::mutex mtx_;
+
+  /** @brief The queued values */
+  std::deque<T> queue_;
+
+};// class work_stealing_queue
+
+}// namespace lbann
+#endif /* LBANN_UTILS_THREADS_WORK_STEALING_QUEUE_HPP_INCLUDED */
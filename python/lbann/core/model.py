@@ -28,7 +28,19 @@ class Model:
                  summary_dir=None,
                  subgraph_communication=SubgraphCommunication.PT2PT,
                  subgraph_topology=False,
-                 subgraph_num_common_resources=0):
+                 subgraph_num_common_resources=0,
+                 gradient_bucket_size=0,
+                 gradient_bucket_order=None,
+                 recompute_every_n_layers=0,
+                 recompute_checkpoint_layers=[],
+                 fuse_elementwise_operators=False,
+                 mixed_precision=False,
+                 initial_loss_scale=None,
+                 loss_scale_growth_interval=None,
+                 static_loss_scale=False,
+                 float_layers=[],
+                 gradient_accumulation_steps=1,
+                 plan_layer_memory=False):
 
         # Scalar fields
         self.epochs = epochs
@@ -56,6 +68,18 @@ class Model:
         self.subgraph_communication = subgraph_communication
         self.subgraph_topology = subgraph_topology
         self.subgraph_num_common_resources = subgraph_num_common_resources
+        self.gradient_bucket_size = gradient_bucket_size
+        self.gradient_bucket_order = gradient_bucket_order
+        self.recompute_every_n_layers = recompute_every_n_layers
+        self.recompute_checkpoint_layers = make_iterable(recompute_checkpoint_layers)
+        self.fuse_elementwise_operators = fuse_elementwise_operators
+        self.mixed_precision = mixed_precision
+        self.initial_loss_scale = initial_loss_scale
+        self.loss_scale_growth_interval = loss_scale_growth_interval
+        self.static_loss_scale = static_loss_scale
+        self.float_layers = make_iterable(float_layers)
+        self.gradient_accumulation_steps = gradient_accumulation_steps
+        self.plan_layer_memory = plan_layer_memory
 
     def export_proto(self):
         """Construct and return a protobuf message."""
@@ -65,8 +89,32 @@ class Model:
         model.subgraph_communication = convert_to_protbuf_enums(self.subgraph_communication)
         model.enable_subgraph_topology = self.subgraph_topology
         model.subgraph_parent_grid_resources = self.subgraph_num_common_resources
+        model.fuse_elementwise_operators = self.fuse_elementwise_operators
+        model.gradient_accumulation_steps = self.gradient_accumulation_steps
+        model.plan_layer_memory = self.plan_layer_memory
         if self.summary_dir is not None:
             model.summarizer.dir = self.summary_dir
+        if self.gradient_bucket_size:
+            model.gradient_bucketing.bucket_size = self.gradient_bucket_size
+            if self.gradient_bucket_order is not None:
+                model.gradient_bucketing.order = self.gradient_bucket_order
+        if self.recompute_every_n_layers or self.recompute_checkpoint_layers:
+            recompute = model.activation_recompute
+            recompute.every_n_layers = self.recompute_every_n_layers
+            recompute.checkpoint_layers.extend(
+                l if isinstance(l, str) else l.name
+                for l in self.recompute_checkpoint_layers)
+        if self.mixed_precision:
+            mixed = model.mixed_precision
+            mixed.enabled = True
+            if self.initial_loss_scale is not None:
+                mixed.initial_loss_scale = self.initial_loss_scale
+            if self.loss_scale_growth_interval is not None:
+                mixed.loss_scale_growth_interval = self.loss_scale_growth_interval
+            mixed.static_loss_scale = self.static_loss_scale
+            mixed.float_layers.extend(
+                l if isinstance(l, str) else l.name
+                for l in self.float_layers)
         # Add model components
         model.layer.extend([l.export_proto() for l in self.layers])
         model.weights.extend([w.export_proto() for w in self.weights])
@@ -12,6 +12,7 @@ class Trainer:
                  random_seed=None,
                  serialize_io=None,
                  training_algo=None,
+                 prefetch_depth=None,
                  callbacks=[]):
         self.name = name
         self.num_parallel_readers = num_parallel_readers
@@ -20,6 +21,7 @@ class Trainer:
         self.mini_batch_size = mini_batch_size
         self.hydrogen_block_size = None
         self.training_algo = training_algo
+        self.prefetch_depth = prefetch_depth
         # Callbacks
         self.callbacks = make_iterable(callbacks)
 
@@ -41,6 +43,8 @@ class Trainer:
             trainer.serialize_io = self.serialize_io
         if self.training_algo is not None:
             trainer.training_algorithm.CopyFrom(self.training_algo.export_proto())
+        if self.prefetch_depth is not None:
+            trainer.data_coordinator.prefetch_depth = self.prefetch_depth
 
         # Add trainer components
         trainer.callback.extend([c.export_proto() for c in self.callbacks])
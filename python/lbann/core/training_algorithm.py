@@ -122,6 +122,51 @@ class BatchedIterativeOptimizer(TrainingAlgorithm):
         params.stopping_criteria.CopyFrom(self.stopping.export_proto())
         return params
 
+class LocalSGD(TrainingAlgorithm):
+    """SGD with periodic model averaging between trainers.
+
+    Trainers take local optimization steps and average their weights
+    every few steps with a single allreduce.
+
+    """
+
+    def __init__(self, name: str, local_algo: BatchedIterativeOptimizer,
+                 averaging_interval: int = 1,
+                 average_optimizer_state: bool = False,
+                 adaptive_interval: bool = False,
+                 max_averaging_interval: int = 0):
+        """Construct a new LocalSGD algorithm.
+
+        Args:
+            name: A user-defined name to identify this object in logs.
+            local_algo: The SGD algorithm run by each trainer.
+            averaging_interval: Number of local steps between model
+              averages.
+            average_optimizer_state: Whether to also average optimizer
+              state (SGD velocity and Adam moments).
+            adaptive_interval: Whether to scale the averaging interval
+              by the square root of the ratio between the current and
+              initial training loss.
+            max_averaging_interval: Upper bound on the adaptive
+              averaging interval (default: averaging_interval).
+        """
+        self.name = name
+        self.local_algo = local_algo
+        self.averaging_interval = averaging_interval
+        self.average_optimizer_state = average_optimizer_state
+        self.adaptive_interval = adaptive_interval
+        self.max_averaging_interval = max_averaging_interval
+
+    def do_export_proto(self):
+        """Get a protobuf representation of this object."""
+        params = AlgoProto.LocalSGD()
+        self.local_algo.export_proto().parameters.Unpack(params.sgd)
+        params.averaging_interval = self.averaging_interval
+        params.average_optimizer_state = self.average_optimizer_state
+        params.adaptive_interval = self.adaptive_interval
+        params.max_averaging_interval = self.max_averaging_interval
+        return params
+
 class MetaLearningStrategy:
     """Base class for metalearning strategies for LTFB."""
     def __init__(self):
@@ -258,7 +303,7 @@ class RandomPairwiseExchange(MetaLearningStrategy):
         no effort has been made here to mirror the C++ polymorphism in
         this Python wrapper.
 
-        There are currently three strategies that are subtly different
+        There are currently four strategies that are subtly different
         in the way they exchange model data.
 
         1. "checkpoint_binary": This is the default strategy. Entire
@@ -284,12 +329,21 @@ class RandomPairwiseExchange(MetaLearningStrategy):
            happen to work, this essentially implies that the model
            topology should be homogenous across all trainers.
 
+        4. "stream_weights": Only weights values are exchanged. Each
+           rank streams its local part of every weights matrix to the
+           matching rank of the partner trainer in chunks of at most
+           `chunk_bytes` bytes. No model is serialized and no data
+           passes through the trainer master. The same assumptions as
+           "sendrecv_weights" apply, and the weights must have the
+           same distribution in both trainers.
+
         """
 
         def __init__(self, strategy: str = "checkpoint_binary",
                      weights_names: list[str] = [],
                      exchange_hyperparameters: bool = False,
-                     checkpoint_dir: str = None):
+                     checkpoint_dir: str = None,
+                     chunk_bytes: int = None):
             """Construct a new exchange strategy.
 
             Args:
@@ -302,11 +356,14 @@ class RandomPairwiseExchange(MetaLearningStrategy):
                   the "sendrecv_weights" strategy.
                 checkpoint_dir: A path to a directory for storing the
                   checkpoint files. Only applies to "checkpoint_file".
+                chunk_bytes: Maximum message size in bytes (default:
+                  64 MiB). Only applies to "stream_weights".
             """
             self.strategy = strategy
             self.exchange_hyperparameters = exchange_hyperparameters
             self.weights_names = make_iterable(weights_names)
             self.checkpoint_dir = checkpoint_dir
+            self.chunk_bytes = chunk_bytes
 
         def export_proto(self):
             """Get a protobuf representation of this object."""
@@ -324,6 +381,11 @@ class RandomPairwiseExchange(MetaLearningStrategy):
                     raise Exception("Must provide checkpoint dir")
             elif self.strategy == "sendrecv_weights":
                 msg.sendrecv_weights.exchange_hyperparameters = self.exchange_hyperparameters
+            elif self.strategy == "stream_weights":
+                StreamWeightsMsg = ExchangeStrategyMsg.StreamWeights
+                msg.stream_weights.CopyFrom(StreamWeightsMsg())
+                if self.chunk_bytes:
+                    msg.stream_weights.chunk_bytes = self.chunk_bytes
             else:
                 raise ValueError("Unknown strategy")
             return msg
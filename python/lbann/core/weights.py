@@ -27,12 +27,30 @@ class Weights:
 
     global_count = 0  # Static counter, used for default names
 
-    def __init__(self, initializer=None, optimizer=None, name=None, datatype=None):
+    def __init__(self, initializer=None, optimizer=None, name=None, datatype=None,
+                 gradient_compression=None, topk_ratio=None,
+                 quantization_bits=None, powersgd_rank=None):
+        """
+        Args:
+            gradient_compression (str, optional): Lossy compression of
+                gradient allreduces ('topk', 'quantize', or
+                'powersgd').
+            topk_ratio (float, optional): Fraction of gradient entries
+                sent with top-k sparsification.
+            quantization_bits (int, optional): Bits per gradient entry
+                with quantization (1 or 8).
+            powersgd_rank (int, optional): Rank of PowerSGD
+                approximation.
+        """
         Weights.global_count += 1
         self.name = name if name else 'weights{0}'.format(Weights.global_count)
         self.initializer = initializer
         self.optimizer = optimizer
         self.datatype = datatype
+        self.gradient_compression = gradient_compression
+        self.topk_ratio = topk_ratio
+        self.quantization_bits = quantization_bits
+        self.powersgd_rank = powersgd_rank
 
     def export_proto(self):
         """Construct and return a protobuf message."""
@@ -53,4 +71,14 @@ class Weights:
         if self.datatype:
             proto.datatype = self.datatype
 
+        # Set gradient compression if needed
+        if self.gradient_compression:
+            proto.gradient_compression.type = self.gradient_compression
+            if self.topk_ratio is not None:
+                proto.gradient_compression.topk_ratio = self.topk_ratio
+            if self.quantization_bits is not None:
+                proto.gradient_compression.quantization_bits = self.quantization_bits
+            if self.powersgd_rank is not None:
+                proto.gradient_compression.powersgd_rank = self.powersgd_rank
+
         return proto
@@ -32,9 +32,11 @@
 
 #include "lbann/models/model.hpp"
 #include "lbann/utils/serialize.hpp"
+#include "lbann/utils/timer.hpp"
 
 #include <callbacks.pb.h>
 
+#include <future>
 #include <memory>
 #include <string>
 
@@ -67,6 +69,7 @@ void checkpoint::on_train_end(model *m) {
     do_checkpoint(m, visitor_hook::execution_mode_end);
   }
   p.set_cb_type(callback_type::invalid);
+  finish_async_checkpoints(*m->get_comm());
 }
 
 // Interval defined with checkpoint_epochs or ckpt_dist_epochs
@@ -161,6 +164,13 @@ bool checkpoint::do_checkpoint(model *m, visitor_hook hook) {
   if (get_checkpoint_dir().length() == 0 && m_per_rank_dir.length() == 0) {
     return false;
   }
+  lbann_comm *comm = m->get_comm();
+  // Time during which training is blocked, including waiting for
+  // earlier asynchronous checkpoints to drain
+  const double stall_start = get_time();
+  if (m_async) {
+    finish_async_checkpoints(*comm, m_max_in_flight - 1);
+  }
   // time how long this takes
   // read current epoch and step counters from model
   El::Timer timer;
@@ -168,7 +178,6 @@ bool checkpoint::do_checkpoint(model *m, visitor_hook hook) {
   std::string latest_file;
   size_t epoch = std::numeric_limits<size_t>::max();
   size_t step = std::numeric_limits<size_t>::max();
-  lbann_comm *comm = m->get_comm();
   // TODO: we would want to prepend dir with the model name and model rank:
   // m->get_name() + '.' + std::to_string(comm->get_trainer_rank()) + '.'
   // However, rng state is not part of model state but that of the world.
@@ -189,10 +198,15 @@ bool checkpoint::do_checkpoint(model *m, visitor_hook hook) {
   comm->trainer_broadcast(0, epoch);
   comm->trainer_broadcast(0, step);
 
+  // Asynchronous checkpoints snapshot the model into host memory
+  // here and write it out in the background
+  p.set_staging(m_async);
+  std::vector<std::string> latest_files;
+
   // Distributed ckpt
   if (m_checkpoint_dist)
   {
-    this->do_distributed_checkpoint(
+    auto latest_file = this->do_distributed_checkpoint(
       *comm,
       t,  /* trainer */
       *m, /* model   */
@@ -201,11 +215,14 @@ bool checkpoint::do_checkpoint(model *m, visitor_hook hook) {
       p,  /* persist */
       epoch,
       step);
+    if (!latest_file.empty()) {
+      latest_files.push_back(std::move(latest_file));
+    }
   }
   // Shared checkpoint
   if (m_checkpoint_shared)
   {
-    this->do_shared_checkpoint(
+    auto latest_file = this->do_shared_checkpoint(
       *comm,
       t,  /* trainer */
       *m, /* model   */
@@ -214,10 +231,53 @@ bool checkpoint::do_checkpoint(model *m, visitor_hook hook) {
       p,  /* persist */
       epoch,
       step);
+    if (!latest_file.empty()) {
+      latest_files.push_back(std::move(latest_file));
+    }
   }
+  p.set_staging(false);
 
   uint64_t bytes_count = p.get_bytes();
 
+  if (m_async) {
+    async_checkpoint ckpt;
+    ckpt.write = std::async(
+      std::launch::async,
+      [files = p.take_staged_files()]() {
+        const double start = get_time();
+        const uint64_t bytes = write_staged_files(files);
+        return std::make_pair(bytes, EvalType(get_time() - start));
+      }).share();
+    ckpt.latest_files = std::move(latest_files);
+    ckpt.label = build_string(
+      m->get_name(), ".", comm->get_trainer_rank(), "] Checkpoint [",
+      (is_execution_mode_hook(hook) ? to_string(hook, c.get_execution_mode()) : to_string(hook)),
+      "] to ", get_checkpoint_dir());
+    ckpt.hook = hook;
+    ckpt.mode = c.get_execution_mode();
+    ckpt.epoch = epoch;
+    ckpt.step = step;
+    ckpt.stall_secs = get_time() - stall_start;
+    if (comm->am_trainer_master()) {
+      std::cout << "[" << ckpt.label
+                << " staged: Epoch=" << epoch
+                << " Step=" << step
+                << " (" << ckpt.stall_secs << " secs, " << bytes_count
+                << " bytes), writing in background" << std::endl;
+      fflush(stdout);
+    }
+    m_in_flight.push_back(std::move(ckpt));
+    m_checkpoint_last = MPI_Wtime();
+    p.reset_bytes();
+    return true;
+  }
+
+  if (comm->am_trainer_master()) {
+    for (const auto& latest_file : latest_files) {
+      write_latest(latest_file, hook, c.get_execution_mode(), epoch, step);
+    }
+  }
+
   if (comm->am_trainer_master()) {
     EvalType secs = timer.Stop();
     EvalType bw = 0;
@@ -240,6 +300,48 @@ bool checkpoint::do_checkpoint(model *m, visitor_hook hook) {
   return true;
 }
 
+checkpoint::~checkpoint() {
+  // Join background writes left behind by an early exit. Errors
+  // are dropped since destructors must not throw.
+  for (auto& ckpt : m_in_flight) {
+    if (ckpt.write.valid()) {
+      ckpt.write.wait();
+    }
+  }
+}
+
+void checkpoint::finish_async_checkpoints(lbann_comm& comm,
+                                          size_t max_remaining) {
+  while (m_in_flight.size() > max_remaining) {
+    auto ckpt = std::move(m_in_flight.front());
+    m_in_flight.pop_front();
+    // Rethrows any error from the background write
+    const auto result = ckpt.write.get();
+    const uint64_t bytes_count = result.first;
+    const EvalType write_secs = result.second;
+
+    // Only advertise the checkpoint once every rank has written its
+    // part, so a restart never finds a partial checkpoint
+    comm.trainer_barrier();
+    if (comm.am_trainer_master()) {
+      for (const auto& latest_file : ckpt.latest_files) {
+        write_latest(latest_file, ckpt.hook, ckpt.mode, ckpt.epoch, ckpt.step);
+      }
+      EvalType bw = 0;
+      if (write_secs > 0.0) {
+        bw = EvalType(bytes_count) / (write_secs * 1024.0 * 1024.0);
+      }
+      std::cout << "[" << ckpt.label
+                << " complete: Epoch=" << ckpt.epoch
+                << " Step=" << ckpt.step
+                << " (stall " << ckpt.stall_secs << " secs, write "
+                << write_secs << " secs, " << bytes_count << " bytes, "
+                << bw << " MB/sec)" << std::endl;
+      fflush(stdout);
+    }
+  }
+}
+
 std::string checkpoint::find_latest_checkpoint(lbann_comm& comm,
                                                const std::string& trainer_name,
                                                const std::string& alg_name,
@@ -456,7 +558,7 @@ bool checkpoint::restart(model *m) {
     });
 }
 
-void checkpoint::do_distributed_checkpoint(
+std::string checkpoint::do_distributed_checkpoint(
   lbann_comm& comm,
   trainer& t,
   model& m,
@@ -467,7 +569,7 @@ void checkpoint::do_distributed_checkpoint(
   size_t step)
 {
   if(!m_checkpoint_dist)
-    return;
+    return {};
 
   // Prepend per rank directory with shared checkpoint dir name
   // Per rank directory typically a cache location like node local SSDs
@@ -526,23 +628,18 @@ void checkpoint::do_distributed_checkpoint(
   }
   p.close_checkpoint();
 
-  // Print latest checkpoint to file
+  // The caller prints the latest checkpoint to file
   if (comm.am_trainer_master())
   {
-    auto const latest_file = get_last_distributed_checkpoint_filename(
+    return get_last_distributed_checkpoint_filename(
       t.get_name(),
       this->get_active_training_algorithm().get_type(),
       dir);
-    write_latest(
-      latest_file,
-      hook,
-      mode,
-      epoch,
-      step);
   }
+  return {};
 }
 
-void checkpoint::do_shared_checkpoint(
+std::string checkpoint::do_shared_checkpoint(
   lbann_comm& comm,
   trainer& t,
   model& m,
@@ -553,7 +650,7 @@ void checkpoint::do_shared_checkpoint(
   size_t step)
 {
   if(!m_checkpoint_shared)
-    return;
+    return {};
 
   auto const dir = this->get_checkpoint_dir();
   makedir(dir.c_str());
@@ -584,12 +681,12 @@ void checkpoint::do_shared_checkpoint(
   // close our checkpoint
   p.close_checkpoint();
   if (comm.am_trainer_master()) {
-    auto const latest_file = get_last_shared_checkpoint_filename(
+    return get_last_shared_checkpoint_filename(
       t.get_name(),
       this->get_active_training_algorithm().get_type(),
       dir);
-    write_latest(latest_file, hook, mode, epoch, step);
   }
+  return {};
 }
 
 std::unique_ptr<callback_base>
@@ -604,7 +701,9 @@ build_checkpoint_callback_from_pbuf(
                                  params.checkpoint_secs(),
                                  params.per_rank_dir(),
                                  params.ckpt_dist_epochs(),
-                                 params.ckpt_dist_steps());
+                                 params.ckpt_dist_steps(),
+                                 params.asynchronous(),
+                                 params.max_in_flight());
 }
 
 } // namespace callback
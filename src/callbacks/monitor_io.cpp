@@ -46,20 +46,42 @@ void monitor_io::serialize(Archive & ar) {
      CEREAL_NVP(m_layers));
 }
 
+namespace {
+
+/** @brief Report and reset time spent waiting for data. */
+void report_data_wait(lbann_comm& comm,
+                      data_coordinator& dc,
+                      execution_mode mode) {
+  const auto stats = dc.get_data_wait_statistics(mode);
+  if (stats.num_mini_batches > 0) {
+    std::cout << "Rank " << comm.get_trainer_rank() << "."
+              << comm.get_rank_in_trainer() << " waited "
+              << stats.total_time << "s for " << to_string(mode)
+              << " data over " << stats.num_mini_batches
+              << " mini-batches (mean "
+              << stats.total_time / stats.num_mini_batches
+              << "s, max " << stats.max_time << "s)" << std::endl;
+  }
+  dc.reset_data_wait_statistics(mode);
+}
+
+} // namespace
+
 void monitor_io::on_epoch_end(model *m) {
   const auto& c = static_cast<const sgd_execution_context&>(m->get_execution_context());
-  const data_coordinator& dc = get_const_trainer().get_data_coordinator();
+  data_coordinator& dc = get_trainer().get_data_coordinator();
   lbann_comm *comm = m->get_comm();
   std::cout << "Rank " << comm->get_trainer_rank() << "."
             << comm->get_rank_in_trainer() << " processed "
             << dc.get_num_samples(execution_mode::training) << " training samples of "
             << dc.get_total_num_samples(execution_mode::training) << " ("
             << dc.get_num_samples(execution_mode::training) / c.get_epoch() << " per epoch)" << std::endl;
+  report_data_wait(*comm, dc, execution_mode::training);
 }
 
 void monitor_io::on_test_end(model *m) {
   const auto& c = static_cast<const sgd_execution_context&>(m->get_execution_context());
-  const data_coordinator& dc = get_const_trainer().get_data_coordinator();
+  data_coordinator& dc = get_trainer().get_data_coordinator();
   lbann_comm *comm = m->get_comm();
   std::cout << "Rank " << comm->get_trainer_rank() << "."
             << comm->get_rank_in_trainer() << " processed "
@@ -67,6 +89,7 @@ void monitor_io::on_test_end(model *m) {
             << dc.get_total_num_samples(execution_mode::testing) << " ("
             << dc.get_num_samples(execution_mode::testing) / c.get_epoch()
             << " per epoch)" << std::endl;
+  report_data_wait(*comm, dc, execution_mode::testing);
 }
 
 std::unique_ptr<callback_base>
@@ -0,0 +1,441 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/callbacks/trace.hpp"
+
+#include "lbann/comm_impl.hpp"
+#include "lbann/data_coordinator/data_coordinator.hpp"
+#include "lbann/layers/data_type_layer.hpp"
+#include "lbann/models/model.hpp"
+#include "lbann/optimizers/optimizer.hpp"
+#include "lbann/trainers/trainer.hpp"
+#include "lbann/utils/memory.hpp"
+#include "lbann/utils/serialize.hpp"
+#include "lbann/utils/timer.hpp"
+#include "lbann/weights/data_type_weights.hpp"
+
+#include <callbacks.pb.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace lbann {
+namespace callback {
+
+namespace {
+
+/** Names of the reserved entries at the start of the name table. */
+constexpr size_t step_id = 0;
+constexpr size_t data_wait_id = 1;
+
+/** Number of event types with a column in the summary (see
+ *  trace::summary_index). */
+constexpr size_t num_summary_types = 4;
+
+std::string json_escape(const std::string& str) {
+  std::string out;
+  out.reserve(str.size());
+  for (const char c : str) {
+    if (c == '"' || c == '\\') {
+      out += '\\';
+      out += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      out += ' ';
+    } else {
+      out += c;
+    }
+  }
+  return out;
+}
+
+/** @brief Size of a layer's tensor entries, or 0 if the data type is
+ *  not known. */
+size_t get_element_size(const Layer& l) {
+#define PROTO(T)                                                \
+  if (dynamic_cast<const data_type_layer<T>*>(&l) != nullptr) { \
+    return sizeof(T);                                           \
+  }
+#define LBANN_INSTANTIATE_CPU_HALF
+#define LBANN_INSTANTIATE_GPU_HALF
+#include "lbann/macros/instantiate.hpp"
+#undef PROTO
+  return 0;
+}
+
+/** @brief Size of a weights' entries, or 0 if the data type is not
+ *  known. */
+size_t get_element_size(const weights& w) {
+#define PROTO(T)                                                  \
+  if (dynamic_cast<const data_type_weights<T>*>(&w) != nullptr) { \
+    return sizeof(T);                                             \
+  }
+#include "lbann/macros/instantiate.hpp"
+#undef PROTO
+#undef LBANN_INSTANTIATE_CPU_HALF
+#undef LBANN_INSTANTIATE_GPU_HALF
+  return 0;
+}
+
+size_t get_activation_bytes(const Layer& l) {
+  const size_t element_size = get_element_size(l);
+  size_t bytes = 0;
+  for (const auto* child : l.get_child_layers()) {
+    const auto& acts = l.get_activations(*child);
+    bytes += acts.LocalHeight() * acts.LocalWidth() * element_size;
+  }
+  return bytes;
+}
+
+size_t get_error_signal_bytes(const Layer& l) {
+  const size_t element_size = get_element_size(l);
+  size_t bytes = 0;
+  for (const auto* parent : l.get_parent_layers()) {
+    const auto& grads = l.get_error_signals(*parent);
+    bytes += grads.LocalHeight() * grads.LocalWidth() * element_size;
+  }
+  return bytes;
+}
+
+size_t get_gradient_bytes(const weights& w) {
+  const auto& values = w.get_values();
+  return values.LocalHeight() * values.LocalWidth() * get_element_size(w);
+}
+
+} // namespace
+
+trace::trace()
+  : trace("")
+{}
+
+template <class Archive>
+void trace::serialize(Archive & ar) {
+  ar(::cereal::make_nvp(
+       "BaseCallback",
+       ::cereal::base_class<callback_base>(this)),
+     CEREAL_NVP(m_outdir),
+     CEREAL_NVP(m_top_n),
+     CEREAL_NVP(m_start_step),
+     CEREAL_NVP(m_num_steps));
+}
+
+EvalType trace::get_rel_time() const {
+  return get_time() - m_start_time;
+}
+
+void trace::on_train_begin(model *m) {
+  // Layers and weights get consecutive ids in model order, which is
+  // the same on every rank of the trainer
+  m_names = {"step", "data wait"};
+  m_layer_ids.clear();
+  m_weights_ids.clear();
+  for (const auto* l : m->get_layers()) {
+    m_layer_ids.emplace(l->get_name(), m_names.size());
+    m_names.push_back(l->get_name());
+  }
+  for (const auto* w : m->get_weights()) {
+    m_weights_ids.emplace(w->get_name(), m_names.size());
+    m_names.push_back(w->get_name());
+  }
+  m_events.clear();
+  m_step = 0;
+  m_recording = false;
+  // Ensure the model is synchronized at the start.
+  m->get_comm()->trainer_barrier();
+  m_start_time = get_time();
+}
+
+void trace::on_batch_begin(model *m) {
+  m_recording = (m_step >= m_start_step
+                 && (m_num_steps == 0 || m_step < m_start_step + m_num_steps));
+  m_step_start_time = get_rel_time();
+}
+
+void trace::on_batch_end(model *m) {
+  ++m_step;
+  if (!m_recording) { return; }
+  const EvalType end = get_rel_time();
+  m_events.push_back({step_id, event_type::step, m_step_start_time,
+                      end - m_step_start_time, 0});
+  // The data coordinator only reports how long the last fetch blocked,
+  // so the wait is placed at the start of the step on its own track
+  const auto wait_stats = get_trainer().get_data_coordinator()
+    .get_data_wait_statistics(execution_mode::training);
+  m_events.push_back({data_wait_id, event_type::data_wait, m_step_start_time,
+                      wait_stats.last_time, 0});
+}
+
+void trace::on_forward_prop_begin(model *m, Layer *l) {
+  m_fp_start_time = get_rel_time();
+}
+
+void trace::on_forward_prop_end(model *m, Layer *l) {
+  if (!m_recording) { return; }
+  const EvalType end = get_rel_time();
+  m_events.push_back({m_layer_ids.at(l->get_name()), event_type::forward,
+                      m_fp_start_time, end - m_fp_start_time,
+                      get_activation_bytes(*l)});
+}
+
+void trace::on_backward_prop_begin(model *m, Layer *l) {
+  m_bp_start_time = get_rel_time();
+}
+
+void trace::on_backward_prop_end(model *m, Layer *l) {
+  if (!m_recording) { return; }
+  const EvalType end = get_rel_time();
+  m_events.push_back({m_layer_ids.at(l->get_name()), event_type::backward,
+                      m_bp_start_time, end - m_bp_start_time,
+                      get_error_signal_bytes(*l)});
+}
+
+void trace::on_optimize_begin(model *m, weights *w) {
+  const auto* opt = w->get_optimizer();
+  m_opt_start_allreduce_wait = (opt ? opt->get_allreduce_wait_time() : 0);
+  m_opt_start_time = get_rel_time();
+}
+
+void trace::on_optimize_end(model *m, weights *w) {
+  if (!m_recording) { return; }
+  const EvalType end = get_rel_time();
+  const size_t id = m_weights_ids.at(w->get_name());
+  const size_t bytes = get_gradient_bytes(*w);
+  m_events.push_back({id, event_type::optimize, m_opt_start_time,
+                      end - m_opt_start_time, bytes});
+  // The optimizer finishes the gradient allreduce before it does
+  // anything else, so the wait starts with the optimizer step
+  if (const auto* opt = w->get_optimizer()) {
+    const EvalType wait =
+      opt->get_allreduce_wait_time() - m_opt_start_allreduce_wait;
+    m_events.push_back({id, event_type::allreduce_wait, m_opt_start_time,
+                        wait, bytes});
+  }
+}
+
+void trace::on_train_end(model *m) {
+  const auto& comm = *m->get_comm();
+  const std::string path = m_outdir + "/trace.t" +
+    std::to_string(comm.get_trainer_rank()) + ".r" +
+    std::to_string(comm.get_rank_in_trainer()) + ".json";
+  write_chrome_trace(path, comm.get_rank_in_trainer());
+  write_summary(*m);
+}
+
+void trace::write_chrome_trace(const std::string& path, int pid) const {
+  std::ofstream f(path);
+  if (!f) {
+    LBANN_ERROR("failed to open ", path, " for writing");
+  }
+  f << std::fixed << std::setprecision(3);
+  f << "{\"traceEvents\":[\n";
+  f << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << pid
+    << ",\"args\":{\"name\":\"rank " << pid << "\"}},\n";
+  f << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid
+    << ",\"tid\":0,\"args\":{\"name\":\"compute\"}},\n";
+  f << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid
+    << ",\"tid\":1,\"args\":{\"name\":\"data\"}}";
+  for (const auto& e : m_events) {
+    const int tid = (e.type == event_type::data_wait ? 1 : 0);
+    f << ",\n{\"name\":\"" << json_escape(m_names[e.name])
+      << "\",\"cat\":\"" << event_type_name(e.type)
+      << "\",\"ph\":\"X\",\"pid\":" << pid << ",\"tid\":" << tid
+      << ",\"ts\":" << e.start * 1e6
+      << ",\"dur\":" << e.duration * 1e6;
+    if (e.bytes > 0) {
+      f << ",\"args\":{\"bytes\":" << e.bytes << "}";
+    }
+    f << "}";
+  }
+  f << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+std::string trace::event_type_name(event_type type) {
+  switch (type) {
+  case event_type::step: return "step";
+  case event_type::forward: return "forward";
+  case event_type::backward: return "backward";
+  case event_type::optimize: return "optimize";
+  case event_type::allreduce_wait: return "allreduce_wait";
+  case event_type::data_wait: return "data_wait";
+  }
+  return "unknown";
+}
+
+size_t trace::summary_index(event_type type) {
+  switch (type) {
+  case event_type::forward: return 0;
+  case event_type::backward: return 1;
+  case event_type::optimize: return 2;
+  case event_type::allreduce_wait: return 3;
+  case event_type::step:
+  case event_type::data_wait:
+    break;
+  }
+  LBANN_ERROR("event type ", event_type_name(type),
+              " has no column in the trace summary");
+  return 0;
+}
+
+trace::event_type trace::summary_type(size_t index) {
+  switch (index) {
+  case 0: return event_type::forward;
+  case 1: return event_type::backward;
+  case 2: return event_type::optimize;
+  case 3: return event_type::allreduce_wait;
+  default:
+    LBANN_ERROR("invalid trace summary column (", index, ")");
+  }
+  return event_type::step;
+}
+
+void trace::write_summary(model& m) const {
+  const auto& comm = *m.get_comm();
+
+  // Per-rank totals for each name and event type (forward, backward,
+  // optimize, allreduce wait)
+  const int num_entries = m_names.size() * num_summary_types;
+  std::vector<EvalType> totals(num_entries, 0);
+  std::vector<EvalType> bytes(num_entries, 0);
+  EvalType step_total = 0;
+  EvalType data_wait_total = 0;
+  for (const auto& e : m_events) {
+    switch (e.type) {
+    case event_type::step:
+      step_total += e.duration;
+      break;
+    case event_type::data_wait:
+      data_wait_total += e.duration;
+      break;
+    default:
+      {
+        const size_t idx = e.name * num_summary_types
+          + summary_index(e.type);
+        totals[idx] += e.duration;
+        bytes[idx] = std::max(bytes[idx], EvalType(e.bytes));
+      }
+    }
+  }
+  totals[step_id * num_summary_types] = step_total;
+  totals[data_wait_id * num_summary_types] = data_wait_total;
+
+  // Reduce across the trainer
+  const int num_ranks = comm.get_procs_per_trainer();
+  std::vector<EvalType> min_totals(num_entries), max_totals(num_entries),
+    sum_totals(num_entries), max_bytes(num_entries);
+  comm.trainer_allreduce(totals.data(), num_entries, min_totals.data(),
+                         El::mpi::MIN);
+  comm.trainer_allreduce(totals.data(), num_entries, max_totals.data(),
+                         El::mpi::MAX);
+  comm.trainer_allreduce(totals.data(), num_entries, sum_totals.data(),
+                         El::mpi::SUM);
+  comm.trainer_allreduce(bytes.data(), num_entries, max_bytes.data(),
+                         El::mpi::MAX);
+  std::vector<EvalType> my_step_total(num_ranks, 0);
+  std::vector<EvalType> rank_step_totals(num_ranks, 0);
+  my_step_total[comm.get_rank_in_trainer()] = step_total;
+  comm.trainer_allreduce(my_step_total.data(), num_ranks,
+                         rank_step_totals.data(), El::mpi::SUM);
+
+  if (!comm.am_trainer_master()) { return; }
+
+  // Sort entries by mean time, most expensive first
+  std::vector<size_t> order;
+  for (size_t idx = (data_wait_id + 1) * num_summary_types; idx < totals.size(); ++idx) {
+    if (max_totals[idx] > 0) {
+      order.push_back(idx);
+    }
+  }
+  std::stable_sort(order.begin(), order.end(),
+                   [&sum_totals](size_t a, size_t b) {
+                     return sum_totals[a] > sum_totals[b];
+                   });
+
+  const auto slowest = std::max_element(rank_step_totals.cbegin(),
+                                        rank_step_totals.cend());
+  const auto fastest = std::min_element(rank_step_totals.cbegin(),
+                                        rank_step_totals.cend());
+
+  std::ostringstream ss;
+  ss << std::fixed << std::setprecision(6);
+  ss << "trace summary for model " << m.get_name()
+     << " (trainer " << comm.get_trainer_rank() << ", "
+     << num_ranks << " ranks)\n"
+     << "step time: min " << min_totals[0]
+     << "s, mean " << sum_totals[0] / num_ranks
+     << "s, max " << max_totals[0] << "s"
+     << " (slowest rank " << std::distance(rank_step_totals.cbegin(), slowest)
+     << ", fastest rank " << std::distance(rank_step_totals.cbegin(), fastest)
+     << ")\n"
+     << "data wait: min " << min_totals[data_wait_id * num_summary_types]
+     << "s, mean " << sum_totals[data_wait_id * num_summary_types] / num_ranks
+     << "s, max " << max_totals[data_wait_id * num_summary_types] << "s\n";
+  ss << std::left << std::setw(32) << "name" << std::setw(16) << "type"
+     << std::right << std::setw(14) << "min (s)" << std::setw(14) << "mean (s)"
+     << std::setw(14) << "max (s)" << std::setw(16) << "max bytes" << "\n";
+  size_t count = 0;
+  std::string top_entries;
+  for (const auto& idx : order) {
+    ss << std::left << std::setw(32) << m_names[idx / num_summary_types]
+       << std::setw(16) << event_type_name(summary_type(idx % num_summary_types))
+       << std::right << std::setw(14) << min_totals[idx]
+       << std::setw(14) << sum_totals[idx] / num_ranks
+       << std::setw(14) << max_totals[idx]
+       << std::setw(16) << static_cast<size_t>(max_bytes[idx]) << "\n";
+    if (++count == m_top_n) {
+      top_entries = ss.str();
+    }
+  }
+  if (top_entries.empty()) {
+    top_entries = ss.str();
+  }
+
+  const std::string path = m_outdir + "/trace.t" +
+    std::to_string(comm.get_trainer_rank()) + ".summary.txt";
+  std::ofstream f(path);
+  f << ss.str();
+  std::cout << top_entries << std::flush;
+}
+
+std::unique_ptr<callback_base>
+build_trace_callback_from_pbuf(
+  const google::protobuf::Message& proto_msg, std::shared_ptr<lbann_summary> const&) {
+  const auto& params =
+    dynamic_cast<const lbann_data::Callback::CallbackTrace&>(proto_msg);
+  return make_unique<trace>(params.directory(),
+                            params.top_n() > 0 ? params.top_n() : 10,
+                            params.start_step(),
+                            params.num_steps());
+}
+
+} // namespace callback
+} // namespace lbann
+
+#define LBANN_CLASS_NAME callback::trace
+#include <lbann/macros/register_class_with_cereal.hpp>
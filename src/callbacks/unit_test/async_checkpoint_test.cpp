@@ -0,0 +1,313 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <catch2/catch.hpp>
+
+#include "TestHelpers.hpp"
+#include "MPITestHelpers.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/callbacks/checkpoint.hpp>
+#include <lbann/comm_impl.hpp>
+#include <lbann/execution_contexts/sgd_execution_context.hpp>
+#include <lbann/io/file_io.hpp>
+#include <lbann/io/persist.hpp>
+#include <lbann/models/model.hpp>
+#include <lbann/objective_functions/objective_function.hpp>
+#include <lbann/proto/factories.hpp>
+#include <lbann/utils/lbann_library.hpp>
+#include <lbann/utils/memory.hpp>
+#include <lbann/utils/timer.hpp>
+#include <lbann/weights/data_type_weights.hpp>
+
+#include <lbann.pb.h>
+#include <google/protobuf/text_format.h>
+
+#include <chrono>
+#include <fstream>
+#include <thread>
+#include <unistd.h>
+
+namespace pb = ::google::protobuf;
+
+class CheckpointWhiteboxTester
+{
+public:
+  /** Queue a background write the same way do_checkpoint does. */
+  void start_async_write(lbann::callback::checkpoint& cb,
+                         std::vector<lbann::staged_file> files,
+                         std::vector<std::string> latest_files,
+                         std::chrono::milliseconds delay)
+  {
+    lbann::callback::checkpoint::async_checkpoint ckpt;
+    ckpt.write = std::async(
+      std::launch::async,
+      [files = std::move(files), delay]() {
+        std::this_thread::sleep_for(delay);
+        const double start = lbann::get_time();
+        const uint64_t bytes = lbann::write_staged_files(files);
+        return std::make_pair(bytes, lbann::EvalType(lbann::get_time() - start));
+      }).share();
+    ckpt.latest_files = std::move(latest_files);
+    ckpt.label = "async_checkpoint_test";
+    ckpt.hook = lbann::visitor_hook::epoch_begin;
+    ckpt.mode = lbann::execution_mode::training;
+    ckpt.epoch = 1;
+    ckpt.step = 1;
+    ckpt.stall_secs = 0;
+    cb.m_in_flight.push_back(std::move(ckpt));
+  }
+
+  size_t get_num_in_flight(const lbann::callback::checkpoint& cb) const
+  {
+    return cb.m_in_flight.size();
+  }
+};
+
+namespace {
+
+using WeightsType = lbann::data_type_weights<lbann::DataType>;
+
+std::string const model_prototext = R"ptext(
+model {
+  objective_function {
+    layer_term {
+      scale_factor: 1.0
+      layer: "l2"
+    }
+  }
+  layer {
+    name: "x"
+    weights: "x_w"
+    weights_layer {
+      dims: "4"
+    }
+  }
+  layer {
+    name: "fc"
+    parents: "x"
+    weights: "fc_w"
+    fully_connected {
+      num_neurons: 3
+      has_bias: false
+    }
+  }
+  layer {
+    name: "l2"
+    parents: "fc"
+    l2_norm2 {
+    }
+  }
+  weights {
+    name: "x_w"
+    initializer {
+      value_initializer {
+        values: "0.5 -0.3 0.8 0.1"
+      }
+    }
+  }
+  weights {
+    name: "fc_w"
+    initializer {
+      uniform_initializer {
+        min: -1
+        max: 1
+      }
+    }
+  }
+}
+optimizer {
+  sgd {
+    learn_rate: 0.1
+    momentum: 0.9
+  }
+}
+)ptext";
+
+auto make_model(lbann::lbann_comm& comm)
+{
+  lbann_data::LbannPB my_proto;
+  if (!pb::TextFormat::ParseFromString(model_prototext, &my_proto))
+    throw "Parsing protobuf failed.";
+  lbann::construct_trainer(&comm, my_proto.mutable_trainer(), my_proto);
+  return lbann::proto::construct_model(&comm,
+                                       -1,
+                                       my_proto.optimizer(),
+                                       my_proto.trainer(),
+                                       my_proto.model());
+}
+
+/** @brief Run the same steps as sgd_training_algorithm::train_mini_batch */
+void train_step(lbann::model& m, size_t mini_batch_size)
+{
+  auto const mode = lbann::execution_mode::training;
+  lbann::sgd_execution_context c(mode, mini_batch_size);
+  m.reset_mode(c, mode);
+  m.clear_gradients();
+  m.forward_prop(mode);
+  auto& obj = *m.get_objective_function();
+  obj.start_evaluation(mode, mini_batch_size);
+  obj.differentiate();
+  m.backward_prop();
+  obj.compute_weight_regularization();
+  obj.finish_evaluation(mode, mini_batch_size);
+  m.update_weights();
+  m.reset_mode(c, lbann::execution_mode::invalid);
+}
+
+std::vector<El::Matrix<lbann::DataType>>
+get_local_values(const lbann::model& m)
+{
+  std::vector<El::Matrix<lbann::DataType>> values;
+  for (auto const* w : m.get_weights()) {
+    auto const& dtw = dynamic_cast<WeightsType const&>(*w);
+    values.emplace_back(dtw.get_values().LockedMatrix());
+  }
+  return values;
+}
+
+void check_same_values(const std::vector<El::Matrix<lbann::DataType>>& expected,
+                       const std::vector<El::Matrix<lbann::DataType>>& actual)
+{
+  REQUIRE(expected.size() == actual.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    INFO("weights " << i);
+    REQUIRE(expected[i].Height() == actual[i].Height());
+    REQUIRE(expected[i].Width() == actual[i].Width());
+    for (El::Int col = 0; col < expected[i].Width(); ++col) {
+      for (El::Int row = 0; row < expected[i].Height(); ++row) {
+        CHECK(actual[i](row, col) == expected[i](row, col));
+      }
+    }
+  }
+}
+
+/** @brief Directory shared by the ranks of the trainer */
+std::string make_checkpoint_dir(lbann::lbann_comm& comm,
+                                std::string const& name)
+{
+  int pid = getpid();
+  comm.trainer_broadcast(0, pid);
+  auto const dir =
+    "/tmp/async_checkpoint_test_" + name + "_" + std::to_string(pid);
+  if (comm.am_trainer_master()) {
+    lbann::makedir(dir.c_str());
+  }
+  comm.trainer_barrier();
+  return dir;
+}
+
+size_t get_file_size(std::string const& filename)
+{
+  std::ifstream ifs(filename, std::ios::binary | std::ios::ate);
+  return ifs.good() ? static_cast<size_t>(ifs.tellg()) : 0;
+}
+
+} // namespace <anon>
+
+TEST_CASE("Asynchronous checkpoints", "[mpi][callback][checkpoint]")
+{
+  auto& comm = unit_test::utilities::current_world_comm();
+  size_t const mini_batch_size = 3;
+  lbann::DataReaderMetaData metadata;
+  CheckpointWhiteboxTester tester;
+
+  SECTION("Overlapped checkpoint restores identical weights")
+  {
+    auto const dir = make_checkpoint_dir(comm, "restart");
+    auto m = make_model(comm);
+    m->setup(mini_batch_size, metadata);
+    train_step(*m, mini_batch_size);
+    auto const checkpointed_values = get_local_values(*m);
+
+    // Snapshot the model into host memory
+    lbann::persist p;
+    p.open_checkpoint(dir, comm.am_trainer_master());
+    p.set_staging(true);
+    m->save_to_checkpoint_shared(p);
+    p.set_staging(false);
+    p.close_checkpoint();
+    auto files = p.take_staged_files();
+    std::vector<std::string> latest_files;
+    if (comm.am_trainer_master()) {
+      REQUIRE(files.size() == 1);
+      CHECK_FALSE(lbann::exists(files.front().filename.c_str()));
+      latest_files.push_back(dir + "/last.shared.checkpoint");
+    }
+    else {
+      CHECK(files.empty());
+    }
+
+    // Train while the checkpoint is being written
+    lbann::callback::checkpoint cb(dir, dir, 0, 0, 0, "", 0, 0, true, 1);
+    tester.start_async_write(cb,
+                             std::move(files),
+                             latest_files,
+                             std::chrono::milliseconds(100));
+    train_step(*m, mini_batch_size);
+    cb.finish_async_checkpoints(comm);
+    CHECK(tester.get_num_in_flight(cb) == 0);
+    for (auto const& latest_file : latest_files) {
+      CHECK(lbann::exists(latest_file.c_str()));
+    }
+
+    // Restart a new model from the checkpoint
+    auto restored = make_model(comm);
+    lbann::persist p_restart;
+    p_restart.open_restart(dir);
+    restored->load_from_checkpoint_shared(p_restart);
+    p_restart.close_restart();
+    restored->setup(mini_batch_size, metadata);
+    check_same_values(checkpointed_values, get_local_values(*restored));
+
+    // Optimizer state is restored too, so the next step matches
+    train_step(*restored, mini_batch_size);
+    check_same_values(get_local_values(*m), get_local_values(*restored));
+  }
+
+  SECTION("Destructor joins a pending write")
+  {
+    auto const dir = make_checkpoint_dir(comm, "destructor");
+    auto const filename =
+      dir + "/pending_" + std::to_string(comm.get_rank_in_trainer()) + ".bin";
+    auto const latest_file =
+      dir + "/latest_" + std::to_string(comm.get_rank_in_trainer());
+    std::string const contents(1 << 20, 'x');
+
+    auto cb = lbann::make_unique<lbann::callback::checkpoint>(
+      dir, dir, 0, 0, 0, "", 0, 0, true, 1);
+    tester.start_async_write(*cb,
+                             {lbann::staged_file{filename, contents}},
+                             {latest_file},
+                             std::chrono::milliseconds(200));
+    cb.reset();
+
+    // The write finished before the destructor returned, but the
+    // checkpoint was never advertised
+    CHECK(get_file_size(filename) == contents.size());
+    CHECK_FALSE(lbann::exists(latest_file.c_str()));
+  }
+}
@@ -36,6 +36,7 @@
 #include "lbann/utils/distconv.hpp"
 #include "lbann/utils/serialize.hpp"
 #include "lbann/utils/tensor_impl.hpp"
+#include "lbann/utils/timer.hpp"
 #include "lbann/io/persist_impl.hpp"
 
 namespace lbann {
@@ -116,7 +117,10 @@ void buffered_data_coordinator<TensorDataType>::setup_data_fields(
 }
 
 template <typename TensorDataType>
-int buffered_data_coordinator<TensorDataType>::fetch_to_local_matrix(data_buffer_map_t& buffer_map, const execution_mode mode) {
+int buffered_data_coordinator<TensorDataType>::fetch_to_local_matrix(
+  data_buffer_map_t& buffer_map,
+  const execution_mode mode,
+  const generic_data_reader::fetch_cursor& cursor) {
   generic_data_reader *dr = get_data_reader(mode);
   int num_parallel_readers = dr->get_num_parallel_readers();
 
@@ -129,8 +133,8 @@ int buffered_data_coordinator<TensorDataType>::fetch_to_local_matrix(data_buffer
   /// to seeing if the local rank's position is valid.  Note that
   /// every rank will hold data that may be used in the last mini-batch
   if (dr->data_store_active()) {
-    dr->get_data_store().exchange_mini_batch_data(dr->get_position() - dr->get_base_offset() - dr->get_model_offset(),
-                                                  dr->get_loaded_mini_batch_size());
+    dr->get_data_store().exchange_mini_batch_data(cursor.position - dr->get_base_offset() - dr->get_model_offset(),
+                                                  cursor.loaded_mini_batch_size);
   }
 
   buf.m_num_samples_fetched = 0;
@@ -144,7 +148,9 @@ int buffered_data_coordinator<TensorDataType>::fetch_to_local_matrix(data_buffer
       local_input_buffers[b.first] = static_cast<CPUMat*>(&(b.second->Matrix()));
     }
     /** @brief Each rank will fetch a mini-batch worth of data into it's buffer */
-    buf.m_num_samples_fetched = dr->fetch(local_input_buffers, buf.m_indices_fetched_per_mb);
+    buf.m_num_samples_fetched = dr->fetch(local_input_buffers,
+                                         buf.m_indices_fetched_per_mb,
+                                         cursor);
 
     bool data_valid = (buf.m_num_samples_fetched > 0);
     if(data_valid) {
@@ -166,16 +172,79 @@ void buffered_data_coordinator<TensorDataType>::fp_setup_data(data_buffer<IOData
 }
 
 template <typename TensorDataType>
-void buffered_data_coordinator<TensorDataType>::fetch_data_in_background(int future_active_buffer, execution_mode mode) {
+void buffered_data_coordinator<TensorDataType>::fetch_data_in_background(
+  int future_active_buffer,
+  execution_mode mode,
+  const generic_data_reader::fetch_cursor& cursor) {
   int active_buffer_idx = future_active_buffer % m_data_buffers.size();
   data_buffer_map_t& buffer_map = m_data_buffers[active_buffer_idx];
   std::lock_guard<std::mutex> guard(dr_mutex);
-  int mini_batch_size = get_current_mini_batch_size(mode);
-  fp_setup_data(*buffer_map[mode], mini_batch_size);
-  fetch_to_local_matrix(buffer_map, mode);
+  fp_setup_data(*buffer_map[mode], cursor.mini_batch_size);
+  fetch_to_local_matrix(buffer_map, mode, cursor);
   return;
 }
 
+template <typename TensorDataType>
+bool buffered_data_coordinator<TensorDataType>::schedule_background_fetch(
+  int future_active_buffer,
+  execution_mode mode,
+  int lookahead) {
+
+  // Determine which mini-batch to fetch while the data reader state
+  // is still consistent
+  generic_data_reader::fetch_cursor cursor;
+  if (!get_data_reader(mode)->get_fetch_cursor(lookahead, cursor)) {
+    return false;
+  }
+
+  data_buffer_map_t& buffer_map =
+    m_data_buffers[future_active_buffer % m_data_buffers.size()];
+  data_buffer<IODataType>& buffer = get_data_buffer(buffer_map, mode);
+  std::promise<void> done;
+  buffer.set_data_fetch_future(done.get_future());
+  buffer.set_fetch_data_in_background(true);
+
+  // Queue the request and start processing the queue if it is idle
+  bool launch_job = false;
+  {
+    std::lock_guard<std::mutex> guard(m_prefetch_mutex);
+    m_prefetch_queue.push_back(
+      prefetch_request{future_active_buffer, mode, cursor, std::move(done)});
+    launch_job = !m_prefetch_in_progress;
+    m_prefetch_in_progress = true;
+  }
+  if (launch_job) {
+    get_io_thread_pool().submit_job(
+      std::bind(&buffered_data_coordinator::process_prefetch_queue, this));
+  }
+  return true;
+}
+
+template <typename TensorDataType>
+void buffered_data_coordinator<TensorDataType>::process_prefetch_queue() {
+  while (true) {
+    prefetch_request request;
+    {
+      std::lock_guard<std::mutex> guard(m_prefetch_mutex);
+      if (m_prefetch_queue.empty()) {
+        m_prefetch_in_progress = false;
+        return;
+      }
+      request = std::move(m_prefetch_queue.front());
+      m_prefetch_queue.pop_front();
+    }
+    try {
+      fetch_data_in_background(request.future_active_buffer,
+                               request.mode,
+                               request.cursor);
+      request.done.set_value();
+    }
+    catch (...) {
+      request.done.set_exception(std::current_exception());
+    }
+  }
+}
+
 /// Check for each buffer if there is an outstanding fetch request
 template <typename TensorDataType>
 void buffered_data_coordinator<TensorDataType>::collect_background_data_fetch(execution_mode mode) {
@@ -197,14 +266,12 @@ void buffered_data_coordinator<TensorDataType>::fetch_data(execution_mode mode)
   increment_active_buffer_idx(mode);
 
   data_buffer<IODataType>& active_buffer = get_active_buffer(mode);
+  const auto wait_start = get_time();
 
   // If there is no valid data and there is not already a background
   // thread to fetch the data, queue up the background thread
   if(active_buffer.num_samples_ready() == 0 && !active_buffer.is_data_fetched_in_background()) {
-    std::future<void> background_fetch_done = get_io_thread_pool().submit_job(
-      std::bind(&buffered_data_coordinator::fetch_data_in_background, this, this->get_active_buffer_idx(mode), mode));
-    active_buffer.set_data_fetch_future(std::move(background_fetch_done));
-    active_buffer.set_fetch_data_in_background(true);
+    schedule_background_fetch(this->get_active_buffer_idx(mode), mode, 0);
   }
 
   // Wait for the background thread to complete fetching the data
@@ -212,6 +279,7 @@ void buffered_data_coordinator<TensorDataType>::fetch_data(execution_mode mode)
     active_buffer.get_data_fetch_future().get();
     active_buffer.set_fetch_data_in_background(false);
   }
+  record_data_wait_time(mode, get_time() - wait_start);
 
   //  int num_samples_in_batch = 0;
   if(active_buffer.num_samples_ready() > 0) {
@@ -238,14 +306,24 @@ bool buffered_data_coordinator<TensorDataType>::epoch_complete(execution_mode mo
   // Kick off background I/O once the forward prop phase is complete.
   // This is because the data reader has state about the current step
   // in epoch.  In a future PR this state should be moved to the data coordinator
+  // Keep up to prefetch-depth mini-batches in flight. The data
+  // reader now points at the mini-batch after the active one.
   if(!m_data_set_processed && m_trainer->background_io_activity_allowed()) {
-    int next_active_buffer = this->get_active_buffer_idx(mode) + 1;
-    std::future<void> background_fetch_done = get_io_thread_pool().submit_job(
-      std::bind(&buffered_data_coordinator::fetch_data_in_background, this, next_active_buffer, mode));
-    data_buffer_map_t& next_io_buffer_map = m_data_buffers[next_active_buffer % m_data_buffers.size()];
-    data_buffer<IODataType>& next_io_buffer = get_data_buffer(next_io_buffer_map, mode);
-    next_io_buffer.set_data_fetch_future(std::move(background_fetch_done));
-    next_io_buffer.set_fetch_data_in_background(true);
+    const int active_buffer_idx = this->get_active_buffer_idx(mode);
+    const int prefetch_depth = get_prefetch_depth();
+    for (int k = 1; k <= prefetch_depth; ++k) {
+      const int next_active_buffer = active_buffer_idx + k;
+      data_buffer_map_t& next_io_buffer_map = m_data_buffers[next_active_buffer % m_data_buffers.size()];
+      data_buffer<IODataType>& next_io_buffer = get_data_buffer(next_io_buffer_map, mode);
+      if (next_io_buffer.is_data_fetched_in_background()
+          || next_io_buffer.num_samples_ready() > 0) {
+        // Already in flight or collected
+        continue;
+      }
+      if (!schedule_background_fetch(next_active_buffer, mode, k - 1)) {
+        break;
+      }
+    }
   }
   return m_data_set_processed;
 }
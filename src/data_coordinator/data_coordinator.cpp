@@ -30,6 +30,8 @@
 #include <lbann/utils/distconv.hpp>
 #include <lbann/utils/serialize.hpp>
 
+#include <algorithm>
+
 namespace lbann {
 
 template <class Archive>
@@ -214,6 +216,26 @@ int data_coordinator::get_current_mini_batch_size(execution_mode mode) const {
   return (data_reader != nullptr) ? data_reader->get_current_mini_batch_size() : 0;
 }
 
+auto data_coordinator::get_data_wait_statistics(execution_mode mode) const
+  -> data_wait_statistics {
+  auto it = m_data_wait_statistics.find(mode);
+  return (it != m_data_wait_statistics.end()
+          ? it->second
+          : data_wait_statistics{});
+}
+
+void data_coordinator::reset_data_wait_statistics(execution_mode mode) {
+  m_data_wait_statistics.erase(mode);
+}
+
+void data_coordinator::record_data_wait_time(execution_mode mode, EvalType time) {
+  auto& stats = m_data_wait_statistics[mode];
+  ++stats.num_mini_batches;
+  stats.total_time += time;
+  stats.max_time = std::max(stats.max_time, time);
+  stats.last_time = time;
+}
+
 int data_coordinator::get_global_mini_batch_size(execution_mode mode) const {
   const generic_data_reader *data_reader = get_data_reader(mode);
   return (data_reader != nullptr) ? data_reader->get_global_mini_batch_size() : 0;
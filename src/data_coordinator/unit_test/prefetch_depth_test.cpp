@@ -0,0 +1,137 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <catch2/catch.hpp>
+
+#include "TestHelpers.hpp"
+#include "MPITestHelpers.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/data_coordinator/buffered_data_coordinator.hpp>
+#include <lbann/data_readers/utils/input_data_type.hpp>
+#include <lbann/trainers/trainer.hpp>
+#include <lbann/utils/lbann_library.hpp>
+
+#include <lbann.pb.h>
+#include <google/protobuf/text_format.h>
+
+#include <vector>
+
+namespace pb = ::google::protobuf;
+
+namespace {
+
+using DataCoordinatorType = lbann::buffered_data_coordinator<lbann::DataType>;
+using MatType = El::DistMatrix<lbann::DataType, El::STAR, El::VC,
+                               El::ELEMENT, El::Device::CPU>;
+
+// 22 samples in mini-batches of 4, so the last mini-batch is partial
+std::string const trainer_prototext = R"ptext(
+trainer {
+  mini_batch_size: 4
+  random_seed: 20211016
+  data_coordinator {
+    prefetch_depth: PREFETCH_DEPTH
+  }
+}
+data_reader {
+  reader {
+    name: "synthetic"
+    role: "train"
+    shuffle: true
+    num_samples: 22
+    num_labels: 2
+    synth_dimensions: "3"
+    absolute_sample_count: 0
+    percent_of_data_to_use: 1.0
+  }
+}
+)ptext";
+
+/** @brief Sample indices fetched by this rank over several epochs */
+struct fetch_record {
+  std::vector<El::Int> indices;
+  std::vector<size_t> epoch_steps;
+  size_t num_waits = 0;
+};
+
+fetch_record fetch_epochs(lbann::lbann_comm& comm,
+                          int prefetch_depth,
+                          int num_epochs)
+{
+  std::string prototext = trainer_prototext;
+  auto const pos = prototext.find("PREFETCH_DEPTH");
+  prototext.replace(pos, 14, std::to_string(prefetch_depth));
+  lbann_data::LbannPB my_proto;
+  if (!pb::TextFormat::ParseFromString(prototext, &my_proto))
+    throw "Parsing protobuf failed.";
+  auto& t = lbann::construct_trainer(&comm, my_proto.mutable_trainer(), my_proto);
+
+  auto& dc = dynamic_cast<DataCoordinatorType&>(t.get_data_coordinator());
+  REQUIRE(dc.get_prefetch_depth() == static_cast<size_t>(prefetch_depth));
+  dc.register_active_data_field(INPUT_DATA_TYPE_SAMPLES);
+
+  auto const mode = lbann::execution_mode::training;
+  MatType samples(comm.get_trainer_grid());
+  fetch_record record;
+  for (int epoch = 0; epoch < num_epochs; ++epoch) {
+    size_t steps = 0;
+    do {
+      dc.fetch_data(mode);
+      auto& buffer = dc.get_active_buffer(mode);
+      auto const& indices = *buffer.get_sample_indices_fetched_per_mb();
+      for (int i = 0; i < buffer.num_samples_ready(); ++i) {
+        record.indices.push_back(indices.Get(i, 0));
+      }
+      dc.distribute_from_local_matrix(mode, INPUT_DATA_TYPE_SAMPLES, samples);
+      ++steps;
+    } while (!dc.epoch_complete(mode));
+    record.epoch_steps.push_back(steps);
+  }
+  record.num_waits = dc.get_data_wait_statistics(mode).num_mini_batches;
+  return record;
+}
+
+} // namespace <anon>
+
+TEST_CASE("Prefetch depth does not change the sample sequence",
+          "[mpi][data_coordinator][prefetch]")
+{
+  auto& comm = unit_test::utilities::current_world_comm();
+  int const num_epochs = 3;
+  auto const reference = fetch_epochs(comm, 1, num_epochs);
+  REQUIRE(reference.epoch_steps.size() == num_epochs);
+  REQUIRE(reference.num_waits ==
+          reference.epoch_steps[0] * num_epochs);
+
+  for (int depth : {2, 4, 8}) {
+    INFO("prefetch depth " << depth);
+    auto const record = fetch_epochs(comm, depth, num_epochs);
+    CHECK(record.epoch_steps == reference.epoch_steps);
+    CHECK(record.indices == reference.indices);
+    CHECK(record.num_waits == reference.num_waits);
+  }
+}
@@ -61,6 +61,10 @@ void generic_data_reader::shuffle_indices(rng_gen& gen) {
   if (m_shuffle) {
     std::shuffle(m_shuffled_indices.begin(), m_shuffled_indices.end(),
                  gen);
+    // Reduce data store exchange traffic, if requested
+    if (m_data_store != nullptr) {
+      m_data_store->localize_shuffled_indices(m_shuffled_indices, gen);
+    }
   }
 }
 
@@ -83,9 +87,49 @@ void generic_data_reader::setup(int num_io_threads, observer_ptr<thread_pool> io
   m_io_thread_pool = io_thread_pool;
 }
 
+bool generic_data_reader::get_fetch_cursor(int lookahead,
+                                           fetch_cursor& cursor) const {
+  int pos = m_current_pos;
+  int current_idx = m_current_mini_batch_idx;
+  int loaded_idx = m_loaded_mini_batch_idx;
+  for (int i = 0; i < lookahead; ++i) {
+    // Same stride logic as get_next_position
+    if ((current_idx + m_iteration_stride - 1) == (m_num_iterations_per_epoch-1)) {
+      pos += m_stride_to_last_mini_batch;
+    } else {
+      pos += m_stride_to_next_mini_batch;
+    }
+    ++current_idx;
+    loaded_idx += m_iteration_stride;
+  }
+  if (lookahead > 0 && current_idx >= m_num_iterations_per_epoch) {
+    return false;
+  }
+  cursor.position = pos;
+  cursor.loaded_mini_batch_size =
+    (loaded_idx >= (m_num_iterations_per_epoch-1)
+     ? m_last_mini_batch_size
+     : m_mini_batch_size);
+  cursor.mini_batch_size =
+    (current_idx == (m_num_iterations_per_epoch-1)
+     ? m_last_mini_batch_size + m_world_master_mini_batch_adjustment
+     : m_mini_batch_size);
+  return true;
+}
+
 int lbann::generic_data_reader::fetch(
   std::map<data_field_type, CPUMat*>& input_buffers,
   El::Matrix<El::Int>& indices_fetched)
+{
+  fetch_cursor cursor;
+  get_fetch_cursor(0, cursor);
+  return fetch(input_buffers, indices_fetched, cursor);
+}
+
+int lbann::generic_data_reader::fetch(
+  std::map<data_field_type, CPUMat*>& input_buffers,
+  El::Matrix<El::Int>& indices_fetched,
+  const fetch_cursor& cursor)
 {
   // Check to make sure that a valid map was passed
   if (input_buffers.empty()) {
@@ -120,7 +164,7 @@ int lbann::generic_data_reader::fetch(
   }
 
 #ifdef DEBUG
-  if (m_current_pos == 0) {
+  if (cursor.position == 0) {
     if (is_master()) {
       std::cout << "role: " << get_role() << " model: " << m_trainer->get_name()
                 << " shuffled indices: ";
@@ -132,20 +176,23 @@ int lbann::generic_data_reader::fetch(
   }
   #endif
 
-  int loaded_batch_size = get_loaded_mini_batch_size();
+  m_fetch_pos = cursor.position;
+  int loaded_batch_size = cursor.loaded_mini_batch_size;
 
-  const int end_pos = std::min(static_cast<size_t>(m_current_pos+loaded_batch_size), m_shuffled_indices.size());
+  const int end_pos = std::min(static_cast<size_t>(m_fetch_pos+loaded_batch_size), m_shuffled_indices.size());
   const int mb_size =
-    std::min(El::Int{((end_pos - m_current_pos) + m_sample_stride - 1) /
+    std::min(El::Int{((end_pos - m_fetch_pos) + m_sample_stride - 1) /
                      m_sample_stride},
              buffer_width);
 
-  if(!position_valid()) {
-    if(position_is_overrun()) {
+  if (m_fetch_pos >= get_num_data()) {
+    const int num_indices = m_shuffled_indices.size();
+    if (m_fetch_pos >= num_indices
+        && (m_fetch_pos - num_indices) < m_comm->get_procs_per_trainer()) {
       return 0;
     }else {
       LBANN_ERROR(std::string{} + "generic data reader load error: !position_valid"
-                  + " -- current pos = " + std::to_string(m_current_pos)
+                  + " -- current pos = " + std::to_string(m_fetch_pos)
                   + " and there are " + std::to_string(m_shuffled_indices.size()) + " indices");
     }
   }
@@ -175,31 +222,71 @@ int lbann::generic_data_reader::fetch(
 
   // Fetch data is executed by the thread pool so it has to dispatch
   // work to other threads in the thread pool and do some work locally
-  for (int t = 0; t < static_cast<int>(m_io_thread_pool->get_num_threads()); t++) {
-    // Queue up work into other threads and then finish off the
-    // mini-batch in the active thread
-    if (t == m_io_thread_pool->get_local_thread_id()) {
-      continue;
-    }
-    else {
+  const int num_io_threads = m_io_thread_pool->get_num_threads();
+  const int local_thread_id = m_io_thread_pool->get_local_thread_id();
+#ifdef LBANN_DETERMINISTIC
+  // Strided blocks keep the sample to I/O RNG mapping reproducible
+  const bool use_chunks = false;
+#else
+  const bool use_chunks = supports_chunked_fetch();
+#endif // LBANN_DETERMINISTIC
+  if (use_chunks) {
+    // Threads claim small chunks of samples until the mini-batch is
+    // exhausted, so threads that finish early pick up more work
+    std::atomic<El::Int> next_sample{0};
+    const El::Int chunk_size = get_fetch_chunk_size(mb_size, num_io_threads);
+    for (int t = 0; t < num_io_threads; t++) {
+      if (t == local_thread_id) {
+        continue;
+      }
       m_io_thread_pool->submit_job_to_work_group(
-        std::bind(&generic_data_reader::fetch_data_block,
+        std::bind(&generic_data_reader::fetch_data_chunks,
                   this,
                   std::ref(input_buffers),
                   t,
-                  m_io_thread_pool->get_num_threads(),
+                  std::ref(next_sample),
+                  chunk_size,
                   mb_size,
                   std::ref(indices_fetched)));
     }
+    fetch_data_chunks(input_buffers,
+                      local_thread_id,
+                      next_sample,
+                      chunk_size,
+                      mb_size,
+                      indices_fetched);
+
+    // Wait for all of the threads to finish before next_sample goes
+    // out of scope
+    m_io_thread_pool->finish_work_group();
   }
-  fetch_data_block(input_buffers,
-                   m_io_thread_pool->get_local_thread_id(),
-                   m_io_thread_pool->get_num_threads(),
-                   mb_size,
-                   indices_fetched);
+  else {
+    for (int t = 0; t < num_io_threads; t++) {
+      // Queue up work into other threads and then finish off the
+      // mini-batch in the active thread
+      if (t == local_thread_id) {
+        continue;
+      }
+      else {
+        m_io_thread_pool->submit_job_to_work_group(
+          std::bind(&generic_data_reader::fetch_data_block,
+                    this,
+                    std::ref(input_buffers),
+                    t,
+                    num_io_threads,
+                    mb_size,
+                    std::ref(indices_fetched)));
+      }
+    }
+    fetch_data_block(input_buffers,
+                     local_thread_id,
+                     num_io_threads,
+                     mb_size,
+                     indices_fetched);
 
-  // Wait for all of the threads to finish
-  m_io_thread_pool->finish_work_group();
+    // Wait for all of the threads to finish
+    m_io_thread_pool->finish_work_group();
+  }
 
   /// Allow each thread to perform any postprocessing necessary on the
   /// data source prior to fetching data
@@ -221,71 +308,111 @@ bool lbann::generic_data_reader::fetch_data_block(
 
   //  CPUMat& X
   for (int s = block_offset; s < mb_size; s += block_stride) {
-    int n = m_current_pos + (s * m_sample_stride);
-    int index = m_shuffled_indices[n];
-    indices_fetched.Set(s, 0, index);
-
-    for (auto& [data_field, buf] : input_buffers) {
-      bool valid = false;
-      if (data_field == INPUT_DATA_TYPE_SAMPLES) {
-        if (buf == nullptr || buf->Height() == 0 || buf->Width() == 0) {
-          LBANN_ERROR(
-            "fetch_data_block function called with invalid buffer: h=",
-            buf->Height(),
-            " x ",
-            buf->Width());
-        }
-        valid = fetch_datum(*buf, index, s);
-        if (!valid) {
-          LBANN_ERROR("invalid datum (index ", std::to_string(index), ")");
-        }
+    fetch_sample(input_buffers, s, indices_fetched);
+  }
+
+  return true;
+}
+
+bool lbann::generic_data_reader::fetch_data_chunks(
+  std::map<data_field_type, CPUMat*>& input_buffers,
+  El::Int thread_id,
+  std::atomic<El::Int>& next_sample,
+  El::Int chunk_size,
+  El::Int mb_size,
+  El::Matrix<El::Int>& indices_fetched)
+{
+  locked_io_rng_ref io_rng = set_io_generators_local_index(thread_id);
+
+  for (El::Int begin = next_sample.fetch_add(chunk_size);
+       begin < mb_size;
+       begin = next_sample.fetch_add(chunk_size)) {
+    const El::Int end = std::min(begin + chunk_size, mb_size);
+    for (El::Int s = begin; s < end; ++s) {
+      fetch_sample(input_buffers, s, indices_fetched);
+    }
+  }
+
+  return true;
+}
+
+El::Int lbann::generic_data_reader::get_fetch_chunk_size(El::Int mb_size,
+                                                        El::Int num_threads)
+{
+  // Aim for several chunks per thread so that uneven sample costs
+  // even out, but keep chunks large enough to amortize the atomic
+  constexpr El::Int chunks_per_thread = 4;
+  const El::Int num_chunks = std::max(num_threads, El::Int{1}) * chunks_per_thread;
+  return std::max((mb_size + num_chunks - 1) / num_chunks, El::Int{1});
+}
+
+void lbann::generic_data_reader::fetch_sample(
+  std::map<data_field_type, CPUMat*>& input_buffers,
+  El::Int s,
+  El::Matrix<El::Int>& indices_fetched)
+{
+  int n = m_fetch_pos + (s * m_sample_stride);
+  int index = m_shuffled_indices[n];
+  indices_fetched.Set(s, 0, index);
+
+  for (auto& [data_field, buf] : input_buffers) {
+    bool valid = false;
+    if (data_field == INPUT_DATA_TYPE_SAMPLES) {
+      if (buf == nullptr || buf->Height() == 0 || buf->Width() == 0) {
+        LBANN_ERROR(
+          "fetch_data_block function called with invalid buffer: h=",
+          buf->Height(),
+          " x ",
+          buf->Width());
       }
-      else if (data_field == INPUT_DATA_TYPE_LABELS && has_labels()) {
-        if (buf == nullptr || buf->Height() == 0 || buf->Width() == 0) {
-          LBANN_ERROR(
-            "fetch_data_block function called with invalid buffer: h=",
-            buf->Height(),
-            " x ",
-            buf->Width());
-        }
-        valid = fetch_label(*buf, index, s);
-        if (!valid) {
-          LBANN_ERROR("invalid datum (index ", std::to_string(index), ")");
-        }
+      valid = fetch_datum(*buf, index, s);
+      if (!valid) {
+        LBANN_ERROR("invalid datum (index ", std::to_string(index), ")");
       }
-      else if (data_field == INPUT_DATA_TYPE_RESPONSES && has_responses()) {
-        if (buf == nullptr || buf->Height() == 0 || buf->Width() == 0) {
-          LBANN_ERROR(
-            "fetch_data_block function called with invalid buffer: h=",
-            buf->Height(),
-            " x ",
-            buf->Width());
-        }
-        valid = fetch_response(*buf, index, s);
-        if (!valid) {
-          LBANN_ERROR("invalid datum (index ", std::to_string(index), ")");
-        }
+    }
+    else if (data_field == INPUT_DATA_TYPE_LABELS && has_labels()) {
+      if (buf == nullptr || buf->Height() == 0 || buf->Width() == 0) {
+        LBANN_ERROR(
+          "fetch_data_block function called with invalid buffer: h=",
+          buf->Height(),
+          " x ",
+          buf->Width());
       }
-      else if (has_data_field(data_field)) {
-        if (buf == nullptr || buf->Height() == 0 || buf->Width() == 0) {
-          LBANN_ERROR(
-            "fetch_data_block function called with invalid buffer: h=",
-            buf->Height(),
-            " x ",
-            buf->Width());
-        }
-        valid = fetch_data_field(data_field, *buf, index, s);
-        if (!valid) {
-          LBANN_ERROR("invalid datum (index ", std::to_string(index), ") for field ", data_field);
-        }
+      valid = fetch_label(*buf, index, s);
+      if (!valid) {
+        LBANN_ERROR("invalid datum (index ", std::to_string(index), ")");
       }
-      else {
-        LBANN_ERROR("Unsupported data_field ", data_field);
+    }
+    else if (data_field == INPUT_DATA_TYPE_RESPONSES && has_responses()) {
+      if (buf == nullptr || buf->Height() == 0 || buf->Width() == 0) {
+        LBANN_ERROR(
+          "fetch_data_block function called with invalid buffer: h=",
+          buf->Height(),
+          " x ",
+          buf->Width());
+      }
+      valid = fetch_response(*buf, index, s);
+      if (!valid) {
+        LBANN_ERROR("invalid datum (index ", std::to_string(index), ")");
       }
     }
+    else if (has_data_field(data_field)) {
+      if (buf == nullptr || buf->Height() == 0 || buf->Width() == 0) {
+        LBANN_ERROR(
+          "fetch_data_block function called with invalid buffer: h=",
+          buf->Height(),
+          " x ",
+          buf->Width());
+      }
+      valid = fetch_data_field(data_field, *buf, index, s);
+      if (!valid) {
+        LBANN_ERROR("invalid datum (index ", std::to_string(index), ") for field ", data_field);
+      }
+    }
+    else {
+      LBANN_ERROR("Unsupported data_field ", data_field);
+    }
   }
-
-  return true;
 }
 
 void lbann::generic_data_reader::set_jag_variables(int mb_size) {
@@ -698,7 +825,8 @@ void generic_data_reader::instantiate_data_store() {
   if (!(arg_parser.get<bool>(USE_DATA_STORE) ||
         arg_parser.get<bool>(PRELOAD_DATA_STORE) ||
         arg_parser.get<bool>(DATA_STORE_CACHE) ||
-        arg_parser.get<std::string>(DATA_STORE_SPILL) != "")) {
+        arg_parser.get<std::string>(DATA_STORE_SPILL) != "" ||
+        arg_parser.get<std::string>(DATA_STORE_TIERED_CACHE) != "")) {
     if (m_data_store != nullptr) {
       delete m_data_store;
       m_data_store = nullptr;
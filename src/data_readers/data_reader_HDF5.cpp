@@ -32,6 +32,9 @@
 #include "lbann/data_readers/sample_list_open_files_impl.hpp"
 #include "lbann/utils/timer.hpp"
 
+#include <algorithm>
+#include <map>
+
 namespace lbann {
 namespace {
 
@@ -114,6 +117,178 @@ void do_repack_image(T* const src_buf,
   std::copy_n(dst_buf, n_elts, src_buf);
 }
 
+/** @brief Throw an exception if an HDF5 call failed. */
+template <typename T>
+T check_hdf5(T status, const char* call)
+{
+  if (status < 0) {
+    LBANN_ERROR("HDF5 call failed: ", call);
+  }
+  return status;
+}
+
+/** @brief Closes an HDF5 identifier when it goes out of scope. */
+class hdf5_handle
+{
+public:
+  hdf5_handle(hid_t id, herr_t (*close)(hid_t)) : m_id{id}, m_close{close} {}
+  ~hdf5_handle()
+  {
+    if (m_id >= 0) {
+      m_close(m_id);
+    }
+  }
+  hdf5_handle(const hdf5_handle&) = delete;
+  hdf5_handle& operator=(const hdf5_handle&) = delete;
+  hid_t get() const noexcept { return m_id; }
+
+private:
+  hid_t m_id;
+  herr_t (*m_close)(hid_t);
+};
+
+/** @brief Conduit type of a field read in blocks.
+ *  @param file_type HDF5 type of the dataset on disk.
+ *  @param coerce_to Type requested in the schema ("float" or
+ *                   "double"), or empty to keep the type on disk.
+ */
+conduit::index_t get_block_dtype(hid_t file_type, std::string const& coerce_to)
+{
+  if (coerce_to == "float") {
+    return conduit::DataType::FLOAT32_ID;
+  }
+  if (coerce_to == "double") {
+    return conduit::DataType::FLOAT64_ID;
+  }
+  if (!coerce_to.empty()) {
+    LBANN_ERROR("Un-implemented type requested for coercion: ",
+                coerce_to,
+                "; you need to update the data reader to support this");
+  }
+  const size_t size = H5Tget_size(file_type);
+  switch (H5Tget_class(file_type)) {
+  case H5T_FLOAT:
+    if (size == 4) {
+      return conduit::DataType::FLOAT32_ID;
+    }
+    if (size == 8) {
+      return conduit::DataType::FLOAT64_ID;
+    }
+    break;
+  case H5T_INTEGER:
+    {
+      const bool is_signed = (H5Tget_sign(file_type) == H5T_SGN_2);
+      if (size == 4) {
+        return (is_signed ? conduit::DataType::INT32_ID
+                          : conduit::DataType::UINT32_ID);
+      }
+      if (size == 8) {
+        return (is_signed ? conduit::DataType::INT64_ID
+                          : conduit::DataType::UINT64_ID);
+      }
+    }
+    break;
+  default:
+    break;
+  }
+  LBANN_ERROR("batched reads only support float32/64, int32/64, and "
+              "uint32/64 datasets");
+  return conduit::DataType::EMPTY_ID;
+}
+
+/** @brief HDF5 memory type matching a Conduit type. */
+hid_t get_native_hdf5_type(conduit::index_t dtype)
+{
+  switch (dtype) {
+  case conduit::DataType::FLOAT32_ID:
+    return H5T_NATIVE_FLOAT;
+  case conduit::DataType::FLOAT64_ID:
+    return H5T_NATIVE_DOUBLE;
+  case conduit::DataType::INT32_ID:
+    return H5T_NATIVE_INT32;
+  case conduit::DataType::INT64_ID:
+    return H5T_NATIVE_INT64;
+  case conduit::DataType::UINT32_ID:
+    return H5T_NATIVE_UINT32;
+  case conduit::DataType::UINT64_ID:
+    return H5T_NATIVE_UINT64;
+  default:
+    LBANN_ERROR("no HDF5 type for conduit type ",
+                conduit::DataType::id_to_name(dtype));
+  }
+  return -1;
+}
+
+/** @brief Select rows of a dataset.
+ *
+ *  Runs of consecutive rows are merged into a single hyperslab. If
+ *  the dataset is 1D and no rows are consecutive, a point selection
+ *  is used instead.
+ *
+ *  @param file_space Dataspace of the dataset.
+ *  @param dims Dimensions of the dataset; the first indexes rows.
+ *  @param rows Sorted row indices, without duplicates.
+ */
+void select_rows(hid_t file_space,
+                 std::vector<hsize_t> const& dims,
+                 std::vector<hsize_t> const& rows)
+{
+  if (!rows.empty() && rows.back() >= dims[0]) {
+    LBANN_ERROR("row ", rows.back(), " is out of range for a dataset with ",
+                dims[0], " rows");
+  }
+  std::vector<std::pair<hsize_t, hsize_t>> runs; // (first row, length)
+  for (const auto& row : rows) {
+    if (!runs.empty() && runs.back().first + runs.back().second == row) {
+      ++runs.back().second;
+    }
+    else {
+      runs.emplace_back(row, 1);
+    }
+  }
+  if (dims.size() == 1 && runs.size() == rows.size() && !rows.empty()) {
+    check_hdf5(H5Sselect_elements(file_space,
+                                  H5S_SELECT_SET,
+                                  rows.size(),
+                                  rows.data()),
+               "H5Sselect_elements");
+    return;
+  }
+  check_hdf5(H5Sselect_none(file_space), "H5Sselect_none");
+  std::vector<hsize_t> start(dims.size(), 0);
+  std::vector<hsize_t> count(dims);
+  for (const auto& [first, length] : runs) {
+    start[0] = first;
+    count[0] = length;
+    check_hdf5(H5Sselect_hyperslab(file_space,
+                                   H5S_SELECT_OR,
+                                   start.data(),
+                                   nullptr,
+                                   count.data(),
+                                   nullptr),
+               "H5Sselect_hyperslab");
+  }
+}
+
+/** @brief Row index of a sample read in blocks. */
+hsize_t get_sample_row(std::string const& sample_name)
+{
+  size_t pos = 0;
+  unsigned long long row = 0;
+  try {
+    row = std::stoull(sample_name, &pos);
+  }
+  catch (std::exception const&) {
+    pos = 0;
+  }
+  if (pos == 0 || pos != sample_name.size()) {
+    LBANN_ERROR("with batched reads, sample names must be row indices; "
+                "got: ",
+                sample_name);
+  }
+  return row;
+}
+
 } // namespace
 
 template <typename T>
@@ -151,7 +326,45 @@ void hdf5_data_reader::pack(std::string const& group_name,
   std::ostringstream ss;
   ss << '/' << LBANN_DATA_ID_STR(index) + '/' + group_name;
   node[ss.str()] = std::move(data);
+  add_composite_node(group_name);
+}
+
+template <typename T>
+void hdf5_data_reader::pack_block(std::string const& group_name,
+                                  const conduit::Node& block,
+                                  size_t const row,
+                                  size_t const num_rows,
+                                  conduit::Node& node,
+                                  size_t const index)
+{
+  if (m_packing_groups.find(group_name) == m_packing_groups.end()) {
+    LBANN_ERROR("(m_packing_groups.find(", group_name, ") failed");
+  }
+  const PackingGroup& g = m_packing_groups[group_name];
+  std::vector<T> data(g.n_elts);
+  size_t idx = 0;
+  for (size_t k = 0; k < g.names.size(); k++) {
+    size_t const n_elts = g.sizes[k];
+    if (!block.has_path(g.names[k])) {
+      LBANN_ERROR("no block for field: ", g.names[k]);
+    }
+    const conduit::Node& field = block[g.names[k]];
+    if (static_cast<size_t>(field.dtype().number_of_elements()) !=
+        n_elts * num_rows) {
+      LBANN_ERROR("block for field ", g.names[k], " has the wrong size");
+    }
+    const T* field_data = reinterpret_cast<const T*>(field.element_ptr(0));
+    memcpy(data.data() + idx, field_data + row * n_elts, n_elts * sizeof(T));
+    idx += n_elts;
+  }
+  std::ostringstream ss;
+  ss << '/' << LBANN_DATA_ID_STR(index) + '/' + group_name;
+  node[ss.str()] = std::move(data);
+  add_composite_node(group_name);
+}
 
+void hdf5_data_reader::add_composite_node(const std::string& group_name)
+{
   // this is clumsy and should be done better
   if (m_add_to_map.find(group_name) == m_add_to_map.end()) {
     m_add_to_map.insert(group_name);
@@ -194,6 +407,10 @@ void hdf5_data_reader::copy_members(const hdf5_data_reader& rhs)
   m_experiment_schema_filename = rhs.m_experiment_schema_filename;
   m_data_schema_filename = rhs.m_data_schema_filename;
   m_delete_packed_fields = rhs.m_delete_packed_fields;
+  m_batched_reads = rhs.m_batched_reads;
+  m_read_block_size = rhs.m_read_block_size;
+  m_chunk_cache_bytes = rhs.m_chunk_cache_bytes;
+  m_chunk_cache_slots = rhs.m_chunk_cache_slots;
   m_packing_groups = rhs.m_packing_groups;
   m_experiment_schema = rhs.m_experiment_schema;
   m_data_schema = rhs.m_data_schema;
@@ -285,21 +502,26 @@ void hdf5_data_reader::do_preload_data_store()
               << get_role() << std::endl;
   }
 
-  for (size_t idx = 0; idx < m_shuffled_indices.size(); idx++) {
-    int index = m_shuffled_indices[idx];
-    if (m_data_store->get_index_owner(index) != get_rank()) {
-      continue;
-    }
-    try {
-      conduit::Node& node = m_data_store->get_empty_node(index);
-      load_sample(node, index);
-      m_data_store->set_preloaded_conduit_node(index, node);
-    }
-    catch (conduit::Error const& e) {
-      LBANN_ERROR("trying to load the node ",
-                  index,
-                  " and caught conduit exception: ",
-                  e.what());
+  if (m_batched_reads) {
+    preload_sample_blocks();
+  }
+  else {
+    for (size_t idx = 0; idx < m_shuffled_indices.size(); idx++) {
+      int index = m_shuffled_indices[idx];
+      if (m_data_store->get_index_owner(index) != get_rank()) {
+        continue;
+      }
+      try {
+        conduit::Node& node = m_data_store->get_empty_node(index);
+        load_sample(node, index);
+        m_data_store->set_preloaded_conduit_node(index, node);
+      }
+      catch (conduit::Error const& e) {
+        LBANN_ERROR("trying to load the node ",
+                    index,
+                    " and caught conduit exception: ",
+                    e.what());
+      }
     }
   }
   // Once all of the data has been preloaded, close all of the file handles
@@ -327,6 +549,10 @@ void hdf5_data_reader::load_sample(conduit::Node& node,
                                    size_t index,
                                    bool ignore_failure)
 {
+  if (m_batched_reads) {
+    load_sample_block({index}, {&node}, ignore_failure);
+    return;
+  }
   auto [file_handle,sample_name] = data_reader_sample_list::open_file(index);
   // load data for the field names specified in the user's experiment-schema
   for (auto& [pathname, path_node] : m_useme_node_map) {
@@ -377,6 +603,232 @@ void hdf5_data_reader::load_sample(conduit::Node& node,
   pack(node, index);
 }
 
+void hdf5_data_reader::preload_sample_blocks()
+{
+  // Group this rank's samples by file
+  std::map<size_t, std::vector<size_t>> file_indices;
+  for (const auto& index : m_shuffled_indices) {
+    if (m_data_store->get_index_owner(index) == get_rank()) {
+      file_indices[get_sample(index).first].push_back(index);
+    }
+  }
+
+  size_t block_size = m_read_block_size;
+  if (block_size == 0 && get_mini_batch_size() > 0) {
+    block_size = get_mini_batch_size();
+  }
+
+  std::vector<size_t> indices;
+  std::vector<conduit::Node*> nodes;
+  for (const auto& [file_id, all_indices] : file_indices) {
+    const size_t step = (block_size > 0 ? block_size : all_indices.size());
+    for (size_t begin = 0; begin < all_indices.size(); begin += step) {
+      const size_t end = std::min(begin + step, all_indices.size());
+      indices.assign(all_indices.begin() + begin, all_indices.begin() + end);
+      nodes.clear();
+      for (const auto& index : indices) {
+        nodes.push_back(&m_data_store->get_empty_node(index));
+      }
+      try {
+        load_sample_block(indices, nodes);
+      }
+      catch (conduit::Error const& e) {
+        LBANN_ERROR("trying to load a block of ",
+                    indices.size(),
+                    " nodes starting at ",
+                    indices.front(),
+                    " and caught conduit exception: ",
+                    e.what());
+      }
+      for (size_t k = 0; k < indices.size(); ++k) {
+        m_data_store->set_preloaded_conduit_node(indices[k], *nodes[k]);
+      }
+    }
+  }
+}
+
+void hdf5_data_reader::load_sample_block(
+  const std::vector<size_t>& indices,
+  const std::vector<conduit::Node*>& nodes,
+  bool ignore_failure)
+{
+  if (indices.empty()) {
+    return;
+  }
+  if (indices.size() != nodes.size()) {
+    LBANN_ERROR("got ", indices.size(), " indices but ", nodes.size(),
+                " nodes");
+  }
+
+  // Rows to read, in file order and without duplicates; HDF5 returns
+  // the selected rows in this order
+  auto file_handle = data_reader_sample_list::open_file(indices.front()).first;
+  std::vector<hsize_t> sample_rows;
+  sample_rows.reserve(indices.size());
+  for (const auto& index : indices) {
+    const auto& sample = get_sample(index);
+    if (sample.first != get_sample(indices.front()).first) {
+      LBANN_ERROR("samples ", indices.front(), " and ", index,
+                  " are not in the same file");
+    }
+    sample_rows.push_back(get_sample_row(sample.second));
+  }
+  std::vector<hsize_t> rows(sample_rows);
+  std::sort(rows.begin(), rows.end());
+  rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+  const size_t num_rows = rows.size();
+
+  // Read, coerce, normalize, and repack each field for the whole block
+  conduit::Node block;
+  std::vector<std::string> fields;
+  for (auto& [pathname, path_node] : m_useme_node_map) {
+    // do not load a "packed" field, as it doesn't exist on disk!
+    if (is_composite_node(path_node)) {
+      continue;
+    }
+    const conduit::Node& metadata = path_node.child(s_metadata_node_name);
+    if (!read_field_block(file_handle,
+                          "/" + pathname,
+                          metadata,
+                          rows,
+                          block[pathname],
+                          ignore_failure)) {
+      block.remove(pathname);
+      continue;
+    }
+    fields.push_back(pathname);
+    if (metadata.has_child("scale")) {
+      normalize(block, pathname, metadata);
+    }
+    if (metadata.has_child("channels") &&
+        metadata["channels"].as_int64() > 1) {
+      repack_image(block, pathname, metadata, num_rows);
+    }
+  }
+
+  // Fields that only exist in packed form
+  if (m_packing_groups.size() == 0) {
+    conduit::Node row_node;
+    for (const auto& pathname : fields) {
+      const conduit::Node& field = block[pathname];
+      row_node[pathname].set(
+        conduit::DataType(field.dtype().id(),
+                          field.dtype().number_of_elements() / num_rows));
+    }
+    build_packing_map(row_node);
+  }
+  std::unordered_set<std::string> packed_fields;
+  if (m_delete_packed_fields) {
+    for (const auto& t : m_packing_groups) {
+      packed_fields.insert(t.second.names.begin(), t.second.names.end());
+    }
+  }
+
+  // Pack each sample directly from the block
+  for (size_t k = 0; k < indices.size(); ++k) {
+    const size_t index = indices[k];
+    conduit::Node& node = *nodes[k];
+    const size_t row = std::lower_bound(rows.begin(), rows.end(),
+                                        sample_rows[k]) - rows.begin();
+    for (const auto& pathname : fields) {
+      if (packed_fields.count(pathname) > 0) {
+        continue;
+      }
+      const conduit::Node& field = block[pathname];
+      const conduit::index_t n_elts =
+        field.dtype().number_of_elements() / num_rows;
+      const auto* field_data =
+        reinterpret_cast<const unsigned char*>(field.element_ptr(0));
+      std::ostringstream ss;
+      ss << LBANN_DATA_ID_STR(index) << '/' << pathname;
+      node[ss.str()].set(
+        conduit::DataType(field.dtype().id(), n_elts),
+        const_cast<unsigned char*>(field_data +
+                                   row * n_elts * field.dtype().element_bytes()));
+    }
+    pack_block(block, row, num_rows, node, index);
+  }
+}
+
+bool hdf5_data_reader::read_field_block(hid_t file_handle,
+                                        const std::string& path,
+                                        const conduit::Node& metadata,
+                                        const std::vector<hsize_t>& rows,
+                                        conduit::Node& block,
+                                        bool ignore_failure)
+{
+  if (!conduit::relay::io::hdf5_has_path(file_handle, path)) {
+    if (ignore_failure) {
+      return false;
+    }
+    LBANN_ERROR("hdf5_has_path failed for path: ", path);
+  }
+
+  // Open the dataset with the requested chunk cache
+  const hdf5_handle dapl(
+    check_hdf5(H5Pcreate(H5P_DATASET_ACCESS), "H5Pcreate"),
+    H5Pclose);
+  if (m_chunk_cache_bytes > 0 || m_chunk_cache_slots > 0) {
+    check_hdf5(H5Pset_chunk_cache(dapl.get(),
+                                  (m_chunk_cache_slots > 0
+                                     ? m_chunk_cache_slots
+                                     : H5D_CHUNK_CACHE_NSLOTS_DEFAULT),
+                                  (m_chunk_cache_bytes > 0
+                                     ? m_chunk_cache_bytes
+                                     : H5D_CHUNK_CACHE_NBYTES_DEFAULT),
+                                  H5D_CHUNK_CACHE_W0_DEFAULT),
+               "H5Pset_chunk_cache");
+  }
+  const hdf5_handle dataset(
+    check_hdf5(H5Dopen2(file_handle, path.c_str(), dapl.get()), "H5Dopen2"),
+    H5Dclose);
+  const hdf5_handle file_space(
+    check_hdf5(H5Dget_space(dataset.get()), "H5Dget_space"),
+    H5Sclose);
+  const hdf5_handle file_type(
+    check_hdf5(H5Dget_type(dataset.get()), "H5Dget_type"),
+    H5Tclose);
+
+  // Get the type to read into; coercion is done by HDF5
+  std::string coerce_to;
+  if (metadata.has_child(s_coerce_name)) {
+    // conduit includes quotes around the string, so strip them off
+    const std::string& cc = metadata[s_coerce_name].to_string();
+    coerce_to = cc.substr(1, cc.size() - 2);
+  }
+  const conduit::index_t dtype = get_block_dtype(file_type.get(), coerce_to);
+
+  // Select the rows and read them back to back
+  const int ndims =
+    check_hdf5(H5Sget_simple_extent_ndims(file_space.get()),
+               "H5Sget_simple_extent_ndims");
+  if (ndims < 1) {
+    LBANN_ERROR("dataset ", path, " must have a dimension for rows");
+  }
+  std::vector<hsize_t> dims(ndims);
+  check_hdf5(H5Sget_simple_extent_dims(file_space.get(), dims.data(), nullptr),
+             "H5Sget_simple_extent_dims");
+  hsize_t n_elts = rows.size();
+  for (int d = 1; d < ndims; ++d) {
+    n_elts *= dims[d];
+  }
+  select_rows(file_space.get(), dims, rows);
+  block.set(conduit::DataType(dtype, n_elts));
+  if (n_elts > 0) {
+    const hdf5_handle mem_space(
+      check_hdf5(H5Screate_simple(1, &n_elts, nullptr), "H5Screate_simple"),
+      H5Sclose);
+    check_hdf5(H5Dread(dataset.get(),
+                       get_native_hdf5_type(dtype),
+                       mem_space.get(),
+                       file_space.get(),
+                       H5P_DEFAULT,
+                       block.element_ptr(0)),
+               "H5Dread");
+  }
+  return true;
+}
+
 void hdf5_data_reader::normalize(conduit::Node& node,
                                  const std::string& path,
                                  const conduit::Node& metadata)
@@ -597,6 +1049,32 @@ void hdf5_data_reader::get_leaves(
   }
 }
 
+void hdf5_data_reader::pack_block(const conduit::Node& block,
+                                  size_t row,
+                                  size_t num_rows,
+                                  conduit::Node& node,
+                                  size_t index)
+{
+  for (const auto& t : m_packing_groups) {
+    const std::string& group_name = t.first;
+    const PackingGroup& g = t.second;
+    std::string group_type = conduit::DataType::id_to_name(g.data_type);
+    if (group_type == "float32") {
+      pack_block<float>(group_name, block, row, num_rows, node, index);
+    }
+    else if (group_type == "float64") {
+      pack_block<double>(group_name, block, row, num_rows, node, index);
+    }
+    else {
+      LBANN_ERROR("packing is currently only implemented for float32 and "
+                  "float64; your data type was: ",
+                  group_type,
+                  " for group_name: ",
+                  group_name);
+    }
+  }
+}
+
 void hdf5_data_reader::pack(conduit::Node& node, size_t index)
 {
   if (m_packing_groups.size() == 0) {
@@ -773,7 +1251,8 @@ void hdf5_data_reader::coerce(const conduit::Node& metadata,
 
 void hdf5_data_reader::repack_image(conduit::Node& node,
                                     const std::string& path,
-                                    const conduit::Node& metadata)
+                                    const conduit::Node& metadata,
+                                    size_t num_images)
 {
 
   // ==== start: sanity checking
@@ -791,8 +1270,7 @@ void hdf5_data_reader::repack_image(conduit::Node& node,
   // ==== end: sanity checking
 
   void* vals = node[path].element_ptr(0);
-  size_t n_bytes = node[path].dtype().number_of_elements() *
-                   node[path].dtype().element_bytes();
+  size_t n_elts = node[path].dtype().number_of_elements() / num_images;
   int64_t n_channels = metadata["channels"].value();
   const conduit::int64* dims = metadata["dims"].as_int64_ptr();
   const int row_dim = dims[0];
@@ -800,11 +1278,15 @@ void hdf5_data_reader::repack_image(conduit::Node& node,
 
   if (node[path].dtype().is_float32()) {
     float* data = reinterpret_cast<float*>(vals);
-    do_repack_image(data, n_bytes, row_dim, col_dim, n_channels);
+    for (size_t k = 0; k < num_images; ++k) {
+      do_repack_image(data + k * n_elts, n_elts, row_dim, col_dim, n_channels);
+    }
   }
   else if (node[path].dtype().is_float64()) {
     double* data = reinterpret_cast<double*>(vals);
-    do_repack_image(data, n_bytes, row_dim, col_dim, n_channels);
+    for (size_t k = 0; k < num_images; ++k) {
+      do_repack_image(data + k * n_elts, n_elts, row_dim, col_dim, n_channels);
+    }
   }
   else {
     LBANN_ERROR(
@@ -0,0 +1,215 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+//
+// data_reader_image_shards .hpp .cpp - data reader for packed image shards
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/comm_impl.hpp"
+#include "lbann/data_readers/data_reader_image_shards.hpp"
+#include "lbann/utils/argument_parser.hpp"
+#include "lbann/utils/file_utils.hpp"
+#include "lbann/utils/image.hpp"
+#include "lbann/utils/options.hpp"
+#include "lbann/utils/threads/thread_pool.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <numeric>
+#include <sstream>
+#include <unistd.h>
+
+namespace lbann {
+
+class image_shard_reader::shard_handles {
+public:
+  shard_handles(const std::vector<std::string>& filenames) {
+    for (const auto& filename : filenames) {
+      const int fd = open(filename.c_str(), O_RDONLY);
+      if (fd == -1) {
+        close_all();
+        LBANN_ERROR("could not open image shard ", filename,
+                    " (", std::strerror(errno), ")");
+      }
+      m_fds.push_back(fd);
+    }
+  }
+  ~shard_handles() { close_all(); }
+  shard_handles(const shard_handles&) = delete;
+  shard_handles& operator=(const shard_handles&) = delete;
+
+  /** @brief Read size bytes at offset in a shard */
+  void read(uint32_t shard, uint64_t offset, uint64_t size, uint8_t* buf) const {
+    uint64_t bytes_read = 0;
+    while (bytes_read < size) {
+      const ssize_t n = pread(m_fds.at(shard),
+                              buf + bytes_read,
+                              size - bytes_read,
+                              offset + bytes_read);
+      if (n < 0 && errno == EINTR) {
+        continue;
+      }
+      if (n <= 0) {
+        LBANN_ERROR("could not read ", size, " bytes at offset ", offset,
+                    " from image shard ", shard,
+                    (n < 0 ? std::string(" (") + std::strerror(errno) + ")"
+                           : std::string(" (unexpected end of file)")));
+      }
+      bytes_read += n;
+    }
+  }
+
+private:
+  void close_all() {
+    for (const auto& fd : m_fds) {
+      close(fd);
+    }
+    m_fds.clear();
+  }
+
+  std::vector<int> m_fds;
+};
+
+image_shard_reader::image_shard_reader(bool shuffle)
+  : image_data_reader(shuffle) {
+  set_defaults();
+}
+
+image_shard_reader::~image_shard_reader() {}
+
+void image_shard_reader::read_index(std::istream& istrm,
+                                    std::vector<std::string>& shards,
+                                    std::vector<shard_sample>& samples,
+                                    labels_t& labels) {
+  std::string magic;
+  int version = 0;
+  istrm >> magic >> version;
+  if (!istrm || magic != "LBANN_IMAGE_SHARDS" || version != 1) {
+    LBANN_ERROR("image shard index has an unrecognized header");
+  }
+  size_t num_shards = 0, num_samples = 0;
+  istrm >> num_shards >> num_samples;
+  if (!istrm) {
+    LBANN_ERROR("image shard index is missing the shard and sample counts");
+  }
+  shards.resize(num_shards);
+  for (auto& shard : shards) {
+    istrm >> shard;
+  }
+  samples.resize(num_samples);
+  labels.resize(num_samples);
+  for (size_t i = 0; i < num_samples; ++i) {
+    auto& sample = samples[i];
+    istrm >> sample.shard >> sample.offset >> sample.size >> labels[i];
+    if (!istrm) {
+      LBANN_ERROR("image shard index ends after ", i, " of ",
+                  num_samples, " samples");
+    }
+    if (sample.shard >= num_shards) {
+      LBANN_ERROR("sample ", i, " in image shard index refers to shard ",
+                  sample.shard, ", but there are only ", num_shards,
+                  " shards");
+    }
+  }
+}
+
+void image_shard_reader::load() {
+  auto& arg_parser = global_argument_parser();
+  if (arg_parser.get<bool>(USE_DATA_STORE) ||
+      arg_parser.get<bool>(PRELOAD_DATA_STORE) ||
+      arg_parser.get<bool>(DATA_STORE_CACHE) ||
+      arg_parser.get<std::string>(DATA_STORE_SPILL) != "" ||
+      arg_parser.get<std::string>(DATA_STORE_TIERED_CACHE) != "") {
+    LBANN_ERROR("the image_shards data reader does not support the data store; "
+                "please remove --use_data_store, --preload_data_store, "
+                "--data_store_cache, --data_store_spill, and "
+                "--data_store_tiered_cache");
+  }
+
+  const std::string index_filename = get_file_dir() + get_data_filename();
+
+  // Only the trainer master touches the filesystem for the index
+  std::string index;
+  if (m_comm->am_trainer_master()) {
+    std::ifstream in(index_filename);
+    if (!in) {
+      LBANN_ERROR("failed to open image shard index ", index_filename);
+    }
+    std::ostringstream ss;
+    ss << in.rdbuf();
+    index = ss.str();
+  }
+  m_comm->trainer_broadcast(0, index);
+
+  std::vector<std::string> shards;
+  {
+    std::istringstream istrm(index);
+    read_index(istrm, shards, m_samples, m_labels);
+  }
+
+  // Shard paths are relative to the index file
+  const std::string index_dir =
+    add_delimiter(file::extract_parent_directory(index_filename));
+  for (auto& shard : shards) {
+    if (shard.empty() || shard[0] != '/') {
+      shard = index_dir + shard;
+    }
+  }
+  m_shards = std::make_shared<shard_handles>(shards);
+
+  // reset indices
+  m_shuffled_indices.clear();
+  m_shuffled_indices.resize(m_samples.size());
+  std::iota(m_shuffled_indices.begin(), m_shuffled_indices.end(), 0);
+  resize_shuffled_indices();
+
+  select_subset_of_data();
+}
+
+void image_shard_reader::setup(int num_io_threads,
+                               observer_ptr<thread_pool> io_thread_pool) {
+  image_data_reader::setup(num_io_threads, io_thread_pool);
+  m_thread_buffers.resize(num_io_threads);
+}
+
+bool image_shard_reader::fetch_datum(CPUMat& X, int data_id, int mb_idx) {
+  const auto& sample = m_samples.at(data_id);
+  auto& buf = m_thread_buffers[m_io_thread_pool->get_local_thread_id()];
+  buf.resize(sample.size);
+  m_shards->read(sample.shard, sample.offset, sample.size, buf.data());
+
+  El::Matrix<uint8_t> encoded_image(sample.size, 1, buf.data(), sample.size);
+  El::Matrix<uint8_t> image;
+  std::vector<size_t> dims;
+  decode_image(encoded_image, image, dims);
+
+  auto X_v = El::View(X, El::IR(0, X.Height()), El::IR(mb_idx, mb_idx + 1));
+  m_transform_pipeline.apply(image, X_v, dims);
+
+  return true;
+}
+
+}  // namespace lbann
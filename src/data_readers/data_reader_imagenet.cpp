@@ -29,16 +29,38 @@
 #include "lbann/data_readers/data_reader_imagenet.hpp"
 #include "lbann/data_readers/sample_list_impl.hpp"
 #include "lbann/utils/image.hpp"
+#include "lbann/utils/argument_parser.hpp"
 #include "lbann/utils/file_utils.hpp"
+#include "lbann/utils/options.hpp"
+
+#include <unistd.h>
 
 namespace lbann {
 
 imagenet_reader::imagenet_reader(bool shuffle)
   : image_data_reader(shuffle) {
   set_defaults();
+  auto& arg_parser = global_argument_parser();
+  m_use_mmap = arg_parser.get<bool>(IMAGE_MMAP);
+  m_image_readahead = arg_parser.get<int>(IMAGE_READAHEAD);
 }
 
-imagenet_reader::~imagenet_reader() {}
+imagenet_reader::imagenet_reader(const imagenet_reader& other)
+  : image_data_reader(other),
+    m_use_mmap(other.m_use_mmap),
+    m_image_readahead(other.m_image_readahead) {}
+
+imagenet_reader& imagenet_reader::operator=(const imagenet_reader& other) {
+  image_data_reader::operator=(other);
+  close_readahead_files();
+  m_use_mmap = other.m_use_mmap;
+  m_image_readahead = other.m_image_readahead;
+  return *this;
+}
+
+imagenet_reader::~imagenet_reader() {
+  close_readahead_files();
+}
 
 void imagenet_reader::set_defaults() {
   m_image_width = 256;
@@ -49,6 +71,69 @@ void imagenet_reader::set_defaults() {
   m_supported_input_types[INPUT_DATA_TYPE_LABELS] = true;
 }
 
+void imagenet_reader::load_image_file(int data_id,
+                                      const std::string& image_path,
+                                      El::Matrix<uint8_t>& image,
+                                      std::vector<size_t>& dims) const {
+  int fd = -1;
+  if (m_image_readahead > 0) {
+    std::lock_guard<std::mutex> lock(m_readahead_mutex);
+    auto it = m_readahead_files.find(data_id);
+    if (it != m_readahead_files.end()) {
+      fd = it->second;
+      m_readahead_files.erase(it);
+    }
+  }
+  if (fd != -1) {
+    if (m_use_mmap) {
+      load_image_mmap(fd, image_path, image, dims);
+    } else {
+      load_image(fd, image_path, image, dims);
+    }
+  } else if (m_use_mmap) {
+    load_image_mmap(image_path, image, dims);
+  } else {
+    load_image(image_path, image, dims);
+  }
+}
+
+void imagenet_reader::readahead_image_file(int mb_idx) const {
+  if (m_image_readahead <= 0) {
+    return;
+  }
+  // Earlier slots already hinted the files for the nearer mini-batches
+  const size_t pos = m_fetch_pos + mb_idx * m_sample_stride
+    + m_image_readahead * m_stride_to_next_mini_batch;
+  if (pos >= m_shuffled_indices.size()) {
+    return;
+  }
+  const int data_id = m_shuffled_indices[pos];
+  {
+    std::lock_guard<std::mutex> lock(m_readahead_mutex);
+    if (m_readahead_files.count(data_id) > 0) {
+      return;
+    }
+  }
+  const auto file_id = m_sample_list[data_id].first;
+  const int fd = prefetch_image_file(
+    get_file_dir() + m_sample_list.get_samples_filename(file_id));
+  if (fd == -1) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(m_readahead_mutex);
+  if (!m_readahead_files.emplace(data_id, fd).second) {
+    close(fd);
+  }
+}
+
+void imagenet_reader::close_readahead_files() const {
+  std::lock_guard<std::mutex> lock(m_readahead_mutex);
+  for (const auto& f : m_readahead_files) {
+    close(f.second);
+  }
+  m_readahead_files.clear();
+}
+
 CPUMat imagenet_reader::create_datum_view(CPUMat& X, const int mb_idx) const {
   return El::View(X, El::IR(0, X.Height()), El::IR(mb_idx, mb_idx + 1));
 }
@@ -87,7 +172,7 @@ bool imagenet_reader::fetch_datum(CPUMat& X, int data_id, int mb_idx) {
         }
       }
       m_issue_warning = false;
-      load_image(image_path, image, dims);
+      load_image_file(data_id, image_path, image, dims);
       have_node = false;
     }
 
@@ -101,7 +186,8 @@ bool imagenet_reader::fetch_datum(CPUMat& X, int data_id, int mb_idx) {
 
   // this block fires if not using data store
   else {
-    load_image(image_path, image, dims);
+    readahead_image_file(mb_idx);
+    load_image_file(data_id, image_path, image, dims);
   }
 
   auto X_v = create_datum_view(X, mb_idx);
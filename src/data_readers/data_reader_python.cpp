@@ -134,7 +134,7 @@ bool python_reader::fetch_data_block(
   // Get arguments for sample access function
   python::object args_list = PyList_New(0);
   for (El::Int i = 0; i < mb_size; ++i) {
-    El::Int sample_index = m_shuffled_indices[m_current_pos + i * m_sample_stride];
+    El::Int sample_index = m_shuffled_indices[m_fetch_pos + i * m_sample_stride];
     El::Int array_offset = sample_size * i;
     PyList_Append(args_list,
                   python::object(Py_BuildValue("(l,l)",
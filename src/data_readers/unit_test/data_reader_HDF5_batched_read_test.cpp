@@ -0,0 +1,166 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <catch2/catch.hpp>
+
+#include "TestHelpers.hpp"
+
+#include <conduit/conduit.hpp>
+#include <cstdio>
+#include <hdf5.h>
+
+#include "lbann/data_readers/data_reader_HDF5.hpp"
+
+class DataReaderHDF5WhiteboxTester
+{
+public:
+  bool read_field_block(lbann::hdf5_data_reader& x,
+                        hid_t file_handle,
+                        const std::string& path,
+                        const conduit::Node& metadata,
+                        const std::vector<hsize_t>& rows,
+                        conduit::Node& block,
+                        bool ignore_failure = false)
+  {
+    return x.read_field_block(file_handle,
+                              path,
+                              metadata,
+                              rows,
+                              block,
+                              ignore_failure);
+  }
+};
+
+namespace {
+
+/** Writes a chunked [6,4] float64 dataset "/x", with x[i][j] = 4*i+j,
+ *  and a [6] int32 dataset "/n", with n[i] = 10+i.
+ */
+void write_test_file(const std::string& filename)
+{
+  hid_t file = H5Fcreate(filename.c_str(),
+                         H5F_ACC_TRUNC,
+                         H5P_DEFAULT,
+                         H5P_DEFAULT);
+  REQUIRE(file >= 0);
+
+  hsize_t x_dims[2] = {6, 4};
+  hsize_t x_chunk[2] = {2, 4};
+  std::vector<double> x(24);
+  for (size_t i = 0; i < x.size(); ++i) {
+    x[i] = i;
+  }
+  hid_t x_space = H5Screate_simple(2, x_dims, nullptr);
+  hid_t x_plist = H5Pcreate(H5P_DATASET_CREATE);
+  H5Pset_chunk(x_plist, 2, x_chunk);
+  hid_t x_dataset = H5Dcreate2(file, "/x", H5T_NATIVE_DOUBLE, x_space,
+                               H5P_DEFAULT, x_plist, H5P_DEFAULT);
+  H5Dwrite(x_dataset, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT,
+           x.data());
+  H5Dclose(x_dataset);
+  H5Pclose(x_plist);
+  H5Sclose(x_space);
+
+  hsize_t n_dims[1] = {6};
+  std::vector<int32_t> n = {10, 11, 12, 13, 14, 15};
+  hid_t n_space = H5Screate_simple(1, n_dims, nullptr);
+  hid_t n_dataset = H5Dcreate2(file, "/n", H5T_NATIVE_INT32, n_space,
+                               H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+  H5Dwrite(n_dataset, H5T_NATIVE_INT32, H5S_ALL, H5S_ALL, H5P_DEFAULT,
+           n.data());
+  H5Dclose(n_dataset);
+  H5Sclose(n_space);
+
+  H5Fclose(file);
+}
+
+} // namespace
+
+TEST_CASE("hdf5 data reader batched reads",
+          "[data_reader][hdf5][batched]")
+{
+  const std::string filename = "data_reader_HDF5_batched_read_test.h5";
+  write_test_file(filename);
+  hid_t file = H5Fopen(filename.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+  REQUIRE(file >= 0);
+
+  lbann::hdf5_data_reader dr;
+  dr.set_chunk_cache(1 << 20, 127);
+  DataReaderHDF5WhiteboxTester white_box_tester;
+  conduit::Node metadata;
+
+  SECTION("rows with runs are read in file order")
+  {
+    conduit::Node block;
+    REQUIRE(white_box_tester.read_field_block(dr, file, "/x", metadata,
+                                              {0, 2, 3, 5}, block));
+    REQUIRE(block.dtype().is_float64());
+    REQUIRE(block.dtype().number_of_elements() == 16);
+    const double* data = block.as_float64_ptr();
+    const std::vector<double> expected = {0,  1,  2,  3,  8,  9,  10, 11,
+                                          12, 13, 14, 15, 20, 21, 22, 23};
+    for (size_t i = 0; i < expected.size(); ++i) {
+      CHECK(data[i] == expected[i]);
+    }
+  }
+
+  SECTION("isolated rows of a 1D dataset")
+  {
+    conduit::Node block;
+    REQUIRE(white_box_tester.read_field_block(dr, file, "/n", metadata,
+                                              {1, 3, 5}, block));
+    REQUIRE(block.dtype().is_int32());
+    REQUIRE(block.dtype().number_of_elements() == 3);
+    const int32_t* data = block.as_int32_ptr();
+    CHECK(data[0] == 11);
+    CHECK(data[1] == 13);
+    CHECK(data[2] == 15);
+  }
+
+  SECTION("coercion is done on read")
+  {
+    conduit::Node block;
+    metadata["coerce"] = "float";
+    REQUIRE(white_box_tester.read_field_block(dr, file, "/n", metadata,
+                                              {4}, block));
+    REQUIRE(block.dtype().is_float32());
+    CHECK(block.as_float32_ptr()[0] == 14.f);
+  }
+
+  SECTION("invalid reads")
+  {
+    conduit::Node block;
+    CHECK_THROWS(white_box_tester.read_field_block(dr, file, "/x", metadata,
+                                                   {2, 6}, block));
+    CHECK_THROWS(white_box_tester.read_field_block(dr, file, "/foo", metadata,
+                                                   {0}, block));
+    CHECK_FALSE(white_box_tester.read_field_block(dr, file, "/foo", metadata,
+                                                  {0}, block, true));
+  }
+
+  H5Fclose(file);
+  std::remove(filename.c_str());
+}
@@ -0,0 +1,90 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <catch2/catch.hpp>
+
+#include "lbann/data_readers/data_reader_image_shards.hpp"
+
+#include <sstream>
+
+TEST_CASE("Image shard index parsing", "[data_reader][image_shards]")
+{
+  std::vector<std::string> shards;
+  std::vector<lbann::image_shard_reader::shard_sample> samples;
+  lbann::image_data_reader::labels_t labels;
+
+  SECTION("Valid index")
+  {
+    std::istringstream index("LBANN_IMAGE_SHARDS 1\n"
+                             "2 3\n"
+                             "train.00000.shard\n"
+                             "train.00001.shard\n"
+                             "0 0 1000 7\n"
+                             "0 1000 1300 2\n"
+                             "1 0 1600 999\n");
+    REQUIRE_NOTHROW(lbann::image_shard_reader::read_index(index,
+                                                          shards,
+                                                          samples,
+                                                          labels));
+    REQUIRE(shards.size() == 2);
+    CHECK(shards[1] == "train.00001.shard");
+    REQUIRE(samples.size() == 3);
+    REQUIRE(labels.size() == 3);
+    CHECK(samples[1].shard == 0);
+    CHECK(samples[1].offset == 1000);
+    CHECK(samples[1].size == 1300);
+    CHECK(samples[2].shard == 1);
+    CHECK(labels[0] == 7);
+    CHECK(labels[2] == 999);
+  }
+
+  SECTION("Bad header")
+  {
+    std::istringstream index("LBANN_SAMPLE_LIST 1\n1 0\nx.shard\n");
+    CHECK_THROWS(lbann::image_shard_reader::read_index(index,
+                                                       shards,
+                                                       samples,
+                                                       labels));
+  }
+
+  SECTION("Truncated index")
+  {
+    std::istringstream index("LBANN_IMAGE_SHARDS 1\n1 2\nx.shard\n0 0 10 1\n");
+    CHECK_THROWS(lbann::image_shard_reader::read_index(index,
+                                                       shards,
+                                                       samples,
+                                                       labels));
+  }
+
+  SECTION("Shard out of range")
+  {
+    std::istringstream index("LBANN_IMAGE_SHARDS 1\n1 1\nx.shard\n1 0 10 1\n");
+    CHECK_THROWS(lbann::image_shard_reader::read_index(index,
+                                                       shards,
+                                                       samples,
+                                                       labels));
+  }
+}
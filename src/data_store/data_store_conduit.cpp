@@ -27,6 +27,7 @@
 
 #include "lbann/comm_impl.hpp"
 #include "lbann/data_store/data_store_conduit.hpp"
+#include "lbann/data_store/sample_compression.hpp"
 
 #include "lbann/data_readers/data_reader_jag_conduit.hpp"
 #include "lbann/data_readers/data_reader_image.hpp"
@@ -38,6 +39,8 @@
 #include "lbann/utils/file_utils.hpp"
 #include "lbann/utils/commify.hpp"
 #include "lbann/utils/serialize.hpp"
+#include "lbann/utils/memory.hpp"
+#include <atomic>
 #include <unordered_set>
 #include <sys/mman.h>
 #include <sys/stat.h>
@@ -48,7 +51,9 @@
 #include <unistd.h>
 #include <sys/statvfs.h>
 
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
 
 namespace lbann {
 
@@ -94,11 +99,33 @@ data_store_conduit::data_store_conduit(
   if (arg_parser.get<std::string>(DATA_STORE_SPILL) != "") {
     setup_spill(arg_parser.get<std::string>(DATA_STORE_SPILL));
   }
+  if (arg_parser.get<std::string>(DATA_STORE_TIERED_CACHE) != "") {
+    if (arg_parser.get<std::string>(DATA_STORE_SPILL) != "" ||
+        arg_parser.get<bool>(DATA_STORE_CACHE)) {
+      LBANN_ERROR("--data_store_tiered_cache can not be combined with --data_store_spill or --data_store_cache");
+    }
+    setup_tiered_cache(arg_parser.get<std::string>(DATA_STORE_TIERED_CACHE));
+  }
 
   set_is_local_cache(arg_parser.get<bool>(DATA_STORE_CACHE));
   set_is_preloading(arg_parser.get<bool>(PRELOAD_DATA_STORE));
   set_is_explicitly_loading(! is_preloading());
 
+  if (arg_parser.get<bool>(DATA_STORE_COMPRESS)) {
+    if (arg_parser.get<std::string>(DATA_STORE_SPILL) != "" || is_local_cache()) {
+      LBANN_ERROR("--data_store_compress can not be combined with --data_store_spill or --data_store_cache");
+    }
+    // compressed sizes depend on the sample contents
+    m_compress_samples = true;
+    m_node_sizes_vary = true;
+    PROFILE("data_store_conduit is compressing samples");
+  }
+
+  m_locality = arg_parser.get<float>(DATA_STORE_LOCALITY);
+  if (m_locality < 0 || m_locality > 1) {
+    LBANN_ERROR("--data_store_locality must be in [0,1]; value is: ", m_locality);
+  }
+
   if (is_local_cache()) {
     PROFILE("data_store_conduit is running in local_cache mode");
   } else {
@@ -217,6 +244,14 @@ void data_store_conduit::copy_members(const data_store_conduit& rhs) {
   m_cur_spill_dir = rhs.m_cur_spill_dir;
   m_num_files_in_cur_spill_dir = rhs.m_num_files_in_cur_spill_dir;
 
+  // each copy evicts samples to its own directory
+  m_tiered_cache_dir_base = rhs.m_tiered_cache_dir_base;
+  m_tiered_cache_memory_budget = rhs.m_tiered_cache_memory_budget;
+  m_tiered_cache.reset();
+
+  m_compress_samples = rhs.m_compress_samples;
+  m_locality = rhs.m_locality;
+
   /// Clear the pointer to the data reader, this cannot be copied
   m_reader = nullptr;
   m_shuffled_indices = nullptr;
@@ -301,10 +336,26 @@ void data_store_conduit::set_preloaded_conduit_node(int data_id, const conduit::
     return;
   }
 
+  if (using_tiered_cache()) {
+    auto n2 = make_unique<conduit::Node>();
+    pack_sample(node, *n2);  // node == m_data[data_id]
+    if (!m_node_sizes_vary) {
+      error_check_compacted_node(*n2, data_id);
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_my_num_indices;
+    if (m_node_sizes_vary) {
+      m_sample_sizes[data_id] = n2->total_bytes_compact();
+    }
+    m_data.erase(data_id);
+    get_tiered_cache().insert(data_id, std::move(n2));
+    return;
+  }
+
   {
     conduit::Node n2 = node;  // node == m_data[data_id]
     std::lock_guard<std::mutex> lock(m_mutex);
-    build_node_for_sending(n2, m_data[data_id]);
+    pack_sample(n2, m_data[data_id]);
   }
   if (!m_node_sizes_vary) {
     error_check_compacted_node(m_data[data_id], data_id);
@@ -358,7 +409,7 @@ void data_store_conduit::set_conduit_node(int data_id, const conduit::Node &node
 
   {
     //std::lock_guard<std::mutex> lock(m_mutex);
-    if (already_have == false && m_data.find(data_id) != m_data.end()) {
+    if (already_have == false && has_conduit_node(data_id)) {
       DEBUG_DS("m_data.size: ", m_data.size(), " ERROR: duplicate data_id: ", data_id);
       LBANN_ERROR("duplicate data_id: ", data_id, " in data_store_conduit::set_conduit_node; role: ", m_reader->get_role());
     }
@@ -375,6 +426,20 @@ void data_store_conduit::set_conduit_node(int data_id, const conduit::Node &node
     m_data[data_id] = node;
   }
 
+  else if (using_tiered_cache()) {
+    auto key = std::make_pair(data_id, m_offset_in_partition);
+    m_owner[key] = m_rank_in_trainer;
+    auto n2 = make_unique<conduit::Node>();
+    pack_sample(node, *n2);
+    m_sample_sizes[data_id] = n2->total_bytes_compact();
+    error_check_compacted_node(*n2, data_id);
+    get_tiered_cache().insert(data_id, std::move(n2));
+    if (already_have) {
+      // 'node' was obtained from get_empty_node(), i.e, it is in m_data
+      m_data.erase(data_id);
+    }
+  }
+
   else {
     if (m_spill) {
   PROFILE("spill!\n");
@@ -407,7 +472,7 @@ void data_store_conduit::set_conduit_node(int data_id, const conduit::Node &node
       DEBUG_DS("set_conduit_node : rank_in_trainer=", m_rank_in_trainer, " and partition_in_trainer=", m_partition_in_trainer, " offset in partition=", m_offset_in_partition, " with num_partitions=", m_num_partitions_in_trainer);
       auto key = std::make_pair(data_id, m_offset_in_partition);
       m_owner[key] = m_rank_in_trainer;
-      build_node_for_sending(node, m_data[data_id]);
+      pack_sample(node, m_data[data_id]);
       m_sample_sizes[data_id] = m_data[data_id].total_bytes_compact();
       error_check_compacted_node(m_data[data_id], data_id);
       //      m_mutex.unlock();
@@ -425,6 +490,10 @@ const conduit::Node & data_store_conduit::get_conduit_node(int data_id) const {
     return t3->second;
   }
 
+  if (m_compress_samples) {
+    return get_decompressed_sample(data_id)["data"];
+  }
+
   iterator_t t2 = m_minibatch_data.find(data_id);
   // if not preloaded, and get_label() or get_response() is called,
   // we need to check m_data
@@ -433,6 +502,10 @@ const conduit::Node & data_store_conduit::get_conduit_node(int data_id) const {
     if (t3 != m_data.end()) {
       return t3->second["data"];
     }
+    // n.b. the node stays pinned in memory until the next exchange
+    if (using_tiered_cache() && get_tiered_cache().contains(data_id)) {
+      return get_tiered_cache().get(data_id)["data"];
+    }
     LBANN_ERROR("failed to find data_id: ", data_id, " in m_minibatch_data; m_minibatch_data.size: ", m_minibatch_data.size(), " and also failed to find it in m_data; m_data.size: ", m_data.size(), "; role: ", m_reader->get_role());
   }
 
@@ -475,6 +548,125 @@ void data_store_conduit::build_node_for_sending(const conduit::Node &node_in, co
   }
 }
 
+void data_store_conduit::unpack_node(conduit::uint8 *buffer, conduit::Node &node_out) {
+  node_out["schema_len"].set_external((conduit::int64*)buffer);
+  buffer +=8;
+  node_out["schema"].set_external_char8_str((char*)(buffer));
+  conduit::Schema rcv_schema;
+  conduit::Generator gen(node_out["schema"].as_char8_str());
+  gen.walk(rcv_schema);
+  buffer += node_out["schema"].total_bytes_compact();
+  node_out["data"].set_external(rcv_schema, buffer);
+}
+
+void data_store_conduit::find_largest_leaf(const conduit::Node &node, size_t &largest_bytes, size_t &element_size) {
+  if (node.number_of_children() == 0) {
+    const conduit::DataType &dtype = node.dtype();
+    const size_t bytes = dtype.number_of_elements() * dtype.element_bytes();
+    if (bytes > largest_bytes) {
+      largest_bytes = bytes;
+      element_size = dtype.element_bytes();
+    }
+    return;
+  }
+  for (conduit::index_t i = 0; i < node.number_of_children(); ++i) {
+    find_largest_leaf(node.child(i), largest_bytes, element_size);
+  }
+}
+
+void data_store_conduit::pack_sample(const conduit::Node &node_in, conduit::Node &node_out) {
+  if (!m_compress_samples) {
+    build_node_for_sending(node_in, node_out);
+    return;
+  }
+
+  conduit::Node packed;
+  build_node_for_sending(node_in, packed);
+  const unsigned char *raw = reinterpret_cast<const unsigned char*>(packed.data_ptr());
+
+  // the schema is small and is left uncompressed; the data part is at
+  // the end of the node
+  compressed_sample_header header;
+  header.raw_size = packed.total_bytes_compact();
+  header.schema_size = header.raw_size - packed["data"].total_bytes_compact();
+  size_t largest_bytes = 0;
+  size_t element_size = 1;
+  find_largest_leaf(packed["data"], largest_bytes, element_size);
+  header.element_size = element_size;
+  const std::vector<unsigned char> data =
+    shuffle_rle_compress(raw + header.schema_size,
+                         header.raw_size - header.schema_size,
+                         element_size);
+
+  node_out.reset();
+  node_out.set(conduit::DataType::uint8(sizeof(header) + header.schema_size + data.size()));
+  unsigned char *out = reinterpret_cast<unsigned char*>(node_out.data_ptr());
+  std::memcpy(out, &header, sizeof(header));
+  std::memcpy(out + sizeof(header), raw, header.schema_size);
+  std::copy(data.begin(), data.end(), out + sizeof(header) + header.schema_size);
+
+  m_stored_raw_bytes += header.raw_size;
+  m_stored_compressed_bytes += node_out.total_bytes_compact();
+}
+
+void data_store_conduit::decompress_sample(const conduit::Node &compressed, conduit::Node &buffer, conduit::Node &node_out) const {
+  const unsigned char *in = reinterpret_cast<const unsigned char*>(compressed.data_ptr());
+  const size_t size = compressed.total_bytes_compact();
+  compressed_sample_header header;
+  if (size < sizeof(header)) {
+    LBANN_ERROR("compressed sample has ", size, " bytes, which is less than its header");
+  }
+  std::memcpy(&header, in, sizeof(header));
+  if (size < sizeof(header) + header.schema_size || header.raw_size < header.schema_size) {
+    LBANN_ERROR("compressed sample has an invalid header; size: ", size, " raw size: ", header.raw_size, " schema size: ", header.schema_size);
+  }
+
+  buffer.set(conduit::DataType::uint8(header.raw_size));
+  unsigned char *out = reinterpret_cast<unsigned char*>(buffer.data_ptr());
+  std::memcpy(out, in + sizeof(header), header.schema_size);
+  const size_t offset = sizeof(header) + header.schema_size;
+  shuffle_rle_decompress(in + offset, size - offset,
+                         out + header.schema_size,
+                         header.raw_size - header.schema_size,
+                         header.element_size);
+  unpack_node(reinterpret_cast<conduit::uint8*>(out), node_out);
+}
+
+const conduit::Node& data_store_conduit::get_decompressed_sample(int data_id) const {
+  decompressed_sample *sample = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(m_decompression_mutex);
+    sample = &m_decompressed_samples[data_id];
+  }
+
+  // if several threads ask for the same sample, one decompresses it
+  // and the others wait
+  std::call_once(sample->decoded, [this, data_id, sample]() {
+    const conduit::Node *compressed = nullptr;
+    map_ii_t::const_iterator t1 = m_compressed_recv_indices.find(data_id);
+    std::unordered_map<int, conduit::Node>::const_iterator t2 = m_data.find(data_id);
+    if (t1 != m_compressed_recv_indices.end()) {
+      compressed = &m_recv_buffer[t1->second];
+    } else if (t2 != m_data.end()) {
+      compressed = &t2->second;
+    } else if (using_tiered_cache() && get_tiered_cache().contains(data_id)) {
+      // n.b. the node stays pinned in memory until the next exchange
+      compressed = &get_tiered_cache().get(data_id);
+    } else {
+      LBANN_ERROR("failed to find compressed sample for data_id: ", data_id, "; received samples: ", m_compressed_recv_indices.size(), " m_data.size: ", m_data.size(), "; role: ", m_reader->get_role());
+    }
+
+    double tm1 = get_time();
+    decompress_sample(*compressed, sample->buffer, sample->node);
+    const double elapsed = get_time() - tm1;
+
+    std::lock_guard<std::mutex> lock(m_decompression_mutex);
+    ++m_num_decompressed;
+    m_decompression_time += elapsed;
+  });
+  return sample->node;
+}
+
 void data_store_conduit::exchange_data_by_sample(size_t current_pos, size_t mb_size) {
   if (! m_is_setup) {
     LBANN_ERROR("setup(mb_size) has not been called");
@@ -524,10 +716,13 @@ void data_store_conduit::exchange_data_by_sample(size_t current_pos, size_t mb_s
   for (int p=0; p<m_np_in_trainer; p++) {
     const std::unordered_set<int> &indices = m_indices_to_send[p];
     for (auto index : indices) {
-      if (m_data.find(index) == m_data.end()) {
+      if (!using_tiered_cache() && m_data.find(index) == m_data.end()) {
         LBANN_ERROR("failed to find data_id: ", index, " to be sent to ", p, " in m_data");
       }
-      const conduit::Node& n = m_data[index];
+      // n.b. samples stay pinned in the tiered cache until the sends complete
+      const conduit::Node& n = (using_tiered_cache()
+                                ? get_tiered_cache().get(index)
+                                : m_data[index]);
       const El::byte *s = reinterpret_cast<const El::byte*>(n.data_ptr());
       if(!n.is_contiguous()) {
         LBANN_ERROR("data_id: ", index, " does not have a contiguous layout");
@@ -548,6 +743,20 @@ void data_store_conduit::exchange_data_by_sample(size_t current_pos, size_t mb_s
         sz = m_sample_sizes[index];
       }
 
+      if (p == m_rank_in_trainer) {
+        ++m_num_local_samples;
+      } else {
+        ++m_num_remote_samples;
+        m_remote_bytes += sz;
+      }
+
+      if (m_compress_samples) {
+        compressed_sample_header header;
+        std::memcpy(&header, s, sizeof(header));
+        m_sent_raw_bytes += header.raw_size;
+        m_sent_compressed_bytes += sz;
+      }
+
       m_comm->nb_tagged_send<El::byte>(s, sz, p, index, m_send_requests[ss++], m_comm->get_trainer_comm());
     }
   }
@@ -557,6 +766,11 @@ void data_store_conduit::exchange_data_by_sample(size_t current_pos, size_t mb_s
     LBANN_ERROR("ss != m_send_requests.size; ss: ", ss, " m_send_requests.size: ", m_send_requests.size());
   }
 
+  // read the samples for the next mini-batch while this one is in flight
+  if (using_tiered_cache()) {
+    prefetch_tiered_cache(current_pos + mb_size, mb_size);
+  }
+
   // start recvs for incoming data
   ss = 0;
 
@@ -597,27 +811,32 @@ void data_store_conduit::exchange_data_by_sample(size_t current_pos, size_t mb_s
   m_comm->wait_all(m_recv_requests);
   m_comm->trainer_barrier();
   m_wait_all_time += (get_time() - tm5);
+  if (using_tiered_cache()) {
+    get_tiered_cache().unpin_all();
+  }
 
   //========================================================================
   //part 3: construct the Nodes needed by me for the current minibatch
 
   tm5 = get_time();
-  conduit::Node nd;
   m_minibatch_data.clear();
-  for (size_t j=0; j < m_recv_buffer.size(); j++) {
-    conduit::uint8 *n_buff_ptr = (conduit::uint8*)m_recv_buffer[j].data_ptr();
-    conduit::Node n_msg;
-    n_msg["schema_len"].set_external((conduit::int64*)n_buff_ptr);
-    n_buff_ptr +=8;
-    n_msg["schema"].set_external_char8_str((char*)(n_buff_ptr));
-    conduit::Schema rcv_schema;
-    conduit::Generator gen(n_msg["schema"].as_char8_str());
-    gen.walk(rcv_schema);
-    n_buff_ptr += n_msg["schema"].total_bytes_compact();
-    n_msg["data"].set_external(rcv_schema,n_buff_ptr);
-
-    int data_id = m_recv_data_ids[j];
-    m_minibatch_data[data_id].set_external(n_msg["data"]);
+  if (m_compress_samples) {
+    // compressed samples are decompressed by the I/O threads; see
+    // get_decompressed_sample()
+    m_decompressed_samples.clear();
+    m_compressed_recv_indices.clear();
+    for (size_t j=0; j < m_recv_data_ids.size(); j++) {
+      m_compressed_recv_indices[m_recv_data_ids[j]] = j;
+    }
+  }
+  else {
+    for (size_t j=0; j < m_recv_buffer.size(); j++) {
+      conduit::uint8 *n_buff_ptr = (conduit::uint8*)m_recv_buffer[j].data_ptr();
+      conduit::Node n_msg;
+      unpack_node(n_buff_ptr, n_msg);
+      int data_id = m_recv_data_ids[j];
+      m_minibatch_data[data_id].set_external(n_msg["data"]);
+    }
   }
   m_rebuild_time += (get_time() - tm5);
 
@@ -627,18 +846,22 @@ void data_store_conduit::exchange_data_by_sample(size_t current_pos, size_t mb_s
   }
 }
 
+int data_store_conduit::get_consumer_rank(int pos) const {
+#ifdef LBANN_HAS_DISTCONV
+  int num_ranks_in_partition = dc::get_number_of_io_partitions();
+#else
+  int num_ranks_in_partition = 1;
+#endif // LBANN_HAS_DISTCONV
+  return ((pos % m_owner_map_mb_size) % m_num_partitions_in_trainer) * num_ranks_in_partition + m_offset_in_partition;
+}
+
 int data_store_conduit::build_indices_i_will_recv(int current_pos, int mb_size) {
   m_indices_to_recv.clear();
   m_indices_to_recv.resize(m_np_in_trainer);
   int k = 0;
   for (int i=current_pos; i< current_pos + mb_size; ++i) {
     auto index = (*m_shuffled_indices)[i];
-#ifdef LBANN_HAS_DISTCONV
-    int num_ranks_in_partition = dc::get_number_of_io_partitions();
-#else
-    int num_ranks_in_partition = 1;
-#endif // LBANN_HAS_DISTCONV
-    if ((((i % m_owner_map_mb_size) % m_num_partitions_in_trainer) * num_ranks_in_partition + m_offset_in_partition) == m_rank_in_trainer) {
+    if (get_consumer_rank(i) == m_rank_in_trainer) {
       auto key = std::make_pair(index, m_offset_in_partition);
       int owner = m_owner[key];
       m_indices_to_recv[owner].insert(index);
@@ -661,14 +884,11 @@ int data_store_conduit::build_indices_i_will_send(int current_pos, int mb_size)
       is_mine = true;
     } else if (m_spilled_nodes.find(index) != m_spilled_nodes.end()) {
       is_mine = true;
+    } else if (using_tiered_cache() && get_tiered_cache().contains(index)) {
+      is_mine = true;
     }
     if (is_mine) {
-#ifdef LBANN_HAS_DISTCONV
-      int num_ranks_in_partition = dc::get_number_of_io_partitions();
-#else
-      int num_ranks_in_partition = 1;
-#endif // LBANN_HAS_DISTCONV
-      m_indices_to_send[(((i % m_owner_map_mb_size) % m_num_partitions_in_trainer) * num_ranks_in_partition + m_offset_in_partition)].insert(index);
+      m_indices_to_send[get_consumer_rank(i)].insert(index);
 
       // Sanity check
       auto key = std::make_pair(index, m_offset_in_partition);
@@ -700,6 +920,16 @@ PROFILE("build_preloaded_owner_map; m_owner_maps_were_exchanged = true");
 }
 
 const conduit::Node & data_store_conduit::get_random_node() const {
+  if (m_data.empty() && using_tiered_cache()) {
+    const auto data_ids = get_tiered_cache().get_data_ids();
+    if (!data_ids.empty()) {
+      const int data_id = data_ids[random() % data_ids.size()];
+      return (m_compress_samples
+              ? get_decompressed_sample(data_id)
+              : get_tiered_cache().get(data_id));
+    }
+  }
+
   size_t sz = m_data.size();
 
   // Deal with edge case
@@ -709,7 +939,7 @@ const conduit::Node & data_store_conduit::get_random_node() const {
 
   int offset = random() % sz;
   auto it = std::next(m_data.begin(), offset);
-  return it->second;
+  return (m_compress_samples ? get_decompressed_sample(it->first) : it->second);
 }
 
 const conduit::Node & data_store_conduit::get_random_node(const std::string &field) const {
@@ -897,7 +1127,56 @@ void data_store_conduit::check_mem_capacity(lbann_comm *comm, const std::string
 
 bool data_store_conduit::has_conduit_node(int data_id) const {
   std::unordered_map<int, conduit::Node>::const_iterator t = m_data.find(data_id);
-  return t != m_data.end();
+  if (t != m_data.end()) {
+    return true;
+  }
+  return using_tiered_cache() && get_tiered_cache().contains(data_id);
+}
+
+void data_store_conduit::localize_shuffled_indices(std::vector<int> &indices, rng_gen &gen) const {
+  if (m_locality <= 0 || !m_owner_maps_were_exchanged || m_owner_map_mb_size == 0 || is_local_cache()) {
+    return;
+  }
+
+  // positions of the samples owned by each rank, in shuffled order
+  std::vector<std::vector<size_t>> owned(m_np_in_trainer);
+  for (size_t j = 0; j < indices.size(); ++j) {
+    auto it = m_owner.find(std::make_pair(indices[j], m_offset_in_partition));
+    if (it == m_owner.end()) {
+      LBANN_ERROR("failed to find owner of data_id: ", indices[j], "; m_owner.size: ", m_owner.size(), " role: ", m_reader->get_role());
+    }
+    owned[it->second].push_back(j);
+  }
+
+  // fill each position with the next unused sample owned by its
+  // consumer, or with the next unused sample overall; the latter keeps
+  // the order of the global shuffle when m_locality is small, and
+  // picks up the excess when a rank runs out of its own samples
+  std::vector<size_t> next_owned(m_np_in_trainer, 0);
+  std::vector<bool> used(indices.size(), false);
+  size_t next_global = 0;
+  std::uniform_real_distribution<double> dist(0., 1.);
+  std::vector<int> localized(indices.size());
+  for (size_t i = 0; i < indices.size(); ++i) {
+    const int rank = get_consumer_rank(i);
+    const std::vector<size_t> &mine = owned[rank];
+    size_t &next = next_owned[rank];
+    while (next < mine.size() && used[mine[next]]) {
+      ++next;
+    }
+    size_t j;
+    if (next < mine.size() && dist(gen) < m_locality) {
+      j = mine[next++];
+    } else {
+      while (used[next_global]) {
+        ++next_global;
+      }
+      j = next_global;
+    }
+    used[j] = true;
+    localized[i] = indices[j];
+  }
+  indices.swap(localized);
 }
 
 void data_store_conduit::set_shuffled_indices(const std::vector<int> *indices) {
@@ -1495,6 +1774,9 @@ void data_store_conduit::exchange_mini_batch_data(size_t current_pos, size_t mb_
     PROFILE("  is_fully_loaded: ", is_fully_loaded());
     if (! is_local_cache()) {
       profile_timing();
+      print_tiered_cache_statistics();
+      print_compression_statistics();
+      print_exchange_statistics();
     }
   }
 
@@ -1543,7 +1825,11 @@ void data_store_conduit::flush_profile_file() const {
 }
 
 size_t data_store_conduit::get_num_global_indices() const {
-  size_t n = m_comm->trainer_allreduce<size_t>(m_data.size());
+  size_t my_num_samples = m_data.size();
+  if (using_tiered_cache()) {
+    my_num_samples += get_tiered_cache().get_num_samples();
+  }
+  size_t n = m_comm->trainer_allreduce<size_t>(my_num_samples);
   return n;
 }
 
@@ -1656,8 +1942,25 @@ void data_store_conduit::write_checkpoint(std::string dir_name) {
   // save conduit Nodes
   m_metadata << get_conduit_dir() << "\n";
   DEBUG_DS("m_data.size: ", m_data.size());
-  for (auto t : m_data) {
-    spill_conduit_node(t.second["data"], t.first);
+  // compressed samples are written uncompressed
+  auto spill = [this](const conduit::Node &nd, int data_id) {
+    if (m_compress_samples) {
+      conduit::Node buffer, unpacked;
+      decompress_sample(nd, buffer, unpacked);
+      spill_conduit_node(unpacked["data"], data_id);
+    } else {
+      spill_conduit_node(nd["data"], data_id);
+    }
+  };
+  for (const auto &t : m_data) {
+    spill(t.second, t.first);
+  }
+  if (using_tiered_cache()) {
+    auto& cache = get_tiered_cache();
+    for (const auto& data_id : cache.get_data_ids()) {
+      spill(cache.get(data_id), data_id);
+      cache.unpin_all();
+    }
   }
   m_metadata.close();
   PROFILE("time to write checkpoint: ", (get_time() - tm1));
@@ -1771,7 +2074,7 @@ void data_store_conduit::load_checkpoint(std::string dir_name, generic_data_read
       const std::string fn2 = base_dir + "/" + tmp;
       conduit::Node nd;
       nd.load(fn2);
-      build_node_for_sending(nd, m_data[sample_id]);
+      pack_sample(nd, m_data[sample_id]);
     }
   }
   metadata.close();
@@ -1860,6 +2163,144 @@ void data_store_conduit::load_spilled_conduit_nodes() {
   }
 }
 
+void data_store_conduit::setup_tiered_cache(std::string base_dir) {
+  if (base_dir == "lassen") {
+     base_dir = get_lassen_spill_dir();
+  }
+  auto& arg_parser = global_argument_parser();
+  const int budget_mb = arg_parser.get<int>(DATA_STORE_MEMORY_BUDGET);
+  if (budget_mb <= 0) {
+    LBANN_ERROR("--data_store_tiered_cache requires --data_store_memory_budget=<MB> to be positive; value is: ", budget_mb);
+  }
+  m_tiered_cache_dir_base = base_dir;
+  m_tiered_cache_memory_budget = static_cast<size_t>(budget_mb) * 1024 * 1024;
+  PROFILE("base directory for tiered cache: ", m_tiered_cache_dir_base, "; memory budget: ", budget_mb, " MB");
+
+  make_dir_if_it_doesnt_exist(m_tiered_cache_dir_base);
+  m_comm->trainer_barrier();
+}
+
+tiered_sample_cache& data_store_conduit::get_tiered_cache() const {
+  std::lock_guard<std::mutex> lock(m_tiered_cache_mutex);
+  if (m_tiered_cache == nullptr) {
+    static std::atomic<int> num_caches{0};
+    const std::string dir = m_tiered_cache_dir_base + "/tiered_cache_"
+      + m_reader->get_role() + "_" + std::to_string(m_rank_in_world)
+      + "_" + std::to_string(num_caches++);
+    // as with spilled nodes, rebuild the node for sending after
+    // loading; compressed samples are flat arrays and need no repair
+    tiered_sample_cache::restore_function restore = nullptr;
+    if (!m_compress_samples) {
+      restore = [](conduit::Node &node) {
+        conduit::Node sample = node["data"];
+        build_node_for_sending(sample, node);
+      };
+    }
+    m_tiered_cache = make_unique<tiered_sample_cache>(
+      m_tiered_cache_memory_budget, dir, restore);
+  }
+  return *m_tiered_cache;
+}
+
+void data_store_conduit::prefetch_tiered_cache(size_t current_pos, size_t mb_size) {
+  auto& cache = get_tiered_cache();
+  const size_t end_pos = std::min(current_pos + mb_size, m_shuffled_indices->size());
+  std::vector<int> data_ids;
+  for (size_t i = current_pos; i < end_pos; ++i) {
+    const auto index = (*m_shuffled_indices)[i];
+    if (cache.contains(index)) {
+      data_ids.push_back(index);
+    }
+  }
+  cache.prefetch(std::move(data_ids));
+}
+
+void data_store_conduit::print_tiered_cache_statistics() {
+  if (!using_tiered_cache()) {
+    return;
+  }
+  auto& cache = get_tiered_cache();
+  const auto stats = cache.get_statistics();
+  cache.reset_statistics();
+  const int count = 6;
+  size_t send[count] = {stats.hits, stats.prefetch_hits, stats.misses,
+                        stats.evictions, stats.bytes_read, stats.bytes_written};
+  size_t rcv[count];
+  m_comm->trainer_allreduce<size_t>(send, count, rcv);
+  const size_t accesses = rcv[0] + rcv[1] + rcv[2];
+  if (m_trainer_master && accesses > 0) {
+    const double mb = 1024. * 1024.;
+    std::stringstream s;
+    s << "data store tiered cache (" << m_reader->get_role() << "): "
+      << rcv[0] << " hits, "
+      << rcv[1] << " prefetch hits, "
+      << rcv[2] << " misses ("
+      << 100. * (rcv[0] + rcv[1]) / accesses << "% served from memory), "
+      << rcv[3] << " evictions, "
+      << rcv[4] / mb << " MB read, "
+      << rcv[5] / mb << " MB written\n";
+    std::cout << s.str();
+    PROFILE(s.str());
+  }
+}
+
+void data_store_conduit::print_compression_statistics() {
+  if (!m_compress_samples) {
+    return;
+  }
+  size_t num_decompressed = 0;
+  double decompression_time = 0;
+  {
+    std::lock_guard<std::mutex> lock(m_decompression_mutex);
+    num_decompressed = m_num_decompressed;
+    decompression_time = m_decompression_time;
+    m_num_decompressed = 0;
+    m_decompression_time = 0;
+  }
+  const int count = 5;
+  size_t send[count] = {m_stored_raw_bytes, m_stored_compressed_bytes,
+                        m_sent_raw_bytes, m_sent_compressed_bytes,
+                        num_decompressed};
+  m_sent_raw_bytes = 0;
+  m_sent_compressed_bytes = 0;
+  size_t rcv[count];
+  m_comm->trainer_allreduce<size_t>(send, count, rcv);
+  const double max_time = m_comm->trainer_allreduce(decompression_time, El::mpi::MAX);
+  if (m_trainer_master && rcv[1] > 0) {
+    const double mb = 1024. * 1024.;
+    std::stringstream s;
+    s << "data store compression (" << m_reader->get_role() << "): "
+      << rcv[0] / mb << " MB stored as " << rcv[1] / mb << " MB ("
+      << double(rcv[0]) / rcv[1] << "x); "
+      << rcv[2] / mb << " MB exchanged as " << rcv[3] / mb << " MB ("
+      << (rcv[3] > 0 ? double(rcv[2]) / rcv[3] : 1.) << "x); "
+      << rcv[4] << " samples decompressed in " << max_time
+      << " s (max over ranks, summed over I/O threads)\n";
+    std::cout << s.str();
+    PROFILE(s.str());
+  }
+}
+
+void data_store_conduit::print_exchange_statistics() {
+  const int count = 3;
+  size_t send[count] = {m_num_local_samples, m_num_remote_samples, m_remote_bytes};
+  m_num_local_samples = 0;
+  m_num_remote_samples = 0;
+  m_remote_bytes = 0;
+  size_t rcv[count];
+  m_comm->trainer_allreduce<size_t>(send, count, rcv);
+  const size_t num_samples = rcv[0] + rcv[1];
+  if (m_trainer_master && num_samples > 0) {
+    std::stringstream s;
+    s << "data store exchange (" << m_reader->get_role() << "): "
+      << rcv[1] << " of " << num_samples << " samples ("
+      << 100. * rcv[1] / num_samples << "%) sent between ranks, "
+      << rcv[2] / (1024. * 1024.) << " MB; locality: " << m_locality << "\n";
+    std::cout << s.str();
+    PROFILE(s.str());
+  }
+}
+
 void data_store_conduit::open_informational_files() {
   auto& arg_parser = global_argument_parser();
   if (m_comm == nullptr) {
@@ -2065,6 +2506,9 @@ size_t data_store_conduit::get_mem_usage() {
     }
     r += nd.total_bytes_compact();
   }
+  if (using_tiered_cache()) {
+    r += get_tiered_cache().get_memory_usage();
+  }
   return r;
 }
 
@@ -0,0 +1,156 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/data_store/sample_compression.hpp"
+
+#include "lbann/utils/exception.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace lbann {
+
+namespace {
+
+/** Shortest run that is encoded as a repeated byte. */
+constexpr size_t min_run = 3;
+/** Longest run in one block. */
+constexpr size_t max_run = 127 + min_run;
+/** Longest literal sequence in one block. */
+constexpr size_t max_literal = 128;
+
+/** Whether a run of at least @c min_run bytes starts at @c pos. */
+bool run_starts_at(const unsigned char* data, size_t size, size_t pos) {
+  if (pos + min_run > size) {
+    return false;
+  }
+  for (size_t i = 1; i < min_run; ++i) {
+    if (data[pos + i] != data[pos]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace <anon>
+
+std::vector<unsigned char> shuffle_rle_compress(const unsigned char* data,
+                                                size_t size,
+                                                size_t element_size) {
+  element_size = std::max(element_size, size_t(1));
+
+  // Group bytes by their position within elements
+  const size_t num_elements = size / element_size;
+  const size_t shuffled_size = num_elements * element_size;
+  std::vector<unsigned char> shuffled(size);
+  for (size_t k = 0; k < element_size; ++k) {
+    for (size_t i = 0; i < num_elements; ++i) {
+      shuffled[k * num_elements + i] = data[i * element_size + k];
+    }
+  }
+  std::copy(data + shuffled_size, data + size,
+            shuffled.begin() + shuffled_size);
+
+  // Run-length encoding
+  const unsigned char* in = shuffled.data();
+  std::vector<unsigned char> out;
+  out.reserve(size + size / max_literal + 1);
+  size_t pos = 0;
+  while (pos < size) {
+    size_t run = 1;
+    while (pos + run < size && run < max_run && in[pos + run] == in[pos]) {
+      ++run;
+    }
+    if (run >= min_run) {
+      out.push_back(static_cast<unsigned char>(128 + run - min_run));
+      out.push_back(in[pos]);
+      pos += run;
+    }
+    else {
+      const size_t start = pos;
+      do {
+        ++pos;
+      } while (pos < size
+               && pos - start < max_literal
+               && !run_starts_at(in, size, pos));
+      out.push_back(static_cast<unsigned char>(pos - start - 1));
+      out.insert(out.end(), in + start, in + pos);
+    }
+  }
+  return out;
+}
+
+void shuffle_rle_decompress(const unsigned char* data,
+                            size_t size,
+                            unsigned char* output,
+                            size_t output_size,
+                            size_t element_size) {
+  element_size = std::max(element_size, size_t(1));
+
+  // Run-length decoding
+  std::vector<unsigned char> shuffled(output_size);
+  size_t in_pos = 0;
+  size_t out_pos = 0;
+  while (in_pos < size) {
+    const size_t control = data[in_pos++];
+    if (control < 128) {
+      const size_t length = control + 1;
+      if (in_pos + length > size || out_pos + length > output_size) {
+        LBANN_ERROR("corrupt compressed buffer: literal block of ", length,
+                    " bytes at offset ", in_pos - 1, " overruns buffer");
+      }
+      std::memcpy(shuffled.data() + out_pos, data + in_pos, length);
+      in_pos += length;
+      out_pos += length;
+    }
+    else {
+      const size_t length = control - 128 + min_run;
+      if (in_pos >= size || out_pos + length > output_size) {
+        LBANN_ERROR("corrupt compressed buffer: run of ", length,
+                    " bytes at offset ", in_pos - 1, " overruns buffer");
+      }
+      std::fill_n(shuffled.data() + out_pos, length, data[in_pos++]);
+      out_pos += length;
+    }
+  }
+  if (out_pos != output_size) {
+    LBANN_ERROR("corrupt compressed buffer: decompressed ", out_pos,
+                " bytes, but expected ", output_size);
+  }
+
+  // Restore element byte order
+  const size_t num_elements = output_size / element_size;
+  const size_t shuffled_size = num_elements * element_size;
+  for (size_t k = 0; k < element_size; ++k) {
+    for (size_t i = 0; i < num_elements; ++i) {
+      output[i * element_size + k] = shuffled[k * num_elements + i];
+    }
+  }
+  std::copy(shuffled.begin() + shuffled_size, shuffled.end(),
+            output + shuffled_size);
+}
+
+} // namespace lbann
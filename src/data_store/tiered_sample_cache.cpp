@@ -0,0 +1,241 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/data_store/tiered_sample_cache.hpp"
+
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/file_utils.hpp"
+#include "lbann/utils/memory.hpp"
+
+#include <chrono>
+#include <cstdio>
+
+namespace lbann {
+
+tiered_sample_cache::tiered_sample_cache(size_t memory_budget,
+                                         std::string spill_dir,
+                                         restore_function restore)
+  : m_memory_budget{memory_budget},
+    m_spill_dir{std::move(spill_dir)},
+    m_restore{std::move(restore)} {
+  file::make_directory(m_spill_dir);
+}
+
+tiered_sample_cache::~tiered_sample_cache() {
+  if (m_prefetch.valid()) {
+    m_prefetch.wait();
+  }
+  // conduit writes the schema to a separate "_json" file
+  for (const auto& data_id : m_on_disk) {
+    const auto filename = get_filename(data_id);
+    std::remove(filename.c_str());
+    std::remove((filename + "_json").c_str());
+  }
+  std::remove(m_spill_dir.c_str()); // Only succeeds if empty
+}
+
+void tiered_sample_cache::insert(int data_id,
+                                 std::unique_ptr<conduit::Node> node) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_resident.count(data_id) > 0 || m_on_disk.count(data_id) > 0) {
+    LBANN_ERROR("tiered sample cache already contains data_id ", data_id);
+  }
+  add_resident(data_id, std::move(node));
+  evict_to_budget();
+}
+
+bool tiered_sample_cache::contains(int data_id) const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_resident.count(data_id) > 0 || m_on_disk.count(data_id) > 0;
+}
+
+const conduit::Node& tiered_sample_cache::get(int data_id) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  collect_prefetch(m_prefetching.count(data_id) > 0);
+
+  // Sample is in memory
+  auto it = m_resident.find(data_id);
+  if (it != m_resident.end()) {
+    auto& e = it->second;
+    if (e.prefetched) {
+      ++m_statistics.prefetch_hits;
+      e.prefetched = false;
+    }
+    else {
+      ++m_statistics.hits;
+    }
+    m_lru.splice(m_lru.begin(), m_lru, e.lru_pos);
+    e.pinned = true;
+    return *e.node;
+  }
+
+  // Read sample from disk
+  if (m_on_disk.count(data_id) == 0) {
+    LBANN_ERROR("tiered sample cache does not contain data_id ", data_id);
+  }
+  ++m_statistics.misses;
+  auto node = read_sample(data_id);
+  m_statistics.bytes_read += node->total_bytes_compact();
+  auto& e = add_resident(data_id, std::move(node));
+  e.pinned = true;
+  evict_to_budget();
+  return *e.node;
+}
+
+void tiered_sample_cache::unpin_all() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for (auto& t : m_resident) {
+    t.second.pinned = false;
+  }
+  evict_to_budget();
+}
+
+void tiered_sample_cache::prefetch(std::vector<int> data_ids) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  collect_prefetch(true);
+  std::vector<int> to_read;
+  for (const auto& data_id : data_ids) {
+    if (m_resident.count(data_id) == 0
+        && m_on_disk.count(data_id) > 0
+        && m_prefetching.insert(data_id).second) {
+      to_read.push_back(data_id);
+    }
+  }
+  if (to_read.empty()) {
+    return;
+  }
+  m_prefetch = std::async(
+    std::launch::async,
+    [this, to_read]() {
+      prefetch_result result;
+      result.reserve(to_read.size());
+      for (const auto& data_id : to_read) {
+        result.emplace_back(data_id, read_sample(data_id));
+      }
+      return result;
+    });
+}
+
+std::vector<int> tiered_sample_cache::get_data_ids() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  std::vector<int> data_ids(m_on_disk.begin(), m_on_disk.end());
+  for (const auto& t : m_resident) {
+    if (m_on_disk.count(t.first) == 0) {
+      data_ids.push_back(t.first);
+    }
+  }
+  return data_ids;
+}
+
+size_t tiered_sample_cache::get_num_samples() const {
+  return get_data_ids().size();
+}
+
+size_t tiered_sample_cache::get_memory_usage() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_memory_usage;
+}
+
+tiered_sample_cache_statistics tiered_sample_cache::get_statistics() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_statistics;
+}
+
+void tiered_sample_cache::reset_statistics() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_statistics = tiered_sample_cache_statistics{};
+}
+
+std::string tiered_sample_cache::get_filename(int data_id) const {
+  return m_spill_dir + "/" + std::to_string(data_id);
+}
+
+std::unique_ptr<conduit::Node>
+tiered_sample_cache::read_sample(int data_id) const {
+  auto node = make_unique<conduit::Node>();
+  node->load(get_filename(data_id));
+  if (m_restore) {
+    m_restore(*node);
+  }
+  return node;
+}
+
+void tiered_sample_cache::evict_to_budget() {
+  auto it = m_lru.end();
+  while (m_memory_usage > m_memory_budget && it != m_lru.begin()) {
+    --it;
+    const int data_id = *it;
+    auto& e = m_resident.at(data_id);
+    if (e.pinned) {
+      continue;
+    }
+    if (m_on_disk.count(data_id) == 0) {
+      e.node->save(get_filename(data_id));
+      m_on_disk.insert(data_id);
+      m_statistics.bytes_written += e.bytes;
+    }
+    m_memory_usage -= e.bytes;
+    ++m_statistics.evictions;
+    m_resident.erase(data_id);
+    it = m_lru.erase(it);
+  }
+}
+
+tiered_sample_cache::entry&
+tiered_sample_cache::add_resident(int data_id,
+                                  std::unique_ptr<conduit::Node> node) {
+  auto& e = m_resident[data_id];
+  e.bytes = node->total_bytes_compact();
+  e.node = std::move(node);
+  m_lru.push_front(data_id);
+  e.lru_pos = m_lru.begin();
+  m_memory_usage += e.bytes;
+  return e;
+}
+
+void tiered_sample_cache::collect_prefetch(bool wait) {
+  if (!m_prefetch.valid()) {
+    return;
+  }
+  if (!wait
+      && m_prefetch.wait_for(std::chrono::seconds(0))
+           != std::future_status::ready) {
+    return;
+  }
+  auto result = m_prefetch.get();
+  m_prefetching.clear();
+  for (auto& t : result) {
+    if (m_resident.count(t.first) > 0) {
+      continue;
+    }
+    m_statistics.bytes_read += t.second->total_bytes_compact();
+    auto& e = add_resident(t.first, std::move(t.second));
+    e.prefetched = true;
+  }
+  evict_to_budget();
+}
+
+} // namespace lbann
@@ -0,0 +1,211 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <catch2/catch.hpp>
+
+#include "MPITestHelpers.hpp"
+#include "TestHelpers.hpp"
+
+#include "./data_store_conduit_whitebox_tester.hpp"
+
+#include "lbann/data_readers/data_reader_synthetic.hpp"
+#include "lbann/utils/memory.hpp"
+
+#include <conduit/conduit.hpp>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+// Sample with leaves of several types; "values" has the most bytes
+conduit::Node make_sample()
+{
+  conduit::Node node;
+  std::vector<double> values(64);
+  for (size_t i = 0; i < values.size(); ++i) {
+    values[i] = 1.0 + 0.01 * (i / 8);
+  }
+  std::vector<conduit::int32> labels(50);
+  for (size_t i = 0; i < labels.size(); ++i) {
+    labels[i] = static_cast<conduit::int32>(i % 3) - 1;
+  }
+  std::vector<conduit::uint8> mask(301, 0);
+  mask[7] = 255;
+  node["000000012/values"].set(values);
+  node["000000012/labels"].set(labels);
+  node["000000012/meta/mask"].set(mask);
+  node["000000012/meta/scale"].set(conduit::float32(0.25));
+  node["000000012/meta/name"].set("sample twelve");
+  return node;
+}
+
+template <typename T>
+void check_same_leaf(const conduit::Node& expected, const conduit::Node& actual)
+{
+  REQUIRE(actual.dtype().id() == expected.dtype().id());
+  REQUIRE(actual.dtype().number_of_elements()
+          == expected.dtype().number_of_elements());
+  const conduit::DataArray<T> e = expected.value();
+  const conduit::DataArray<T> a = actual.value();
+  for (conduit::index_t i = 0; i < e.number_of_elements(); ++i) {
+    CHECK(a[i] == e[i]);
+  }
+}
+
+void check_same_sample(const conduit::Node& expected,
+                       const conduit::Node& actual)
+{
+  const std::string prefix = "000000012/";
+  check_same_leaf<double>(expected[prefix + "values"],
+                          actual[prefix + "values"]);
+  check_same_leaf<conduit::int32>(expected[prefix + "labels"],
+                                  actual[prefix + "labels"]);
+  check_same_leaf<conduit::uint8>(expected[prefix + "meta/mask"],
+                                  actual[prefix + "meta/mask"]);
+  check_same_leaf<conduit::float32>(expected[prefix + "meta/scale"],
+                                    actual[prefix + "meta/scale"]);
+  CHECK(actual[prefix + "meta/name"].as_string()
+        == expected[prefix + "meta/name"].as_string());
+}
+
+} // namespace <anon>
+
+TEST_CASE("Data store compressed sample round trip",
+          "[mpi][data_store][compression]")
+{
+  auto& comm = unit_test::utilities::current_world_comm();
+  lbann::data_reader_synthetic reader(1, 1, false);
+  reader.set_comm(&comm);
+  auto ds = lbann::make_unique<lbann::data_store_conduit>(&reader);
+  DataStoreConduitWhiteboxTester tester;
+
+  const conduit::Node sample = make_sample();
+  conduit::Node raw;
+  tester.build_node_for_sending(sample, raw);
+  const size_t raw_size = raw.total_bytes_compact();
+  const size_t schema_size = raw_size - raw["data"].total_bytes_compact();
+  const auto* raw_bytes = static_cast<const unsigned char*>(raw.data_ptr());
+
+  SECTION("Largest leaf of a multi-leaf node")
+  {
+    size_t largest_bytes = 0;
+    size_t element_size = 1;
+    tester.find_largest_leaf(sample, largest_bytes, element_size);
+    CHECK(largest_bytes == 64 * sizeof(double));
+    CHECK(element_size == sizeof(double));
+
+    // The int32 leaf is largest once the doubles are gone
+    conduit::Node other = make_sample();
+    other["000000012"].remove("values");
+    largest_bytes = 0;
+    element_size = 1;
+    tester.find_largest_leaf(other, largest_bytes, element_size);
+    CHECK(largest_bytes == 301);
+    CHECK(element_size == 1);
+    other["000000012/labels"].set(std::vector<conduit::int32>(100, 3));
+    largest_bytes = 0;
+    element_size = 1;
+    tester.find_largest_leaf(other, largest_bytes, element_size);
+    CHECK(largest_bytes == 100 * sizeof(conduit::int32));
+    CHECK(element_size == sizeof(conduit::int32));
+  }
+
+  SECTION("Unpacking an uncompressed node")
+  {
+    tester.set_compress_samples(*ds, false);
+    conduit::Node packed;
+    tester.pack_sample(*ds, sample, packed);
+    REQUIRE(packed.total_bytes_compact() == raw_size);
+    CHECK(std::memcmp(packed.data_ptr(), raw_bytes, raw_size) == 0);
+
+    conduit::Node unpacked;
+    tester.unpack_node(static_cast<conduit::uint8*>(packed.data_ptr()),
+                       unpacked);
+    CHECK(unpacked["schema_len"].total_bytes_compact()
+          + unpacked["schema"].total_bytes_compact() == schema_size);
+    check_same_sample(sample, unpacked["data"]);
+  }
+
+  SECTION("Header and schema are stored uncompressed")
+  {
+    tester.set_compress_samples(*ds, true);
+    conduit::Node packed;
+    tester.pack_sample(*ds, sample, packed);
+    REQUIRE(packed.dtype().is_uint8());
+    const auto header = tester.get_header(packed);
+    CHECK(header.raw_size == raw_size);
+    CHECK(header.schema_size == schema_size);
+    CHECK(header.element_size == sizeof(double));
+    REQUIRE(packed.total_bytes_compact() >= sizeof(header) + schema_size);
+    const auto* packed_bytes =
+      static_cast<const unsigned char*>(packed.data_ptr());
+    CHECK(std::memcmp(packed_bytes + sizeof(header),
+                      raw_bytes,
+                      schema_size) == 0);
+    CHECK(packed.total_bytes_compact() < raw_size);
+  }
+
+  SECTION("Compressed samples round trip")
+  {
+    tester.set_compress_samples(*ds, true);
+    conduit::Node packed;
+    tester.pack_sample(*ds, sample, packed);
+
+    conduit::Node buffer;
+    conduit::Node unpacked;
+    tester.decompress_sample(*ds, packed, buffer, unpacked);
+    REQUIRE(buffer.total_bytes_compact() == raw_size);
+    CHECK(std::memcmp(buffer.data_ptr(), raw_bytes, raw_size) == 0);
+    CHECK(unpacked["schema"].as_string() == raw["schema"].as_string());
+    check_same_sample(sample, unpacked["data"]);
+  }
+
+  SECTION("Samples can be compressed in place")
+  {
+    tester.set_compress_samples(*ds, true);
+    conduit::Node node = make_sample();
+    tester.pack_sample(*ds, node, node);
+    REQUIRE(node.dtype().is_uint8());
+
+    conduit::Node buffer;
+    conduit::Node unpacked;
+    tester.decompress_sample(*ds, node, buffer, unpacked);
+    check_same_sample(sample, unpacked["data"]);
+  }
+
+  SECTION("Truncated samples are rejected")
+  {
+    tester.set_compress_samples(*ds, true);
+    conduit::Node packed;
+    tester.pack_sample(*ds, sample, packed);
+    conduit::Node truncated;
+    truncated.set(conduit::DataType::uint8(8));
+    std::memcpy(truncated.data_ptr(), packed.data_ptr(), 8);
+    conduit::Node buffer;
+    conduit::Node unpacked;
+    CHECK_THROWS(tester.decompress_sample(*ds, truncated, buffer, unpacked));
+  }
+}
@@ -0,0 +1,103 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_DATA_STORE_CONDUIT_WHITEBOX_TESTER_HPP_INCLUDED
+#define LBANN_DATA_STORE_CONDUIT_WHITEBOX_TESTER_HPP_INCLUDED
+
+#include "lbann/data_store/data_store_conduit.hpp"
+
+#include <conduit/conduit.hpp>
+#include <cstring>
+#include <vector>
+
+class DataStoreConduitWhiteboxTester
+{
+public:
+  using header_type = lbann::data_store_conduit::compressed_sample_header;
+
+  void set_compress_samples(lbann::data_store_conduit& ds, bool compress)
+  { ds.m_compress_samples = compress; }
+
+  void build_node_for_sending(const conduit::Node& node_in,
+                              conduit::Node& node_out)
+  { lbann::data_store_conduit::build_node_for_sending(node_in, node_out); }
+
+  void unpack_node(conduit::uint8* buffer, conduit::Node& node_out)
+  { lbann::data_store_conduit::unpack_node(buffer, node_out); }
+
+  void find_largest_leaf(const conduit::Node& node,
+                         size_t& largest_bytes,
+                         size_t& element_size)
+  {
+    lbann::data_store_conduit::find_largest_leaf(node,
+                                                 largest_bytes,
+                                                 element_size);
+  }
+
+  void pack_sample(lbann::data_store_conduit& ds,
+                   const conduit::Node& node_in,
+                   conduit::Node& node_out)
+  { ds.pack_sample(node_in, node_out); }
+
+  void decompress_sample(const lbann::data_store_conduit& ds,
+                         const conduit::Node& compressed,
+                         conduit::Node& buffer,
+                         conduit::Node& node_out)
+  { ds.decompress_sample(compressed, buffer, node_out); }
+
+  header_type get_header(const conduit::Node& compressed)
+  {
+    header_type header;
+    std::memcpy(&header, compressed.data_ptr(), sizeof(header));
+    return header;
+  }
+
+  /** Mimics a data store whose owner maps have been exchanged; sample
+   *  @c k is owned by rank @c owners[k]
+   */
+  void set_owner_map(lbann::data_store_conduit& ds,
+                     const std::vector<int>& owners,
+                     int num_ranks,
+                     int mini_batch_size,
+                     double locality)
+  {
+    ds.m_np_in_trainer = num_ranks;
+    ds.m_num_partitions_in_trainer = num_ranks;
+    ds.m_offset_in_partition = 0;
+    ds.m_owner_map_mb_size = mini_batch_size;
+    ds.m_locality = locality;
+    ds.m_owner.clear();
+    for (size_t k = 0; k < owners.size(); ++k) {
+      ds.m_owner[std::make_pair(k, size_t(0))] = owners[k];
+    }
+    ds.m_owner_maps_were_exchanged = true;
+  }
+
+  int get_consumer_rank(const lbann::data_store_conduit& ds, int pos)
+  { return ds.get_consumer_rank(pos); }
+};
+
+#endif // LBANN_DATA_STORE_CONDUIT_WHITEBOX_TESTER_HPP_INCLUDED
@@ -0,0 +1,138 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <catch2/catch.hpp>
+
+#include "MPITestHelpers.hpp"
+#include "TestHelpers.hpp"
+
+#include "./data_store_conduit_whitebox_tester.hpp"
+
+#include "lbann/data_readers/data_reader_synthetic.hpp"
+#include "lbann/utils/memory.hpp"
+#include "lbann/utils/random_number_generators.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+namespace {
+
+constexpr int num_ranks = 4;
+constexpr int mini_batch_size = 8;
+constexpr int num_samples = 48;
+
+// Rank 0 owns only 4 samples, so it runs out of local samples before
+// the end of the epoch; the others split the rest
+std::vector<int> make_owners()
+{
+  std::vector<int> owners(num_samples);
+  for (int k = 0; k < num_samples; ++k) {
+    owners[k] = (k < 4 ? 0 : 1 + k % (num_ranks - 1));
+  }
+  return owners;
+}
+
+std::vector<int> make_shuffled_indices()
+{
+  std::vector<int> indices(num_samples);
+  std::iota(indices.begin(), indices.end(), 0);
+  lbann::rng_gen gen(20210901);
+  std::shuffle(indices.begin(), indices.end(), gen);
+  return indices;
+}
+
+} // namespace <anon>
+
+TEST_CASE("Data store locality-aware shuffling",
+          "[mpi][data_store][locality]")
+{
+  auto& comm = unit_test::utilities::current_world_comm();
+  lbann::data_reader_synthetic reader(1, 1, false);
+  reader.set_comm(&comm);
+  auto ds = lbann::make_unique<lbann::data_store_conduit>(&reader);
+  DataStoreConduitWhiteboxTester tester;
+
+  const std::vector<int> owners = make_owners();
+  const std::vector<int> shuffled = make_shuffled_indices();
+
+  SECTION("Result is a permutation")
+  {
+    for (double locality : {0.3, 0.7, 1.0}) {
+      INFO("locality " << locality);
+      tester.set_owner_map(*ds, owners, num_ranks, mini_batch_size, locality);
+      std::vector<int> indices = shuffled;
+      lbann::rng_gen gen(42);
+      ds->localize_shuffled_indices(indices, gen);
+      CHECK(std::is_permutation(indices.begin(), indices.end(),
+                                shuffled.begin()));
+    }
+  }
+
+  SECTION("Zero locality leaves the shuffle unchanged")
+  {
+    tester.set_owner_map(*ds, owners, num_ranks, mini_batch_size, 0.0);
+    std::vector<int> indices = shuffled;
+    lbann::rng_gen gen(42);
+    ds->localize_shuffled_indices(indices, gen);
+    CHECK(indices == shuffled);
+  }
+
+  SECTION("Full locality uses owned samples while they last")
+  {
+    tester.set_owner_map(*ds, owners, num_ranks, mini_batch_size, 1.0);
+    std::vector<int> indices = shuffled;
+    lbann::rng_gen gen(42);
+    ds->localize_shuffled_indices(indices, gen);
+
+    std::vector<bool> used(num_samples, false);
+    for (size_t i = 0; i < indices.size(); ++i) {
+      const int rank = tester.get_consumer_rank(*ds, i);
+      bool has_owned = false;
+      for (int k = 0; k < num_samples; ++k) {
+        has_owned = has_owned || (owners[k] == rank && !used[k]);
+      }
+      INFO("position " << i << " consumed by rank " << rank);
+      if (has_owned) {
+        CHECK(owners[indices[i]] == rank);
+      }
+      used[indices[i]] = true;
+    }
+  }
+
+  SECTION("Same generator state gives the same result")
+  {
+    tester.set_owner_map(*ds, owners, num_ranks, mini_batch_size, 0.5);
+    std::vector<int> first = shuffled;
+    std::vector<int> second = shuffled;
+    lbann::rng_gen gen1(7);
+    lbann::rng_gen gen2(7);
+    ds->localize_shuffled_indices(first, gen1);
+    ds->localize_shuffled_indices(second, gen2);
+    CHECK(first == second);
+    CHECK(first != shuffled);
+  }
+}
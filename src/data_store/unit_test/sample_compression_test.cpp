@@ -0,0 +1,112 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <catch2/catch.hpp>
+
+#include "lbann/data_store/sample_compression.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+
+std::vector<unsigned char> round_trip(const std::vector<unsigned char>& data,
+                                      size_t element_size,
+                                      size_t* compressed_size = nullptr) {
+  const auto compressed = lbann::shuffle_rle_compress(data.data(),
+                                                      data.size(),
+                                                      element_size);
+  if (compressed_size != nullptr) {
+    *compressed_size = compressed.size();
+  }
+  std::vector<unsigned char> output(data.size());
+  lbann::shuffle_rle_decompress(compressed.data(), compressed.size(),
+                                output.data(), output.size(),
+                                element_size);
+  return output;
+}
+
+} // namespace <anon>
+
+TEST_CASE("Shuffle-RLE sample compression", "[data_store][compression]")
+{
+  SECTION("Smooth float data compresses") {
+    std::vector<float> values(4096, 0.f);
+    for (size_t i = 0; i < 1024; ++i) {
+      values[i] = 1.f + 0.001f * std::floor(i / 64);
+    }
+    std::vector<unsigned char> data(values.size() * sizeof(float));
+    std::memcpy(data.data(), values.data(), data.size());
+    size_t compressed_size = 0;
+    CHECK(round_trip(data, sizeof(float), &compressed_size) == data);
+    CHECK(compressed_size < data.size() / 4);
+  }
+
+  SECTION("Random data round trips with bounded growth") {
+    std::mt19937 gen(20211);
+    std::uniform_int_distribution<int> dist(0, 255);
+    std::vector<unsigned char> data(10007);
+    for (auto& x : data) {
+      x = static_cast<unsigned char>(dist(gen));
+    }
+    size_t compressed_size = 0;
+    CHECK(round_trip(data, 8, &compressed_size) == data);
+    CHECK(compressed_size <= data.size() + data.size() / 128 + 1);
+  }
+
+  SECTION("Partial elements and short runs") {
+    const std::vector<unsigned char> data = {
+      1, 1, 2, 2, 2, 3, 4, 4, 4, 4, 5, 6, 6, 7, 7, 7, 7, 7, 8};
+    CHECK(round_trip(data, 1) == data);
+    CHECK(round_trip(data, 4) == data);
+    CHECK(round_trip(data, 32) == data);
+  }
+
+  SECTION("Long runs") {
+    std::vector<unsigned char> data(1000, 42);
+    data[500] = 0;
+    size_t compressed_size = 0;
+    CHECK(round_trip(data, 1, &compressed_size) == data);
+    CHECK(compressed_size < 32);
+  }
+
+  SECTION("Empty buffer") {
+    CHECK(round_trip({}, 4).empty());
+  }
+
+  SECTION("Corrupt buffer is detected") {
+    const std::vector<unsigned char> data(64, 7);
+    auto compressed = lbann::shuffle_rle_compress(data.data(), data.size(), 4);
+    std::vector<unsigned char> output(data.size() - 1);
+    CHECK_THROWS(lbann::shuffle_rle_decompress(compressed.data(),
+                                               compressed.size(),
+                                               output.data(),
+                                               output.size(),
+                                               4));
+  }
+}
@@ -0,0 +1,132 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <catch2/catch.hpp>
+
+#include "lbann/data_store/tiered_sample_cache.hpp"
+#include "lbann/utils/memory.hpp"
+
+#include <unistd.h>
+
+namespace {
+
+// Sample with 16 doubles (128 bytes)
+std::unique_ptr<conduit::Node> make_sample(int data_id) {
+  auto node = lbann::make_unique<conduit::Node>();
+  std::vector<double> values(16, static_cast<double>(data_id));
+  (*node)["values"].set(values);
+  return node;
+}
+
+double get_sample_value(const conduit::Node& node) {
+  return node["values"].as_double_ptr()[0];
+}
+
+} // namespace <anon>
+
+TEST_CASE("Tiered sample cache", "[data_store][tiered_cache]")
+{
+  const std::string spill_dir =
+    "/tmp/tiered_sample_cache_test_" + std::to_string(getpid());
+  const size_t sample_bytes = make_sample(0)->total_bytes_compact();
+
+  // Room for 4 samples in memory
+  lbann::tiered_sample_cache cache(4 * sample_bytes, spill_dir);
+  for (int i = 0; i < 10; ++i) {
+    cache.insert(i, make_sample(i));
+  }
+
+  SECTION("Memory budget is respected")
+  {
+    CHECK(cache.get_num_samples() == 10);
+    CHECK(cache.get_memory_usage() <= cache.get_memory_budget());
+    auto stats = cache.get_statistics();
+    CHECK(stats.evictions == 6);
+    CHECK(stats.bytes_written == 6 * sample_bytes);
+  }
+
+  SECTION("Evicted samples are read back from disk")
+  {
+    // Samples 6-9 are in memory and 0-5 are on disk
+    for (int i : {6, 7, 8, 9, 0, 1, 2, 3, 4, 5}) {
+      CHECK(cache.contains(i));
+      CHECK(get_sample_value(cache.get(i)) == static_cast<double>(i));
+      cache.unpin_all();
+    }
+    CHECK_FALSE(cache.contains(10));
+    auto stats = cache.get_statistics();
+    CHECK(stats.hits == 4);
+    CHECK(stats.misses == 6);
+  }
+
+  SECTION("Least recently used sample is evicted first")
+  {
+    // Samples 6-9 are in memory; touching 6 makes 7 the LRU sample
+    cache.reset_statistics();
+    cache.get(6);
+    cache.unpin_all();
+    cache.get(0);
+    cache.unpin_all();
+    cache.get(6);
+    cache.unpin_all();
+    cache.get(7);
+    cache.unpin_all();
+    auto stats = cache.get_statistics();
+    CHECK(stats.hits == 2);
+    CHECK(stats.misses == 2);
+  }
+
+  SECTION("Pinned samples are not evicted")
+  {
+    const auto& first = cache.get(0);
+    for (int i = 1; i < 6; ++i) {
+      cache.get(i);
+    }
+    CHECK(cache.get_memory_usage() > cache.get_memory_budget());
+    CHECK(get_sample_value(first) == 0.);
+    cache.unpin_all();
+    CHECK(cache.get_memory_usage() <= cache.get_memory_budget());
+  }
+
+  SECTION("Prefetched samples are served from memory")
+  {
+    cache.reset_statistics();
+    cache.prefetch({0, 1, 2});
+    for (int i = 0; i < 3; ++i) {
+      CHECK(get_sample_value(cache.get(i)) == static_cast<double>(i));
+    }
+    cache.unpin_all();
+    auto stats = cache.get_statistics();
+    CHECK(stats.prefetch_hits == 3);
+    CHECK(stats.misses == 0);
+    CHECK(stats.bytes_read == 3 * sample_bytes);
+  }
+
+  SECTION("Duplicate samples are rejected")
+  {
+    CHECK_THROWS(cache.insert(0, make_sample(0)));
+  }
+}
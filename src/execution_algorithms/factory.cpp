@@ -25,6 +25,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 #include "lbann/execution_algorithms/factory.hpp"
 #include "lbann/execution_algorithms/kfac.hpp"
+#include "lbann/execution_algorithms/local_sgd.hpp"
 #include "lbann/execution_algorithms/ltfb.hpp"
 #include "lbann/execution_algorithms/sgd_training_algorithm.hpp"
 #include "lbann/proto/helpers.hpp"
@@ -42,6 +43,7 @@ lbann::TrainingAlgorithmFactory build_default_factory()
   fact.register_builder("SGD", lbann::make<lbann::sgd_training_algorithm>);
   fact.register_builder("LTFB", lbann::make<lbann::LTFB>);
   fact.register_builder("KFAC", lbann::make<lbann::KFAC>);
+  fact.register_builder("LocalSGD", lbann::make<lbann::local_sgd>);
   return fact;
 }
 
@@ -0,0 +1,297 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/execution_algorithms/local_sgd.hpp"
+
+#include "lbann/comm_impl.hpp"
+#include "lbann/models/model.hpp"
+#include "lbann/optimizers/adam.hpp"
+#include "lbann/optimizers/sgd.hpp"
+#include "lbann/utils/timer.hpp"
+#include "lbann/weights/data_type_weights.hpp"
+
+#include <training_algorithm.pb.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace lbann {
+namespace {
+
+using TensorDataType = DataType;
+using AbsDistMatType = El::AbstractDistMatrix<TensorDataType>;
+
+/** @brief Average matrices over trainers with one allreduce.
+ *  @details The local data of all matrices is packed into a
+ *  contiguous buffer on @c Device.
+ */
+template <El::Device Device>
+void average_packed(std::vector<AbsDistMatType*> const& mats,
+                    lbann_comm& comm)
+{
+  using LocalMatType = El::Matrix<TensorDataType, Device>;
+  El::Int size = 0;
+  for (auto const* mat : mats) {
+    size += mat->LocalHeight() * mat->LocalWidth();
+  }
+  if (size == 0) {
+    return;
+  }
+
+  // Pack local data
+  LocalMatType buffer(size, 1);
+  El::Int offset = 0;
+  for (auto* mat : mats) {
+    auto& local = static_cast<LocalMatType&>(mat->Matrix());
+    const auto height = local.Height();
+    const auto width = local.Width();
+    if (height > 0 && width > 0) {
+      LocalMatType packed;
+      packed.Attach(height, width, buffer.Buffer(offset, 0), height);
+      El::Copy(local, packed);
+    }
+    offset += height * width;
+  }
+
+  // Average over trainers
+  comm.allreduce(static_cast<El::AbstractMatrix<TensorDataType>&>(buffer),
+                 comm.get_intertrainer_comm());
+  El::Scale(El::To<TensorDataType>(1. / comm.get_num_trainers()), buffer);
+
+  // Unpack local data
+  offset = 0;
+  for (auto* mat : mats) {
+    auto& local = static_cast<LocalMatType&>(mat->Matrix());
+    const auto height = local.Height();
+    const auto width = local.Width();
+    if (height > 0 && width > 0) {
+      LocalMatType packed;
+      packed.LockedAttach(height, width, buffer.LockedBuffer(offset, 0), height);
+      El::Copy(packed, local);
+    }
+    offset += height * width;
+  }
+}
+
+} // namespace
+
+local_sgd::local_sgd(std::string name,
+                     std::unique_ptr<sgd_termination_criteria> stop,
+                     size_t averaging_interval,
+                     bool average_optimizer_state,
+                     bool adaptive_interval,
+                     size_t max_averaging_interval,
+                     bool print_time)
+  : BaseType(std::move(name), std::move(stop)),
+    m_averaging_interval{averaging_interval},
+    m_average_optimizer_state{average_optimizer_state},
+    m_adaptive_interval{adaptive_interval},
+    m_max_averaging_interval{max_averaging_interval},
+    m_print_time{print_time},
+    m_current_interval{averaging_interval}
+{
+  if (m_averaging_interval == 0) {
+    LBANN_ERROR("local SGD averaging interval must be positive");
+  }
+  if (m_max_averaging_interval < m_averaging_interval) {
+    LBANN_ERROR("local SGD maximum averaging interval "
+                "(", m_max_averaging_interval, ") is smaller than "
+                "the averaging interval (", m_averaging_interval, ")");
+  }
+}
+
+std::string local_sgd::get_type() const { return "local SGD"; }
+
+bool local_sgd::train_mini_batch(sgd_execution_context& c,
+                                 model& model,
+                                 data_coordinator& dc)
+{
+  const bool finished = BaseType::train_mini_batch(c, model, dc);
+  ++m_steps_since_average;
+  // Models are also averaged at the end of each epoch so that
+  // validation sees the averaged model
+  if (finished || m_steps_since_average >= m_current_interval) {
+    if (m_adaptive_interval) {
+      adapt_interval(model);
+    }
+    average_models(model);
+  }
+  return finished;
+}
+
+void local_sgd::do_train_end_cbs(model& model)
+{
+  if (m_steps_since_average > 0) {
+    average_models(model);
+  }
+  auto const& comm = *model.get_comm();
+  if (m_print_time && comm.am_world_master()) {
+    std::cout << "local SGD: " << m_num_averages << " model averages "
+              << "over " << comm.get_num_trainers() << " trainers "
+              << "took " << m_averaging_time << "s "
+              << "(averaging interval " << m_current_interval << ")"
+              << std::endl;
+  }
+  BaseType::do_train_end_cbs(model);
+}
+
+void local_sgd::average_models(model& m)
+{
+  m_steps_since_average = 0;
+  auto& comm = *m.get_comm();
+  if (comm.get_num_trainers() == 1) {
+    return;
+  }
+  const auto start = get_time();
+
+  // Collect weights values and optimizer state
+  std::vector<AbsDistMatType*> cpu_mats, gpu_mats;
+  auto add_matrix = [&](AbsDistMatType& mat) {
+    switch (mat.GetLocalDevice()) {
+    case El::Device::CPU: cpu_mats.push_back(&mat); break;
+#ifdef LBANN_HAS_GPU
+    case El::Device::GPU: gpu_mats.push_back(&mat); break;
+#endif // LBANN_HAS_GPU
+    default: LBANN_ERROR("invalid device");
+    }
+  };
+  for (auto* w : m.get_weights()) {
+    auto* dtw = dynamic_cast<data_type_weights<TensorDataType>*>(w);
+    if (dtw == nullptr) {
+      LBANN_ERROR("local SGD can not average weights \"", w->get_name(), "\" "
+                  "since its data type does not match the default data type");
+    }
+    add_matrix(dtw->get_values());
+    auto* opt = dtw->get_optimizer();
+    if (!m_average_optimizer_state || opt == nullptr) {
+      continue;
+    }
+    if (auto* sgd_opt = dynamic_cast<sgd<TensorDataType>*>(opt)) {
+      if (sgd_opt->get_momentum() != El::TypeTraits<TensorDataType>::Zero()) {
+        add_matrix(sgd_opt->get_velocity());
+      }
+    }
+    else if (auto* adam_opt = dynamic_cast<adam<TensorDataType>*>(opt)) {
+      add_matrix(adam_opt->get_moment1());
+      add_matrix(adam_opt->get_moment2());
+    }
+  }
+
+  // Average with one allreduce per device
+  average_packed<El::Device::CPU>(cpu_mats, comm);
+#ifdef LBANN_HAS_GPU
+  average_packed<El::Device::GPU>(gpu_mats, comm);
+#endif // LBANN_HAS_GPU
+
+  ++m_num_averages;
+  m_averaging_time += get_time() - start;
+}
+
+void local_sgd::adapt_interval(model& m)
+{
+  // Mean training loss since the last model average, over all
+  // trainers. Objective function statistics are reset each epoch.
+  auto const& obj = *m.get_objective_function();
+  const int num_samples =
+    obj.get_statistics_num_samples(execution_mode::training);
+  const EvalType loss_sum =
+    obj.get_mean_value(execution_mode::training) * num_samples;
+  if (num_samples < m_last_loss_samples) {
+    m_last_loss_sum = 0;
+    m_last_loss_samples = 0;
+  }
+  const int interval_samples = num_samples - m_last_loss_samples;
+  EvalType loss = (interval_samples > 0
+                   ? (loss_sum - m_last_loss_sum) / interval_samples
+                   : EvalType(0));
+  m_last_loss_sum = loss_sum;
+  m_last_loss_samples = num_samples;
+  auto const& comm = *m.get_comm();
+  loss = comm.intertrainer_allreduce(loss) / comm.get_num_trainers();
+
+  // Scale interval by sqrt(loss / initial loss)
+  if (m_initial_loss < EvalType(0)) {
+    m_initial_loss = loss;
+    return;
+  }
+  if (m_initial_loss > EvalType(0) && loss >= EvalType(0)) {
+    const auto interval = static_cast<size_t>(std::ceil(
+      m_averaging_interval * std::sqrt(loss / m_initial_loss)));
+    m_current_interval =
+      std::min(std::max(interval, size_t{1}), m_max_averaging_interval);
+  }
+}
+
+} // namespace lbann
+
+template <>
+std::unique_ptr<lbann::local_sgd>
+lbann::make<lbann::local_sgd>(google::protobuf::Message const& msg_in)
+{
+  auto const& params =
+    dynamic_cast<lbann_data::TrainingAlgorithm const&>(msg_in);
+
+  lbann_data::LocalSGD local_sgd_params;
+  LBANN_ASSERT(params.parameters().UnpackTo(&local_sgd_params));
+
+  // SGD parameters
+  auto const& stopping_criteria =
+    local_sgd_params.sgd().stopping_criteria();
+  std::unique_ptr<lbann::sgd_termination_criteria> stopping;
+  switch (stopping_criteria.criterion_case()) {
+  case lbann_data::SGD::TerminationCriteria::kMaxBatches:
+    stopping = lbann::make_unique<lbann::batch_termination_criteria>(
+      stopping_criteria.max_batches());
+    break;
+  case lbann_data::SGD::TerminationCriteria::kMaxEpochs:
+    stopping = lbann::make_unique<lbann::epoch_termination_criteria>(
+      stopping_criteria.max_epochs());
+    break;
+  case lbann_data::SGD::TerminationCriteria::kMaxSeconds:
+    stopping = lbann::make_unique<lbann::seconds_termination_criteria>(
+      stopping_criteria.max_seconds());
+    break;
+  default:
+    LBANN_ERROR("No stopping criteria specified.");
+  }
+
+  // Local SGD parameters
+  const size_t averaging_interval =
+    std::max<size_t>(local_sgd_params.averaging_interval(), 1);
+  const size_t max_averaging_interval =
+    (local_sgd_params.max_averaging_interval() > 0
+     ? local_sgd_params.max_averaging_interval()
+     : averaging_interval);
+  return make_unique<local_sgd>(params.name(),
+                                std::move(stopping),
+                                averaging_interval,
+                                local_sgd_params.average_optimizer_state(),
+                                local_sgd_params.adaptive_interval(),
+                                max_averaging_interval,
+                                local_sgd_params.print_time());
+}
@@ -395,6 +395,19 @@ make_sendrecv_weights(std::set<std::string> weights_names,
     params.exchange_hyperparameters());
 }
 
+std::unique_ptr<lbann::ltfb::StreamWeights>
+make_stream_weights(std::set<std::string> weights_names,
+                    google::protobuf::Message const& msg)
+{
+  using StreamWeights =
+    lbann_data::RandomPairwiseExchange::ExchangeStrategy::StreamWeights;
+  auto const& params = dynamic_cast<StreamWeights const&>(msg);
+  size_t const chunk_bytes =
+    (params.chunk_bytes() > 0 ? params.chunk_bytes() : 64ul << 20);
+  return std::make_unique<lbann::ltfb::StreamWeights>(std::move(weights_names),
+                                                      chunk_bytes);
+}
+
 lbann::ltfb::RandomPairwiseExchange::metric_strategy
 to_lbann(lbann_data::RandomPairwiseExchange::MetricStrategy strategy)
 {
@@ -417,6 +430,7 @@ ExchangeStrategyFactory build_default_exchange_factory()
   factory.register_builder("CheckpointBinary", make_checkpoint_binary);
   factory.register_builder("CheckpointFile", make_checkpoint_file);
   factory.register_builder("SendRecvWeights", make_sendrecv_weights);
+  factory.register_builder("StreamWeights", make_stream_weights);
   return factory;
 }
 
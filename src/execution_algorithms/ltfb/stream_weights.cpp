@@ -0,0 +1,216 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#include "lbann/execution_algorithms/ltfb/random_pairwise_exchange.hpp"
+
+#include "lbann/comm_impl.hpp"
+#include "lbann/models/model.hpp"
+#include "lbann/utils/typename.hpp"
+#include "lbann/weights/data_type_weights.hpp"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <vector>
+
+namespace lbann {
+namespace ltfb {
+namespace {
+
+using TensorDataType = DataType;
+using WeightsType = data_type_weights<TensorDataType>;
+using LocalMatType = El::AbstractMatrix<TensorDataType>;
+using CPUMatType = El::Matrix<TensorDataType, El::Device::CPU>;
+
+/** @brief Local part of a weights matrix being exchanged. */
+struct stream_buffer
+{
+  /** @brief Host copy of the local values, if they cannot be sent in
+   *  place. */
+  CPUMatType send_copy;
+  /** @brief Host buffer for the partner's values, if they cannot be
+   *  received in place. */
+  CPUMatType recv_copy;
+  /** @brief Where to copy @c recv_copy once the receive finishes. */
+  LocalMatType* recv_target = nullptr;
+};
+
+/** @brief Whether MPI can read or write the matrix directly. */
+bool is_contiguous_cpu(LocalMatType const& mat)
+{
+  return (mat.GetDevice() == El::Device::CPU &&
+          (mat.Height() == mat.LDim() || mat.Width() <= 1));
+}
+
+} // namespace
+
+StreamWeights::StreamWeights(std::set<std::string> weights_names,
+                             size_t chunk_bytes)
+  : BaseType(std::move(weights_names)), m_chunk_bytes{chunk_bytes}
+{}
+
+std::unique_ptr<model>
+StreamWeights::get_partner_model(model const& m,
+                                 El::Int partner_trainer,
+                                 size_t /*step*/)
+{
+  auto const& comm = *m.get_comm();
+  int const rank_in_trainer = comm.get_rank_in_trainer();
+
+  // Start by copying this model. Its weights line up one-to-one with
+  // the weights of the local model.
+  auto partner_model_ptr = m.copy_model();
+  auto& partner_model = *partner_model_ptr;
+
+  // Find the weights to exchange
+  auto const& weights_names = this->weights_names();
+  auto const local_weights = m.get_weights();
+  auto const partner_weights = partner_model.get_weights();
+  std::vector<std::pair<WeightsType const*, WeightsType*>> exchange_list;
+  size_t local_size = 0;
+  for (size_t i = 0; i < local_weights.size(); ++i) {
+    if (!weights_names.empty() &&
+        (weights_names.find(local_weights[i]->get_name()) ==
+         weights_names.cend())) {
+      continue;
+    }
+    auto const* src = dynamic_cast<WeightsType const*>(local_weights[i]);
+    auto* dst = dynamic_cast<WeightsType*>(partner_weights[i]);
+    if (src == nullptr || dst == nullptr) {
+      LBANN_ERROR("StreamWeights only supports weights with the default "
+                  "data type (",
+                  TypeName<TensorDataType>(),
+                  "), but weights \"",
+                  local_weights[i]->get_name(),
+                  "\" in model \"",
+                  m.get_name(),
+                  "\" have a different data type");
+    }
+    exchange_list.emplace_back(src, dst);
+    auto const& values = src->get_values().LockedMatrix();
+    local_size += values.Height() * values.Width();
+  }
+
+  // Make sure the partner rank expects the same amount of data
+  std::array<size_t, 2> const my_layout = {exchange_list.size(), local_size};
+  std::array<size_t, 2> partner_layout = {0, 0};
+  comm.sendrecv(my_layout.data(),
+                2,
+                partner_trainer,
+                rank_in_trainer,
+                partner_layout.data(),
+                2,
+                partner_trainer,
+                rank_in_trainer,
+                El::SyncInfo<El::Device::CPU>{});
+  if (my_layout != partner_layout) {
+    LBANN_ERROR("StreamWeights requires identical weights on partner "
+                "trainers, but this rank has ",
+                my_layout[0], " weights with ", my_layout[1],
+                " local entries and its partner has ",
+                partner_layout[0], " weights with ", partner_layout[1],
+                " local entries");
+  }
+
+  // Messages are at most one chunk. A few chunks are kept in flight
+  // at once, which bounds the size of the host staging buffers.
+  size_t const chunk_size = std::min(
+    std::max(m_chunk_bytes / sizeof(TensorDataType), size_t{1}),
+    static_cast<size_t>(std::numeric_limits<int>::max()));
+  size_t const window_size = 4 * chunk_size;
+
+  std::vector<stream_buffer> pending;
+  pending.reserve(exchange_list.size());
+  std::vector<El::mpi::Request<TensorDataType>> requests;
+  size_t pending_size = 0;
+  auto finish_pending = [&]() {
+    comm.wait_all(requests);
+    requests.clear();
+    for (auto& buf : pending) {
+      if (buf.recv_target != nullptr) {
+        El::Copy(buf.recv_copy, *buf.recv_target);
+      }
+    }
+    pending.clear();
+    pending_size = 0;
+  };
+
+  for (auto& [src, dst] : exchange_list) {
+    auto const& send_mat = src->get_values().LockedMatrix();
+    auto& recv_mat = dst->get_values().Matrix();
+    size_t const size = send_mat.Height() * send_mat.Width();
+    if (size == 0) {
+      continue;
+    }
+    pending.emplace_back();
+    auto& buf = pending.back();
+
+    TensorDataType const* send_buf = send_mat.LockedBuffer();
+    if (!is_contiguous_cpu(send_mat)) {
+      El::Copy(send_mat, buf.send_copy);
+#ifdef LBANN_HAS_GPU
+      if (send_mat.GetDevice() != El::Device::CPU) {
+        hydrogen::gpu::SynchronizeDevice();
+      }
+#endif // LBANN_HAS_GPU
+      send_buf = buf.send_copy.LockedBuffer();
+    }
+    TensorDataType* recv_buf = recv_mat.Buffer();
+    if (!is_contiguous_cpu(recv_mat)) {
+      buf.recv_copy.Resize(recv_mat.Height(), recv_mat.Width());
+      buf.recv_target = &recv_mat;
+      recv_buf = buf.recv_copy.Buffer();
+    }
+
+    // Both partners post chunks in the same order, so MPI's
+    // non-overtaking rule matches them up
+    for (size_t offset = 0; offset < size; offset += chunk_size) {
+      int const count = static_cast<int>(std::min(chunk_size, size - offset));
+      requests.emplace_back();
+      comm.nb_recv(recv_buf + offset,
+                   count,
+                   partner_trainer,
+                   rank_in_trainer,
+                   requests.back());
+      requests.emplace_back();
+      comm.nb_send(send_buf + offset,
+                   count,
+                   partner_trainer,
+                   rank_in_trainer,
+                   requests.back());
+    }
+
+    pending_size += size;
+    if (pending_size >= window_size) {
+      finish_pending();
+    }
+  }
+  finish_pending();
+
+  return partner_model_ptr;
+}
+
+} // namespace ltfb
+} // namespace lbann
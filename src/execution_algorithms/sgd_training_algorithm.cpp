@@ -174,46 +174,63 @@ bool sgd_training_algorithm::train_mini_batch(sgd_execution_context& c,
 
   bool finished = false;
 
-  dc.fetch_data(execution_mode::training);
+  // Accumulate gradients over micro-batches. Gradient allreduces are
+  // deferred until the last micro-batch, so there is one allreduce
+  // and one optimization step per step.
+  const size_t num_micro_batches = model.get_gradient_accumulation_steps();
+  for (size_t micro_batch = 0; micro_batch < num_micro_batches; ++micro_batch) {
+
+    dc.fetch_data(execution_mode::training);
 
 #if defined(LBANN_HAVE_OMP_TASKLOOP)
-  LBANN_OMP_PARALLEL
-  {
-#pragma omp single
+    LBANN_OMP_PARALLEL
     {
+#pragma omp single
+      {
 #endif
-      // Forward prop step
-      model.clear_gradients();
-      model.forward_prop(execution_mode::training);
-      // check if the data coordinator has finished the epoch and kickoff
-      // background I/O
-      finished = dc.epoch_complete(execution_mode::training);
-
-      // Result is not needed until the end of the mini-batch.
-      model.get_objective_function()->start_evaluation(
-        execution_mode::training,
-        c.get_current_mini_batch_size());
-
-      // Backward prop step
-      model.get_objective_function()->differentiate();
-      model.backward_prop();
-      model.get_objective_function()->compute_weight_regularization();
-
-      // Finish evaluation.
-      model.get_objective_function()->finish_evaluation(
-        execution_mode::training,
-        c.get_current_mini_batch_size());
-      model.evaluate_metrics(execution_mode::training,
-                             c.get_current_mini_batch_size());
-
-      // Update step
-      model.update_weights();
-      model.update_layers();
+        // Forward prop step
+        if (micro_batch == 0) { model.clear_gradients(); }
+        model.forward_prop(execution_mode::training);
+        // check if the data coordinator has finished the epoch and kickoff
+        // background I/O
+        finished = dc.epoch_complete(execution_mode::training);
+        const bool last_micro_batch
+          = finished || micro_batch + 1 == num_micro_batches;
+        if (num_micro_batches > 1) {
+          model.set_defer_gradient_allreduces(!last_micro_batch);
+        }
+
+        // Result is not needed until the end of the mini-batch.
+        model.get_objective_function()->start_evaluation(
+          execution_mode::training,
+          c.get_current_mini_batch_size());
+
+        // Backward prop step
+        model.get_objective_function()->differentiate();
+        model.backward_prop();
+        model.get_objective_function()->compute_weight_regularization();
+
+        // Finish evaluation.
+        model.get_objective_function()->finish_evaluation(
+          execution_mode::training,
+          c.get_current_mini_batch_size());
+        model.evaluate_metrics(execution_mode::training,
+                               c.get_current_mini_batch_size());
+
+        // Update step
+        if (last_micro_batch) {
+          model.update_weights();
+          model.update_layers();
+        }
 #if defined(LBANN_HAVE_OMP_TASKLOOP)
+      }
     }
-  }
 #endif
 
+    // The last micro-batch of an epoch ends the step early
+    if (finished) { break; }
+  }
+
   c.inc_step();
   do_batch_end_cbs(model, execution_mode::training);
   return finished;
@@ -0,0 +1,401 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <catch2/catch.hpp>
+
+#include "TestHelpers.hpp"
+#include "MPITestHelpers.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/data_coordinator/data_coordinator.hpp>
+#include <lbann/execution_algorithms/sgd_training_algorithm.hpp>
+#include <lbann/execution_contexts/sgd_execution_context.hpp>
+#include <lbann/layers/io/input_layer.hpp>
+#include <lbann/models/model.hpp>
+#include <lbann/optimizers/optimizer.hpp>
+#include <lbann/proto/factories.hpp>
+#include <lbann/utils/lbann_library.hpp>
+#include <lbann/utils/memory.hpp>
+#include <lbann/weights/data_type_weights.hpp>
+
+#include <lbann.pb.h>
+#include <google/protobuf/text_format.h>
+
+namespace pb = ::google::protobuf;
+
+namespace {
+
+using MatType = El::DistMatrix<lbann::DataType, El::STAR, El::STAR,
+                               El::ELEMENT, El::Device::CPU>;
+using InputLayerType = lbann::input_layer<lbann::DataType,
+                                          lbann::data_layout::DATA_PARALLEL,
+                                          El::Device::CPU>;
+
+std::string const fc_model_prototext = R"ptext(
+model {
+  objective_function {
+    layer_term {
+      scale_factor: 1.0
+      layer: "l2"
+    }
+  }
+  layer {
+    name: "x"
+    input {
+      data_field: "samples"
+    }
+  }
+  layer {
+    name: "fc1"
+    parents: "x"
+    weights: "fc1_w fc1_b"
+    fully_connected {
+      num_neurons: 3
+      has_bias: true
+    }
+  }
+  layer {
+    name: "relu1"
+    parents: "fc1"
+    relu {
+    }
+  }
+  layer {
+    name: "fc2"
+    parents: "relu1"
+    weights: "fc2_w"
+    fully_connected {
+      num_neurons: 3
+      has_bias: false
+    }
+  }
+  layer {
+    name: "l2"
+    parents: "fc2"
+    l2_norm2 {
+    }
+  }
+  weights {
+    name: "fc1_w"
+    initializer {
+      value_initializer {
+        values: "0.3 -0.2 0.5 0.1 0.4 -0.6 -0.3 0.2 0.7"
+      }
+    }
+  }
+  weights {
+    name: "fc1_b"
+    initializer {
+      value_initializer {
+        values: "0.1 -0.5 0.2"
+      }
+    }
+  }
+  weights {
+    name: "fc2_w"
+    initializer {
+      value_initializer {
+        values: "0.6 -0.1 0.3 -0.4 0.2 0.5 0.1 -0.7 0.4"
+      }
+    }
+  }
+}
+optimizer {
+  sgd {
+    learn_rate: 0.1
+    momentum: 0.9
+  }
+}
+)ptext";
+
+std::string const bn_model_prototext = R"ptext(
+model {
+  objective_function {
+    layer_term {
+      scale_factor: 1.0
+      layer: "l2"
+    }
+  }
+  layer {
+    name: "x"
+    input {
+      data_field: "samples"
+    }
+  }
+  layer {
+    name: "fc1"
+    parents: "x"
+    weights: "fc1_w"
+    fully_connected {
+      num_neurons: 3
+      has_bias: false
+    }
+  }
+  layer {
+    name: "bn"
+    parents: "fc1"
+    batch_normalization {
+      decay: 0.8
+      epsilon: 1e-5
+    }
+  }
+  layer {
+    name: "l2"
+    parents: "bn"
+    l2_norm2 {
+    }
+  }
+  weights {
+    name: "fc1_w"
+    initializer {
+      value_initializer {
+        values: "0.3 -0.2 0.5 0.1 0.4 -0.6 -0.3 0.2 0.7"
+      }
+    }
+  }
+}
+optimizer {
+  sgd {
+    learn_rate: 0.1
+  }
+}
+)ptext";
+
+auto make_model(lbann::lbann_comm& comm,
+                std::string const& prototext,
+                size_t accumulation_steps,
+                size_t mini_batch_size)
+{
+  lbann_data::LbannPB my_proto;
+  if (!pb::TextFormat::ParseFromString(prototext, &my_proto))
+    throw "Parsing protobuf failed.";
+  lbann::construct_trainer(&comm, my_proto.mutable_trainer(), my_proto);
+  auto my_model = lbann::proto::construct_model(&comm,
+                                                -1,
+                                                my_proto.optimizer(),
+                                                my_proto.trainer(),
+                                                my_proto.model());
+  my_model->set_gradient_accumulation_steps(accumulation_steps);
+  lbann::DataReaderMetaData metadata;
+  metadata.data_dims[lbann::data_reader_target_mode::INPUT] = {3};
+  my_model->setup(mini_batch_size, metadata);
+  return my_model;
+}
+
+/** @brief Feeds consecutive columns of a matrix to the input layer.
+ *
+ *  The epoch is complete once every column has been fetched.
+ */
+class matrix_data_coordinator final : public lbann::data_coordinator
+{
+public:
+  matrix_data_coordinator(lbann::lbann_comm& comm,
+                          lbann::model& m,
+                          MatType const& samples,
+                          std::vector<El::Int> mini_batch_sizes)
+    : data_coordinator(&comm),
+      m_model{m},
+      m_samples{samples},
+      m_mini_batch_sizes{std::move(mini_batch_sizes)}
+  {}
+
+  void setup_data_fields(int) override {}
+  void fetch_data(lbann::execution_mode) override
+  {
+    REQUIRE(m_num_fetched < m_mini_batch_sizes.size());
+    auto const size = m_mini_batch_sizes[m_num_fetched++];
+    auto& c = dynamic_cast<lbann::sgd_execution_context&>(
+      m_model.get_execution_context());
+    c.set_current_mini_batch_size(size);
+    MatType mini_batch;
+    El::LockedView(mini_batch, m_samples,
+                   El::ALL, El::IR(m_first_sample, m_first_sample + size));
+    m_first_sample += size;
+    for (auto* l : m_model.get_layers()) {
+      if (auto* input = dynamic_cast<InputLayerType*>(l)) {
+        input->set_samples(mini_batch);
+      }
+    }
+  }
+  void collect_background_data_fetch(lbann::execution_mode) override {}
+  bool epoch_complete(lbann::execution_mode) override
+  {
+    return m_first_sample == m_samples.Width();
+  }
+  El::Matrix<El::Int> const*
+  get_sample_indices_per_mb(lbann::execution_mode) const override
+  {
+    return nullptr;
+  }
+  El::Matrix<El::Int>*
+  get_sample_indices_per_mb(lbann::execution_mode) override
+  {
+    return nullptr;
+  }
+
+private:
+  lbann::model& m_model;
+  MatType const& m_samples;
+  std::vector<El::Int> m_mini_batch_sizes;
+  size_t m_num_fetched = 0;
+  El::Int m_first_sample = 0;
+};
+
+/** @brief Exposes a single training step. */
+class test_sgd_training_algorithm : public lbann::sgd_training_algorithm
+{
+public:
+  test_sgd_training_algorithm()
+    : sgd_training_algorithm(
+        "test sgd",
+        lbann::make_unique<lbann::batch_termination_criteria>(1))
+  {}
+  using sgd_training_algorithm::train_mini_batch;
+};
+
+/** @brief Train until every sample has been used.
+ *  @returns Number of optimization steps.
+ */
+size_t train_epoch(lbann::model& m,
+                   MatType const& samples,
+                   std::vector<El::Int> mini_batch_sizes)
+{
+  test_sgd_training_algorithm algo;
+  matrix_data_coordinator dc(*m.get_comm(), m, samples,
+                             std::move(mini_batch_sizes));
+  lbann::sgd_execution_context c(lbann::execution_mode::training,
+                                 samples.Width());
+  size_t num_steps = 0;
+  bool finished = false;
+  while (!finished) {
+    finished = algo.train_mini_batch(c, m, dc);
+    ++num_steps;
+  }
+  m.reset_mode(c, lbann::execution_mode::invalid);
+  return num_steps;
+}
+
+/** @brief Deterministic samples, distinct in every column. */
+MatType make_samples(lbann::lbann_comm& comm, El::Int num_samples)
+{
+  MatType samples(3, num_samples, comm.get_trainer_grid());
+  for (El::Int col = 0; col < num_samples; ++col) {
+    for (El::Int row = 0; row < 3; ++row) {
+      samples.Set(row, col, 0.1 * ((7 * row + 3 * col) % 11) - 0.5);
+    }
+  }
+  return samples;
+}
+
+void check_same_weights(lbann::model const& expected,
+                        lbann::model const& actual)
+{
+  using WeightsType = lbann::data_type_weights<lbann::DataType>;
+  auto const expected_weights = expected.get_weights();
+  auto const actual_weights = actual.get_weights();
+  REQUIRE(expected_weights.size() == actual_weights.size());
+  for (size_t i = 0; i < expected_weights.size(); ++i) {
+    auto const& e = dynamic_cast<WeightsType const&>(*expected_weights[i]);
+    auto const& a = dynamic_cast<WeightsType const&>(*actual_weights[i]);
+    REQUIRE(e.get_name() == a.get_name());
+    auto const& e_local = e.get_values().LockedMatrix();
+    auto const& a_local = a.get_values().LockedMatrix();
+    REQUIRE(e_local.Height() == a_local.Height());
+    REQUIRE(e_local.Width() == a_local.Width());
+    for (El::Int col = 0; col < e_local.Width(); ++col) {
+      for (El::Int row = 0; row < e_local.Height(); ++row) {
+        INFO("weights \"" << e.get_name() << "\" entry ("
+             << row << "," << col << ")");
+        CHECK(a_local(row, col) == Approx(e_local(row, col)));
+      }
+    }
+  }
+}
+
+} // namespace <anon>
+
+TEST_CASE("Gradient accumulation matches full mini-batches",
+          "[mpi][sgd][accumulation]")
+{
+  auto& comm = unit_test::utilities::current_world_comm();
+
+  SECTION("Micro-batches of B/K match mini-batches of B")
+  {
+    auto const samples = make_samples(comm, 16);
+    auto reference = make_model(comm, fc_model_prototext, 1, 8);
+    CHECK(train_epoch(*reference, samples, {8, 8}) == 2);
+    auto accumulated = make_model(comm, fc_model_prototext, 4, 2);
+    CHECK(train_epoch(*accumulated, samples, {2, 2, 2, 2, 2, 2, 2, 2}) == 2);
+    check_same_weights(*reference, *accumulated);
+  }
+
+  SECTION("End of epoch ends the step early")
+  {
+    // The last step only has two micro-batches
+    auto const samples = make_samples(comm, 12);
+    auto reference = make_model(comm, fc_model_prototext, 1, 8);
+    CHECK(train_epoch(*reference, samples, {8, 4}) == 2);
+    auto accumulated = make_model(comm, fc_model_prototext, 4, 2);
+    CHECK(train_epoch(*accumulated, samples, {2, 2, 2, 2, 2, 2}) == 2);
+    check_same_weights(*reference, *accumulated);
+  }
+
+  SECTION("Single micro-batch in the last step is not rescaled")
+  {
+    // The last step only has one micro-batch, so the gradient scale
+    // must drop back to 1 after a step with four micro-batches
+    auto const samples = make_samples(comm, 10);
+    auto reference = make_model(comm, fc_model_prototext, 1, 8);
+    CHECK(train_epoch(*reference, samples, {8, 2}) == 2);
+    auto accumulated = make_model(comm, fc_model_prototext, 4, 2);
+    CHECK(train_epoch(*accumulated, samples, {2, 2, 2, 2, 2}) == 2);
+    check_same_weights(*reference, *accumulated);
+    for (auto const* w : accumulated->get_weights()) {
+      auto const* opt = w->get_optimizer();
+      REQUIRE(opt != nullptr);
+      CHECK(opt->get_loss_scale() == Approx(1));
+    }
+  }
+
+  SECTION("Batch normalization running statistics decay per step")
+  {
+    // Batch norm uses per-micro-batch statistics, so K identical
+    // micro-batches must match one step on a single micro-batch. The
+    // running statistics decay by decay^(1/K) per micro-batch.
+    auto const micro_batch = make_samples(comm, 3);
+    MatType repeated(3, 12, comm.get_trainer_grid());
+    for (El::Int col = 0; col < repeated.Width(); ++col) {
+      for (El::Int row = 0; row < 3; ++row) {
+        repeated.Set(row, col, micro_batch.Get(row, col % 3));
+      }
+    }
+    auto reference = make_model(comm, bn_model_prototext, 1, 3);
+    CHECK(train_epoch(*reference, micro_batch, {3}) == 1);
+    auto accumulated = make_model(comm, bn_model_prototext, 4, 3);
+    CHECK(train_epoch(*accumulated, repeated, {3, 3, 3, 3}) == 1);
+    check_same_weights(*reference, *accumulated);
+  }
+}
@@ -0,0 +1,182 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <catch2/catch.hpp>
+
+#include "TestHelpers.hpp"
+#include "MPITestHelpers.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/execution_algorithms/local_sgd.hpp>
+#include <lbann/models/directed_acyclic_graph.hpp>
+#include <lbann/models/model.hpp>
+#include <lbann/optimizers/adam.hpp>
+#include <lbann/optimizers/sgd.hpp>
+#include <lbann/utils/memory.hpp>
+#include <lbann/weights/data_type_weights.hpp>
+
+#include <algorithm>
+#include <functional>
+
+namespace {
+
+using TensorDataType = lbann::DataType;
+using WeightsType = lbann::data_type_weights<TensorDataType>;
+using AbsDistMatType = El::AbstractDistMatrix<TensorDataType>;
+
+/** @brief Run with one rank per trainer.
+ *
+ *  The world communicator is restored to a single trainer on exit.
+ */
+class one_rank_per_trainer {
+public:
+  explicit one_rank_per_trainer(lbann::lbann_comm& comm) : m_comm{comm} {
+    m_comm.split_trainers(1);
+  }
+  ~one_rank_per_trainer() { m_comm.split_trainers(); }
+private:
+  lbann::lbann_comm& m_comm;
+};
+
+/** @brief Fill local entries with @c offset plus the global index. */
+void fill(AbsDistMatType& mat, TensorDataType offset)
+{
+  for (El::Int col = 0; col < mat.Width(); ++col) {
+    for (El::Int row = 0; row < mat.Height(); ++row) {
+      if (mat.IsLocal(row, col)) {
+        mat.SetLocal(mat.LocalRow(row), mat.LocalCol(col),
+                     offset + row + col * mat.Height());
+      }
+    }
+  }
+}
+
+void check_filled(const AbsDistMatType& mat, TensorDataType offset)
+{
+  for (El::Int col = 0; col < mat.Width(); ++col) {
+    for (El::Int row = 0; row < mat.Height(); ++row) {
+      if (mat.IsLocal(row, col)) {
+        CHECK(mat.GetLocal(mat.LocalRow(row), mat.LocalCol(col))
+              == Approx(offset + row + col * mat.Height()));
+      }
+    }
+  }
+}
+
+/** @brief Model with SGD-with-momentum and Adam weights. */
+auto make_model(lbann::lbann_comm& comm)
+{
+  auto m = lbann::make_unique<lbann::directed_acyclic_graph_model>(
+    &comm, nullptr, nullptr);
+  auto w_sgd = std::make_shared<WeightsType>(comm);
+  w_sgd->set_name("w_sgd");
+  w_sgd->set_dims({5}, {3});
+  w_sgd->set_optimizer(
+    lbann::make_unique<lbann::sgd<TensorDataType>>(0.1f, 0.9f, false));
+  w_sgd->setup();
+  auto w_adam = std::make_shared<WeightsType>(comm);
+  w_adam->set_name("w_adam");
+  w_adam->set_dims({4}, {1});
+  w_adam->set_optimizer(
+    lbann::make_unique<lbann::adam<TensorDataType>>(0.1f, 0.9f, 0.99f, 1e-8f));
+  w_adam->setup();
+  m->add_weights(std::move(w_sgd));
+  m->add_weights(std::move(w_adam));
+  return m;
+}
+
+/** @brief Weights values and optimizer state. */
+std::vector<std::reference_wrapper<AbsDistMatType>>
+get_matrices(lbann::model& m, bool with_optimizer_state)
+{
+  std::vector<std::reference_wrapper<AbsDistMatType>> mats;
+  for (auto* w : m.get_weights()) {
+    auto& dtw = dynamic_cast<WeightsType&>(*w);
+    mats.emplace_back(dtw.get_values());
+    if (!with_optimizer_state) {
+      continue;
+    }
+    auto* opt = dtw.get_optimizer();
+    if (auto* sgd_opt = dynamic_cast<lbann::sgd<TensorDataType>*>(opt)) {
+      mats.emplace_back(sgd_opt->get_velocity());
+    }
+    if (auto* adam_opt = dynamic_cast<lbann::adam<TensorDataType>*>(opt)) {
+      mats.emplace_back(adam_opt->get_moment1());
+      mats.emplace_back(adam_opt->get_moment2());
+    }
+  }
+  return mats;
+}
+
+} // namespace
+
+TEST_CASE("Local SGD model averaging", "[mpi][local_sgd][exchange]")
+{
+  auto& comm = unit_test::utilities::current_world_comm();
+  one_rank_per_trainer split(comm);
+  const int num_trainers = comm.get_num_trainers();
+  const auto trainer_rank = comm.get_trainer_rank();
+  auto m = make_model(comm);
+
+  // Each trainer offsets its matrices by 10 * (trainer rank + matrix
+  // index), so the average is offset by 10 * ((num_trainers - 1) / 2
+  // + matrix index)
+  auto all_mats = get_matrices(*m, true);
+  for (size_t i = 0; i < all_mats.size(); ++i) {
+    fill(all_mats[i], 10 * (trainer_rank + i));
+  }
+  const TensorDataType mean_rank = (num_trainers - 1) / TensorDataType(2);
+
+  SECTION("Weights and optimizer state are averaged")
+  {
+    lbann::local_sgd algo("local sgd",
+                          lbann::make_unique<lbann::batch_termination_criteria>(1),
+                          4, true, false, 4);
+    algo.average_models(*m);
+    for (size_t i = 0; i < all_mats.size(); ++i) {
+      check_filled(all_mats[i], 10 * (mean_rank + i));
+    }
+    CHECK(algo.get_num_averages() == (num_trainers > 1 ? 1u : 0u));
+  }
+
+  SECTION("Optimizer state is kept unless requested")
+  {
+    lbann::local_sgd algo("local sgd",
+                          lbann::make_unique<lbann::batch_termination_criteria>(1),
+                          4, false, false, 4);
+    algo.average_models(*m);
+    const auto values = get_matrices(*m, false);
+    for (size_t i = 0; i < all_mats.size(); ++i) {
+      const bool is_values
+        = std::any_of(values.begin(), values.end(),
+                      [&](const AbsDistMatType& mat) {
+                        return &mat == &all_mats[i].get();
+                      });
+      check_filled(all_mats[i],
+                   10 * ((is_values ? mean_rank : trainer_rank) + i));
+    }
+  }
+}
@@ -0,0 +1,199 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <catch2/catch.hpp>
+
+#include "TestHelpers.hpp"
+#include "MPITestHelpers.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/execution_algorithms/ltfb/random_pairwise_exchange.hpp>
+#include <lbann/models/directed_acyclic_graph.hpp>
+#include <lbann/models/model.hpp>
+#include <lbann/utils/memory.hpp>
+#include <lbann/weights/data_type_weights.hpp>
+
+#include <set>
+#include <vector>
+
+namespace {
+
+using WeightsType = lbann::data_type_weights<lbann::DataType>;
+using AbsDistMatType = El::AbstractDistMatrix<lbann::DataType>;
+
+/** @brief Split the world into at least two trainers when possible.
+ *
+ *  The world communicator is restored to a single trainer on exit.
+ */
+class multiple_trainers {
+public:
+  explicit multiple_trainers(lbann::lbann_comm& comm) : m_comm{comm} {
+    int const world_size = m_comm.get_procs_in_world();
+    m_comm.split_trainers(world_size % 2 == 0 ? world_size / 2 : 1);
+  }
+  ~multiple_trainers() { m_comm.split_trainers(); }
+private:
+  lbann::lbann_comm& m_comm;
+};
+
+std::vector<std::pair<std::string, std::vector<size_t>>> const weights_specs = {
+  {"w0", {7, 5}},
+  {"w1", {3, 1}},
+  {"w2", {1, 1}}};
+
+/** @brief Value of each entry depends on the trainer and the weights. */
+lbann::DataType get_offset(int trainer, size_t weights_index)
+{
+  return 1000 * (trainer + 1) + 100 * weights_index;
+}
+
+/** @brief Fill local entries with @c offset plus the global index. */
+void fill(AbsDistMatType& mat, lbann::DataType offset)
+{
+  for (El::Int col = 0; col < mat.Width(); ++col) {
+    for (El::Int row = 0; row < mat.Height(); ++row) {
+      if (mat.IsLocal(row, col)) {
+        mat.SetLocal(mat.LocalRow(row), mat.LocalCol(col),
+                     offset + row + col * mat.Height());
+      }
+    }
+  }
+}
+
+void check_filled(AbsDistMatType const& mat, lbann::DataType offset)
+{
+  for (El::Int col = 0; col < mat.Width(); ++col) {
+    for (El::Int row = 0; row < mat.Height(); ++row) {
+      if (mat.IsLocal(row, col)) {
+        CHECK(mat.GetLocal(mat.LocalRow(row), mat.LocalCol(col))
+              == offset + row + col * mat.Height());
+      }
+    }
+  }
+}
+
+/** @brief Model whose weights values depend on the trainer. */
+auto make_model(lbann::lbann_comm& comm)
+{
+  auto m = lbann::make_unique<lbann::directed_acyclic_graph_model>(
+    &comm, nullptr, nullptr);
+  for (size_t i = 0; i < weights_specs.size(); ++i) {
+    auto const& spec = weights_specs[i];
+    auto w = std::make_shared<WeightsType>(comm);
+    w->set_name(spec.first);
+    w->set_dims({spec.second[0]}, {spec.second[1]});
+    w->setup();
+    fill(w->get_values(), get_offset(comm.get_trainer_rank(), i));
+    m->add_weights(std::move(w));
+  }
+  return m;
+}
+
+/** @brief Listed weights hold the partner's values, the others the
+ *  local values. An empty list means every weights. */
+void check_exchanged(lbann::model const& m,
+                     std::set<std::string> const& names,
+                     int local_trainer,
+                     int partner_trainer)
+{
+  auto const weights = m.get_weights();
+  REQUIRE(weights.size() == weights_specs.size());
+  for (size_t i = 0; i < weights.size(); ++i) {
+    auto const& w = dynamic_cast<WeightsType const&>(*weights[i]);
+    REQUIRE(w.get_name() == weights_specs[i].first);
+    bool const listed = names.empty() || names.count(w.get_name()) > 0;
+    INFO("weights \"" << w.get_name() << "\"");
+    check_filled(w.get_values(),
+                 get_offset(listed ? partner_trainer : local_trainer, i));
+  }
+}
+
+void check_same_values(lbann::model const& expected,
+                       lbann::model const& actual)
+{
+  auto const expected_weights = expected.get_weights();
+  auto const actual_weights = actual.get_weights();
+  REQUIRE(expected_weights.size() == actual_weights.size());
+  for (size_t i = 0; i < expected_weights.size(); ++i) {
+    auto const& e = dynamic_cast<WeightsType const&>(*expected_weights[i]);
+    auto const& a = dynamic_cast<WeightsType const&>(*actual_weights[i]);
+    CHECK(e.get_name() == a.get_name());
+    auto const& e_local = e.get_values().LockedMatrix();
+    auto const& a_local = a.get_values().LockedMatrix();
+    REQUIRE(e_local.Height() == a_local.Height());
+    REQUIRE(e_local.Width() == a_local.Width());
+    for (El::Int col = 0; col < e_local.Width(); ++col) {
+      for (El::Int row = 0; row < e_local.Height(); ++row) {
+        CHECK(e_local(row, col) == a_local(row, col));
+      }
+    }
+  }
+}
+
+} // namespace
+
+TEST_CASE("StreamWeights exchange", "[mpi][ltfb][exchange]")
+{
+  auto& comm = unit_test::utilities::current_world_comm();
+  multiple_trainers trainers(comm);
+  int const num_trainers = comm.get_num_trainers();
+  if (num_trainers < 2) {
+    WARN("StreamWeights exchange test needs at least two ranks");
+    return;
+  }
+
+  // Pair up neighboring trainers; with an odd number of trainers the
+  // last one exchanges with itself
+  int const trainer = comm.get_trainer_rank();
+  int const partner_trainer =
+    ((trainer ^ 1) < num_trainers ? (trainer ^ 1) : trainer);
+  auto const model = make_model(comm);
+
+  for (std::set<std::string> const names :
+         {std::set<std::string>{}, std::set<std::string>{"w0", "w2"}}) {
+    INFO("number of listed weights: " << names.size());
+
+    // 1 byte, 3 entries, and more than any weights
+    std::vector<std::unique_ptr<lbann::model>> partners;
+    for (size_t chunk_bytes : {size_t{1},
+                               3 * sizeof(lbann::DataType),
+                               size_t{1} << 20}) {
+      INFO("chunk size: " << chunk_bytes << " bytes");
+      lbann::ltfb::StreamWeights strategy(names, chunk_bytes);
+      partners.push_back(
+        strategy.get_partner_model(*model, partner_trainer, 0));
+      REQUIRE(partners.back() != nullptr);
+      CHECK(partners.back().get() != model.get());
+      check_exchanged(*partners.back(), names, trainer, partner_trainer);
+    }
+    for (size_t i = 1; i < partners.size(); ++i) {
+      check_same_values(*partners.front(), *partners[i]);
+    }
+
+    // The local model is left alone, as if no weights were listed
+    check_exchanged(*model, {"none"}, trainer, partner_trainer);
+  }
+}
@@ -23,6 +23,7 @@
 // implied. See the License for the specific language governing
 // permissions and limitations under the license.
 ////////////////////////////////////////////////////////////////////////////////
+#include "lbann/execution_algorithms/local_sgd.hpp"
 #include "lbann/execution_algorithms/sgd_training_algorithm.hpp"
 #include "lbann/execution_algorithms/training_algorithm.hpp"
 #include "lbann/utils/exception.hpp"
@@ -147,6 +148,28 @@ TEST_CASE("Building training algorithm from the factory",
     REQUIRE(sgd2->get_name() == "my sgd algo");
   }
 
+  SECTION("Building local SGD works fine.")
+  {
+    lbann_data::LocalSGD local_sgd_msg;
+    local_sgd_msg.mutable_sgd()->mutable_stopping_criteria()->set_max_epochs(2);
+    local_sgd_msg.set_averaging_interval(8);
+    local_sgd_msg.set_adaptive_interval(true);
+
+    lbann_data::TrainingAlgorithm algo_msg;
+    algo_msg.set_name("my local sgd algo");
+    algo_msg.mutable_parameters()->PackFrom(local_sgd_msg);
+
+    auto algo = lbann::make_abstract<lbann::training_algorithm>(algo_msg);
+
+    auto const& local_sgd = dynamic_cast<lbann::local_sgd const&>(*algo);
+    REQUIRE(local_sgd.get_type() == "local SGD");
+    REQUIRE(local_sgd.get_name() == "my local sgd algo");
+    REQUIRE(local_sgd.get_averaging_interval() == 8);
+
+    auto algo2 = algo->clone();
+    REQUIRE(algo2->get_type() == "local SGD");
+  }
+
   SECTION("Building with an invalid message type fails")
   {
     lbann_data::SGD::TerminationCriteria wrong_msg_type;
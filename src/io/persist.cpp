@@ -325,6 +325,45 @@ std::string lbann::persist::get_filename(persist_type type) const {
   return m_filenames.at(type);
 }
 
+void lbann::persist::stage_file(persist_type type,
+                                std::string filename,
+                                std::string contents) {
+  m_bytes[type] += contents.size();
+  m_staged_files.push_back({std::move(filename), std::move(contents)});
+}
+
+std::vector<lbann::staged_file> lbann::persist::take_staged_files() {
+  std::vector<staged_file> files;
+  files.swap(m_staged_files);
+  return files;
+}
+
+uint64_t lbann::write_staged_files(const std::vector<staged_file>& files) {
+  uint64_t bytes = 0;
+  for (const auto& f : files) {
+    int fd = openwrite(f.filename.c_str());
+    if (fd == -1) {
+      LBANN_ERROR("failed to open checkpoint file (", f.filename, ")");
+    }
+    // A single write may be cut short for large files
+    const char* buf = f.contents.data();
+    size_t remaining = f.contents.size();
+    while (remaining > 0) {
+      ssize_t rc = write(fd, buf, remaining);
+      if (rc < 0 && errno == EINTR) { continue; }
+      if (rc <= 0) {
+        LBANN_ERROR("failed to write checkpoint file (", f.filename, "): ",
+                    strerror(errno));
+      }
+      buf += rc;
+      remaining -= rc;
+    }
+    closewrite(fd, f.filename.c_str());
+    bytes += f.contents.size();
+  }
+  return bytes;
+}
+
 /****************************************************
  * Functions to read/write values to files
  ****************************************************/
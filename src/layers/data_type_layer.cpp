@@ -48,6 +48,52 @@ std::vector<MatrixPtrT> copy_all(std::vector<MatrixPtrT> const& in)
     out.emplace_back(m ? m->Copy() : nullptr);
   return out;
 }
+
+/** @brief Local bytes needed to store a matrix in a planned buffer. */
+template <typename T>
+size_t planned_buffer_bytes(const El::AbstractDistMatrix<T>& mat,
+                            El::Int height,
+                            El::Int width)
+{
+  const El::Int ldim = std::max(El::MaxLength(height, El::Int(mat.ColStride())),
+                                El::Int(1));
+  const El::Int local_width = El::MaxLength(width, El::Int(mat.RowStride()));
+  return static_cast<size_t>(ldim * local_width) * sizeof(T);
+}
+
+/** @brief Store a matrix in a planned buffer.
+ *  @details The matrix keeps its distribution and alignments.
+ *  @returns Whether the buffer is large enough.
+ */
+template <typename T>
+bool attach_planned_buffer(El::AbstractDistMatrix<T>& mat,
+                           void* buffer,
+                           size_t bytes,
+                           El::Int height,
+                           El::Int width)
+{
+  auto* elemental_mat = dynamic_cast<El::ElementalMatrix<T>*>(&mat);
+  if (buffer == nullptr || elemental_mat == nullptr
+      || planned_buffer_bytes(mat, height, width) > bytes) {
+    return false;
+  }
+  const El::Int ldim = std::max(El::MaxLength(height, El::Int(mat.ColStride())),
+                                El::Int(1));
+  elemental_mat->Attach(height, width, mat.Grid(),
+                        mat.ColAlign(), mat.RowAlign(),
+                        static_cast<T*>(buffer), ldim, mat.Root());
+  return true;
+}
+
+/** @brief Whether a matrix is stored in a planned buffer. */
+template <typename T>
+bool is_attached_to(const El::AbstractDistMatrix<T>& mat, const void* buffer)
+{
+  return (buffer != nullptr
+          && mat.Viewing()
+          && static_cast<const void*>(mat.LockedBuffer()) == buffer);
+}
+
 } // namespace
 
 namespace lbann {
@@ -77,6 +123,12 @@ operator=(data_type_layer const& other) {
   m_gradient_wrt_outputs = copy_all(other.m_gradient_wrt_outputs);
   m_gradient_wrt_inputs = copy_all(other.m_gradient_wrt_inputs);
   m_persistent_error_signals = other.m_persistent_error_signals;
+
+  // Planned storage belongs to the other layer's model
+  m_planned_outputs.clear();
+  m_planned_gradient_wrt_inputs.clear();
+  m_allocated_outputs.clear();
+
   return *this;
 }
 
@@ -133,6 +185,127 @@ void data_type_layer<InputTensorDataType, OutputTensorDataType>::forward_prop()
   m_fp_time += get_time() - fp_start;
 }
 
+template <typename InputTensorDataType, typename OutputTensorDataType>
+bool data_type_layer<InputTensorDataType, OutputTensorDataType>::
+supports_activation_recompute() const {
+#ifdef LBANN_HAS_DISTCONV
+  if (distconv_enabled()) { return false; }
+#endif // LBANN_HAS_DISTCONV
+  return true;
+}
+
+template <typename InputTensorDataType, typename OutputTensorDataType>
+size_t data_type_layer<InputTensorDataType, OutputTensorDataType>::
+discard_activations() {
+  size_t bytes = 0;
+  for (auto& output : m_outputs) {
+    if (!output->Viewing()) {
+      bytes += (output->LDim() * output->LocalWidth()
+                * sizeof(OutputTensorDataType));
+    }
+    output->Empty(true);
+  }
+  return bytes;
+}
+
+template <typename InputTensorDataType, typename OutputTensorDataType>
+void data_type_layer<InputTensorDataType, OutputTensorDataType>::
+recompute_forward_prop() {
+  const auto fp_start = get_time();
+  const auto& c = static_cast<sgd_execution_context&>(m_model->get_execution_context());
+  const auto& mini_batch_size = c.get_current_mini_batch_size();
+  fp_setup_inputs(mini_batch_size);
+  fp_setup_outputs(mini_batch_size);
+  fp_compute();
+  m_fp_time += get_time() - fp_start;
+}
+
+template <typename InputTensorDataType, typename OutputTensorDataType>
+void data_type_layer<InputTensorDataType, OutputTensorDataType>::
+reattach_inputs() {
+  const auto& c = static_cast<sgd_execution_context&>(m_model->get_execution_context());
+  fp_setup_inputs(c.get_current_mini_batch_size());
+}
+
+template <typename InputTensorDataType, typename OutputTensorDataType>
+bool data_type_layer<InputTensorDataType, OutputTensorDataType>::
+has_viewing_outputs() const {
+  for (size_t i = 0; i < m_outputs.size(); ++i) {
+    const auto* planned = (i < m_planned_outputs.size()
+                           ? m_planned_outputs[i].data
+                           : nullptr);
+    if (m_outputs[i]->Viewing() && !is_attached_to(*m_outputs[i], planned)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename InputTensorDataType, typename OutputTensorDataType>
+size_t data_type_layer<InputTensorDataType, OutputTensorDataType>::
+get_planned_output_bytes(int child_index) const {
+#ifdef LBANN_HAS_DISTCONV
+  if (distconv_enabled()) { return 0; }
+#endif // LBANN_HAS_DISTCONV
+
+  // Input layers and layers with views or device memory manage
+  // their own outputs
+  if (get_device_allocation() != El::Device::CPU
+      || get_num_parents() < 1
+      || child_index < 0
+      || static_cast<size_t>(child_index) >= m_allocated_outputs.size()
+      || !m_allocated_outputs[child_index]) {
+    return 0;
+  }
+  const auto& output = get_activations(child_index);
+  if (output.Viewing()) { return 0; }
+  return planned_buffer_bytes(output, output.Height(), output.Width());
+
+}
+
+template <typename InputTensorDataType, typename OutputTensorDataType>
+size_t data_type_layer<InputTensorDataType, OutputTensorDataType>::
+get_planned_error_signal_bytes(int parent_index) const {
+#ifdef LBANN_HAS_DISTCONV
+  if (distconv_enabled()) { return 0; }
+#endif // LBANN_HAS_DISTCONV
+
+  // Persistent error signals are viewed by parents after backprop,
+  // and layers with viewing outputs may pass views of their
+  // previous error signals on to their parents
+  if (get_device_allocation() != El::Device::CPU
+      || m_persistent_error_signals
+      || has_viewing_outputs()
+      || parent_index < 0
+      || parent_index >= get_num_parents()) {
+    return 0;
+  }
+  const auto& input = get_prev_activations(parent_index);
+  return planned_buffer_bytes(input, input.Height(), input.Width());
+
+}
+
+template <typename InputTensorDataType, typename OutputTensorDataType>
+void data_type_layer<InputTensorDataType, OutputTensorDataType>::
+set_planned_output_buffer(int child_index, void* buffer, size_t bytes) {
+  if (m_planned_outputs.size() <= static_cast<size_t>(child_index)) {
+    m_planned_outputs.resize(child_index + 1);
+  }
+  m_planned_outputs[child_index].data = buffer;
+  m_planned_outputs[child_index].bytes = (buffer != nullptr ? bytes : 0);
+}
+
+template <typename InputTensorDataType, typename OutputTensorDataType>
+void data_type_layer<InputTensorDataType, OutputTensorDataType>::
+set_planned_error_signal_buffer(int parent_index, void* buffer, size_t bytes) {
+  if (m_planned_gradient_wrt_inputs.size() <= static_cast<size_t>(parent_index)) {
+    m_planned_gradient_wrt_inputs.resize(parent_index + 1);
+  }
+  m_planned_gradient_wrt_inputs[parent_index].data = buffer;
+  m_planned_gradient_wrt_inputs[parent_index].bytes
+    = (buffer != nullptr ? bytes : 0);
+}
+
 template <typename InputTensorDataType, typename OutputTensorDataType>
 void data_type_layer<InputTensorDataType, OutputTensorDataType>::back_prop_impl_() {
   const auto bp_start = get_time();
@@ -828,6 +1001,7 @@ fp_setup_outputs(El::Int mini_batch_size) {
                                 get_activations().DistData());
 
   // Initialize output tensors
+  m_allocated_outputs.assign(get_num_children(), false);
   for (int i = 0; i < get_num_children(); ++i) {
 #ifdef LBANN_HAS_DISTCONV
     if (!keep_original_outputs(i)) continue;
@@ -837,6 +1011,19 @@ fp_setup_outputs(El::Int mini_batch_size) {
     if (align_outputs) {
       output.AlignWith(alignment_dist);
     }
+    auto& child = const_cast<Layer&>(get_child_layer(i));
+    if (child.view_shared_input_storage(*this, output, mini_batch_size)) {
+      continue;
+    }
+    m_allocated_outputs[i] = true;
+    if (static_cast<size_t>(i) < m_planned_outputs.size()
+        && attach_planned_buffer(output,
+                                 m_planned_outputs[i].data,
+                                 m_planned_outputs[i].bytes,
+                                 get_output_size(i),
+                                 mini_batch_size)) {
+      continue;
+    }
     output.Resize(get_output_size(i), mini_batch_size);
   }
 
@@ -988,11 +1175,18 @@ propagate_error_signals_to_parents_() {
     auto& parent = const_cast<Layer&>(get_parent_layer(i));
 
     // If my error signals persist, my parent can always view them,
-    // assuming the distdata is right. Otherwise, my views and my data
-    // will be released. Views must be copied and owned data can
-    // either be copied or swapped out.
+    // assuming the distdata is right. The same holds for views into
+    // my parent's own storage. Otherwise, my views and my data will
+    // be released. Views must be copied and owned data can either be
+    // copied or swapped out. Planned buffers are kept alive by the
+    // model until my parent's backprop, so they can also be viewed.
     auto& error_signal = *m_gradient_wrt_inputs[i];
-    if (m_persistent_error_signals)
+    const bool planned
+      = (static_cast<size_t>(i) < m_planned_gradient_wrt_inputs.size()
+         && is_attached_to(error_signal,
+                           m_planned_gradient_wrt_inputs[i].data));
+    if (m_persistent_error_signals || m_shared_gradient_wrt_inputs[i]
+        || planned)
       attempt_view_error_signal(parent, *this, error_signal);
     else if (error_signal.Viewing())
       deep_copy_error_signal(parent, *this, error_signal);
@@ -1006,6 +1200,7 @@ template <typename InputTensorDataType, typename OutputTensorDataType>
 void data_type_layer<InputTensorDataType, OutputTensorDataType>::
 allocate_new_gradients_() {
   auto parents = get_parent_layers();
+  m_shared_gradient_wrt_inputs.assign(get_num_parents(), false);
   for (int i = 0; i < get_num_parents(); ++i) {
 #ifdef LBANN_HAS_DISTCONV
     if (!keep_original_gradient_wrt_inputs(i)) continue;
@@ -1053,6 +1248,22 @@ bp_setup_gradient_wrt_inputs(
     auto& gradient_wrt_input = get_error_signals(i);
     gradient_wrt_input.Empty(false);
     gradient_wrt_input.AlignWith(get_prev_activations(i));
+    auto& parent = const_cast<Layer&>(get_parent_layer(i));
+    if (parent.view_shared_output_gradient_storage(*this,
+                                                   gradient_wrt_input,
+                                                   mini_batch_size)) {
+      m_shared_gradient_wrt_inputs[i] = true;
+      continue;
+    }
+    if (!m_persistent_error_signals
+        && static_cast<size_t>(i) < m_planned_gradient_wrt_inputs.size()
+        && attach_planned_buffer(gradient_wrt_input,
+                                 m_planned_gradient_wrt_inputs[i].data,
+                                 m_planned_gradient_wrt_inputs[i].bytes,
+                                 get_input_size(i),
+                                 mini_batch_size)) {
+      continue;
+    }
     gradient_wrt_input.Resize(get_input_size(i), mini_batch_size);
   }
 }
@@ -217,6 +217,12 @@ lbann_comm* Layer::get_comm() const {
   return m_model->get_comm();
 }
 
+size_t Layer::get_gradient_accumulation_steps() const {
+  return (m_model != nullptr
+          ? m_model->get_gradient_accumulation_steps()
+          : size_t{1});
+}
+
 bool Layer::update() {
   if (m_frozen) { return true; }
   // Apply any updates.
@@ -245,16 +251,26 @@ void Layer::summarize_stats(lbann_summary& summarizer, int step) {
   reset_counters();
   // Combine the optimizer step time from all the weights.
   double step_time = 0.0;
+  gradient_compression_statistics compression_stats;
   for (size_t i=0; i<num_weights(); ++i) {
     auto& w = get_weights(i);
     auto* opt = w.get_optimizer();
     if (opt) {
       step_time += opt->get_step_time();
+      compression_stats += opt->get_gradient_compression_statistics();
       opt->reset_counters();
     }
   }
   summarizer.reduce_scalar(prefix + "opt_time", step_time, step);
   summarizer.reduce_scalar_all(prefix + "opt_time", step_time, step);
+  if (compression_stats.compressed_bytes > 0) {
+    summarizer.reduce_scalar(prefix + "gradient_compression_ratio",
+                             compression_stats.get_ratio(),
+                             step);
+    summarizer.reduce_scalar(prefix + "gradient_compression_time",
+                             compression_stats.time,
+                             step);
+  }
 }
 
 // ===================================================================
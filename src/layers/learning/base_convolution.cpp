@@ -27,10 +27,10 @@
 #include "lbann/layers/data_type_layer.hpp"
 #include "lbann/layers/layer.hpp"
 #include "lbann/layers/learning/base_convolution.hpp"
+#include "lbann/layers/learning/convolution_cpu.hpp"
 #include "lbann/models/model.hpp"
 #include "lbann/utils/distconv.hpp"
 #include "lbann/utils/exception.hpp"
-#include "lbann/utils/im2col.hpp"
 #include "lbann/utils/memory.hpp"
 #include "lbann/utils/timer.hpp"
 #ifdef LBANN_HAS_DNN_LIB
@@ -277,13 +277,6 @@ base_convolution_layer<TensorDataType,Device>
   }
 
   // Make sure that configuration is supported
-  if (Device == El::Device::CPU
-      && std::any_of(m_dilations.begin(), m_dilations.end(),
-                     [](El::Int d) { return d != 1; })) {
-    err << this->get_type() << " layer \"" << this->get_name() << "\" "
-        << "has non-unit dilation, which is not yet supported on CPU";
-    LBANN_ERROR(err.str());
-  }
   if (Device == El::Device::CPU && m_groups != 1) {
     err << this->get_type() << " layer \"" << this->get_name() << "\" "
         << "has " << m_groups << " groups, "
@@ -756,8 +749,6 @@ base_convolution_layer<TensorDataType,Device>
                         this->get_local_error_signals());
 
   // Matrix parameters
-  const int output_size = local_output.Height();
-  const El::Int local_width = local_input.Width();
   std::vector<int> input_dims, output_dims;
   if (during_forward_prop) {
     input_dims = this->get_input_dims();
@@ -772,34 +763,24 @@ base_convolution_layer<TensorDataType,Device>
                                             kernel_dims.end(),
                                             1, std::multiplies<int>());
 
-  // Initialize matrices
-  const int m = output_size / output_dims[0];
-  const int n = output_dims[0];
-  const int k = kernel_size / output_dims[0];
-  DMatDT<Device> input_col, output_col;
-  DMatDT<Device> im2col_matrix(k, m);
-  const DMatDT<Device> kernel_matrix(k, n, local_kernel.LockedBuffer(), k);
-
-  // Iterate through input columns
-  for (El::Int col = 0; col < local_width; ++col) {
-
-    // Construct im2col matrix from current input column
-    El::LockedView(input_col, local_input, El::ALL, El::IR(col));
-    im2col<TensorDataType>(input_col,
-                           im2col_matrix,
-                           input_dims[0],
-                           input_dims.size() - 1,
-                           &input_dims[1],
-                           m_pads.data(),
-                           &kernel_dims[2],
-                           m_strides.data());
-
-    // Apply convolution to current input column
-    output_col.Attach(m, n, local_output.Buffer(0, col), m);
-    El::Gemm(El::TRANSPOSE, El::NORMAL,
-             El::TypeTraits<TensorDataType>::One(), im2col_matrix, kernel_matrix,
-             El::TypeTraits<TensorDataType>::Zero(), output_col);
-
+  // Apply convolution
+  if constexpr (Device == El::Device::CPU) {
+    const El::Int k = kernel_size / output_dims[0];
+    const El::Int n = output_dims[0];
+    const DMatDT<Device> kernel_matrix(k, n, local_kernel.LockedBuffer(), k);
+    convolution_cpu::apply_convolution<TensorDataType>(
+      dynamic_cast<const DMatDT<Device>&>(local_input),
+      dynamic_cast<DMatDT<Device>&>(local_output),
+      kernel_matrix,
+      input_dims,
+      output_dims,
+      &kernel_dims[2],
+      m_pads.data(),
+      m_strides.data(),
+      m_dilations.data());
+  }
+  else {
+    LBANN_ERROR("im2col convolution is only supported on CPU");
   }
 
 }
@@ -814,13 +795,11 @@ base_convolution_layer<TensorDataType,Device>
   const auto& local_input = (during_forward_prop ?
                              this->get_local_prev_activations() :
                              this->get_local_prev_error_signals());
-  DMatDT<Device>& local_output = (during_forward_prop ?
-                                  this->get_local_activations() :
-                                  this->get_local_error_signals());
+  auto& local_output = (during_forward_prop ?
+                        this->get_local_activations() :
+                        this->get_local_error_signals());
 
   // Matrix parameters
-  const int input_size = local_input.Height();
-  const El::Int local_width = local_input.Width();
   std::vector<int> input_dims, output_dims;
   if (during_forward_prop) {
     input_dims = this->get_input_dims();
@@ -835,35 +814,24 @@ base_convolution_layer<TensorDataType,Device>
                                             kernel_dims.end(),
                                             1, std::multiplies<int>());
 
-  // Initialize matrices
-  const int m = kernel_size / input_dims[0];
-  const int n = input_size / input_dims[0];
-  const int k = input_dims[0];
-  DMatDT<Device> input_col, output_col;
-  DMatDT<Device> im2col_matrix(m, n);
-  const DMatDT<Device> kernel_matrix(m, k, local_kernel.LockedBuffer(), m);
-
-  // Iterate through input columns
-  for (El::Int col = 0; col < local_width; ++col) {
-
-    // Apply transposed convolution to current input column
-    input_col.LockedAttach(n, k, local_input.LockedBuffer(0, col), n);
-    El::Gemm(El::NORMAL, El::TRANSPOSE,
-             El::TypeTraits<TensorDataType>::One(), kernel_matrix, input_col,
-             El::TypeTraits<TensorDataType>::Zero(), im2col_matrix);
-
-    // Perform col2im to accumulate contributions from each kernel
-    // position
-    El::View(output_col, local_output, El::ALL, El::IR(col));
-    col2im<TensorDataType>(im2col_matrix,
-                           output_col,
-                           output_dims[0],
-                           output_dims.size() - 1,
-                           &output_dims[1],
-                           m_pads.data(),
-                           &kernel_dims[2],
-                           m_strides.data());
-
+  // Apply transposed convolution
+  if constexpr (Device == El::Device::CPU) {
+    const El::Int m = kernel_size / input_dims[0];
+    const El::Int k = input_dims[0];
+    const DMatDT<Device> kernel_matrix(m, k, local_kernel.LockedBuffer(), m);
+    convolution_cpu::apply_transposed_convolution<TensorDataType>(
+      dynamic_cast<const DMatDT<Device>&>(local_input),
+      dynamic_cast<DMatDT<Device>&>(local_output),
+      kernel_matrix,
+      input_dims,
+      output_dims,
+      &kernel_dims[2],
+      m_pads.data(),
+      m_strides.data(),
+      m_dilations.data());
+  }
+  else {
+    LBANN_ERROR("im2col transposed convolution is only supported on CPU");
   }
 
 }
@@ -905,8 +873,10 @@ void base_convolution_layer<TensorDataType,Device>
 ::compute_gradients_im2col(bool using_transposed_convolution) {
 
   // Local matrices
-  const DMatDT<Device>& local_input = this->get_local_prev_activations();
-  const DMatDT<Device>& local_gradient_wrt_output = this->get_local_prev_error_signals();
+  const auto& local_input = dynamic_cast<const DMatDT<Device>&>(
+    this->get_local_prev_activations());
+  const auto& local_gradient_wrt_output = dynamic_cast<const DMatDT<Device>&>(
+    this->get_local_prev_error_signals());
   const bool has_local_data = (!local_input.IsEmpty()
                                && !local_gradient_wrt_output.IsEmpty());
 
@@ -966,51 +936,45 @@ void base_convolution_layer<TensorDataType,Device>
   const int n = (using_transposed_convolution ?
                  num_input_channels :
                  num_output_channels);
-  const int k = (using_transposed_convolution ?
-                 this->get_input_size() / num_input_channels :
-                 this->get_output_size() / num_output_channels);
   auto dst_scale = El::TypeTraits<TensorDataType>::Zero(), gradient_scale = El::TypeTraits<TensorDataType>::Zero();
   auto& kernel_gradient = kernel_optimizer->get_gradient_buffer(
     dst_scale, gradient_scale, true);
   El::Scale(dst_scale, kernel_gradient);
-  DMatDT<Device> im2col_matrix(m, k);
+  if (!has_local_data) { return; }
   DMatDT<Device> kernel_gradient_matrix(m, n, kernel_gradient.Buffer(), m);
 
-  // Compute kernel gradient contributions from each data sample
-  for (El::Int col = 0; col < local_width; ++col) {
+  // Compute kernel gradient contributions from all data samples
+  if constexpr (Device == El::Device::CPU) {
     if (using_transposed_convolution) {
-      const DMatDT<Device> input_col(k, n, local_input.LockedBuffer(0,col), k);
-      const DMatDT<Device> gradient_wrt_output_col =
-        El::LockedView(local_gradient_wrt_output, El::ALL, El::IR(col));
-      im2col<TensorDataType>(gradient_wrt_output_col,
-                             im2col_matrix,
-                             num_output_channels,
-                             output_dims.size() - 1,
-                             &output_dims[1],
-                             m_pads.data(),
-                             &kernel_dims[2],
-                             m_strides.data());
-      El::Gemm(El::NORMAL, El::NORMAL,
-               gradient_scale, im2col_matrix, input_col,
-               El::TypeTraits<TensorDataType>::One(), kernel_gradient_matrix);
+      convolution_cpu::accumulate_kernel_gradient<TensorDataType>(
+        local_gradient_wrt_output,
+        local_input,
+        kernel_gradient_matrix,
+        output_dims,
+        num_input_channels,
+        &kernel_dims[2],
+        m_pads.data(),
+        m_strides.data(),
+        m_dilations.data(),
+        gradient_scale);
     }
     else {
-      const DMatDT<Device> input_col
-        = El::LockedView(local_input, El::ALL, El::IR(col));
-      const DMatDT<Device> gradient_wrt_output_col(k, n, local_gradient_wrt_output.LockedBuffer(0,col), k);
-      im2col<TensorDataType>(input_col,
-                             im2col_matrix,
-                             num_input_channels,
-                             input_dims.size() - 1,
-                             &input_dims[1],
-                             m_pads.data(),
-                             &kernel_dims[2],
-                             m_strides.data());
-      El::Gemm(El::NORMAL, El::NORMAL,
-               gradient_scale, im2col_matrix, gradient_wrt_output_col,
-               El::TypeTraits<TensorDataType>::One(), kernel_gradient_matrix);
+      convolution_cpu::accumulate_kernel_gradient<TensorDataType>(
+        local_input,
+        local_gradient_wrt_output,
+        kernel_gradient_matrix,
+        input_dims,
+        num_output_channels,
+        &kernel_dims[2],
+        m_pads.data(),
+        m_strides.data(),
+        m_dilations.data(),
+        gradient_scale);
     }
   }
+  else {
+    LBANN_ERROR("im2col convolution is only supported on CPU");
+  }
 }
 
 #ifdef LBANN_HAS_DNN_LIB
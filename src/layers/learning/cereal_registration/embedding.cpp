@@ -39,7 +39,8 @@ embedding_layer<TensorDataType,Layout,Device>
                         ::cereal::base_class<DataTypeLayer>(this)),
      CEREAL_NVP(m_num_embeddings),
      CEREAL_NVP(m_embedding_dim),
-     CEREAL_NVP(m_padding_idx));
+     CEREAL_NVP(m_padding_idx),
+     CEREAL_NVP(m_sparse_gradients));
 }
 
 } // namespace lbann
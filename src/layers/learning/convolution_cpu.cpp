@@ -0,0 +1,363 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#define LBANN_CONVOLUTION_CPU_INSTANTIATE
+#include "lbann/layers/learning/convolution_cpu.hpp"
+#include "lbann/utils/im2col.hpp"
+#include "lbann/utils/omp_pragma.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+
+namespace lbann {
+namespace convolution_cpu {
+
+namespace {
+
+/** @brief Target number of workspace entries for a block of samples.
+ *
+ *  Large enough for the GEMMs to be efficient, small enough that the
+ *  im2col matrix for a block stays within a few tens of MB.
+ */
+constexpr El::Int block_workspace_size = El::Int(1) << 22;
+
+/** @brief Number of samples to process together. */
+El::Int get_block_size(El::Int num_samples, El::Int workspace_per_sample) {
+  const El::Int block_size
+    = block_workspace_size / std::max(workspace_per_sample, El::Int(1));
+  return std::max(std::min(block_size, num_samples), El::Int(1));
+}
+
+/** @brief Whether im2col is a transpose of the image. */
+bool is_1x1(size_t num_spatial_dims,
+            const int* window_dims,
+            const int* pads,
+            const int* strides) {
+  for (size_t d = 0; d < num_spatial_dims; ++d) {
+    if (window_dims[d] != 1 || pads[d] != 0 || strides[d] != 1) {
+      return false;
+    }
+  }
+  return true;
+}
+
+El::Int get_spatial_size(const std::vector<int>& dims) {
+  return std::accumulate(dims.begin()+1, dims.end(),
+                         El::Int(1), std::multiplies<El::Int>());
+}
+
+/** @brief Stack samples vertically.
+ *
+ *  Sample @c first+s of @c mat is viewed as a rows x cols matrix and
+ *  copied to rows [s*rows, (s+1)*rows) of @c stacked.
+ */
+template <typename TensorDataType>
+void stack_samples(const CPUMatDT<TensorDataType>& mat,
+                   El::Int first,
+                   El::Int num,
+                   El::Int rows,
+                   El::Int cols,
+                   CPUMatDT<TensorDataType>& stacked) {
+  stacked.Resize(rows*num, cols);
+  const auto* __restrict__ mat_buffer = mat.LockedBuffer(0, first);
+  auto* __restrict__ stacked_buffer = stacked.Buffer();
+  const El::Int mat_ldim = mat.LDim();
+  const El::Int stacked_ldim = stacked.LDim();
+  LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+  for (El::Int s = 0; s < num; ++s) {
+    for (El::Int j = 0; j < cols; ++j) {
+      const auto* src = &mat_buffer[j*rows + s*mat_ldim];
+      std::copy(src, src+rows, &stacked_buffer[s*rows + j*stacked_ldim]);
+    }
+  }
+}
+
+/** @brief Inverse of stack_samples. */
+template <typename TensorDataType>
+void unstack_samples(const CPUMatDT<TensorDataType>& stacked,
+                     El::Int first,
+                     El::Int num,
+                     El::Int rows,
+                     El::Int cols,
+                     CPUMatDT<TensorDataType>& mat) {
+  const auto* __restrict__ stacked_buffer = stacked.LockedBuffer();
+  auto* __restrict__ mat_buffer = mat.Buffer(0, first);
+  const El::Int mat_ldim = mat.LDim();
+  const El::Int stacked_ldim = stacked.LDim();
+  LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+  for (El::Int s = 0; s < num; ++s) {
+    for (El::Int j = 0; j < cols; ++j) {
+      const auto* src = &stacked_buffer[s*rows + j*stacked_ldim];
+      std::copy(src, src+rows, &mat_buffer[j*rows + s*mat_ldim]);
+    }
+  }
+}
+
+} // namespace <anon>
+
+template <typename TensorDataType>
+void apply_convolution(const CPUMatDT<TensorDataType>& input,
+                       CPUMatDT<TensorDataType>& output,
+                       const CPUMatDT<TensorDataType>& kernel,
+                       const std::vector<int>& input_dims,
+                       const std::vector<int>& output_dims,
+                       const int* window_dims,
+                       const int* pads,
+                       const int* strides,
+                       const int* dilations) {
+  using LocalMat = CPUMatDT<TensorDataType>;
+  static const auto zero = El::TypeTraits<TensorDataType>::Zero();
+  static const auto one = El::TypeTraits<TensorDataType>::One();
+
+  // Matrix dimensions
+  // Note: The im2col matrix for a sample is k x m.
+  const El::Int num_samples = input.Width();
+  const El::Int num_spatial_dims = input_dims.size() - 1;
+  const El::Int m = get_spatial_size(output_dims);
+  const El::Int n = output_dims[0];
+  const El::Int k = kernel.Height();
+
+  // 1x1 convolution
+  // Note: Each input sample is the transpose of its im2col matrix.
+  if (is_1x1(num_spatial_dims, window_dims, pads, strides)) {
+    for (El::Int col = 0; col < num_samples; ++col) {
+      const LocalMat input_col(m, k, input.LockedBuffer(0, col), m);
+      LocalMat output_col(m, n, output.Buffer(0, col), m);
+      El::Gemm(El::NORMAL, El::NORMAL,
+               one, input_col, kernel,
+               zero, output_col);
+    }
+    return;
+  }
+
+  // Iterate through blocks of samples
+  const El::Int block_size = get_block_size(num_samples, k*m + m*n);
+  LocalMat im2col_matrix, output_block;
+  for (El::Int first = 0; first < num_samples; first += block_size) {
+    const El::Int num = std::min(block_size, num_samples - first);
+
+    // Construct im2col matrix for block
+    const auto input_block = El::LockedView(input,
+                                            El::ALL,
+                                            El::IR(first, first+num));
+    im2col_matrix.Resize(k, m*num);
+    im2col_batched<TensorDataType>(input_block,
+                                   im2col_matrix,
+                                   input_dims[0],
+                                   num_spatial_dims,
+                                   &input_dims[1],
+                                   pads,
+                                   window_dims,
+                                   strides,
+                                   dilations);
+
+    // Apply convolution to block
+    if (num == 1) {
+      LocalMat output_col(m, n, output.Buffer(0, first), m);
+      El::Gemm(El::TRANSPOSE, El::NORMAL,
+               one, im2col_matrix, kernel,
+               zero, output_col);
+    }
+    else {
+      output_block.Resize(m*num, n);
+      El::Gemm(El::TRANSPOSE, El::NORMAL,
+               one, im2col_matrix, kernel,
+               zero, output_block);
+      unstack_samples(output_block, first, num, m, n, output);
+    }
+
+  }
+
+}
+
+template <typename TensorDataType>
+void apply_transposed_convolution(const CPUMatDT<TensorDataType>& input,
+                                  CPUMatDT<TensorDataType>& output,
+                                  const CPUMatDT<TensorDataType>& kernel,
+                                  const std::vector<int>& input_dims,
+                                  const std::vector<int>& output_dims,
+                                  const int* window_dims,
+                                  const int* pads,
+                                  const int* strides,
+                                  const int* dilations) {
+  using LocalMat = CPUMatDT<TensorDataType>;
+  static const auto zero = El::TypeTraits<TensorDataType>::Zero();
+  static const auto one = El::TypeTraits<TensorDataType>::One();
+
+  // Matrix dimensions
+  // Note: The im2col matrix for a sample is m x n.
+  const El::Int num_samples = input.Width();
+  const El::Int num_spatial_dims = output_dims.size() - 1;
+  const El::Int m = kernel.Height();
+  const El::Int n = get_spatial_size(input_dims);
+  const El::Int k = input_dims[0];
+
+  // 1x1 transposed convolution
+  // Note: col2im transposes each sample, so it can be folded into
+  // the GEMM.
+  if (is_1x1(num_spatial_dims, window_dims, pads, strides)) {
+    for (El::Int col = 0; col < num_samples; ++col) {
+      const LocalMat input_col(n, k, input.LockedBuffer(0, col), n);
+      LocalMat output_col(n, m, output.Buffer(0, col), n);
+      El::Gemm(El::NORMAL, El::TRANSPOSE,
+               one, input_col, kernel,
+               zero, output_col);
+    }
+    return;
+  }
+
+  // Iterate through blocks of samples
+  const El::Int block_size = get_block_size(num_samples, n*k + m*n);
+  LocalMat input_block, im2col_matrix, output_block;
+  for (El::Int first = 0; first < num_samples; first += block_size) {
+    const El::Int num = std::min(block_size, num_samples - first);
+
+    // Apply transposed convolution to block
+    im2col_matrix.Resize(m, n*num);
+    if (num == 1) {
+      const LocalMat input_col(n, k, input.LockedBuffer(0, first), n);
+      El::Gemm(El::NORMAL, El::TRANSPOSE,
+               one, kernel, input_col,
+               zero, im2col_matrix);
+    }
+    else {
+      stack_samples(input, first, num, n, k, input_block);
+      El::Gemm(El::NORMAL, El::TRANSPOSE,
+               one, kernel, input_block,
+               zero, im2col_matrix);
+    }
+
+    // Perform col2im to accumulate contributions from each kernel
+    // position
+    El::View(output_block, output, El::ALL, El::IR(first, first+num));
+    col2im_batched<TensorDataType>(im2col_matrix,
+                                   output_block,
+                                   output_dims[0],
+                                   num_spatial_dims,
+                                   &output_dims[1],
+                                   pads,
+                                   window_dims,
+                                   strides,
+                                   dilations);
+
+  }
+
+}
+
+template <typename TensorDataType>
+void accumulate_kernel_gradient(const CPUMatDT<TensorDataType>& im,
+                                const CPUMatDT<TensorDataType>& mat,
+                                CPUMatDT<TensorDataType>& kernel_gradient,
+                                const std::vector<int>& im_dims,
+                                int mat_channels,
+                                const int* window_dims,
+                                const int* pads,
+                                const int* strides,
+                                const int* dilations,
+                                TensorDataType scale) {
+  using LocalMat = CPUMatDT<TensorDataType>;
+  static const auto one = El::TypeTraits<TensorDataType>::One();
+
+  // Matrix dimensions
+  // Note: The im2col matrix for a sample is m x k.
+  const El::Int num_samples = im.Width();
+  const El::Int num_spatial_dims = im_dims.size() - 1;
+  const El::Int m = kernel_gradient.Height();
+  const El::Int n = mat_channels;
+  const El::Int k = mat.Height() / mat_channels;
+
+  // 1x1 convolution
+  // Note: Each im sample is the transpose of its im2col matrix.
+  if (is_1x1(num_spatial_dims, window_dims, pads, strides)) {
+    for (El::Int col = 0; col < num_samples; ++col) {
+      const LocalMat im_col(k, m, im.LockedBuffer(0, col), k);
+      const LocalMat mat_col(k, n, mat.LockedBuffer(0, col), k);
+      El::Gemm(El::TRANSPOSE, El::NORMAL,
+               scale, im_col, mat_col,
+               one, kernel_gradient);
+    }
+    return;
+  }
+
+  // Iterate through blocks of samples
+  const El::Int block_size = get_block_size(num_samples, m*k + k*n);
+  LocalMat im2col_matrix, mat_block;
+  for (El::Int first = 0; first < num_samples; first += block_size) {
+    const El::Int num = std::min(block_size, num_samples - first);
+
+    // Construct im2col matrix for block
+    const auto im_block = El::LockedView(im,
+                                         El::ALL,
+                                         El::IR(first, first+num));
+    im2col_matrix.Resize(m, k*num);
+    im2col_batched<TensorDataType>(im_block,
+                                   im2col_matrix,
+                                   im_dims[0],
+                                   num_spatial_dims,
+                                   &im_dims[1],
+                                   pads,
+                                   window_dims,
+                                   strides,
+                                   dilations);
+
+    // Accumulate kernel gradient contributions from block
+    if (num == 1) {
+      const LocalMat mat_col(k, n, mat.LockedBuffer(0, first), k);
+      El::Gemm(El::NORMAL, El::NORMAL,
+               scale, im2col_matrix, mat_col,
+               one, kernel_gradient);
+    }
+    else {
+      stack_samples(mat, first, num, k, n, mat_block);
+      El::Gemm(El::NORMAL, El::NORMAL,
+               scale, im2col_matrix, mat_block,
+               one, kernel_gradient);
+    }
+
+  }
+
+}
+
+#define PROTO(T)                                                        \
+  template void apply_convolution<T>(                                   \
+    const CPUMatDT<T>&, CPUMatDT<T>&, const CPUMatDT<T>&,               \
+    const std::vector<int>&, const std::vector<int>&,                   \
+    const int*, const int*, const int*, const int*);                    \
+  template void apply_transposed_convolution<T>(                        \
+    const CPUMatDT<T>&, CPUMatDT<T>&, const CPUMatDT<T>&,               \
+    const std::vector<int>&, const std::vector<int>&,                   \
+    const int*, const int*, const int*, const int*);                    \
+  template void accumulate_kernel_gradient<T>(                          \
+    const CPUMatDT<T>&, const CPUMatDT<T>&, CPUMatDT<T>&,               \
+    const std::vector<int>&, int,                                       \
+    const int*, const int*, const int*, const int*, T)
+
+#define LBANN_INSTANTIATE_CPU_HALF
+#include "lbann/macros/instantiate.hpp"
+
+} // namespace convolution_cpu
+} // namespace lbann
@@ -79,13 +79,30 @@ void embedding_layer<TensorDataType, Layout, Device>::bp_compute() {
 
   // Local data
   const auto& local_input = dynamic_cast<const MatType&>(this->get_local_prev_activations());
-  auto& local_embedding_grad = dynamic_cast<MatType&>(this->m_embeddings_grad->Matrix());
   const auto& local_output_grad = dynamic_cast<const MatType&>(this->get_local_prev_error_signals());
   const size_t input_size = this->get_input_size();
   const size_t local_mini_batch_size = local_input.Width();
 
+  // Add sparse gradient w.r.t. embeddings, if supported by optimizer
+  // Note: Don't update gradient for padding index
+  auto* dt_opt = dynamic_cast<OptimizerType*>(&opt);
+  if (m_sparse_gradients && dt_opt != nullptr) {
+    auto& sparse_grad = dt_opt->get_sparse_gradient_buffer();
+    for (size_t j=0; j<local_mini_batch_size; ++j) {
+      for (size_t i=0; i<input_size; ++i) {
+        const El::Int ind = static_cast<El::Int>(std::floor(local_input(i, j)));
+        if (0<=ind && ind<static_cast<El::Int>(this->m_num_embeddings)
+            && ind!=this->m_padding_idx) {
+          sparse_grad.add(ind, local_output_grad.LockedBuffer(i*m_embedding_dim, j));
+        }
+      }
+    }
+    return;
+  }
+
   // Update gradient w.r.t. embeddings
   // Note: Don't update gradient for padding index
+  auto& local_embedding_grad = dynamic_cast<MatType&>(this->m_embeddings_grad->Matrix());
   El::Zero(local_embedding_grad);
   MatType embedding_grad_v, output_grad_v;
   for (size_t j=0; j<local_mini_batch_size; ++j) {
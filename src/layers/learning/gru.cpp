@@ -30,8 +30,10 @@
 #include "lbann/models/model.hpp"
 #include "lbann/weights/initializer.hpp"
 #include "lbann/proto/proto_common.hpp"
+#include "lbann/utils/argument_parser.hpp"
 #include "lbann/utils/dim_helpers.hpp"
 #include "lbann/utils/hash.hpp"
+#include "lbann/utils/options.hpp"
 #include "lbann/utils/sync_info_helpers.hpp"
 #include <layers.pb.h>
 
@@ -56,6 +58,7 @@ gru_layer<TensorDataType, Layout, Device>::gru_layer(const gru_layer& other)
   : data_type_layer<TensorDataType>(other),
     m_hidden_size{other.m_hidden_size},
     m_num_layers{other.m_num_layers} {
+  m_native_cpu_objects.reset();
 #ifdef LBANN_GRU_LAYER_ONEDNN_CPU_SUPPORTED
   m_onednn_cpu_objects.reset();
 #endif // LBANN_GRU_LAYER_ONEDNN_CPU_SUPPORTED
@@ -70,6 +73,7 @@ gru_layer<TensorDataType, Layout, Device>& gru_layer<TensorDataType, Layout, Dev
   data_type_layer<TensorDataType>::operator=(other);
   m_hidden_size = other.m_hidden_size;
   m_num_layers = other.m_num_layers;
+  m_native_cpu_objects.reset();
 #ifdef LBANN_GRU_LAYER_ONEDNN_CPU_SUPPORTED
   m_onednn_cpu_objects.reset();
 #endif // LBANN_GRU_LAYER_ONEDNN_CPU_SUPPORTED
@@ -254,11 +258,24 @@ void gru_layer<TensorDataType, Layout, Device>
     hh_bias.set_matrix_distribution(dist);
   }
 
-#ifdef LBANN_GRU_LAYER_ONEDNN_CPU_SUPPORTED
   if constexpr (Device == El::Device::CPU) {
-    setup_onednn_cpu();
-  }
+    // oneDNN only supports stacked GRU cells with matching input
+    // and hidden sizes
+    m_native_cpu_objects.reset();
+#ifdef LBANN_GRU_LAYER_ONEDNN_CPU_SUPPORTED
+    m_onednn_cpu_objects.reset();
+    auto& arg_parser = global_argument_parser();
+    if ((m_num_layers <= 1 || input_size == m_hidden_size)
+        && !arg_parser.get<bool>(USE_NATIVE_CPU_GRU)) {
+      setup_onednn_cpu();
+    }
+    else {
+      setup_native_cpu();
+    }
+#else
+    setup_native_cpu();
 #endif // LBANN_GRU_LAYER_ONEDNN_CPU_SUPPORTED
+  }
 #ifdef LBANN_GRU_LAYER_CUDNN_SUPPORTED
   if constexpr (Device == El::Device::GPU) {
     setup_cudnn();
@@ -273,12 +290,147 @@ void gru_layer<TensorDataType, Layout, Device>
 
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 void gru_layer<TensorDataType, Layout, Device>::fp_compute() {
-  fp_compute_impl(*this);
+  if constexpr (Device == El::Device::CPU) {
+#ifdef LBANN_GRU_LAYER_ONEDNN_CPU_SUPPORTED
+    if (m_onednn_cpu_objects != nullptr) {
+      fp_compute_impl(*this);
+      return;
+    }
+#endif // LBANN_GRU_LAYER_ONEDNN_CPU_SUPPORTED
+    fp_compute_native_cpu();
+  }
+  else {
+    fp_compute_impl(*this);
+  }
 }
 
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 void gru_layer<TensorDataType, Layout, Device>::bp_compute() {
-  bp_compute_impl(*this);
+  if constexpr (Device == El::Device::CPU) {
+#ifdef LBANN_GRU_LAYER_ONEDNN_CPU_SUPPORTED
+    if (m_onednn_cpu_objects != nullptr) {
+      bp_compute_impl(*this);
+      return;
+    }
+#endif // LBANN_GRU_LAYER_ONEDNN_CPU_SUPPORTED
+    bp_compute_native_cpu();
+  }
+  else {
+    bp_compute_impl(*this);
+  }
+}
+
+// =========================================================
+// Native CPU implementation
+// =========================================================
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void gru_layer<TensorDataType, Layout, Device>::setup_native_cpu() {
+  m_native_cpu_objects = make_unique<gru_cpu::workspace<TensorDataType>>();
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void gru_layer<TensorDataType, Layout, Device>::fp_compute_native_cpu() {
+  if constexpr (Device == El::Device::CPU) {
+
+    // Matrices
+    using LocalMat = El::Matrix<TensorDataType, El::Device::CPU>;
+    const auto& input_sequence
+      = dynamic_cast<const LocalMat&>(this->get_local_prev_activations(0));
+    const auto& init_hidden
+      = dynamic_cast<const LocalMat&>(this->get_local_prev_activations(1));
+    auto& output_sequence
+      = dynamic_cast<LocalMat&>(this->get_local_activations());
+
+    // Return immediately if there is no local data.
+    if (input_sequence.Width() <= 0) {
+      return;
+    }
+
+    // Native CPU objects
+    if (m_native_cpu_objects == nullptr) {
+      LBANN_ERROR(
+        this->get_type()," layer \"",this->get_name(),"\" ",
+        "attempted to run native CPU implementation ",
+        "before initializing workspaces");
+    }
+
+    // Weights
+    std::vector<LocalMat> weights_list(4*m_num_layers);
+    for (size_t i=0; i<4*m_num_layers; ++i) {
+      const auto& w
+        = dynamic_cast<const LocalMat&>(this->weights_values(i).LockedMatrix());
+      El::LockedView(weights_list[i], w);
+    }
+
+    gru_cpu::fp_compute(
+      input_sequence,
+      init_hidden,
+      weights_list,
+      output_sequence,
+      *m_native_cpu_objects);
+
+  }
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void gru_layer<TensorDataType, Layout, Device>::bp_compute_native_cpu() {
+  if constexpr (Device == El::Device::CPU) {
+
+    // Matrices
+    using LocalMat = El::Matrix<TensorDataType, El::Device::CPU>;
+    const auto& input_sequence
+      = dynamic_cast<const LocalMat&>(this->get_local_prev_activations(0));
+    const auto& init_hidden
+      = dynamic_cast<const LocalMat&>(this->get_local_prev_activations(1));
+    const auto& output_sequence_grad
+      = dynamic_cast<const LocalMat&>(this->get_local_prev_error_signals());
+    auto& input_sequence_grad
+      = dynamic_cast<LocalMat&>(this->get_local_error_signals(0));
+    auto& init_hidden_grad
+      = dynamic_cast<LocalMat&>(this->get_local_error_signals(1));
+
+    // Native CPU objects
+    if (m_native_cpu_objects == nullptr) {
+      LBANN_ERROR(
+        this->get_type()," layer \"",this->get_name(),"\" ",
+        "attempted to run native CPU implementation ",
+        "before initializing workspaces");
+    }
+
+    // Weights
+    std::vector<LocalMat> weights_list(4*m_num_layers);
+    for (size_t i=0; i<4*m_num_layers; ++i) {
+      const auto& w
+        = dynamic_cast<const LocalMat&>(this->weights_values(i).LockedMatrix());
+      El::LockedView(weights_list[i], w);
+    }
+
+    // Compute gradients
+    // Note: Weight gradients are zero if there is no local data.
+    std::vector<LocalMat> weights_grad_list(4*m_num_layers);
+    gru_cpu::bp_compute(
+      input_sequence,
+      init_hidden,
+      weights_list,
+      output_sequence_grad,
+      input_sequence_grad,
+      init_hidden_grad,
+      weights_grad_list,
+      *m_native_cpu_objects);
+
+    // Send gradients to optimizers
+    TensorDataType buf_scale, in_scale;
+    for (size_t i=0; i<4*m_num_layers; ++i) {
+      auto&& opt = this->get_weights(i).get_optimizer();
+      if (opt != nullptr) {
+        auto& buf = opt->get_gradient_buffer(buf_scale, in_scale, true);
+        El::Scale(buf_scale, buf);
+        El::Axpy(in_scale, weights_grad_list[i], buf.Matrix());
+      }
+    }
+
+  }
 }
 
 // =========================================================
@@ -1646,17 +1798,8 @@ struct Builder<TensorDataType,data_layout::DATA_PARALLEL,El::Device::CPU>
   {
     constexpr auto Layout = data_layout::DATA_PARALLEL;
     constexpr auto Device = El::Device::CPU;
-#ifdef LBANN_GRU_LAYER_ONEDNN_CPU_SUPPORTED
     using LayerType = gru_layer<TensorDataType,Layout,Device>;
     return make_unique<LayerType>(std::forward<Args>(args)...);
-#else
-    LBANN_ERROR(
-      "CPU gru_layer requires oneDNN "
-      "(TensorDataType=",TypeName<TensorDataType>(),", ",
-      "Layout=",to_string(Layout),", ",
-      "Device=",to_string(Device),")");
-    return nullptr;
-#endif // LBANN_GRU_LAYER_ONEDNN_CPU_SUPPORTED
   }
 };
 
@@ -1703,14 +1846,12 @@ std::unique_ptr<Layer> build_gru_layer_from_pbuf(
 // Explicit template instantiation
 // =========================================================
 
-#ifdef LBANN_GRU_LAYER_ONEDNN_CPU_SUPPORTED
 #define PROTO(T)                                                        \
   template class gru_layer<                                             \
     T, data_layout::DATA_PARALLEL, El::Device::CPU>;
 #define LBANN_INSTANTIATE_CPU_HALF
 #include "lbann/macros/instantiate.hpp"
 #undef PROTO
-#endif // LBANN_GRU_LAYER_ONEDNN_CPU_SUPPORTED
 #ifdef LBANN_GRU_LAYER_CUDNN_SUPPORTED
 #define PROTO(T)                                                        \
   template class gru_layer<                                             \
@@ -0,0 +1,408 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#define LBANN_GRU_CPU_INSTANTIATE
+#include "lbann/layers/learning/gru_cpu.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/omp_pragma.hpp"
+
+#include <algorithm>
+
+namespace lbann {
+namespace gru_cpu {
+
+namespace {
+
+template <typename TensorDataType>
+inline TensorDataType sigmoid(const TensorDataType& x) {
+  static const auto one = El::TypeTraits<TensorDataType>::One();
+  return one / (one + El::Exp(-x));
+}
+
+/** @brief Get a contiguous sequence matrix.
+ *
+ *  A sequence matrix is (sequence_length*vector_size) x
+ *  mini_batch_size. If it is contiguous, it can be viewed as a
+ *  vector_size x (sequence_length*mini_batch_size) matrix. Otherwise
+ *  it is copied into @c workspace.
+ */
+template <typename TensorDataType>
+const TensorDataType* get_contiguous_sequence(
+  const El::Matrix<TensorDataType, El::Device::CPU>& sequence,
+  El::Matrix<TensorDataType, El::Device::CPU>& workspace) {
+  if (sequence.LDim() == sequence.Height() || sequence.Width() <= 1) {
+    return sequence.LockedBuffer();
+  }
+  workspace.Resize(sequence.Height(), sequence.Width(), sequence.Height());
+  El::Copy(sequence, workspace);
+  return workspace.LockedBuffer();
+}
+
+} // namespace <anon>
+
+template <typename TensorDataType>
+void fp_compute(
+  const El::Matrix<TensorDataType, El::Device::CPU>& input_sequence,
+  const El::Matrix<TensorDataType, El::Device::CPU>& init_hidden,
+  const std::vector<El::Matrix<TensorDataType, El::Device::CPU>>& weights,
+  El::Matrix<TensorDataType, El::Device::CPU>& output_sequence,
+  workspace<TensorDataType>& ws) {
+
+  // Typedefs
+  using LocalMat = El::Matrix<TensorDataType, El::Device::CPU>;
+  static const auto zero = El::TypeTraits<TensorDataType>::Zero();
+  static const auto one = El::TypeTraits<TensorDataType>::One();
+
+  // Dimensions
+  const El::Int num_layers = weights.size() / 4;
+  const El::Int input_size = weights[0].Width();
+  const El::Int hidden_size = weights[1].Width();
+  const El::Int sequence_length = input_sequence.Height() / input_size;
+  const El::Int mini_batch_size = input_sequence.Width();
+  const El::Int num_cols = sequence_length * mini_batch_size;
+  ws.output_sequences.resize(num_layers);
+  ws.gates.resize(num_layers);
+  if (mini_batch_size <= 0) {
+    return;
+  }
+
+  // Input sequence with one column per time step and sample
+  LocalMat x;
+  x.LockedAttach(input_size,
+                 num_cols,
+                 get_contiguous_sequence(input_sequence, ws.input_sequence),
+                 input_size);
+
+  auto& hh_gates = ws.hh_gates;
+  hh_gates.Resize(3*hidden_size, mini_batch_size, 3*hidden_size);
+  for (El::Int layer = 0; layer < num_layers; ++layer) {
+    const auto& ih_matrix = weights[4*layer];
+    const auto& hh_matrix = weights[4*layer+1];
+    const auto* __restrict__ ih_bias = weights[4*layer+2].LockedBuffer();
+    const auto* __restrict__ hh_bias = weights[4*layer+3].LockedBuffer();
+    auto& gates = ws.gates[layer];
+    auto& output = ws.output_sequences[layer];
+    gates.Resize(4*hidden_size, num_cols, 4*hidden_size);
+    output.Resize(hidden_size, num_cols, hidden_size);
+
+    // Input-hidden contribution to gates for all time steps
+    LocalMat ih_gates;
+    ih_gates.Attach(3*hidden_size, num_cols, gates.Buffer(), 4*hidden_size);
+    El::Gemm(El::NORMAL, El::NORMAL, one, ih_matrix, x, zero, ih_gates);
+
+    // Unroll GRU cell
+    // Note: Column t-1 of the output holds the hidden state of the
+    // first sample and each sample spans sequence_length columns.
+    const TensorDataType* prev_hidden_buffer
+      = init_hidden.LockedBuffer() + layer*hidden_size;
+    El::Int prev_hidden_ldim = init_hidden.LDim();
+    for (El::Int t = 0; t < sequence_length; ++t) {
+      if (t > 0) {
+        prev_hidden_buffer = output.LockedBuffer() + (t-1)*output.LDim();
+        prev_hidden_ldim = sequence_length * output.LDim();
+      }
+
+      // Hidden-hidden contribution to gates
+      const LocalMat prev_hidden(hidden_size,
+                                 mini_batch_size,
+                                 prev_hidden_buffer,
+                                 prev_hidden_ldim);
+      El::Gemm(El::NORMAL, El::NORMAL,
+               one, hh_matrix, prev_hidden,
+               zero, hh_gates);
+
+      // Apply gate nonlinearities and update hidden state
+      auto* __restrict__ gates_buffer = gates.Buffer();
+      const auto* __restrict__ hh_gates_buffer = hh_gates.LockedBuffer();
+      auto* __restrict__ output_buffer = output.Buffer();
+      LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+      for (El::Int j = 0; j < mini_batch_size; ++j) {
+        for (El::Int i = 0; i < hidden_size; ++i) {
+          const El::Int col = t + j*sequence_length;
+          auto* g = &gates_buffer[col*4*hidden_size];
+          const auto* gh = &hh_gates_buffer[j*3*hidden_size];
+          const auto& h_prev = prev_hidden_buffer[i+j*prev_hidden_ldim];
+          const auto r = sigmoid(g[i] + ih_bias[i]
+                                 + gh[i] + hh_bias[i]);
+          const auto z = sigmoid(g[hidden_size+i] + ih_bias[hidden_size+i]
+                                 + gh[hidden_size+i] + hh_bias[hidden_size+i]);
+          const auto hn = gh[2*hidden_size+i] + hh_bias[2*hidden_size+i];
+          const auto n = El::Tanh(g[2*hidden_size+i] + ih_bias[2*hidden_size+i]
+                                  + r * hn);
+          g[i] = r;
+          g[hidden_size+i] = z;
+          g[2*hidden_size+i] = n;
+          g[3*hidden_size+i] = hn;
+          output_buffer[i+col*hidden_size] = (one - z) * n + z * h_prev;
+        }
+      }
+
+    }
+
+    // Output sequence is input to next GRU cell
+    x.LockedAttach(hidden_size, num_cols, output.LockedBuffer(), hidden_size);
+
+  }
+
+  // Copy output sequence of last GRU cell
+  const LocalMat output(sequence_length*hidden_size,
+                        mini_batch_size,
+                        ws.output_sequences.back().LockedBuffer(),
+                        sequence_length*hidden_size);
+  El::Copy(output, output_sequence);
+
+}
+
+template <typename TensorDataType>
+void bp_compute(
+  const El::Matrix<TensorDataType, El::Device::CPU>& input_sequence,
+  const El::Matrix<TensorDataType, El::Device::CPU>& init_hidden,
+  const std::vector<El::Matrix<TensorDataType, El::Device::CPU>>& weights,
+  const El::Matrix<TensorDataType, El::Device::CPU>& output_sequence_grad,
+  El::Matrix<TensorDataType, El::Device::CPU>& input_sequence_grad,
+  El::Matrix<TensorDataType, El::Device::CPU>& init_hidden_grad,
+  std::vector<El::Matrix<TensorDataType, El::Device::CPU>>& weights_grad,
+  workspace<TensorDataType>& ws) {
+
+  // Typedefs
+  using LocalMat = El::Matrix<TensorDataType, El::Device::CPU>;
+  static const auto zero = El::TypeTraits<TensorDataType>::Zero();
+  static const auto one = El::TypeTraits<TensorDataType>::One();
+
+  // Dimensions
+  const El::Int num_layers = weights.size() / 4;
+  const El::Int input_size = weights[0].Width();
+  const El::Int hidden_size = weights[1].Width();
+  const El::Int sequence_length = input_sequence.Height() / input_size;
+  const El::Int mini_batch_size = input_sequence.Width();
+  const El::Int num_cols = sequence_length * mini_batch_size;
+
+  // Initialize weight gradients
+  weights_grad.resize(4*num_layers);
+  for (El::Int layer = 0; layer < num_layers; ++layer) {
+    for (El::Int i = 0; i < 4; ++i) {
+      const auto& w = weights[4*layer+i];
+      weights_grad[4*layer+i].Resize(w.Height(), w.Width());
+    }
+  }
+  if (mini_batch_size <= 0) {
+    for (auto& dw : weights_grad) {
+      El::Zero(dw);
+    }
+    return;
+  }
+  if (ws.gates.size() != static_cast<size_t>(num_layers)
+      || ws.gates.front().Width() != num_cols) {
+    LBANN_ERROR("attempted GRU back prop without matching forward prop");
+  }
+
+  // Workspaces
+  auto& ih_gates_grad = ws.ih_gates_grad;
+  auto& hh_gates_grad = ws.hh_gates_grad;
+  auto& prev_hidden = ws.prev_hidden;
+  auto& hidden_grad = ws.hidden_grad;
+  ih_gates_grad.Resize(3*hidden_size, num_cols, 3*hidden_size);
+  hh_gates_grad.Resize(3*hidden_size, num_cols, 3*hidden_size);
+  prev_hidden.Resize(hidden_size, num_cols, hidden_size);
+  hidden_grad.Resize(hidden_size, mini_batch_size, hidden_size);
+  El::Ones(ws.ones, num_cols, 1);
+
+  // Output sequence gradient with one column per time step and sample
+  LocalMat dy;
+  dy.LockedAttach(
+    hidden_size,
+    num_cols,
+    get_contiguous_sequence(output_sequence_grad, ws.output_sequence_grad),
+    hidden_size);
+
+  for (El::Int layer = num_layers-1; layer >= 0; --layer) {
+    const auto& ih_matrix = weights[4*layer];
+    const auto& hh_matrix = weights[4*layer+1];
+    const auto& gates = ws.gates[layer];
+    const auto& output = ws.output_sequences[layer];
+    const auto* init_hidden_buffer = init_hidden.LockedBuffer() + layer*hidden_size;
+    const El::Int init_hidden_ldim = init_hidden.LDim();
+
+    // Back prop through time
+    // Note: Gradients w.r.t. gates are stored for all time steps so
+    // that weight gradients can be computed with large GEMMs.
+    El::Zero(hidden_grad);
+    for (El::Int t = sequence_length-1; t >= 0; --t) {
+      const TensorDataType* prev_hidden_buffer = init_hidden_buffer;
+      El::Int prev_hidden_ldim = init_hidden_ldim;
+      if (t > 0) {
+        prev_hidden_buffer = output.LockedBuffer() + (t-1)*output.LDim();
+        prev_hidden_ldim = sequence_length * output.LDim();
+      }
+
+      // Back prop through gate nonlinearities
+      const auto* __restrict__ gates_buffer = gates.LockedBuffer();
+      const auto* __restrict__ dy_buffer = dy.LockedBuffer();
+      auto* __restrict__ ih_gates_grad_buffer = ih_gates_grad.Buffer();
+      auto* __restrict__ hh_gates_grad_buffer = hh_gates_grad.Buffer();
+      auto* __restrict__ hidden_grad_buffer = hidden_grad.Buffer();
+      LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+      for (El::Int j = 0; j < mini_batch_size; ++j) {
+        for (El::Int i = 0; i < hidden_size; ++i) {
+          const El::Int col = t + j*sequence_length;
+          const auto* g = &gates_buffer[col*4*hidden_size];
+          auto* dgi = &ih_gates_grad_buffer[col*3*hidden_size];
+          auto* dgh = &hh_gates_grad_buffer[col*3*hidden_size];
+          auto& dh_next = hidden_grad_buffer[i+j*hidden_size];
+          const auto& h_prev = prev_hidden_buffer[i+j*prev_hidden_ldim];
+          const auto& r = g[i];
+          const auto& z = g[hidden_size+i];
+          const auto& n = g[2*hidden_size+i];
+          const auto& hn = g[3*hidden_size+i];
+          const auto dh = dy_buffer[i+col*hidden_size] + dh_next;
+          const auto dn = dh * (one - z) * (one - n * n);
+          const auto dr = dn * hn * r * (one - r);
+          const auto dz = dh * (h_prev - n) * z * (one - z);
+          dgi[i] = dr;
+          dgi[hidden_size+i] = dz;
+          dgi[2*hidden_size+i] = dn;
+          dgh[i] = dr;
+          dgh[hidden_size+i] = dz;
+          dgh[2*hidden_size+i] = dn * r;
+          dh_next = dh * z;
+        }
+      }
+
+      // Back prop through hidden-hidden matrix
+      const LocalMat hh_gates_grad_t(3*hidden_size,
+                                     mini_batch_size,
+                                     (hh_gates_grad.LockedBuffer()
+                                      + t*hh_gates_grad.LDim()),
+                                     sequence_length*hh_gates_grad.LDim());
+      El::Gemm(El::TRANSPOSE, El::NORMAL,
+               one, hh_matrix, hh_gates_grad_t,
+               one, hidden_grad);
+
+    }
+
+    // Gradient w.r.t. initial hidden state
+    LocalMat init_hidden_grad_v;
+    El::View(init_hidden_grad_v, init_hidden_grad,
+             El::IR(layer*hidden_size, (layer+1)*hidden_size), El::ALL);
+    El::Copy(hidden_grad, init_hidden_grad_v);
+
+    // Hidden state before each time step
+    {
+      const auto* __restrict__ output_buffer = output.LockedBuffer();
+      auto* __restrict__ prev_hidden_buffer = prev_hidden.Buffer();
+      LBANN_OMP_PARALLEL_FOR
+      for (El::Int j = 0; j < mini_batch_size; ++j) {
+        const auto* h0 = &init_hidden_buffer[j*init_hidden_ldim];
+        const auto* y = &output_buffer[j*sequence_length*hidden_size];
+        auto* h = &prev_hidden_buffer[j*sequence_length*hidden_size];
+        std::copy(h0, h0+hidden_size, h);
+        std::copy(y, y+(sequence_length-1)*hidden_size, h+hidden_size);
+      }
+    }
+
+    // Weight gradients
+    LocalMat x;
+    if (layer == 0) {
+      x.LockedAttach(input_size,
+                     num_cols,
+                     get_contiguous_sequence(input_sequence, ws.input_sequence),
+                     input_size);
+    }
+    else {
+      x.LockedAttach(hidden_size,
+                     num_cols,
+                     ws.output_sequences[layer-1].LockedBuffer(),
+                     hidden_size);
+    }
+    El::Gemm(El::NORMAL, El::TRANSPOSE,
+             one, ih_gates_grad, x,
+             zero, weights_grad[4*layer]);
+    El::Gemm(El::NORMAL, El::TRANSPOSE,
+             one, hh_gates_grad, prev_hidden,
+             zero, weights_grad[4*layer+1]);
+    El::Gemv(El::NORMAL, one, ih_gates_grad, ws.ones,
+             zero, weights_grad[4*layer+2]);
+    El::Gemv(El::NORMAL, one, hh_gates_grad, ws.ones,
+             zero, weights_grad[4*layer+3]);
+
+    // Gradient w.r.t. input sequence of GRU cell
+    // Note: The output sequence gradient is no longer needed, so its
+    // workspace is reused for the next GRU cell.
+    if (layer > 0) {
+      auto& dx = ws.output_sequence_grad;
+      dx.Resize(hidden_size, num_cols, hidden_size);
+      El::Gemm(El::TRANSPOSE, El::NORMAL,
+               one, ih_matrix, ih_gates_grad,
+               zero, dx);
+      dy.LockedAttach(hidden_size, num_cols, dx.LockedBuffer(), hidden_size);
+    }
+    else if (input_sequence_grad.LDim() == input_sequence_grad.Height()
+             || mini_batch_size <= 1) {
+      LocalMat dx;
+      dx.Attach(input_size, num_cols, input_sequence_grad.Buffer(), input_size);
+      El::Gemm(El::TRANSPOSE, El::NORMAL,
+               one, ih_matrix, ih_gates_grad,
+               zero, dx);
+    }
+    else {
+      auto& dx = ws.input_sequence_grad;
+      dx.Resize(input_size, num_cols, input_size);
+      El::Gemm(El::TRANSPOSE, El::NORMAL,
+               one, ih_matrix, ih_gates_grad,
+               zero, dx);
+      const LocalMat dx_v(sequence_length*input_size,
+                          mini_batch_size,
+                          dx.LockedBuffer(),
+                          sequence_length*input_size);
+      El::Copy(dx_v, input_sequence_grad);
+    }
+
+  }
+
+}
+
+#define PROTO(T)                                                        \
+  template void fp_compute<T>(                                          \
+    const El::Matrix<T, El::Device::CPU>&,                              \
+    const El::Matrix<T, El::Device::CPU>&,                              \
+    const std::vector<El::Matrix<T, El::Device::CPU>>&,                 \
+    El::Matrix<T, El::Device::CPU>&,                                    \
+    workspace<T>&);                                                     \
+  template void bp_compute<T>(                                          \
+    const El::Matrix<T, El::Device::CPU>&,                              \
+    const El::Matrix<T, El::Device::CPU>&,                              \
+    const std::vector<El::Matrix<T, El::Device::CPU>>&,                 \
+    const El::Matrix<T, El::Device::CPU>&,                              \
+    El::Matrix<T, El::Device::CPU>&,                                    \
+    El::Matrix<T, El::Device::CPU>&,                                    \
+    std::vector<El::Matrix<T, El::Device::CPU>>&,                       \
+    workspace<T>&)
+
+#define LBANN_INSTANTIATE_CPU_HALF
+#include "lbann/macros/instantiate.hpp"
+
+} // namespace gru_cpu
+} // namespace lbann
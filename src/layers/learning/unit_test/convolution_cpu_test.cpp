@@ -0,0 +1,304 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <catch2/catch.hpp>
+
+#include "lbann/base.hpp"
+#include "lbann/layers/learning/convolution_cpu.hpp"
+#include "lbann/utils/im2col.hpp"
+
+#include <functional>
+#include <numeric>
+#include <vector>
+
+namespace {
+
+using MatType = lbann::CPUMatDT<double>;
+
+/** @brief 2D convolution parameters. */
+struct conv_config {
+  int input_channels;
+  int output_channels;
+  std::vector<int> input_spatial_dims;
+  std::vector<int> window_dims;
+  std::vector<int> pads;
+  std::vector<int> strides;
+  std::vector<int> dilations;
+  El::Int num_samples;
+
+  /** @brief Window covered by a dilated window. */
+  std::vector<int> get_dilated_window_dims() const {
+    std::vector<int> dims(2);
+    for (size_t d = 0; d < 2; ++d) {
+      dims[d] = (window_dims[d] - 1) * dilations[d] + 1;
+    }
+    return dims;
+  }
+  std::vector<int> get_input_dims() const {
+    return {input_channels, input_spatial_dims[0], input_spatial_dims[1]};
+  }
+  std::vector<int> get_output_dims() const {
+    const auto dilated_dims = get_dilated_window_dims();
+    std::vector<int> dims = {output_channels};
+    for (size_t d = 0; d < 2; ++d) {
+      dims.push_back((input_spatial_dims[d] + 2 * pads[d] - dilated_dims[d])
+                     / strides[d] + 1);
+    }
+    return dims;
+  }
+};
+
+El::Int get_size(const std::vector<int>& dims) {
+  return std::accumulate(dims.begin(), dims.end(),
+                         El::Int(1), std::multiplies<El::Int>());
+}
+
+/** @brief Row of a kernel matrix for a channel and window position. */
+El::Int get_kernel_row(int channel, int y, int x, const std::vector<int>& window_dims) {
+  return x + window_dims[1] * (y + window_dims[0] * channel);
+}
+
+/** @brief Embed a dilated kernel in its undilated window.
+ *
+ *  A dilated convolution is equivalent to a convolution with the
+ *  larger window, with zeros at the skipped positions. This lets the
+ *  previous im2col path, which has no dilation support, act as the
+ *  reference.
+ */
+MatType expand_kernel(const MatType& kernel,
+                      int channels,
+                      const conv_config& cfg) {
+  const auto dilated_dims = cfg.get_dilated_window_dims();
+  MatType expanded;
+  El::Zeros(expanded, channels * get_size(dilated_dims), kernel.Width());
+  for (El::Int j = 0; j < kernel.Width(); ++j) {
+    for (int c = 0; c < channels; ++c) {
+      for (int y = 0; y < cfg.window_dims[0]; ++y) {
+        for (int x = 0; x < cfg.window_dims[1]; ++x) {
+          const auto row = get_kernel_row(c, y, x, cfg.window_dims);
+          const auto expanded_row = get_kernel_row(c,
+                                                   y * cfg.dilations[0],
+                                                   x * cfg.dilations[1],
+                                                   dilated_dims);
+          expanded(expanded_row, j) = kernel(row, j);
+        }
+      }
+    }
+  }
+  return expanded;
+}
+
+/** @brief Forward convolution with one im2col and GEMM per sample. */
+void reference_convolution(const MatType& input,
+                           MatType& output,
+                           const MatType& kernel,
+                           const conv_config& cfg) {
+  const auto input_dims = cfg.get_input_dims();
+  const auto output_dims = cfg.get_output_dims();
+  const auto window_dims = cfg.get_dilated_window_dims();
+  const auto expanded_kernel = expand_kernel(kernel, cfg.input_channels, cfg);
+  const El::Int m = get_size(output_dims) / output_dims[0];
+  const El::Int n = output_dims[0];
+  const El::Int k = expanded_kernel.Height();
+  MatType im2col_matrix(k, m), output_col;
+  output.Resize(get_size(output_dims), input.Width());
+  for (El::Int col = 0; col < input.Width(); ++col) {
+    const auto input_col = El::LockedView(input, El::ALL, El::IR(col));
+    lbann::im2col<double>(input_col, im2col_matrix, input_dims[0], 2,
+                          &input_dims[1], cfg.pads.data(),
+                          window_dims.data(), cfg.strides.data());
+    output_col.Attach(m, n, output.Buffer(0, col), m);
+    El::Gemm(El::TRANSPOSE, El::NORMAL,
+             1., im2col_matrix, expanded_kernel,
+             0., output_col);
+  }
+}
+
+/** @brief Transposed convolution with one GEMM and col2im per sample.
+ *
+ *  Maps tensors shaped like the convolution output to tensors shaped
+ *  like the convolution input, as in backprop.
+ */
+void reference_transposed_convolution(const MatType& input,
+                                      MatType& output,
+                                      const MatType& kernel,
+                                      const conv_config& cfg) {
+  const auto input_dims = cfg.get_output_dims();
+  const auto output_dims = cfg.get_input_dims();
+  const auto window_dims = cfg.get_dilated_window_dims();
+  const auto expanded_kernel = expand_kernel(kernel, cfg.input_channels, cfg);
+  const El::Int m = expanded_kernel.Height();
+  const El::Int n = get_size(input_dims) / input_dims[0];
+  const El::Int k = input_dims[0];
+  MatType im2col_matrix(m, n), input_col;
+  output.Resize(get_size(output_dims), input.Width());
+  for (El::Int col = 0; col < input.Width(); ++col) {
+    input_col.LockedAttach(n, k, input.LockedBuffer(0, col), n);
+    El::Gemm(El::NORMAL, El::TRANSPOSE,
+             1., expanded_kernel, input_col,
+             0., im2col_matrix);
+    auto output_col = El::View(output, El::ALL, El::IR(col));
+    lbann::col2im<double>(im2col_matrix, output_col, output_dims[0], 2,
+                          &output_dims[1], cfg.pads.data(),
+                          window_dims.data(), cfg.strides.data());
+  }
+}
+
+/** @brief Kernel gradient with one im2col and GEMM per sample.
+ *
+ *  Entries at the skipped positions of a dilated window are dropped.
+ */
+void reference_kernel_gradient(const MatType& input,
+                               const MatType& gradient_wrt_output,
+                               MatType& kernel_gradient,
+                               const conv_config& cfg,
+                               double scale) {
+  const auto input_dims = cfg.get_input_dims();
+  const auto output_dims = cfg.get_output_dims();
+  const auto window_dims = cfg.get_dilated_window_dims();
+  const El::Int m = cfg.input_channels * get_size(window_dims);
+  const El::Int n = cfg.output_channels;
+  const El::Int k = get_size(output_dims) / output_dims[0];
+  MatType im2col_matrix(m, k), gradient_col, expanded_gradient;
+  El::Zeros(expanded_gradient, m, n);
+  for (El::Int col = 0; col < input.Width(); ++col) {
+    const auto input_col = El::LockedView(input, El::ALL, El::IR(col));
+    lbann::im2col<double>(input_col, im2col_matrix, input_dims[0], 2,
+                          &input_dims[1], cfg.pads.data(),
+                          window_dims.data(), cfg.strides.data());
+    gradient_col.LockedAttach(k, n, gradient_wrt_output.LockedBuffer(0, col), k);
+    El::Gemm(El::NORMAL, El::NORMAL,
+             scale, im2col_matrix, gradient_col,
+             1., expanded_gradient);
+  }
+  for (El::Int j = 0; j < n; ++j) {
+    for (int c = 0; c < cfg.input_channels; ++c) {
+      for (int y = 0; y < cfg.window_dims[0]; ++y) {
+        for (int x = 0; x < cfg.window_dims[1]; ++x) {
+          const auto row = get_kernel_row(c, y, x, cfg.window_dims);
+          const auto expanded_row = get_kernel_row(c,
+                                                   y * cfg.dilations[0],
+                                                   x * cfg.dilations[1],
+                                                   window_dims);
+          kernel_gradient(row, j) += expanded_gradient(expanded_row, j);
+        }
+      }
+    }
+  }
+}
+
+void check_close(const MatType& actual, const MatType& expected) {
+  REQUIRE(actual.Height() == expected.Height());
+  REQUIRE(actual.Width() == expected.Width());
+  for (El::Int j = 0; j < actual.Width(); ++j) {
+    for (El::Int i = 0; i < actual.Height(); ++i) {
+      CHECK(actual(i, j) == Approx(expected(i, j)));
+    }
+  }
+}
+
+/** @brief Compare the convolution_cpu engine with the previous path. */
+void check_against_reference(const conv_config& cfg) {
+  const auto input_dims = cfg.get_input_dims();
+  const auto output_dims = cfg.get_output_dims();
+  const El::Int kernel_height
+    = cfg.input_channels * get_size(cfg.window_dims);
+
+  MatType input, gradient_wrt_output, kernel;
+  El::Uniform(input, get_size(input_dims), cfg.num_samples);
+  El::Uniform(gradient_wrt_output, get_size(output_dims), cfg.num_samples);
+  El::Uniform(kernel, kernel_height, cfg.output_channels);
+
+  SECTION("Convolution")
+  {
+    MatType output(get_size(output_dims), cfg.num_samples), expected;
+    lbann::convolution_cpu::apply_convolution<double>(
+      input, output, kernel, input_dims, output_dims,
+      cfg.window_dims.data(), cfg.pads.data(),
+      cfg.strides.data(), cfg.dilations.data());
+    reference_convolution(input, expected, kernel, cfg);
+    check_close(output, expected);
+  }
+
+  SECTION("Transposed convolution")
+  {
+    MatType output(get_size(input_dims), cfg.num_samples), expected;
+    lbann::convolution_cpu::apply_transposed_convolution<double>(
+      gradient_wrt_output, output, kernel, output_dims, input_dims,
+      cfg.window_dims.data(), cfg.pads.data(),
+      cfg.strides.data(), cfg.dilations.data());
+    reference_transposed_convolution(gradient_wrt_output, expected,
+                                     kernel, cfg);
+    check_close(output, expected);
+  }
+
+  SECTION("Kernel gradient")
+  {
+    const double scale = 0.5;
+    MatType kernel_gradient, expected;
+    El::Uniform(kernel_gradient, kernel_height, cfg.output_channels);
+    El::Copy(kernel_gradient, expected);
+    lbann::convolution_cpu::accumulate_kernel_gradient<double>(
+      input, gradient_wrt_output, kernel_gradient, input_dims,
+      cfg.output_channels, cfg.window_dims.data(), cfg.pads.data(),
+      cfg.strides.data(), cfg.dilations.data(), scale);
+    reference_kernel_gradient(input, gradient_wrt_output, expected,
+                              cfg, scale);
+    check_close(kernel_gradient, expected);
+  }
+}
+
+} // namespace
+
+TEST_CASE("CPU convolution matches per-sample im2col",
+          "[layer][convolution][im2col]")
+{
+  SECTION("Unit stride, no padding")
+  {
+    check_against_reference({2, 3, {7, 6}, {3, 2}, {0, 0}, {1, 1}, {1, 1}, 4});
+  }
+  SECTION("Strided and padded")
+  {
+    check_against_reference({3, 2, {9, 8}, {3, 3}, {1, 2}, {2, 3}, {1, 1}, 5});
+  }
+  SECTION("Dilated")
+  {
+    check_against_reference({2, 2, {10, 9}, {3, 2}, {0, 0}, {1, 1}, {2, 3}, 3});
+  }
+  SECTION("Strided, padded and dilated")
+  {
+    check_against_reference({3, 4, {11, 10}, {3, 3}, {2, 1}, {2, 2}, {2, 3}, 3});
+  }
+  SECTION("1x1 window")
+  {
+    check_against_reference({4, 3, {5, 6}, {1, 1}, {0, 0}, {1, 1}, {1, 1}, 4});
+  }
+  SECTION("Several blocks of samples")
+  {
+    // The im2col workspace of one sample fills most of a block
+    check_against_reference({4, 2, {256, 256}, {3, 3}, {1, 1}, {1, 1}, {1, 1}, 3});
+  }
+}
@@ -104,6 +104,7 @@ void batch_normalization_layer<TensorDataType, T_layout, Dev>::fp_compute() {
     if (num_per_sum <= 1) {
       El::Fill(local_var, one);
     } else {
+      const auto decay = this->get_running_decay();
       LBANN_OMP_PARALLEL_FOR
       for (El::Int channel = 0; channel < num_channels; ++channel) {
         auto num_per_sum_dt = El::To<TensorDataType>(num_per_sum);
@@ -116,8 +117,8 @@ void batch_normalization_layer<TensorDataType, T_layout, Dev>::fp_compute() {
         local_var(channel, 0) = var;
         auto& running_mean = local_running_mean(channel, 0);
         auto& running_var = local_running_var(channel, 0);
-        running_mean = this->m_decay * running_mean + (one - this->m_decay) * mean;
-        running_var = this->m_decay * running_var + (one - this->m_decay) * var;
+        running_mean = decay * running_mean + (one - decay) * mean;
+        running_var = decay * running_var + (one - decay) * var;
       }
     }
 
@@ -539,7 +539,7 @@ void batch_normalization_layer<TensorDataType, T_layout, Dev>::fp_compute() {
       hydrogen::gpu::LaunchKernel(
         fp_statistics_kernel<TensorDataType>,
         grid_dims, block_dim, 0, multisync,
-        num_channels, num_per_sum, this->m_epsilon, this->m_decay,
+        num_channels, num_per_sum, this->m_epsilon, this->get_running_decay(),
         local_mean.Buffer(), local_var.Buffer(),
         local_running_mean.Buffer(), local_running_var.Buffer());
     }
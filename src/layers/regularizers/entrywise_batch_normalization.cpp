@@ -396,7 +396,7 @@ void entrywise_batch_normalization_layer<TensorDataType, T_layout, Dev>::fp_comp
 
   const auto mode = this->m_model->get_execution_context().get_execution_mode();
   fp_impl(*this->get_comm(),
-          this->m_decay,
+          this->get_running_decay(),
           this->m_epsilon,
           mode == execution_mode::training,
           this->get_prev_activations(),
@@ -37,7 +37,8 @@ concatenate_layer<TensorDataType,Layout,Device>
   using DataTypeLayer = data_type_layer<TensorDataType>;
   ar(::cereal::make_nvp("DataTypeLayer",
                         ::cereal::base_class<DataTypeLayer>(this)),
-     CEREAL_NVP(m_concat_dim));
+     CEREAL_NVP(m_concat_dim),
+     CEREAL_NVP(m_zero_copy));
   // Members that aren't serialized:
   //   m_workspace
   //   m_workspace_event
@@ -40,7 +40,8 @@ slice_layer<TensorDataType,Layout,Device>
      CEREAL_NVP(m_slice_dim),
      CEREAL_NVP(m_slice_points),
      CEREAL_NVP(m_set_slice_points_from_data_reader),
-     CEREAL_NVP(m_var_category));
+     CEREAL_NVP(m_var_category),
+     CEREAL_NVP(m_zero_copy));
   // Members that aren't serialized
   //   m_workspace;
   //   m_workspace_event;
@@ -37,8 +37,10 @@ std::unique_ptr<Layer> build_concatenate_layer_from_pbuf(
 {
   LBANN_ASSERT_MSG_HAS_FIELD(proto_layer, concatenation);
   using LayerType = concatenate_layer<TensorDataType, Layout, Device>;
-  const auto& axis = proto_layer.concatenation().axis();
-  return lbann::make_unique<LayerType>(comm, axis);
+  const auto& params = proto_layer.concatenation();
+  return lbann::make_unique<LayerType>(comm,
+                                       params.axis(),
+                                       params.zero_copy());
 }
 
 #define PROTO_DEVICE(T, Device) \
@@ -0,0 +1,487 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <catch2/catch.hpp>
+
+#include "TestHelpers.hpp"
+#include "MPITestHelpers.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/execution_contexts/sgd_execution_context.hpp>
+#include <lbann/layers/data_type_layer.hpp>
+#include <lbann/models/model.hpp>
+#include <lbann/objective_functions/objective_function.hpp>
+#include <lbann/proto/factories.hpp>
+#include <lbann/utils/lbann_library.hpp>
+#include <lbann/weights/data_type_weights.hpp>
+
+#include <lbann.pb.h>
+#include <google/protobuf/text_format.h>
+
+namespace pb = ::google::protobuf;
+
+namespace {
+
+using LayerType = lbann::data_type_layer<lbann::DataType>;
+
+// Parents of the concatenate layer: "fc_a" and "relu_b" accept
+// strided tensors, "softmax_c" does not.
+std::string const concatenate_prototext = R"ptext(
+model {
+  objective_function {
+    layer_term {
+      scale_factor: 1.0
+      layer: "l2"
+    }
+  }
+  layer {
+    name: "x"
+    weights: "x_w"
+    weights_layer {
+      dims: "4"
+    }
+  }
+  layer {
+    name: "fc_a"
+    parents: "x"
+    weights: "fc_a_w"
+    fully_connected {
+      num_neurons: 3
+      has_bias: false
+    }
+  }
+  layer {
+    name: "fc_b"
+    parents: "x"
+    weights: "fc_b_w"
+    fully_connected {
+      num_neurons: 2
+      has_bias: false
+    }
+  }
+  layer {
+    name: "relu_b"
+    parents: "fc_b"
+    relu {
+    }
+  }
+  layer {
+    name: "softmax_c"
+    parents: "x"
+    softmax {
+    }
+  }
+  layer {
+    name: "concat"
+    parents: "fc_a relu_b softmax_c"
+    concatenation {
+      axis: 0
+      zero_copy: ZERO_COPY
+    }
+  }
+  layer {
+    name: "fc_out"
+    parents: "concat"
+    weights: "fc_out_w"
+    fully_connected {
+      num_neurons: 2
+      has_bias: false
+    }
+  }
+  layer {
+    name: "l2"
+    parents: "fc_out"
+    l2_norm2 {
+    }
+  }
+  weights {
+    name: "x_w"
+    initializer {
+      value_initializer {
+        values: "0.5 -0.3 0.8 0.1"
+      }
+    }
+  }
+  weights {
+    name: "fc_a_w"
+    initializer {
+      uniform_initializer {
+        min: -1
+        max: 1
+      }
+    }
+  }
+  weights {
+    name: "fc_b_w"
+    initializer {
+      uniform_initializer {
+        min: -1
+        max: 1
+      }
+    }
+  }
+  weights {
+    name: "fc_out_w"
+    initializer {
+      uniform_initializer {
+        min: -1
+        max: 1
+      }
+    }
+  }
+}
+optimizer {
+  sgd {
+    learn_rate: 0.1
+  }
+}
+)ptext";
+
+// Children of the slice layer: "fc_a" and "relu_b" accept strided
+// tensors, "softmax_c" does not.
+std::string const slice_prototext = R"ptext(
+model {
+  objective_function {
+    layer_term {
+      scale_factor: 1.0
+      layer: "l2_a"
+    }
+    layer_term {
+      scale_factor: 1.0
+      layer: "l2_b"
+    }
+    layer_term {
+      scale_factor: 1.0
+      layer: "l2_c"
+    }
+  }
+  layer {
+    name: "x"
+    weights: "x_w"
+    weights_layer {
+      dims: "4"
+    }
+  }
+  layer {
+    name: "fc_in"
+    parents: "x"
+    weights: "fc_in_w"
+    fully_connected {
+      num_neurons: 9
+      has_bias: false
+    }
+  }
+  layer {
+    name: "slice"
+    parents: "fc_in"
+    children: "fc_a relu_b softmax_c"
+    slice {
+      axis: 0
+      slice_points: "0 3 5 9"
+      zero_copy: ZERO_COPY
+    }
+  }
+  layer {
+    name: "fc_a"
+    parents: "slice"
+    weights: "fc_a_w"
+    fully_connected {
+      num_neurons: 2
+      has_bias: false
+    }
+  }
+  layer {
+    name: "relu_b"
+    parents: "slice"
+    relu {
+    }
+  }
+  layer {
+    name: "softmax_c"
+    parents: "slice"
+    softmax {
+    }
+  }
+  layer {
+    name: "l2_a"
+    parents: "fc_a"
+    l2_norm2 {
+    }
+  }
+  layer {
+    name: "l2_b"
+    parents: "relu_b"
+    l2_norm2 {
+    }
+  }
+  layer {
+    name: "l2_c"
+    parents: "softmax_c"
+    l2_norm2 {
+    }
+  }
+  weights {
+    name: "x_w"
+    initializer {
+      value_initializer {
+        values: "0.5 -0.3 0.8 0.1"
+      }
+    }
+  }
+  weights {
+    name: "fc_in_w"
+    initializer {
+      uniform_initializer {
+        min: -1
+        max: 1
+      }
+    }
+  }
+  weights {
+    name: "fc_a_w"
+    initializer {
+      uniform_initializer {
+        min: -1
+        max: 1
+      }
+    }
+  }
+}
+optimizer {
+  sgd {
+    learn_rate: 0.1
+  }
+}
+)ptext";
+
+auto make_model(lbann::lbann_comm& comm,
+                std::string prototext,
+                bool zero_copy,
+                size_t mini_batch_size)
+{
+  auto const pos = prototext.find("ZERO_COPY");
+  prototext.replace(pos, 9, zero_copy ? "true" : "false");
+  lbann_data::LbannPB my_proto;
+  if (!pb::TextFormat::ParseFromString(prototext, &my_proto))
+    throw "Parsing protobuf failed.";
+  lbann::construct_trainer(&comm, my_proto.mutable_trainer(), my_proto);
+  auto my_model = lbann::proto::construct_model(&comm,
+                                                -1,
+                                                my_proto.optimizer(),
+                                                my_proto.trainer(),
+                                                my_proto.model());
+  lbann::DataReaderMetaData metadata;
+  my_model->setup(mini_batch_size, metadata);
+  return my_model;
+}
+
+/** @brief Run the same steps as sgd_training_algorithm::train_mini_batch */
+void train_step(lbann::model& m, size_t mini_batch_size)
+{
+  auto const mode = lbann::execution_mode::training;
+  lbann::sgd_execution_context c(mode, mini_batch_size);
+  m.reset_mode(c, mode);
+  m.clear_gradients();
+  m.forward_prop(mode);
+  auto& obj = *m.get_objective_function();
+  obj.start_evaluation(mode, mini_batch_size);
+  obj.differentiate();
+  m.backward_prop();
+  obj.compute_weight_regularization();
+  obj.finish_evaluation(mode, mini_batch_size);
+  m.update_weights();
+  m.reset_mode(c, lbann::execution_mode::invalid);
+}
+
+LayerType const& get_layer(lbann::model const& m, std::string const& name)
+{
+  for (auto const* l : m.get_layers()) {
+    if (l->get_name() == name) {
+      return dynamic_cast<LayerType const&>(*l);
+    }
+  }
+  LBANN_ERROR("could not find layer \"", name, "\"");
+}
+
+/** @brief Start both models from the same random weights */
+void copy_weights(lbann::model const& source, lbann::model& target)
+{
+  using WeightsType = lbann::data_type_weights<lbann::DataType>;
+  auto const source_weights = source.get_weights();
+  auto target_weights = target.get_weights();
+  REQUIRE(source_weights.size() == target_weights.size());
+  for (size_t i = 0; i < source_weights.size(); ++i) {
+    auto const& s = dynamic_cast<WeightsType const&>(*source_weights[i]);
+    auto& t = dynamic_cast<WeightsType&>(*target_weights[i]);
+    REQUIRE(s.get_name() == t.get_name());
+    t.set_values(s.get_values());
+  }
+}
+
+template <typename MatrixT>
+void check_same_values(MatrixT const& expected, MatrixT const& actual)
+{
+  auto const& e_local = expected.LockedMatrix();
+  auto const& a_local = actual.LockedMatrix();
+  REQUIRE(e_local.Height() == a_local.Height());
+  REQUIRE(e_local.Width() == a_local.Width());
+  for (El::Int col = 0; col < e_local.Width(); ++col) {
+    for (El::Int row = 0; row < e_local.Height(); ++row) {
+      CHECK(a_local(row, col) == Approx(e_local(row, col)));
+    }
+  }
+}
+
+void check_same_weights(lbann::model const& expected,
+                        lbann::model const& actual)
+{
+  using WeightsType = lbann::data_type_weights<lbann::DataType>;
+  auto const expected_weights = expected.get_weights();
+  auto const actual_weights = actual.get_weights();
+  REQUIRE(expected_weights.size() == actual_weights.size());
+  for (size_t i = 0; i < expected_weights.size(); ++i) {
+    auto const& e = dynamic_cast<WeightsType const&>(*expected_weights[i]);
+    auto const& a = dynamic_cast<WeightsType const&>(*actual_weights[i]);
+    REQUIRE(e.get_name() == a.get_name());
+    INFO("weights \"" << e.get_name() << "\"");
+    check_same_values(e.get_values(), a.get_values());
+  }
+}
+
+} // namespace <anon>
+
+TEST_CASE("Zero-copy concatenate matches copies",
+          "[mpi][layer][concatenate]")
+{
+  auto& comm = unit_test::utilities::current_world_comm();
+  size_t const mini_batch_size = 3;
+  auto reference = make_model(comm, concatenate_prototext, false,
+                              mini_batch_size);
+  auto zero_copy = make_model(comm, concatenate_prototext, true,
+                              mini_batch_size);
+  copy_weights(*reference, *zero_copy);
+  train_step(*reference, mini_batch_size);
+  train_step(*zero_copy, mini_batch_size);
+
+  auto const& ref_concat = get_layer(*reference, "concat");
+  auto const& concat = get_layer(*zero_copy, "concat");
+
+  SECTION("Parents that accept strided tensors write in place")
+  {
+    CHECK(get_layer(*zero_copy, "fc_a").get_activations().Viewing());
+    CHECK(get_layer(*zero_copy, "relu_b").get_activations().Viewing());
+    CHECK_FALSE(get_layer(*zero_copy, "softmax_c").get_activations().Viewing());
+    CHECK_FALSE(get_layer(*reference, "fc_a").get_activations().Viewing());
+    CHECK(concat.get_error_signals(0).Viewing());
+    CHECK(concat.get_error_signals(1).Viewing());
+    CHECK_FALSE(concat.get_error_signals(2).Viewing());
+  }
+
+  SECTION("Forward prop")
+  {
+    check_same_values(ref_concat.get_activations(), concat.get_activations());
+    for (auto const& name : {"fc_a", "relu_b", "softmax_c"}) {
+      INFO("layer \"" << name << "\"");
+      check_same_values(get_layer(*reference, name).get_activations(),
+                        get_layer(*zero_copy, name).get_activations());
+    }
+  }
+
+  SECTION("Backward prop")
+  {
+    for (int i = 0; i < concat.get_num_parents(); ++i) {
+      INFO("parent " << i);
+      check_same_values(ref_concat.get_error_signals(i),
+                        concat.get_error_signals(i));
+    }
+    check_same_weights(*reference, *zero_copy);
+  }
+}
+
+TEST_CASE("Zero-copy slice matches copies", "[mpi][layer][slice]")
+{
+  auto& comm = unit_test::utilities::current_world_comm();
+  size_t const mini_batch_size = 3;
+  auto reference = make_model(comm, slice_prototext, false,
+                              mini_batch_size);
+  auto zero_copy = make_model(comm, slice_prototext, true,
+                              mini_batch_size);
+  copy_weights(*reference, *zero_copy);
+  train_step(*reference, mini_batch_size);
+  train_step(*zero_copy, mini_batch_size);
+
+  auto const& ref_slice = get_layer(*reference, "slice");
+  auto const& slice = get_layer(*zero_copy, "slice");
+
+  SECTION("Children that accept strided tensors get views")
+  {
+    CHECK(slice.get_activations(0).Viewing());
+    CHECK(slice.get_activations(1).Viewing());
+    CHECK_FALSE(slice.get_activations(2).Viewing());
+    CHECK_FALSE(ref_slice.get_activations(0).Viewing());
+    CHECK(get_layer(*zero_copy, "fc_a").get_error_signals().Viewing());
+    CHECK(get_layer(*zero_copy, "relu_b").get_error_signals().Viewing());
+    CHECK_FALSE(get_layer(*zero_copy, "softmax_c").get_error_signals().Viewing());
+    CHECK_FALSE(get_layer(*reference, "fc_a").get_error_signals().Viewing());
+  }
+
+  SECTION("Children write gradients into the input gradient")
+  {
+    // Children's gradients w.r.t. inputs view the rows of the input
+    // gradient
+    auto const& input_grad = slice.get_error_signals().LockedMatrix();
+    auto const& fc_a_grad =
+      get_layer(*zero_copy, "fc_a").get_error_signals().LockedMatrix();
+    auto const& relu_b_grad =
+      get_layer(*zero_copy, "relu_b").get_error_signals().LockedMatrix();
+    if (input_grad.Width() == 0) { return; }
+    CHECK(fc_a_grad.LockedBuffer() == input_grad.LockedBuffer(0, 0));
+    CHECK(relu_b_grad.LockedBuffer() == input_grad.LockedBuffer(3, 0));
+    CHECK(fc_a_grad.LDim() == input_grad.LDim());
+    CHECK(relu_b_grad.LDim() == input_grad.LDim());
+  }
+
+  SECTION("Forward prop")
+  {
+    for (int i = 0; i < slice.get_num_children(); ++i) {
+      INFO("child " << i);
+      check_same_values(ref_slice.get_activations(i),
+                        slice.get_activations(i));
+    }
+    for (auto const& name : {"fc_a", "relu_b", "softmax_c"}) {
+      INFO("layer \"" << name << "\"");
+      check_same_values(get_layer(*reference, name).get_activations(),
+                        get_layer(*zero_copy, name).get_activations());
+    }
+  }
+
+  SECTION("Backward prop")
+  {
+    check_same_values(ref_slice.get_error_signals(),
+                      slice.get_error_signals());
+    check_same_weights(*reference, *zero_copy);
+  }
+}
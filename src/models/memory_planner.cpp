@@ -0,0 +1,126 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/models/memory_planner.hpp"
+#include "lbann/utils/exception.hpp"
+
+#include <algorithm>
+#include <map>
+#include <numeric>
+
+namespace lbann {
+
+size_t memory_planner::add_tensor(std::string name,
+                                  size_t bytes,
+                                  size_t first_use,
+                                  size_t last_use) {
+  if (first_use > last_use) {
+    LBANN_ERROR("tensor \"", name, "\" has first use (step ", first_use, ") "
+                "after last use (step ", last_use, ")");
+  }
+  m_tensors.push_back({std::move(name), bytes, first_use, last_use, 0});
+  m_buffer_sizes.clear();
+  return m_tensors.size() - 1;
+}
+
+void memory_planner::clear() {
+  m_tensors.clear();
+  m_buffer_sizes.clear();
+}
+
+void memory_planner::plan() {
+  m_buffer_sizes.clear();
+
+  // Visit tensors from largest to smallest, breaking ties by order of
+  // first use for run-to-run consistency
+  std::vector<size_t> order(m_tensors.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [this](size_t a, size_t b) {
+                     const auto& x = m_tensors[a];
+                     const auto& y = m_tensors[b];
+                     if (x.bytes != y.bytes) { return x.bytes > y.bytes; }
+                     return x.first_use < y.first_use;
+                   });
+
+  // Intervals occupied in each buffer
+  std::vector<std::vector<std::pair<size_t,size_t>>> occupied;
+  const auto& is_free = [&occupied](size_t buffer, const tensor& t) {
+    for (const auto& interval : occupied[buffer]) {
+      if (t.first_use <= interval.second && interval.first <= t.last_use) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  for (const auto& i : order) {
+    auto& t = m_tensors[i];
+    auto best = m_buffer_sizes.size();
+    for (size_t b = 0; b < m_buffer_sizes.size(); ++b) {
+      if ((best == m_buffer_sizes.size()
+           || m_buffer_sizes[b] < m_buffer_sizes[best])
+          && is_free(b, t)) {
+        best = b;
+      }
+    }
+    if (best == m_buffer_sizes.size()) {
+      m_buffer_sizes.push_back(t.bytes);
+      occupied.emplace_back();
+    }
+    t.buffer = best;
+    occupied[best].emplace_back(t.first_use, t.last_use);
+  }
+
+}
+
+size_t memory_planner::get_naive_bytes() const {
+  size_t bytes = 0;
+  for (const auto& t : m_tensors) { bytes += t.bytes; }
+  return bytes;
+}
+
+size_t memory_planner::get_planned_bytes() const {
+  return std::accumulate(m_buffer_sizes.begin(), m_buffer_sizes.end(),
+                         size_t{0});
+}
+
+size_t memory_planner::get_live_peak_bytes() const {
+  // Sweep over interval endpoints
+  std::map<size_t, long long> deltas;
+  for (const auto& t : m_tensors) {
+    deltas[t.first_use] += static_cast<long long>(t.bytes);
+    deltas[t.last_use + 1] -= static_cast<long long>(t.bytes);
+  }
+  long long live = 0, peak = 0;
+  for (const auto& d : deltas) {
+    live += d.second;
+    peak = std::max(peak, live);
+  }
+  return static_cast<size_t>(peak);
+}
+
+} // namespace lbann
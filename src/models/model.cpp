@@ -45,15 +45,19 @@
 #include "lbann/data_store/data_store_conduit.hpp"
 #include "lbann/utils/serialize.hpp"
 #include "lbann/utils/summary_impl.hpp"
+#include "lbann/utils/timer.hpp"
 
 #include <model.pb.h>
 #include <optimizers.pb.h>
 
 #include <mpi.h>
 
+#include <algorithm>
+#include <functional>
 #include <string>
 #include <unistd.h>
 #include <iomanip>
+#include <sstream>
 #include <queue>
 #include <unordered_set>
 
@@ -89,6 +93,19 @@ model::model(const model& other) :
   m_execution_context(other.m_execution_context),
   m_comm(other.m_comm),
   m_name(other.m_name),
+  m_gradient_bucket_size(other.m_gradient_bucket_size),
+  m_gradient_bucket_order(other.m_gradient_bucket_order),
+  m_fuse_elementwise_operators(other.m_fuse_elementwise_operators),
+  m_mixed_precision(other.m_mixed_precision),
+  m_loss_scale(other.m_loss_scale),
+  m_loss_scale_growth_interval(other.m_loss_scale_growth_interval),
+  m_dynamic_loss_scale(other.m_dynamic_loss_scale),
+  m_num_finite_steps(other.m_num_finite_steps),
+  m_num_skipped_steps(other.m_num_skipped_steps),
+  m_gradient_accumulation_steps(other.m_gradient_accumulation_steps),
+  m_recompute_every_n_layers(other.m_recompute_every_n_layers),
+  m_recompute_checkpoint_layers(other.m_recompute_checkpoint_layers),
+  m_plan_layer_memory(other.m_plan_layer_memory),
   m_model_is_setup(false) {
 
   // Deep copies
@@ -147,6 +164,27 @@ model& model::operator=(const model& other) {
   // Shallow copies
   m_comm = other.m_comm;
   m_name = other.m_name;
+  m_gradient_bucket_size = other.m_gradient_bucket_size;
+  m_gradient_bucket_order = other.m_gradient_bucket_order;
+  m_gradient_buckets.reset();
+  m_fuse_elementwise_operators = other.m_fuse_elementwise_operators;
+  m_mixed_precision = other.m_mixed_precision;
+  m_loss_scale = other.m_loss_scale;
+  m_loss_scale_growth_interval = other.m_loss_scale_growth_interval;
+  m_dynamic_loss_scale = other.m_dynamic_loss_scale;
+  m_num_finite_steps = other.m_num_finite_steps;
+  m_num_skipped_steps = other.m_num_skipped_steps;
+  m_gradient_accumulation_steps = other.m_gradient_accumulation_steps;
+  m_num_micro_batches = 0;
+  m_recompute_every_n_layers = other.m_recompute_every_n_layers;
+  m_recompute_checkpoint_layers = other.m_recompute_checkpoint_layers;
+  m_recompute_segments.clear();
+  m_recompute_segment_index.clear();
+  m_plan_layer_memory = other.m_plan_layer_memory;
+  m_training_memory_plan = layer_memory_plan();
+  m_inference_memory_plan = layer_memory_plan();
+  m_layer_memory_pool.clear();
+  m_bound_memory_plan = nullptr;
   m_model_is_setup = false;
 
   // Deep copies
@@ -307,6 +345,42 @@ description model::get_description() const {
   desc.add(std::string{});
   desc.add(weights_desc);
 
+  // Gradient bucketing
+  if (m_gradient_bucket_size > 0) {
+    desc.add(std::string{});
+    desc.add("Gradient bucket size", m_gradient_bucket_size);
+    desc.add("Gradient bucket order", to_string(m_gradient_bucket_order));
+  }
+
+  // Activation recomputation
+  if (m_recompute_every_n_layers > 0
+      || !m_recompute_checkpoint_layers.empty()) {
+    desc.add(std::string{});
+    desc.add("Activation recompute segment length",
+             m_recompute_every_n_layers);
+    std::ostringstream ss;
+    for (const auto& name : m_recompute_checkpoint_layers) {
+      ss << (ss.tellp() > 0 ? ", " : "") << name;
+    }
+    desc.add("Activation recompute checkpoint layers", ss.str());
+  }
+
+  // Mixed-precision training
+  if (m_mixed_precision) {
+    desc.add(std::string{});
+    desc.add("Loss scale", m_loss_scale);
+    desc.add("Dynamic loss scale", m_dynamic_loss_scale);
+    if (m_dynamic_loss_scale) {
+      desc.add("Loss scale growth interval", m_loss_scale_growth_interval);
+    }
+  }
+
+  // Gradient accumulation
+  if (m_gradient_accumulation_steps > 1) {
+    desc.add(std::string{});
+    desc.add("Gradient accumulation steps", m_gradient_accumulation_steps);
+  }
+
   // Callbacks
   description callback_desc("Callbacks:");
   for (const auto& cb : m_callbacks) {
@@ -504,8 +578,104 @@ void model::copy_trained_weights_from(std::vector<weights*>& new_weights) {
   }
 }
 
+void model::set_gradient_bucketing(size_t bucket_size_bytes,
+                                   gradient_bucket_order order) {
+  if (m_model_is_setup) {
+    LBANN_ERROR("attempted to configure gradient bucketing in model "
+                "\"", get_name(), "\" after setup");
+  }
+  m_gradient_bucket_size = bucket_size_bytes;
+  m_gradient_bucket_order = order;
+}
+
+void model::set_elementwise_operator_fusion(bool fuse) {
+  if (m_model_is_setup) {
+    LBANN_ERROR("attempted to configure operator fusion in model "
+                "\"", get_name(), "\" after setup");
+  }
+  m_fuse_elementwise_operators = fuse;
+}
+
+void model::set_layer_memory_planning(bool plan) {
+  if (m_model_is_setup) {
+    LBANN_ERROR("attempted to configure layer memory planning in model "
+                "\"", get_name(), "\" after setup");
+  }
+  m_plan_layer_memory = plan;
+}
+
+const memory_planner& model::get_layer_memory_plan(execution_mode mode) const {
+  return (mode == execution_mode::training
+          ? m_training_memory_plan.planner
+          : m_inference_memory_plan.planner);
+}
+
+void model::set_mixed_precision(EvalType initial_loss_scale,
+                                size_t growth_interval,
+                                bool dynamic) {
+  if (m_model_is_setup) {
+    LBANN_ERROR("attempted to configure mixed-precision training in model "
+                "\"", get_name(), "\" after setup");
+  }
+  if (initial_loss_scale < EvalType(1)) {
+    LBANN_ERROR("invalid initial loss scale (", initial_loss_scale, ")");
+  }
+  if (dynamic && growth_interval == 0) {
+    LBANN_ERROR("invalid loss scale growth interval (", growth_interval, ")");
+  }
+  m_mixed_precision = true;
+  m_loss_scale = initial_loss_scale;
+  m_loss_scale_growth_interval = growth_interval;
+  m_dynamic_loss_scale = dynamic;
+  m_num_finite_steps = 0;
+  m_num_skipped_steps = 0;
+}
+
+void model::set_gradient_accumulation_steps(size_t steps) {
+  if (m_model_is_setup) {
+    LBANN_ERROR("attempted to configure gradient accumulation in model "
+                "\"", get_name(), "\" after setup");
+  }
+  if (steps == 0) {
+    LBANN_ERROR("invalid number of gradient accumulation steps (0)");
+  }
+  m_gradient_accumulation_steps = steps;
+}
+
+void model::set_defer_gradient_allreduces(bool defer) {
+  for (auto&& w : m_weights) {
+    auto&& opt = w->get_optimizer();
+    if (opt != nullptr) { opt->set_defer_gradient_allreduce(defer); }
+  }
+}
+
+void model::set_activation_recompute(size_t every_n_layers,
+                                     std::set<std::string> checkpoint_layers) {
+  if (m_model_is_setup) {
+    LBANN_ERROR("attempted to configure activation recomputation in model "
+                "\"", get_name(), "\" after setup");
+  }
+  m_recompute_every_n_layers = every_n_layers;
+  m_recompute_checkpoint_layers = std::move(checkpoint_layers);
+}
+
 void model::swap_layers(model& other) {
   std::swap(m_layers, other.m_layers);
+
+  // Memory plans and their buffers follow the layers they refer to
+  const auto& bound_plan = [](model& to, const model& from) {
+    const auto* plan = from.m_bound_memory_plan;
+    return (plan == &from.m_training_memory_plan ? &to.m_training_memory_plan
+            : plan == &from.m_inference_memory_plan ? &to.m_inference_memory_plan
+            : nullptr);
+  };
+  const auto* this_bound_plan = bound_plan(other, *this);
+  const auto* other_bound_plan = bound_plan(*this, other);
+  std::swap(m_training_memory_plan, other.m_training_memory_plan);
+  std::swap(m_inference_memory_plan, other.m_inference_memory_plan);
+  std::swap(m_layer_memory_pool, other.m_layer_memory_pool);
+  m_bound_memory_plan = other_bound_plan;
+  other.m_bound_memory_plan = this_bound_plan;
 }
 
 void model::swap_weights(model& other) {
@@ -631,6 +801,7 @@ void model::setup(size_t max_mini_batch_size, DataReaderMetaData& dr_metadata, b
   // Setup layers
 
   setup_layer_topology();
+  fuse_elementwise_operator_layers();
   setup_layer_execution_order();
   if(this->is_subgraph_parallelism_enabled())
   {
@@ -638,10 +809,12 @@ void model::setup(size_t max_mini_batch_size, DataReaderMetaData& dr_metadata, b
   }
 
   setup_layers(max_mini_batch_size, dr_metadata);
-
+  setup_activation_recompute();
+  setup_layer_memory_plan();
 
   // Setup weights
   setup_weights();
+  setup_gradient_bucketing();
 
   // Setup objective function
   m_objective_function->setup(*this);
@@ -1550,6 +1723,12 @@ void model::setup_layer_execution_order() {
 
 void model::setup_layers(size_t max_mini_batch_size, DataReaderMetaData& dr_metadata) {
 
+  // Layers allocate their own tensors until memory is planned
+  bind_layer_memory_plan(nullptr);
+  m_training_memory_plan = layer_memory_plan();
+  m_inference_memory_plan = layer_memory_plan();
+  m_layer_memory_pool.clear();
+
   for (El::Int i = 0; i < get_num_layers(); ++i) {
     auto& l = get_layer(i);
     l.set_model(this);
@@ -1564,6 +1743,7 @@ void model::setup_layers(size_t max_mini_batch_size, DataReaderMetaData& dr_meta
     }
     l.check_setup();
   }
+
 }
 
 void model::setup_weights() {
@@ -1578,9 +1758,447 @@ void model::setup_weights() {
               return x->get_name().compare(y->get_name()) < 0;
             });
 
+  // Replace 16-bit weights with master weights
+  std::vector<std::pair<OwningWeightsPtr,OwningWeightsPtr>> master_weights;
+  if (m_mixed_precision) {
+    master_weights = setup_master_weights();
+  }
+
   // Setup weights
   for (auto&& w : m_weights) { w->setup(); }
 
+  // Initialize master weights from 16-bit weights
+  for (auto& w_pair : master_weights) {
+    auto& w = *w_pair.first;
+    auto& master = dynamic_cast<data_type_weights<DataType>&>(*w_pair.second);
+    w.setup();
+    El::Copy(w.get_values(), master.get_values());
+  }
+
+}
+
+auto model::setup_master_weights()
+  -> std::vector<std::pair<OwningWeightsPtr,OwningWeightsPtr>> {
+  std::vector<std::pair<OwningWeightsPtr,OwningWeightsPtr>> replaced;
+  std::unordered_map<weights*,ViewingWeightsPtr> weights_map;
+  for (auto& w : m_weights) {
+    // Note: Frozen weights do not have an optimizer and are kept.
+    if (dynamic_cast<data_type_weights<DataType>*>(w.get()) != nullptr
+        || w->get_optimizer() == nullptr) {
+      continue;
+    }
+
+    // Construct master weights with a copy of the 16-bit weights'
+    // optimizer, rebuilt from its hyperparameters
+    // Note: Values are copied from the 16-bit weights once they are
+    // initialized. The 16-bit weights are not optimized.
+    const auto& opt = *w->get_optimizer();
+    lbann_data::Optimizer opt_msg;
+    opt.write_proto(&opt_msg);
+    auto master_opt = proto::construct_optimizer<DataType>(opt_msg);
+    master_opt->set_gradient_compression(opt.get_gradient_compression());
+    auto master = std::make_shared<data_type_weights<DataType>>(*m_comm);
+    master->set_name(w->get_name());
+    master->set_dims(w->get_matrix_height_dims(),
+                     w->get_matrix_width_dims());
+    master->set_matrix_distribution(w->get_matrix_distribution());
+    master->set_optimizer(std::move(master_opt));
+    w->set_optimizer(nullptr);
+
+    weights_map[w.get()] = master;
+    replaced.emplace_back(w, master);
+    w = std::move(master);
+  }
+
+  // Point layers and objective function to master weights
+  if (!weights_map.empty()) {
+    remap_pointers({}, weights_map);
+  }
+
+  return replaced;
+}
+
+void model::setup_gradient_bucketing() {
+
+  // Detach optimizers from any existing bucket manager
+  for (auto&& w : m_weights) {
+    auto* opt = w->get_optimizer();
+    if (opt != nullptr) { opt->set_gradient_bucket_manager(nullptr); }
+  }
+  m_gradient_buckets.reset();
+  if (m_gradient_bucket_size == 0) { return; }
+
+  // Attach optimizers to bucket manager
+  // Note: Weights are packed in reverse order since back prop
+  // computes gradients in roughly that order.
+  m_gradient_buckets = make_unique<gradient_bucket_manager>(
+    *m_comm,
+    m_gradient_bucket_size,
+    m_gradient_bucket_order);
+  std::vector<const void*> owners;
+  for (auto rit = m_weights.rbegin(); rit != m_weights.rend(); ++rit) {
+    auto* opt = (*rit)->get_optimizer();
+    if (opt != nullptr) {
+      opt->set_gradient_bucket_manager(m_gradient_buckets.get());
+      owners.push_back(opt);
+    }
+  }
+  m_gradient_buckets->set_owner_order(std::move(owners));
+
+}
+
+void model::fuse_elementwise_operator_layers() {
+  if (!m_fuse_elementwise_operators
+      || this->is_subgraph_parallelism_enabled()) {
+    return;
+  }
+
+  // Count references to each layer from other layers, metrics, and
+  // the objective function
+  std::unordered_map<const Layer*, size_t> num_refs;
+  for (const auto& l : m_layers) {
+    for (const auto& ptr : l->get_layer_pointers()) {
+      num_refs[ptr.lock().get()]++;
+    }
+  }
+  for (const auto& m : m_metrics) {
+    for (const auto& ptr : m->get_layer_pointers()) {
+      num_refs[ptr.lock().get()]++;
+    }
+  }
+  if (m_objective_function != nullptr) {
+    for (const auto& ptr : m_objective_function->get_layer_pointers()) {
+      num_refs[ptr.lock().get()]++;
+    }
+  }
+
+  const size_t num_layers_before = m_layers.size();
+  for (size_t i = 0; i < m_layers.size(); ++i) {
+    const auto parent_ptr = m_layers[i];
+    auto& parent = *parent_ptr;
+    while (parent.get_num_children() == 1) {
+
+      // Child must only be referenced by this layer and its own
+      // children, i.e. its output is only visible through them
+      auto child_ptr = parent.get_child_layer_pointer(0).lock();
+      auto& child = *child_ptr;
+      if (child.get_num_parents() != 1
+          || child.has_weights()
+          || num_refs[&child] != 1 + child.get_num_children()) {
+        break;
+      }
+      if (!parent.absorb_elementwise_child(child)) { break; }
+
+      // Connect the child's children to this layer
+      parent.clear_child_layers();
+      for (int j = 0; j < child.get_num_children(); ++j) {
+        auto grandchild_ptr = child.get_child_layer_pointer(j);
+        auto& grandchild = *grandchild_ptr.lock();
+        parent.add_child_layer(grandchild_ptr);
+        grandchild.replace_parent_layer(
+          parent_ptr,
+          grandchild.find_parent_layer_index(child));
+      }
+      num_refs[&parent] += child.get_num_children();
+      num_refs[&parent] -= 1;
+
+      // Remove the child
+      auto it = std::find(m_layers.begin(), m_layers.end(), child_ptr);
+      m_layers.erase(it);
+      i = std::distance(m_layers.begin(),
+                        std::find(m_layers.begin(), m_layers.end(),
+                                  parent_ptr));
+    }
+  }
+
+  if (m_comm->am_world_master() && m_layers.size() != num_layers_before) {
+    std::cout << "Model \"" << get_name() << "\": fused "
+              << num_layers_before - m_layers.size() << " entry-wise "
+              << "operator layers into their parents" << std::endl;
+  }
+
+}
+
+void model::setup_activation_recompute() {
+  m_recompute_segments.clear();
+  m_recompute_segment_index.clear();
+  if (m_recompute_every_n_layers == 0
+      && m_recompute_checkpoint_layers.empty()) {
+    return;
+  }
+  if (this->is_subgraph_parallelism_enabled()) {
+    LBANN_WARNING("activation recomputation is not supported with "
+                  "sub-graph parallelism, so it is disabled in model "
+                  "\"", get_name(), "\"");
+    return;
+  }
+
+  // Check that checkpoint layers are in the model
+  const El::Int num_layers = get_num_layers();
+  std::unordered_map<const Layer*, El::Int> positions;
+  std::unordered_set<std::string> names;
+  for (El::Int i = 0; i < num_layers; ++i) {
+    positions[&get_layer(i)] = i;
+    names.insert(get_layer(i).get_name());
+  }
+  for (const auto& name : m_recompute_checkpoint_layers) {
+    if (names.count(name) == 0) {
+      LBANN_ERROR("model \"", get_name(), "\" has no layer \"", name, "\" ",
+                  "to use as an activation recompute checkpoint");
+    }
+  }
+
+  // Split layers into segments that end at checkpoint layers
+  m_recompute_segment_index.assign(num_layers, -1);
+  El::Int first = 0;
+  for (El::Int i = 0; i < num_layers; ++i) {
+    const auto& l = get_layer(i);
+    const bool is_checkpoint
+      = (i == num_layers - 1
+         || !l.supports_activation_recompute()
+         || m_recompute_checkpoint_layers.count(l.get_name()) > 0
+         || (m_recompute_every_n_layers > 0
+             && (i + 1) % m_recompute_every_n_layers == 0));
+    if (!is_checkpoint) { continue; }
+    recompute_segment segment;
+    segment.last = i;
+
+    // Discard outputs that are only consumed within the segment
+    std::unordered_set<El::Int> discarded;
+    for (El::Int j = first; j < i; ++j) {
+      const auto& children = get_layer(j).get_child_layers();
+      if (children.empty()) { continue; }
+      const bool internal = std::all_of(
+        children.begin(), children.end(),
+        [&](const Layer* child) { return positions.at(child) <= i; });
+      if (internal) { discarded.insert(j); }
+    }
+
+    // Keep outputs that kept layers view, e.g. the input of an
+    // identity layer. Kept layers may in turn be views, so repeat
+    // until nothing changes.
+    bool changed = true;
+    while (changed) {
+      changed = false;
+      for (El::Int j = first; j <= i; ++j) {
+        const auto& l = get_layer(j);
+        if (discarded.count(j) > 0 || !l.has_viewing_outputs()) { continue; }
+        for (const auto* parent : l.get_parent_layers()) {
+          if (discarded.erase(positions.at(parent)) > 0) { changed = true; }
+        }
+      }
+    }
+    for (El::Int j = first; j < i; ++j) {
+      if (discarded.count(j) > 0) { segment.discarded.push_back(j); }
+    }
+
+    // Kept layers must refresh their views of recomputed outputs
+    for (El::Int j = first; j <= i; ++j) {
+      if (discarded.count(j) > 0) { continue; }
+      for (const auto* parent : get_layer(j).get_parent_layers()) {
+        if (discarded.count(positions.at(parent)) > 0) {
+          segment.reattached.push_back(j);
+          break;
+        }
+      }
+    }
+
+    if (!segment.discarded.empty()) {
+      m_recompute_segment_index[i] = m_recompute_segments.size();
+      m_recompute_segments.push_back(std::move(segment));
+    }
+    first = i + 1;
+  }
+
+}
+
+void model::setup_layer_memory_plan() {
+  if (!m_plan_layer_memory) { return; }
+  if (this->is_subgraph_parallelism_enabled()) {
+    LBANN_WARNING("layer memory planning is not supported with "
+                  "sub-graph parallelism, so it is disabled in model "
+                  "\"", get_name(), "\"");
+    return;
+  }
+  if (m_recompute_every_n_layers > 0
+      || !m_recompute_checkpoint_layers.empty()) {
+    LBANN_WARNING("layer memory planning is not supported with "
+                  "activation recomputation, so it is disabled in model "
+                  "\"", get_name(), "\"");
+    return;
+  }
+
+  // Plans share buffers, so each buffer fits its largest use
+  m_training_memory_plan = plan_layer_memory(true);
+  m_inference_memory_plan = plan_layer_memory(false);
+  std::vector<size_t> pool_sizes;
+  for (const auto* plan : {&m_training_memory_plan, &m_inference_memory_plan}) {
+    const auto& sizes = plan->planner.get_buffer_sizes();
+    pool_sizes.resize(std::max(pool_sizes.size(), sizes.size()), 0);
+    for (size_t i = 0; i < sizes.size(); ++i) {
+      pool_sizes[i] = std::max(pool_sizes[i], sizes[i]);
+    }
+  }
+  m_layer_memory_pool.resize(pool_sizes.size());
+  for (size_t i = 0; i < pool_sizes.size(); ++i) {
+    m_layer_memory_pool[i].resize(pool_sizes[i]);
+  }
+
+  // Report savings
+  if (m_comm->am_world_master()) {
+    const auto& to_mib = [](size_t bytes) {
+      return static_cast<double>(bytes) / (1024. * 1024.);
+    };
+    const auto& report = [&to_mib](const memory_planner& planner) {
+      std::ostringstream ss;
+      ss << std::fixed << std::setprecision(1)
+         << "naive " << to_mib(planner.get_naive_bytes()) << " MiB, "
+         << "planned " << to_mib(planner.get_planned_bytes()) << " MiB "
+         << "in " << planner.get_buffer_sizes().size() << " buffers, "
+         << "live peak " << to_mib(planner.get_live_peak_bytes()) << " MiB";
+      return ss.str();
+    };
+    std::cout << "Model \"" << get_name() << "\" planned layer memory "
+              << "per rank:\n"
+              << "  training:  " << report(m_training_memory_plan.planner)
+              << "\n"
+              << "  inference: " << report(m_inference_memory_plan.planner)
+              << std::endl;
+  }
+
+}
+
+model::layer_memory_plan model::plan_layer_memory(bool training) const {
+  layer_memory_plan plan;
+  const size_t num_layers = m_layers.size();
+  std::unordered_map<const Layer*, size_t> positions;
+  for (size_t i = 0; i < num_layers; ++i) {
+    positions[m_layers[i].get()] = i;
+  }
+  const size_t end_step = 2 * num_layers;
+  const auto& fp_step = [](size_t pos) { return pos; };
+  const auto& bp_step = [num_layers](size_t pos) {
+    return 2 * num_layers - 1 - pos;
+  };
+
+  // Layers whose tensors may be read after forward prop
+  std::unordered_set<const Layer*> pinned;
+  for (const auto& m : m_metrics) {
+    for (const auto& ptr : m->get_layer_pointers()) {
+      pinned.insert(ptr.lock().get());
+    }
+  }
+  if (m_objective_function != nullptr) {
+    for (const auto& ptr : m_objective_function->get_layer_pointers()) {
+      pinned.insert(ptr.lock().get());
+    }
+  }
+
+  // Last step that reads an output, including through views of it
+  std::function<size_t(const Layer&, const Layer&)> last_output_read
+    = [&](const Layer& parent, const Layer& child) {
+    if (pinned.count(&parent) > 0 || pinned.count(&child) > 0) {
+      return end_step;
+    }
+    const auto parent_pos = positions.at(&parent);
+    const auto child_pos = positions.at(&child);
+    auto last = fp_step(child_pos);
+    if (training && child.bp_reads_inputs()) {
+      last = std::max(last, bp_step(child_pos));
+    }
+    if (training && parent.bp_reads_outputs()) {
+      last = std::max(last, bp_step(parent_pos));
+    }
+    if (child.has_viewing_outputs()) {
+      for (const auto* grandchild : child.get_child_layers()) {
+        last = std::max(last, last_output_read(child, *grandchild));
+      }
+    }
+    return last;
+  };
+
+  // Last step that reads an error signal. Parents that keep their
+  // error signals may pass views of them on to their own parents.
+  std::function<size_t(const Layer&)> last_error_signal_read
+    = [&](const Layer& parent) {
+    auto last = bp_step(positions.at(&parent));
+    if (parent.get_keep_error_signals()) {
+      for (const auto* grandparent : parent.get_parent_layers()) {
+        last = std::max(last, last_error_signal_read(*grandparent));
+      }
+    }
+    return last;
+  };
+
+  for (size_t i = 0; i < num_layers; ++i) {
+    auto& l = *m_layers[i];
+
+    // Outputs, written by this layer's forward prop
+    for (int j = 0; j < l.get_num_children(); ++j) {
+      const auto bytes = l.get_planned_output_bytes(j);
+      if (bytes == 0) { continue; }
+      plan.planner.add_tensor(l.get_name() + " output " + std::to_string(j),
+                              bytes,
+                              fp_step(i),
+                              last_output_read(l, l.get_child_layer(j)));
+      plan.owners.push_back({m_layers[i], false, j});
+    }
+
+    // Gradients w.r.t. inputs, written by this layer's backward prop
+    if (!training) { continue; }
+    for (int j = 0; j < l.get_num_parents(); ++j) {
+      const auto bytes = l.get_planned_error_signal_bytes(j);
+      if (bytes == 0) { continue; }
+      plan.planner.add_tensor(l.get_name() + " error signal " + std::to_string(j),
+                              bytes,
+                              bp_step(i),
+                              last_error_signal_read(l.get_parent_layer(j)));
+      plan.owners.push_back({m_layers[i], true, j});
+    }
+
+  }
+
+  plan.planner.plan();
+  return plan;
+}
+
+void model::bind_layer_memory_plan(const layer_memory_plan* plan) {
+  if (plan == m_bound_memory_plan) { return; }
+  if (m_bound_memory_plan != nullptr) {
+    for (const auto& owner : m_bound_memory_plan->owners) {
+      auto l = owner.layer.lock();
+      if (l == nullptr) { continue; }
+      if (owner.error_signal) {
+        l->set_planned_error_signal_buffer(owner.index, nullptr, 0);
+      }
+      else {
+        l->set_planned_output_buffer(owner.index, nullptr, 0);
+      }
+    }
+  }
+  if (plan != nullptr) {
+    const auto& tensors = plan->planner.get_tensors();
+    for (size_t i = 0; i < tensors.size(); ++i) {
+      const auto& owner = plan->owners[i];
+      auto l = owner.layer.lock();
+      if (l == nullptr) {
+        LBANN_ERROR("layer memory plan of model \"", get_name(), "\" "
+                    "refers to a layer that no longer exists");
+      }
+      auto& buffer = m_layer_memory_pool[tensors[i].buffer];
+      if (owner.error_signal) {
+        l->set_planned_error_signal_buffer(owner.index,
+                                           buffer.data(),
+                                           buffer.size());
+      }
+      else {
+        l->set_planned_output_buffer(owner.index,
+                                     buffer.data(),
+                                     buffer.size());
+      }
+    }
+  }
+  m_bound_memory_plan = plan;
 }
 
 void model::add_evaluation_layers(std::unordered_set<Layer*>& layer_set,
@@ -2016,11 +2634,24 @@ void model::clear_gradients() {
     auto&& opt = w->get_optimizer();
     if (opt != nullptr) { opt->clear_gradient(); }
   }
+  if (m_gradient_buckets != nullptr) { m_gradient_buckets->reset(); }
+  m_num_micro_batches = 0;
 }
 
 void model::forward_prop(execution_mode mode) {
   do_model_forward_prop_begin_cbs(mode);
 
+  // Use the buffers planned for this execution mode
+  if (!m_layer_memory_pool.empty()) {
+    bind_layer_memory_plan(mode == execution_mode::training
+                           ? &m_training_memory_plan
+                           : &m_inference_memory_plan);
+  }
+
+  for (auto& segment : m_recompute_segments) {
+    segment.pending = false;
+  }
+
   for (El::Int i = 0; i < get_num_layers(); ++i) {
     auto& l = get_layer(i);
 
@@ -2046,6 +2677,18 @@ void model::forward_prop(execution_mode mode) {
       l.forward_prop();
       do_layer_forward_prop_end_cbs(mode, &l);
 
+      // Release activations that will be recomputed in backprop
+      if (mode == execution_mode::training
+          && !m_recompute_segments.empty()
+          && m_recompute_segment_index[i] >= 0) {
+        auto& segment = m_recompute_segments[m_recompute_segment_index[i]];
+        segment.bytes_released = 0;
+        for (const auto& j : segment.discarded) {
+          segment.bytes_released += get_layer(j).discard_activations();
+        }
+        segment.pending = true;
+      }
+
     }
   }
   do_model_forward_prop_end_cbs(mode);
@@ -2054,8 +2697,20 @@ void model::forward_prop(execution_mode mode) {
 
 void model::backward_prop() {
 
+  // The inference memory plan does not keep what backprop reads
+  if (m_bound_memory_plan == &m_inference_memory_plan) {
+    LBANN_ERROR("model \"", get_name(), "\" cannot perform backward prop "
+                "after a forward prop outside of training, since its "
+                "layer memory is planned for inference");
+  }
+
   do_model_backward_prop_begin_cbs();
 
+  // Scale loss to keep 16-bit gradients in range
+  if (m_mixed_precision) {
+    m_objective_function->set_loss_scale(m_loss_scale);
+  }
+
   for (El::Int i = get_num_layers()-1; i >= 0; --i) {
 
     // Perform backward prop step on current layer
@@ -2079,6 +2734,23 @@ void model::backward_prop() {
     }
     else
     {
+      // Recompute activations before entering a segment
+      if (!m_recompute_segments.empty()
+          && m_recompute_segment_index[i] >= 0) {
+        auto& segment = m_recompute_segments[m_recompute_segment_index[i]];
+        if (segment.pending) {
+          const auto recompute_start = get_time();
+          for (const auto& j : segment.discarded) {
+            get_layer(j).recompute_forward_prop();
+          }
+          for (const auto& j : segment.reattached) {
+            get_layer(j).reattach_inputs();
+          }
+          segment.recompute_time += get_time() - recompute_start;
+          segment.pending = false;
+        }
+      }
+
       do_layer_backward_prop_begin_cbs(&l);
       l.back_prop();
       do_layer_backward_prop_end_cbs(&l);
@@ -2104,6 +2776,10 @@ void model::backward_prop() {
 
   }
 
+  // Launch allreduces for partially-filled gradient buckets
+  if (m_gradient_buckets != nullptr) { m_gradient_buckets->flush(); }
+  ++m_num_micro_batches;
+
   do_model_backward_prop_end_cbs();
 
 
@@ -2112,6 +2788,47 @@ void model::backward_prop() {
 void model::update_weights() {
   do_model_optimize_begin_cbs();
 
+  // Gradients are summed over micro-batches and multiplied by the
+  // loss scale, so optimizers divide both out. The scale is set on
+  // every step since the number of micro-batches can change, e.g. when
+  // the end of an epoch cuts a step short.
+  const EvalType gradient_scale
+    = ((m_mixed_precision ? m_loss_scale : EvalType(1))
+       * std::max(m_num_micro_batches, size_t{1}));
+  for (auto&& w : m_weights) {
+    auto&& opt = w->get_optimizer();
+    if (opt != nullptr) { opt->set_loss_scale(gradient_scale); }
+  }
+
+  // Skip optimization step if loss-scaled gradients overflowed
+  // Note: Every optimizer is checked so that all gradient allreduces
+  // are finished.
+  if (m_mixed_precision) {
+    bool finite = true;
+    for (auto&& w : m_weights) {
+      auto&& opt = w->get_optimizer();
+      if (opt != nullptr) {
+        finite = opt->gradient_is_finite() && finite;
+      }
+    }
+    finite = m_comm->trainer_allreduce(static_cast<int>(finite),
+                                       El::mpi::MIN);
+    if (!finite) {
+      ++m_num_skipped_steps;
+      m_num_finite_steps = 0;
+      if (m_dynamic_loss_scale) {
+        m_loss_scale = std::max(m_loss_scale / 2, EvalType(1));
+      }
+      do_model_optimize_end_cbs();
+      return;
+    }
+    if (m_dynamic_loss_scale
+        && ++m_num_finite_steps >= m_loss_scale_growth_interval) {
+      m_loss_scale *= 2;
+      m_num_finite_steps = 0;
+    }
+  }
+
   // Apply optimization step to weights
   // Note: Heuristically, forward prop consumes weights in the same
   // order as m_weights and backprop computes weights gradients in
@@ -2348,6 +3065,48 @@ void model::summarize_stats(lbann_summary& summarizer) {
     "metric_evaluation_time",
     total_metric_time,
     c.get_step());
+  if (m_gradient_buckets != nullptr) {
+    summarizer.reduce_scalar(
+      "gradient_bucket_allreduces",
+      m_gradient_buckets->get_num_allreduces(),
+      c.get_step());
+    summarizer.reduce_scalar(
+      "gradient_bucket_gradients",
+      m_gradient_buckets->get_num_gradients(),
+      c.get_step());
+    summarizer.reduce_scalar(
+      "gradient_bucket_bytes",
+      m_gradient_buckets->get_num_bytes(),
+      c.get_step());
+  }
+  if (!m_recompute_segments.empty()) {
+    EvalType total_recompute_time = 0;
+    size_t total_bytes_released = 0;
+    for (auto& segment : m_recompute_segments) {
+      const auto& name = get_layer(segment.last).get_name();
+      summarizer.reduce_scalar(name + "/recompute_time",
+                               segment.recompute_time,
+                               c.get_step());
+      summarizer.reduce_scalar(name + "/recompute_bytes",
+                               segment.bytes_released,
+                               c.get_step());
+      total_recompute_time += segment.recompute_time;
+      total_bytes_released += segment.bytes_released;
+      segment.recompute_time = 0;
+    }
+    summarizer.reduce_scalar("activation_recompute_time",
+                             total_recompute_time,
+                             c.get_step());
+    summarizer.reduce_scalar("activation_recompute_bytes",
+                             total_bytes_released,
+                             c.get_step());
+  }
+  if (m_mixed_precision) {
+    summarizer.reduce_scalar("loss_scale", m_loss_scale, c.get_step());
+    summarizer.reduce_scalar("skipped_steps",
+                             m_num_skipped_steps,
+                             c.get_step());
+  }
 }
 
 void model::summarize_matrices(lbann_summary& summarizer) {
@@ -2381,19 +3140,28 @@ bool model::save_to_checkpoint_shared(persist& p) {
   //                   the trainer master...
   m_comm->trainer_barrier();
 
-  // Open the stream for writing
+  // Open the stream for writing. When staging, the archive is kept
+  // in host memory and written out later by the caller.
+  const auto filename = file::join_path(p.get_checkpoint_dir(), "model.bin");
   std::ofstream ofs;
-  if (m_comm->am_trainer_master())
+  std::ostringstream oss;
+  if (m_comm->am_trainer_master() && !p.is_staging())
   {
-    ofs.open(file::join_path(p.get_checkpoint_dir(), "model.bin"));
+    ofs.open(filename);
     LBANN_ASSERT(ofs.good());
   }
 
   // Write the checkpoint
   {
-    lbann::RootedBinaryOutputArchive ar(ofs, m_comm->get_trainer_grid());
+    std::ostream& os = (p.is_staging()
+                        ? static_cast<std::ostream&>(oss)
+                        : static_cast<std::ostream&>(ofs));
+    lbann::RootedBinaryOutputArchive ar(os, m_comm->get_trainer_grid());
     ar(*this);
   }
+  if (m_comm->am_trainer_master() && p.is_staging()) {
+    p.stage_file(persist_type::model, filename, oss.str());
+  }
 
   p.open_checkpoint_dir(trainer_dir, false);
   return true;
@@ -2434,18 +3202,39 @@ bool model::save_to_checkpoint_distributed(persist& p){
 
 #ifdef LBANN_HAS_CEREAL_BINARY_ARCHIVES
   {
-    std::ofstream ofs(file::join_path(p.get_checkpoint_dir(), "model.bin"));
-    cereal::BinaryOutputArchive ar(ofs);
-    ar(*this);
+    const auto filename = file::join_path(p.get_checkpoint_dir(), "model.bin");
+    if (p.is_staging()) {
+      std::ostringstream oss;
+      {
+        cereal::BinaryOutputArchive ar(oss);
+        ar(*this);
+      }
+      p.stage_file(persist_type::model, filename, oss.str());
+    }
+    else {
+      std::ofstream ofs(filename);
+      cereal::BinaryOutputArchive ar(ofs);
+      ar(*this);
+    }
   }
 #endif // LBANN_HAS_CEREAL_BINARY_ARCHIVES
 
 #ifdef LBANN_HAS_CEREAL_XML_ARCHIVES
   {
-    std::ofstream  ofs_xml(
-      file::join_path(p.get_checkpoint_dir(), "model.xml"));
-    cereal::XMLOutputArchive ar(ofs_xml);
-    ar(*this);
+    const auto filename = file::join_path(p.get_checkpoint_dir(), "model.xml");
+    if (p.is_staging()) {
+      std::ostringstream oss;
+      {
+        cereal::XMLOutputArchive ar(oss);
+        ar(*this);
+      }
+      p.stage_file(persist_type::model, filename, oss.str());
+    }
+    else {
+      std::ofstream ofs_xml(filename);
+      cereal::XMLOutputArchive ar(ofs_xml);
+      ar(*this);
+    }
   }
 #endif // LBANN_HAS_CEREAL_XML_ARCHIVES
 
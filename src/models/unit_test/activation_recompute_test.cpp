@@ -0,0 +1,243 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <catch2/catch.hpp>
+
+#include "TestHelpers.hpp"
+#include "MPITestHelpers.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/execution_contexts/sgd_execution_context.hpp>
+#include <lbann/models/model.hpp>
+#include <lbann/objective_functions/objective_function.hpp>
+#include <lbann/proto/factories.hpp>
+#include <lbann/utils/lbann_library.hpp>
+#include <lbann/weights/data_type_weights.hpp>
+
+#include <lbann.pb.h>
+#include <google/protobuf/text_format.h>
+
+namespace pb = ::google::protobuf;
+
+namespace {
+
+// Identity and reshape outputs are views of their inputs. With
+// "id" as a checkpoint, its parent "relu1" must keep its outputs.
+std::string const model_prototext = R"ptext(
+model {
+  objective_function {
+    layer_term {
+      scale_factor: 1.0
+      layer: "l2"
+    }
+  }
+  layer {
+    name: "x"
+    constant {
+      value: 0.5
+      num_neurons: "3"
+    }
+  }
+  layer {
+    name: "fc1"
+    parents: "x"
+    weights: "fc1_w fc1_b"
+    fully_connected {
+      num_neurons: 3
+      has_bias: true
+    }
+  }
+  layer {
+    name: "relu1"
+    parents: "fc1"
+    relu {
+    }
+  }
+  layer {
+    name: "id"
+    parents: "relu1"
+    identity {
+    }
+  }
+  layer {
+    name: "fc2"
+    parents: "id"
+    weights: "fc2_w"
+    fully_connected {
+      num_neurons: 3
+      has_bias: false
+    }
+  }
+  layer {
+    name: "r"
+    parents: "fc2"
+    reshape {
+      dims: "3"
+    }
+  }
+  layer {
+    name: "l2"
+    parents: "r"
+    l2_norm2 {
+    }
+  }
+  weights {
+    name: "fc1_w"
+    initializer {
+      value_initializer {
+        values: "0.3 -0.2 0.5 0.1 0.4 -0.6 -0.3 0.2 0.7"
+      }
+    }
+  }
+  weights {
+    name: "fc1_b"
+    initializer {
+      value_initializer {
+        values: "0.1 -0.5 0.2"
+      }
+    }
+  }
+  weights {
+    name: "fc2_w"
+    initializer {
+      value_initializer {
+        values: "0.6 -0.1 0.3 -0.4 0.2 0.5 0.1 -0.7 0.4"
+      }
+    }
+  }
+}
+optimizer {
+  sgd {
+    learn_rate: 0.1
+  }
+}
+)ptext";
+
+auto make_model(lbann::lbann_comm& comm,
+                size_t every_n_layers,
+                std::set<std::string> checkpoint_layers,
+                size_t mini_batch_size)
+{
+  lbann_data::LbannPB my_proto;
+  if (!pb::TextFormat::ParseFromString(model_prototext, &my_proto))
+    throw "Parsing protobuf failed.";
+  lbann::construct_trainer(&comm, my_proto.mutable_trainer(), my_proto);
+  auto my_model = lbann::proto::construct_model(&comm,
+                                                -1,
+                                                my_proto.optimizer(),
+                                                my_proto.trainer(),
+                                                my_proto.model());
+  my_model->set_activation_recompute(every_n_layers,
+                                     std::move(checkpoint_layers));
+  lbann::DataReaderMetaData metadata;
+  my_model->setup(mini_batch_size, metadata);
+  return my_model;
+}
+
+/** @brief Run the same steps as sgd_training_algorithm::train_mini_batch */
+void train_step(lbann::model& m, size_t mini_batch_size)
+{
+  auto const mode = lbann::execution_mode::training;
+  lbann::sgd_execution_context c(mode, mini_batch_size);
+  m.reset_mode(c, mode);
+  m.clear_gradients();
+  m.forward_prop(mode);
+  auto& obj = *m.get_objective_function();
+  obj.start_evaluation(mode, mini_batch_size);
+  obj.differentiate();
+  m.backward_prop();
+  obj.compute_weight_regularization();
+  obj.finish_evaluation(mode, mini_batch_size);
+  m.update_weights();
+  m.reset_mode(c, lbann::execution_mode::invalid);
+}
+
+void check_same_weights(lbann::model const& expected,
+                        lbann::model const& actual)
+{
+  using WeightsType = lbann::data_type_weights<lbann::DataType>;
+  auto const expected_weights = expected.get_weights();
+  auto const actual_weights = actual.get_weights();
+  REQUIRE(expected_weights.size() == actual_weights.size());
+  for (size_t i = 0; i < expected_weights.size(); ++i) {
+    auto const& e = dynamic_cast<WeightsType const&>(*expected_weights[i]);
+    auto const& a = dynamic_cast<WeightsType const&>(*actual_weights[i]);
+    REQUIRE(e.get_name() == a.get_name());
+    auto const& e_local = e.get_values().LockedMatrix();
+    auto const& a_local = a.get_values().LockedMatrix();
+    REQUIRE(e_local.Height() == a_local.Height());
+    REQUIRE(e_local.Width() == a_local.Width());
+    for (El::Int col = 0; col < e_local.Width(); ++col) {
+      for (El::Int row = 0; row < e_local.Height(); ++row) {
+        INFO("weights \"" << e.get_name() << "\" entry ("
+             << row << "," << col << ")");
+        CHECK(a_local(row, col) == Approx(e_local(row, col)));
+      }
+    }
+  }
+}
+
+} // namespace <anon>
+
+TEST_CASE("Activation recomputation matches regular training",
+          "[mpi][model][recompute]")
+{
+  auto& comm = unit_test::utilities::current_world_comm();
+  size_t const mini_batch_size = 4;
+  size_t const num_steps = 3;
+
+  auto reference = make_model(comm, 0, {}, mini_batch_size);
+  for (size_t step = 0; step < num_steps; ++step) {
+    train_step(*reference, mini_batch_size);
+  }
+
+  SECTION("Checkpoint at a view of a recomputable layer")
+  {
+    auto recompute = make_model(comm, 0, {"id"}, mini_batch_size);
+    for (size_t step = 0; step < num_steps; ++step) {
+      train_step(*recompute, mini_batch_size);
+    }
+    check_same_weights(*reference, *recompute);
+  }
+
+  SECTION("Periodic checkpoints")
+  {
+    auto recompute = make_model(comm, 2, {}, mini_batch_size);
+    for (size_t step = 0; step < num_steps; ++step) {
+      train_step(*recompute, mini_batch_size);
+    }
+    check_same_weights(*reference, *recompute);
+  }
+
+  SECTION("Single segment")
+  {
+    auto recompute = make_model(comm, 0, {"l2"}, mini_batch_size);
+    for (size_t step = 0; step < num_steps; ++step) {
+      train_step(*recompute, mini_batch_size);
+    }
+    check_same_weights(*reference, *recompute);
+  }
+}
@@ -0,0 +1,158 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <catch2/catch.hpp>
+
+#include "TestHelpers.hpp"
+#include "MPITestHelpers.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/models/directed_acyclic_graph.hpp>
+#include <lbann/models/model.hpp>
+#include <lbann/optimizers/sgd.hpp>
+#include <lbann/utils/memory.hpp>
+#include <lbann/weights/data_type_weights.hpp>
+#include <lbann/weights/initializer.hpp>
+
+#include <limits>
+#include <memory>
+
+namespace {
+
+using WeightsType = lbann::data_type_weights<float>;
+
+/** @brief Model with one weights tensor, initialized to one and
+ *         updated with SGD without momentum.
+ */
+auto make_model(lbann::lbann_comm& comm)
+{
+  auto m = lbann::make_unique<lbann::directed_acyclic_graph_model>(
+    &comm, nullptr, nullptr);
+  auto w = std::make_shared<WeightsType>(comm);
+  w->set_name("w");
+  w->set_dims({4}, {3});
+  w->set_initializer(
+    lbann::make_unique<lbann::constant_initializer<float>>(1.f));
+  w->set_optimizer(lbann::make_unique<lbann::sgd<float>>(1.f, 0.f, false));
+  w->setup();
+  m->add_weights(std::move(w));
+  return m;
+}
+
+/** @brief Run an optimization step with a loss-scaled gradient.
+ *
+ *  The unscaled gradient is @c gradient in every entry.
+ */
+void step(lbann::model& m, float gradient)
+{
+  auto& w = dynamic_cast<WeightsType&>(*m.get_weights().front());
+  auto& opt = *w.get_optimizer();
+  std::unique_ptr<El::AbstractDistMatrix<float>> contrib(
+    El::AbstractDistMatrix<float>::Instantiate(w.get_values().DistData()));
+  contrib->Resize(w.get_matrix_height(), w.get_matrix_width());
+  El::Fill(*contrib, gradient * static_cast<float>(m.get_loss_scale()));
+  m.clear_gradients();
+  opt.add_to_gradient(*contrib);
+  m.update_weights();
+}
+
+void check_values(const lbann::model& m, float expected)
+{
+  const auto& w = dynamic_cast<const WeightsType&>(*m.get_weights().front());
+  const auto& local_values = w.get_values().LockedMatrix();
+  for (El::Int col = 0; col < local_values.Width(); ++col) {
+    for (El::Int row = 0; row < local_values.Height(); ++row) {
+      CHECK(local_values(row, col) == Approx(expected));
+    }
+  }
+}
+
+} // namespace
+
+TEST_CASE("Loss scaling in optimization steps",
+          "[mpi][model][mixed_precision]")
+{
+  auto& comm = unit_test::utilities::current_world_comm();
+  constexpr float inf = std::numeric_limits<float>::infinity();
+  auto m = make_model(comm);
+
+  SECTION("Overflow skips the step and halves the loss scale")
+  {
+    m->set_mixed_precision(8.f, 2, true);
+    step(*m, inf);
+    check_values(*m, 1.f);
+    CHECK(m->get_loss_scale() == 4.f);
+    CHECK(m->get_num_skipped_steps() == 1);
+  }
+
+  SECTION("Loss scale grows after steps without overflow")
+  {
+    m->set_mixed_precision(8.f, 2, true);
+    step(*m, 0.25f);
+    check_values(*m, 0.75f);
+    CHECK(m->get_loss_scale() == 8.f);
+    step(*m, 0.25f);
+    check_values(*m, 0.5f);
+    CHECK(m->get_loss_scale() == 16.f);
+    CHECK(m->get_num_skipped_steps() == 0);
+  }
+
+  SECTION("Overflow restarts the growth interval")
+  {
+    m->set_mixed_precision(8.f, 2, true);
+    step(*m, 0.25f);
+    step(*m, inf);
+    CHECK(m->get_loss_scale() == 4.f);
+    step(*m, 0.25f);
+    CHECK(m->get_loss_scale() == 4.f);
+    step(*m, 0.25f);
+    CHECK(m->get_loss_scale() == 8.f);
+    check_values(*m, 0.25f);
+    CHECK(m->get_num_skipped_steps() == 1);
+  }
+
+  SECTION("Loss scale is not halved below one")
+  {
+    m->set_mixed_precision(1.f, 2, true);
+    step(*m, inf);
+    CHECK(m->get_loss_scale() == 1.f);
+    step(*m, 0.25f);
+    check_values(*m, 0.75f);
+  }
+
+  SECTION("Static loss scale")
+  {
+    m->set_mixed_precision(8.f, 1, false);
+    step(*m, inf);
+    check_values(*m, 1.f);
+    CHECK(m->get_loss_scale() == 8.f);
+    step(*m, 0.25f);
+    step(*m, 0.25f);
+    check_values(*m, 0.5f);
+    CHECK(m->get_loss_scale() == 8.f);
+    CHECK(m->get_num_skipped_steps() == 1);
+  }
+}
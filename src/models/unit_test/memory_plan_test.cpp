@@ -0,0 +1,317 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <catch2/catch.hpp>
+
+#include "TestHelpers.hpp"
+#include "MPITestHelpers.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/execution_contexts/sgd_execution_context.hpp>
+#include <lbann/layers/data_type_layer.hpp>
+#include <lbann/models/model.hpp>
+#include <lbann/objective_functions/objective_function.hpp>
+#include <lbann/proto/factories.hpp>
+#include <lbann/utils/lbann_library.hpp>
+#include <lbann/weights/data_type_weights.hpp>
+
+#include <lbann.pb.h>
+#include <google/protobuf/text_format.h>
+
+namespace pb = ::google::protobuf;
+
+namespace {
+
+using LayerType = lbann::data_type_layer<lbann::DataType>;
+
+// ReLU and fully-connected backprop only read their inputs and
+// softmax backprop only reads its outputs, so the outputs of "fc3"
+// die at the forward prop of "sm" and error signals can reuse the
+// buffers of activations. The outputs of "id" are views of the
+// outputs of "relu1", which must live until the backprop of "fc2".
+std::string const model_prototext = R"ptext(
+model {
+  plan_layer_memory: PLAN
+  objective_function {
+    layer_term {
+      scale_factor: 1.0
+      layer: "l2"
+    }
+  }
+  layer {
+    name: "x"
+    weights: "x_w"
+    weights_layer {
+      dims: "4"
+    }
+  }
+  layer {
+    name: "fc1"
+    parents: "x"
+    weights: "fc1_w"
+    fully_connected {
+      num_neurons: 3
+      has_bias: false
+    }
+  }
+  layer {
+    name: "relu1"
+    parents: "fc1"
+    relu {
+    }
+  }
+  layer {
+    name: "id"
+    parents: "relu1"
+    identity {
+    }
+  }
+  layer {
+    name: "fc2"
+    parents: "id"
+    weights: "fc2_w"
+    fully_connected {
+      num_neurons: 3
+      has_bias: false
+    }
+  }
+  layer {
+    name: "relu2"
+    parents: "fc2"
+    relu {
+    }
+  }
+  layer {
+    name: "fc3"
+    parents: "relu2"
+    weights: "fc3_w"
+    fully_connected {
+      num_neurons: 3
+      has_bias: false
+    }
+  }
+  layer {
+    name: "sm"
+    parents: "fc3"
+    softmax {
+    }
+  }
+  layer {
+    name: "l2"
+    parents: "sm"
+    l2_norm2 {
+    }
+  }
+  weights {
+    name: "x_w"
+    initializer {
+      value_initializer {
+        values: "0.5 -0.3 0.8 0.1"
+      }
+    }
+  }
+  weights {
+    name: "fc1_w"
+    initializer {
+      value_initializer {
+        values: "0.3 -0.2 0.5 0.1 0.4 -0.6 -0.3 0.2 0.7 0.1 -0.4 0.6"
+      }
+    }
+  }
+  weights {
+    name: "fc2_w"
+    initializer {
+      value_initializer {
+        values: "0.6 -0.1 0.3 -0.4 0.2 0.5 0.1 -0.7 0.4"
+      }
+    }
+  }
+  weights {
+    name: "fc3_w"
+    initializer {
+      value_initializer {
+        values: "-0.2 0.4 0.1 0.3 -0.5 0.2 0.6 0.1 -0.3"
+      }
+    }
+  }
+}
+optimizer {
+  sgd {
+    learn_rate: 0.1
+  }
+}
+)ptext";
+
+auto make_model(lbann::lbann_comm& comm, bool plan, size_t mini_batch_size)
+{
+  auto prototext = model_prototext;
+  auto const pos = prototext.find("PLAN");
+  prototext.replace(pos, 4, plan ? "true" : "false");
+  lbann_data::LbannPB my_proto;
+  if (!pb::TextFormat::ParseFromString(prototext, &my_proto))
+    throw "Parsing protobuf failed.";
+  lbann::construct_trainer(&comm, my_proto.mutable_trainer(), my_proto);
+  auto my_model = lbann::proto::construct_model(&comm,
+                                                -1,
+                                                my_proto.optimizer(),
+                                                my_proto.trainer(),
+                                                my_proto.model());
+  lbann::DataReaderMetaData metadata;
+  my_model->setup(mini_batch_size, metadata);
+  return my_model;
+}
+
+/** @brief Run the same steps as sgd_training_algorithm::train_mini_batch */
+void train_step(lbann::model& m, size_t mini_batch_size)
+{
+  auto const mode = lbann::execution_mode::training;
+  lbann::sgd_execution_context c(mode, mini_batch_size);
+  m.reset_mode(c, mode);
+  m.clear_gradients();
+  m.forward_prop(mode);
+  auto& obj = *m.get_objective_function();
+  obj.start_evaluation(mode, mini_batch_size);
+  obj.differentiate();
+  m.backward_prop();
+  obj.compute_weight_regularization();
+  obj.finish_evaluation(mode, mini_batch_size);
+  m.update_weights();
+  m.reset_mode(c, lbann::execution_mode::invalid);
+}
+
+/** @brief Run the same steps as sgd_training_algorithm::evaluate_mini_batch */
+void test_step(lbann::model& m, size_t mini_batch_size)
+{
+  auto const mode = lbann::execution_mode::testing;
+  lbann::sgd_execution_context c(mode, mini_batch_size);
+  m.reset_mode(c, mode);
+  m.forward_prop(mode);
+  auto& obj = *m.get_objective_function();
+  obj.start_evaluation(mode, mini_batch_size);
+  obj.finish_evaluation(mode, mini_batch_size);
+  m.reset_mode(c, lbann::execution_mode::invalid);
+}
+
+LayerType const& get_layer(lbann::model const& m, std::string const& name)
+{
+  for (auto const* l : m.get_layers()) {
+    if (l->get_name() == name) {
+      return dynamic_cast<LayerType const&>(*l);
+    }
+  }
+  LBANN_ERROR("could not find layer \"", name, "\"");
+}
+
+template <typename MatrixT>
+void check_same_values(MatrixT const& expected, MatrixT const& actual)
+{
+  auto const& e_local = expected.LockedMatrix();
+  auto const& a_local = actual.LockedMatrix();
+  REQUIRE(e_local.Height() == a_local.Height());
+  REQUIRE(e_local.Width() == a_local.Width());
+  for (El::Int col = 0; col < e_local.Width(); ++col) {
+    for (El::Int row = 0; row < e_local.Height(); ++row) {
+      CHECK(a_local(row, col) == Approx(e_local(row, col)));
+    }
+  }
+}
+
+void check_same_weights(lbann::model const& expected,
+                        lbann::model const& actual)
+{
+  using WeightsType = lbann::data_type_weights<lbann::DataType>;
+  auto const expected_weights = expected.get_weights();
+  auto const actual_weights = actual.get_weights();
+  REQUIRE(expected_weights.size() == actual_weights.size());
+  for (size_t i = 0; i < expected_weights.size(); ++i) {
+    auto const& e = dynamic_cast<WeightsType const&>(*expected_weights[i]);
+    auto const& a = dynamic_cast<WeightsType const&>(*actual_weights[i]);
+    REQUIRE(e.get_name() == a.get_name());
+    INFO("weights \"" << e.get_name() << "\"");
+    check_same_values(e.get_values(), a.get_values());
+  }
+}
+
+} // namespace <anon>
+
+TEST_CASE("Layer memory planning", "[mpi][model][memory_planner]")
+{
+  auto& comm = unit_test::utilities::current_world_comm();
+  size_t const mini_batch_size = 4;
+  size_t const num_steps = 3;
+  auto reference = make_model(comm, false, mini_batch_size);
+  auto planned = make_model(comm, true, mini_batch_size);
+
+  SECTION("Plans reuse buffers")
+  {
+    auto const& training
+      = planned->get_layer_memory_plan(lbann::execution_mode::training);
+    auto const& inference
+      = planned->get_layer_memory_plan(lbann::execution_mode::testing);
+    CHECK(training.get_tensors().size() > 0);
+    CHECK(training.get_planned_bytes() < training.get_naive_bytes());
+    CHECK(inference.get_planned_bytes() < inference.get_naive_bytes());
+    CHECK(inference.get_planned_bytes() <= training.get_planned_bytes());
+    CHECK(reference->get_layer_memory_plan(lbann::execution_mode::training)
+          .get_tensors().empty());
+  }
+
+  SECTION("Planned model matches the unplanned model")
+  {
+    for (size_t step = 0; step < num_steps; ++step) {
+      train_step(*reference, mini_batch_size);
+      train_step(*planned, mini_batch_size);
+    }
+    check_same_weights(*reference, *planned);
+
+    // Activations are stored in planned buffers
+    CHECK(get_layer(*planned, "fc1").get_activations().Viewing());
+    CHECK_FALSE(get_layer(*reference, "fc1").get_activations().Viewing());
+
+    // Evaluation switches to the inference plan and back
+    test_step(*reference, mini_batch_size);
+    test_step(*planned, mini_batch_size);
+    check_same_values(get_layer(*reference, "sm").get_activations(),
+                      get_layer(*planned, "sm").get_activations());
+    CHECK(reference->get_objective_function()->get_mean_value(
+            lbann::execution_mode::testing)
+          == Approx(planned->get_objective_function()->get_mean_value(
+                      lbann::execution_mode::testing)));
+    train_step(*reference, mini_batch_size);
+    train_step(*planned, mini_batch_size);
+    check_same_weights(*reference, *planned);
+  }
+
+  SECTION("Backprop is not allowed with the inference plan")
+  {
+    auto const mode = lbann::execution_mode::testing;
+    lbann::sgd_execution_context c(mode, mini_batch_size);
+    planned->reset_mode(c, mode);
+    planned->forward_prop(mode);
+    CHECK_THROWS(planned->backward_prop());
+    planned->reset_mode(c, lbann::execution_mode::invalid);
+  }
+}
@@ -0,0 +1,75 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+// MUST include this
+#include <catch2/catch.hpp>
+
+// File being tested
+#include <lbann/models/memory_planner.hpp>
+#include <lbann/utils/exception.hpp>
+
+TEST_CASE("Memory planner", "[memory_planner]")
+{
+  lbann::memory_planner planner;
+
+  SECTION("Disjoint lifetimes share a buffer")
+  {
+    // Chain of four layers in inference mode: each activation dies
+    // once the next layer has run
+    planner.add_tensor("a", 100, 0, 1);
+    planner.add_tensor("b", 300, 1, 2);
+    planner.add_tensor("c", 200, 2, 3);
+    planner.add_tensor("d", 50, 3, 3);
+    planner.plan();
+    const auto& tensors = planner.get_tensors();
+    CHECK(planner.get_naive_bytes() == 650);
+    CHECK(planner.get_live_peak_bytes() == 500);
+    CHECK(planner.get_planned_bytes() == 500);
+    CHECK(planner.get_buffer_sizes().size() == 2);
+    CHECK(tensors[0].buffer == tensors[2].buffer);
+    CHECK(tensors[1].buffer == tensors[3].buffer);
+    CHECK(tensors[0].buffer != tensors[1].buffer);
+  }
+
+  SECTION("Overlapping lifetimes get separate buffers")
+  {
+    planner.add_tensor("a", 10, 0, 5);
+    planner.add_tensor("b", 20, 2, 3);
+    planner.add_tensor("c", 30, 5, 6);
+    planner.plan();
+    CHECK(planner.get_planned_bytes() == 40);
+    CHECK(planner.get_live_peak_bytes() == 40);
+    CHECK(planner.get_buffer_sizes().size() == 2);
+    for (const auto& t : planner.get_tensors()) {
+      CHECK(planner.get_buffer_sizes()[t.buffer] >= t.bytes);
+    }
+  }
+
+  SECTION("Invalid lifetime")
+  {
+    CHECK_THROWS_AS(planner.add_tensor("a", 10, 3, 2), lbann::exception);
+  }
+}
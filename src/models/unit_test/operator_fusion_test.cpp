@@ -0,0 +1,340 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <catch2/catch.hpp>
+
+#include "TestHelpers.hpp"
+#include "MPITestHelpers.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/execution_contexts/sgd_execution_context.hpp>
+#include <lbann/layers/data_type_layer.hpp>
+#include <lbann/models/model.hpp>
+#include <lbann/objective_functions/objective_function.hpp>
+#include <lbann/proto/factories.hpp>
+#include <lbann/utils/lbann_library.hpp>
+#include <lbann/weights/data_type_weights.hpp>
+
+#include <lbann.pb.h>
+#include <google/protobuf/text_format.h>
+
+namespace pb = ::google::protobuf;
+
+namespace {
+
+using LayerType = lbann::data_type_layer<lbann::DataType>;
+
+// "scale", "add" and "sin" form a chain that fuses into "scale".
+// "sin" has two children, so a split layer is inserted after it and
+// the chain stops there. On the "cos" branch, "tanh" fuses into
+// "cos".
+std::string const model_prototext = R"ptext(
+model {
+  fuse_elementwise_operators: FUSE
+  objective_function {
+    layer_term {
+      scale_factor: 1.0
+      layer: "l2_a"
+    }
+    layer_term {
+      scale_factor: 1.0
+      layer: "l2_b"
+    }
+  }
+  layer {
+    name: "x"
+    weights: "x_w"
+    weights_layer {
+      dims: "4"
+    }
+  }
+  layer {
+    name: "fc"
+    parents: "x"
+    weights: "fc_w"
+    fully_connected {
+      num_neurons: 4
+      has_bias: false
+    }
+  }
+  layer {
+    name: "scale"
+    parents: "fc"
+    operator_layer {
+      ops {
+        parameters {
+          [type.googleapis.com/lbann_data.ScaleOperator] {
+            constant: 2.0
+          }
+        }
+      }
+    }
+  }
+  layer {
+    name: "add"
+    parents: "scale"
+    operator_layer {
+      ops {
+        parameters {
+          [type.googleapis.com/lbann_data.AddConstantOperator] {
+            constant: -0.5
+          }
+        }
+      }
+    }
+  }
+  layer {
+    name: "sin"
+    parents: "add"
+    operator_layer {
+      ops {
+        parameters {
+          [type.googleapis.com/lbann_data.SinOperator] {}
+        }
+      }
+    }
+  }
+  layer {
+    name: "l2_a"
+    parents: "sin"
+    l2_norm2 {
+    }
+  }
+  layer {
+    name: "cos"
+    parents: "sin"
+    operator_layer {
+      ops {
+        parameters {
+          [type.googleapis.com/lbann_data.CosOperator] {}
+        }
+      }
+    }
+  }
+  layer {
+    name: "tanh"
+    parents: "cos"
+    operator_layer {
+      ops {
+        parameters {
+          [type.googleapis.com/lbann_data.TanhOperator] {}
+        }
+      }
+    }
+  }
+  layer {
+    name: "l2_b"
+    parents: "tanh"
+    l2_norm2 {
+    }
+  }
+  weights {
+    name: "x_w"
+    initializer {
+      value_initializer {
+        values: "0.5 -0.3 0.8 0.1"
+      }
+    }
+  }
+  weights {
+    name: "fc_w"
+    initializer {
+      value_initializer {
+        values: "0.3 -0.2 0.5 0.1 0.4 -0.6 -0.3 0.2 0.7 0.1 -0.4 0.6 -0.5 0.3 0.2 -0.1"
+      }
+    }
+  }
+}
+optimizer {
+  sgd {
+    learn_rate: 0.1
+  }
+}
+)ptext";
+
+auto make_model(lbann::lbann_comm& comm, bool fuse, size_t mini_batch_size)
+{
+  auto prototext = model_prototext;
+  auto const pos = prototext.find("FUSE");
+  prototext.replace(pos, 4, fuse ? "true" : "false");
+  lbann_data::LbannPB my_proto;
+  if (!pb::TextFormat::ParseFromString(prototext, &my_proto))
+    throw "Parsing protobuf failed.";
+  lbann::construct_trainer(&comm, my_proto.mutable_trainer(), my_proto);
+  auto my_model = lbann::proto::construct_model(&comm,
+                                                -1,
+                                                my_proto.optimizer(),
+                                                my_proto.trainer(),
+                                                my_proto.model());
+  lbann::DataReaderMetaData metadata;
+  my_model->setup(mini_batch_size, metadata);
+  return my_model;
+}
+
+/** @brief Run the same steps as sgd_training_algorithm::train_mini_batch */
+void train_step(lbann::model& m, size_t mini_batch_size)
+{
+  auto const mode = lbann::execution_mode::training;
+  lbann::sgd_execution_context c(mode, mini_batch_size);
+  m.reset_mode(c, mode);
+  m.clear_gradients();
+  m.forward_prop(mode);
+  auto& obj = *m.get_objective_function();
+  obj.start_evaluation(mode, mini_batch_size);
+  obj.differentiate();
+  m.backward_prop();
+  obj.compute_weight_regularization();
+  obj.finish_evaluation(mode, mini_batch_size);
+  m.update_weights();
+  m.reset_mode(c, lbann::execution_mode::invalid);
+}
+
+lbann::Layer const* find_layer(lbann::model const& m, std::string const& name)
+{
+  for (auto const* l : m.get_layers()) {
+    if (l->get_name() == name) {
+      return l;
+    }
+  }
+  return nullptr;
+}
+
+LayerType const& get_layer(lbann::model const& m, std::string const& name)
+{
+  auto const* l = find_layer(m, name);
+  if (l == nullptr) {
+    LBANN_ERROR("could not find layer \"", name, "\"");
+  }
+  return dynamic_cast<LayerType const&>(*l);
+}
+
+template <typename MatrixT>
+void check_same_values(MatrixT const& expected, MatrixT const& actual)
+{
+  auto const& e_local = expected.LockedMatrix();
+  auto const& a_local = actual.LockedMatrix();
+  REQUIRE(e_local.Height() == a_local.Height());
+  REQUIRE(e_local.Width() == a_local.Width());
+  for (El::Int col = 0; col < e_local.Width(); ++col) {
+    for (El::Int row = 0; row < e_local.Height(); ++row) {
+      CHECK(a_local(row, col) == Approx(e_local(row, col)));
+    }
+  }
+}
+
+void check_same_weights(lbann::model const& expected,
+                        lbann::model const& actual)
+{
+  using WeightsType = lbann::data_type_weights<lbann::DataType>;
+  auto const expected_weights = expected.get_weights();
+  auto const actual_weights = actual.get_weights();
+  REQUIRE(expected_weights.size() == actual_weights.size());
+  for (size_t i = 0; i < expected_weights.size(); ++i) {
+    auto const& e = dynamic_cast<WeightsType const&>(*expected_weights[i]);
+    auto const& a = dynamic_cast<WeightsType const&>(*actual_weights[i]);
+    REQUIRE(e.get_name() == a.get_name());
+    INFO("weights \"" << e.get_name() << "\"");
+    check_same_values(e.get_values(), a.get_values());
+  }
+}
+
+} // namespace <anon>
+
+TEST_CASE("Entry-wise operator fusion rewrites the layer graph",
+          "[mpi][model][fusion]")
+{
+  auto& comm = unit_test::utilities::current_world_comm();
+  size_t const mini_batch_size = 3;
+  auto reference = make_model(comm, false, mini_batch_size);
+  auto fused = make_model(comm, true, mini_batch_size);
+
+  SECTION("Fused layers are removed")
+  {
+    CHECK(fused->get_num_layers() == reference->get_num_layers() - 3);
+    for (auto const& name : {"add", "sin", "tanh"}) {
+      INFO("layer \"" << name << "\"");
+      CHECK(find_layer(*reference, name) != nullptr);
+      CHECK(find_layer(*fused, name) == nullptr);
+    }
+  }
+
+  SECTION("Parent and child links skip fused layers")
+  {
+    auto const& fc = get_layer(*fused, "fc");
+    auto const& scale = get_layer(*fused, "scale");
+    auto const& cos = get_layer(*fused, "cos");
+    auto const& l2_a = get_layer(*fused, "l2_a");
+    auto const& l2_b = get_layer(*fused, "l2_b");
+
+    REQUIRE(fc.get_num_children() == 1);
+    CHECK(&fc.get_child_layer(0) == &scale);
+    REQUIRE(scale.get_num_parents() == 1);
+    CHECK(&scale.get_parent_layer(0) == &fc);
+
+    // The branch after "sin" is not fused
+    REQUIRE(scale.get_num_children() == 1);
+    auto const& split = scale.get_child_layer(0);
+    CHECK(split.get_type() == "split");
+    REQUIRE(split.get_num_parents() == 1);
+    CHECK(&split.get_parent_layer(0) == &scale);
+    REQUIRE(split.get_num_children() == 2);
+    CHECK(&split.get_child_layer(0) == &l2_a);
+    CHECK(&split.get_child_layer(1) == &cos);
+    REQUIRE(l2_a.get_num_parents() == 1);
+    CHECK(&l2_a.get_parent_layer(0) == &split);
+    REQUIRE(cos.get_num_parents() == 1);
+    CHECK(&cos.get_parent_layer(0) == &split);
+
+    REQUIRE(cos.get_num_children() == 1);
+    CHECK(&cos.get_child_layer(0) == &l2_b);
+    REQUIRE(l2_b.get_num_parents() == 1);
+    CHECK(&l2_b.get_parent_layer(0) == &cos);
+  }
+
+  SECTION("Fused model matches the unfused model")
+  {
+    train_step(*reference, mini_batch_size);
+    train_step(*fused, mini_batch_size);
+    {
+      INFO("chain ending at \"sin\"");
+      check_same_values(get_layer(*reference, "sin").get_activations(),
+                        get_layer(*fused, "scale").get_activations());
+    }
+    {
+      INFO("chain ending at \"tanh\"");
+      check_same_values(get_layer(*reference, "tanh").get_activations(),
+                        get_layer(*fused, "cos").get_activations());
+    }
+    for (auto const& name : {"l2_a", "l2_b"}) {
+      INFO("layer \"" << name << "\"");
+      check_same_values(get_layer(*reference, name).get_activations(),
+                        get_layer(*fused, name).get_activations());
+    }
+    check_same_values(get_layer(*reference, "fc").get_error_signals(),
+                      get_layer(*fused, "fc").get_error_signals());
+    check_same_weights(*reference, *fused);
+  }
+}
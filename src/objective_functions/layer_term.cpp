@@ -92,10 +92,15 @@ EvalType layer_term::finish_evaluation() {
 
 void layer_term::differentiate() {
   auto& eval = dynamic_cast<abstract_evaluation_layer<DataType>&>(get_evaluation_layer());
-  eval.set_scale(m_scale_factor);
+  eval.set_scale(m_scale_factor * m_loss_scale);
   // get_evaluation_layer().set_scale(m_scale_factor);
 }
 
+void layer_term::set_loss_scale(EvalType loss_scale) {
+  objective_function_term::set_loss_scale(loss_scale);
+  differentiate();
+}
+
 }  // namespace lbann
 
 #define LBANN_CLASS_NAME layer_term
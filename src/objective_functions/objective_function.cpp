@@ -121,6 +121,12 @@ void objective_function::differentiate() {
   m_differentiation_time += get_time() - start_time;
 }
 
+void objective_function::set_loss_scale(EvalType loss_scale) {
+  for (auto&& term : m_terms) {
+    term->set_loss_scale(loss_scale);
+  }
+}
+
 void objective_function::compute_weight_regularization() {
   const auto start_time = get_time();
   prof_region_begin("obj-weight-regularization", prof_colors[0], false);
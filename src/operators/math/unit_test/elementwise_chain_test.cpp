@@ -0,0 +1,113 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+// Testing framework stuff
+#include <catch2/catch.hpp>
+
+#include "MPITestHelpers.hpp"
+#include "MatrixHelpers.hpp"
+#include "TestHelpers.hpp"
+
+#include "OperatorTraits.hpp"
+
+// CUT
+#include "lbann/operators/elementwise_operator.hpp"
+
+// Other stuff
+#include "lbann/operators/math/binary_with_constant.hpp"
+#include "lbann/operators/math/clamp.hpp"
+#include "lbann/operators/math/unary.hpp"
+
+#include <vector>
+
+using namespace lbann;
+
+TEMPLATE_TEST_CASE("Fused entry-wise operator chain",
+                   "[mpi][operator][math][fusion]",
+                   float,
+                   double)
+{
+  using T = TestType;
+  constexpr auto D = El::Device::CPU;
+  using OpType = ElementwiseOperator<T, T, D>;
+  using MatType = DataParallelMatrixType<T, D>;
+
+  auto& world_comm = unit_test::utilities::current_world_comm();
+  auto const& g = world_comm.get_trainer_grid();
+
+  // scale -> add constant -> clamp -> sin
+  ScaleOperator<T, D> scale(2.);
+  AddConstantOperator<T, D> add(-0.5);
+  ClampOperator<T, D> clamp(-0.75, 0.75);
+  SinOperator<T, D> sin_op;
+  std::vector<OpType const*> const ops = {&scale, &add, &clamp, &sin_op};
+
+  // Local matrices span a single tile, several column tiles, and
+  // several row tiles
+  auto const tile_size = OpType::chain_tile_size;
+  std::vector<std::pair<El::Int, El::Int>> const shapes = {
+    {13, 17},
+    {300, 3 * tile_size / 300 * world_comm.get_procs_per_trainer()},
+    {2 * tile_size + 7, 3 * world_comm.get_procs_per_trainer()}};
+
+  for (auto const& shape : shapes) {
+    El::Int const height = shape.first;
+    El::Int const width = shape.second;
+    MatType input(height, width, g, 0), grad_wrt_output(height, width, g, 0);
+    El::MakeUniform(input);
+    El::MakeUniform(grad_wrt_output);
+
+    // Reference: apply operators one at a time
+    std::vector<MatType> values(ops.size(), MatType(height, width, g, 0));
+    for (size_t i = 0; i < ops.size(); ++i) {
+      if (i == 0)
+        ops[i]->fp_compute({input}, {values[i]});
+      else
+        ops[i]->fp_compute({values[i - 1]}, {values[i]});
+    }
+    std::vector<MatType> grads(ops.size(), MatType(height, width, g, 0));
+    for (size_t i = ops.size(); i-- > 0;) {
+      auto const& grad_out = (i + 1 == ops.size() ? grad_wrt_output
+                                                  : grads[i + 1]);
+      auto const& value_in = (i == 0 ? input : values[i - 1]);
+      ops[i]->bp_compute({value_in}, {grad_out}, {grads[i]});
+    }
+
+    // Fused forward prop
+    MatType output(height, width, g, 0);
+    El::Fill(output, El::To<T>(-10.));
+    REQUIRE_NOTHROW(OpType::fp_compute_chain(ops, {input}, output));
+    CHECK(output == values.back());
+
+    // Fused backward prop
+    MatType grad_wrt_input(height, width, g, 0);
+    El::Fill(grad_wrt_input, El::To<T>(-10.));
+    REQUIRE_NOTHROW(OpType::bp_compute_chain(ops,
+                                             {input},
+                                             grad_wrt_output,
+                                             {grad_wrt_input}));
+    CHECK(grad_wrt_input == grads.front());
+  }
+}
@@ -55,6 +55,14 @@ description adagrad<TensorDataType>::get_description() const {
   return desc;
 }
 
+template <typename TensorDataType>
+void adagrad<TensorDataType>::write_proto(lbann_data::Optimizer* proto) const {
+  proto->Clear();
+  auto* opt = proto->mutable_adagrad();
+  opt->set_learn_rate(this->get_learning_rate());
+  opt->set_eps(El::To<double>(m_eps));
+}
+
 template <typename TensorDataType>
 void adagrad<TensorDataType>::setup(WeightsType* w) {
   OptimizerType::setup(w);
@@ -108,6 +116,42 @@ void adagrad<TensorDataType>::step_compute_cpu(AbsDistMatrixType& values,
 
 }
 
+template <typename TensorDataType>
+void adagrad<TensorDataType>::step_compute_sparse(AbsDistMatrixType& values,
+                                                  const SparseGradientType& gradient) {
+  if (values.GetLocalDevice() != El::Device::CPU) {
+    OptimizerType::step_compute_sparse(values, gradient);
+    return;
+  }
+
+  // Get local matrix data
+  const El::Int local_height = values.LocalHeight();
+  const El::Int height = gradient.height();
+  const El::Int num_indices = gradient.num_indices();
+  const auto* __restrict__ indices = gradient.indices().data();
+  const auto* __restrict__ gradient_buffer = gradient.values().data();
+  auto* __restrict__ values_buffer = values.Buffer();
+  const El::Int values_ldim = values.LDim();
+  auto* __restrict__ cache_buffer = m_cache->Buffer();
+  const El::Int cache_ldim = m_cache->LDim();
+
+  // Apply AdaGrad step to nonzero columns
+  const auto learning_rate = El::To<TensorDataType>(this->get_learning_rate());
+  LBANN_OMP_PARALLEL_FOR
+  for (El::Int k = 0; k < num_indices; ++k) {
+    if (!values.IsLocalCol(indices[k])) { continue; }
+    const El::Int col = values.LocalCol(indices[k]);
+    for (El::Int row = 0; row < local_height; ++row) {
+      auto& x = values_buffer[row+col*values_ldim];
+      const auto& g = gradient_buffer[values.GlobalRow(row)+k*height];
+      auto& c = cache_buffer[row+col*cache_ldim];
+      c += g * g;
+      x -= learning_rate * g / (El::Sqrt(c) + m_eps);
+    }
+  }
+
+}
+
 template <typename TensorDataType>
 std::unique_ptr<optimizer>
 build_adagrad_optimizer_from_pbuf(
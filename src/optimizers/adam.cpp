@@ -76,6 +76,16 @@ description adam<TensorDataType>::get_description() const {
   return desc;
 }
 
+template <typename TensorDataType>
+void adam<TensorDataType>::write_proto(lbann_data::Optimizer* proto) const {
+  proto->Clear();
+  auto* opt = proto->mutable_adam();
+  opt->set_learn_rate(this->get_learning_rate());
+  opt->set_beta1(El::To<double>(m_beta1));
+  opt->set_beta2(El::To<double>(m_beta2));
+  opt->set_eps(El::To<double>(m_eps));
+}
+
 template <typename TensorDataType>
 auto adam<TensorDataType>::get_moment1() const -> const AbsDistMatrixType& {
   if (m_moment1 == nullptr) {
@@ -208,6 +218,57 @@ void adam<TensorDataType>::step_compute_cpu(AbsDistMatrixType& values,
 
 }
 
+template <typename TensorDataType>
+void adam<TensorDataType>::step_compute_sparse(AbsDistMatrixType& values,
+                                               const SparseGradientType& gradient) {
+  static const auto one = TensorDataType(1.);
+
+  if (values.GetLocalDevice() != El::Device::CPU) {
+    OptimizerType::step_compute_sparse(values, gradient);
+    return;
+  }
+
+  // Precompute the bias correction and learning rate.
+  m_current_beta1 *= m_beta1;
+  m_current_beta2 *= m_beta2;
+  const TensorDataType correction =
+    El::To<TensorDataType>(this->get_learning_rate()) *
+    (El::Sqrt(one - m_current_beta2) / (one - m_current_beta1));
+
+  // Get local matrix data
+  const El::Int local_height = values.LocalHeight();
+  const El::Int height = gradient.height();
+  const El::Int num_indices = gradient.num_indices();
+  const auto* __restrict__ indices = gradient.indices().data();
+  const auto* __restrict__ gradient_buffer = gradient.values().data();
+  auto* __restrict__ values_buffer = values.Buffer();
+  const El::Int values_ldim = values.LDim();
+  auto* __restrict__ moment1_buffer = m_moment1->Buffer();
+  auto* __restrict__ moment2_buffer = m_moment2->Buffer();
+  const El::Int moment1_ldim = m_moment1->LDim();
+  const El::Int moment2_ldim = m_moment2->LDim();
+
+  // Lazy Adam step on nonzero columns
+  LBANN_OMP_PARALLEL_FOR
+  for (El::Int k = 0; k < num_indices; ++k) {
+    if (!values.IsLocalCol(indices[k])) { continue; }
+    const El::Int col = values.LocalCol(indices[k]);
+    for (El::Int row = 0; row < local_height; ++row) {
+      auto& x = values_buffer[row+col*values_ldim];
+      const auto& g = gradient_buffer[values.GlobalRow(row)+k*height] + m_eps; // Avoid denormalized floats
+      if (std::isinf(g) || std::isnan(g)) {
+        continue;
+      }
+      auto& m1 = moment1_buffer[row+col*moment1_ldim];
+      auto& m2 = moment2_buffer[row+col*moment2_ldim];
+      m1 = m_beta1 * m1 + (one - m_beta1) * g;
+      m2 = m_beta2 * m2 + (one - m_beta2) * g * g;
+      x -= correction * m1 / (El::Sqrt(m2) + m_eps);
+    }
+  }
+
+}
+
 template <typename TensorDataType>
 std::unique_ptr<optimizer>
 build_adam_optimizer_from_pbuf(
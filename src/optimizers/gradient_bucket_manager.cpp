@@ -0,0 +1,157 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/comm_impl.hpp"
+#include "lbann/optimizers/gradient_bucket_manager.hpp"
+
+#include <algorithm>
+
+namespace lbann {
+
+std::string to_string(gradient_bucket_order order) {
+  switch (order) {
+  case gradient_bucket_order::backward:
+    return "backward";
+  case gradient_bucket_order::reverse_weights:
+    return "reverse_weights";
+  default:
+    return "unknown";
+  }
+}
+
+gradient_bucket_order gradient_bucket_order_from_string(std::string const& str) {
+  if (str.empty() || str == "backward") {
+    return gradient_bucket_order::backward;
+  }
+  if (str == "reverse_weights") {
+    return gradient_bucket_order::reverse_weights;
+  }
+  LBANN_ERROR("invalid gradient bucket order (", str, ")");
+  return gradient_bucket_order::backward;
+}
+
+gradient_bucket_manager::gradient_bucket_manager(
+  lbann_comm& comm,
+  size_t bucket_size_bytes,
+  gradient_bucket_order order)
+  : m_comm(&comm),
+    m_bucket_size(bucket_size_bytes),
+    m_order(order) {}
+
+gradient_bucket_manager::~gradient_bucket_manager() {
+  try {
+    reset();
+  }
+  catch (...) {}
+}
+
+void gradient_bucket_manager::set_owner_order(std::vector<const void*> owners) {
+  m_owner_ranks.clear();
+  for (size_t i = 0; i < owners.size(); ++i) {
+    m_owner_ranks.emplace(owners[i], i);
+  }
+}
+
+void gradient_bucket_manager::wait(const El::BaseDistMatrix& gradient) {
+  auto it = m_assignments.find(&gradient);
+  if (it == m_assignments.end()) {
+    flush();
+    it = m_assignments.find(&gradient);
+    if (it == m_assignments.end()) {
+      LBANN_ERROR("attempted to wait on a gradient that has not been "
+                  "handed to the gradient bucket manager");
+    }
+  }
+  auto& bucket = *it->second;
+  if (!bucket.is_launched()) {
+    // Launch all partially-filled buckets so that every process
+    // launches the same sequence of allreduces
+    flush();
+  }
+  bucket.complete(*m_comm);
+}
+
+void gradient_bucket_manager::flush() {
+
+  // Pack pending gradients in requested order
+  if (!m_pending.empty()) {
+    std::stable_sort(m_pending.begin(), m_pending.end(),
+                     [](const pending_gradient& x,
+                        const pending_gradient& y) {
+                       return x.rank < y.rank;
+                     });
+    auto pending = std::move(m_pending);
+    m_pending.clear();
+    for (auto& p : pending) { p.assign(); }
+  }
+
+  // Launch partially-filled buckets
+  for (auto& key_pool : m_pools) {
+    auto& pool = key_pool.second;
+    if (pool.open != nullptr) {
+      auto& bucket = *pool.open;
+      pool.open = nullptr;
+      launch(bucket);
+    }
+  }
+
+}
+
+void gradient_bucket_manager::reset() {
+
+  // Make sure all communication has finished
+  flush();
+  for (auto& key_pool : m_pools) {
+    auto& pool = key_pool.second;
+    for (size_t i = 0; i < pool.num_used; ++i) {
+      auto& bucket = *pool.buckets[i];
+      bucket.complete(*m_comm);
+      bucket.reset();
+    }
+    pool.num_used = 0;
+    pool.open = nullptr;
+  }
+  m_assignments.clear();
+
+  // Record statistics from this step
+  if (m_num_gradients > 0) {
+    m_last_num_allreduces = m_num_allreduces;
+    m_last_num_gradients = m_num_gradients;
+    m_last_num_bytes = m_num_bytes;
+  }
+  m_num_allreduces = 0;
+  m_num_gradients = 0;
+  m_num_bytes = 0;
+
+}
+
+void gradient_bucket_manager::launch(gradient_bucket& bucket) {
+  bucket.launch(*m_comm);
+  ++m_num_allreduces;
+  m_num_bytes += bucket.get_size_bytes();
+}
+
+} // namespace lbann
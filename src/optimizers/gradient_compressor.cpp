@@ -0,0 +1,518 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#define LBANN_GRADIENT_COMPRESSOR_INSTANTIATE
+#include "lbann/comm_impl.hpp"
+#include "lbann/optimizers/gradient_compressor.hpp"
+#include "lbann/utils/omp_pragma.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+namespace lbann {
+
+std::string to_string(gradient_compression_type type) {
+  switch (type) {
+  case gradient_compression_type::none:
+    return "none";
+  case gradient_compression_type::topk:
+    return "topk";
+  case gradient_compression_type::quantize:
+    return "quantize";
+  case gradient_compression_type::powersgd:
+    return "powersgd";
+  default:
+    return "unknown";
+  }
+}
+
+gradient_compression_type
+gradient_compression_type_from_string(std::string const& str) {
+  if (str.empty() || str == "none") {
+    return gradient_compression_type::none;
+  }
+  if (str == "topk") {
+    return gradient_compression_type::topk;
+  }
+  if (str == "quantize") {
+    return gradient_compression_type::quantize;
+  }
+  if (str == "powersgd") {
+    return gradient_compression_type::powersgd;
+  }
+  LBANN_ERROR("invalid gradient compression type (", str, ")");
+  return gradient_compression_type::none;
+}
+
+namespace {
+
+/** @brief Type for intermediate arithmetic.
+ *  @details Sums and residuals in half precision lose too much
+ *  accuracy.
+ */
+template <typename T> struct compute_type { using type = T; };
+#ifdef LBANN_HAS_HALF
+template <> struct compute_type<cpu_fp16> { using type = float; };
+#endif // LBANN_HAS_HALF
+#ifdef LBANN_HAS_GPU_FP16
+template <> struct compute_type<fp16> { using type = float; };
+#endif // LBANN_HAS_GPU_FP16
+
+/** @brief Compressor that keeps its compression error.
+ *
+ *  The residual from the previous step is added to the local
+ *  gradient before compressing, and whatever the compressed data
+ *  does not represent becomes the new residual.
+ */
+template <typename TensorDataType>
+class error_feedback_compressor
+  : public data_type_gradient_compressor<TensorDataType> {
+public:
+  using CPUMatrixType =
+    typename data_type_gradient_compressor<TensorDataType>::CPUMatrixType;
+  using ComputeType = typename compute_type<TensorDataType>::type;
+
+protected:
+
+  /** @brief Add local gradient to residual.
+   *  @details The residual is packed in column-major order. It is
+   *  zeroed if the gradient size has changed.
+   */
+  std::vector<ComputeType>& add_to_residual(const CPUMatrixType& local) {
+    const El::Int height = local.Height();
+    const El::Int width = local.Width();
+    const El::Int ldim = local.LDim();
+    if (m_residual.size() != static_cast<size_t>(height * width)) {
+      m_residual.assign(height * width, ComputeType(0));
+    }
+    const auto* __restrict__ buf = local.LockedBuffer();
+    auto* __restrict__ res = m_residual.data();
+    LBANN_OMP_PARALLEL_FOR
+    for (El::Int col = 0; col < width; ++col) {
+      for (El::Int row = 0; row < height; ++row) {
+        res[row + col * height] += El::To<ComputeType>(buf[row + col * ldim]);
+      }
+    }
+    return m_residual;
+  }
+
+private:
+  /** @brief Compression error from previous step. */
+  std::vector<ComputeType> m_residual;
+};
+
+/** @brief Top-k sparsification.
+ *
+ *  Each rank sends the indices and values of its largest-magnitude
+ *  entries. Since every rank sends the same number of entries, they
+ *  are exchanged with fixed-size allgathers.
+ */
+template <typename TensorDataType>
+class topk_compressor : public error_feedback_compressor<TensorDataType> {
+public:
+  using CPUMatrixType =
+    typename error_feedback_compressor<TensorDataType>::CPUMatrixType;
+  using ComputeType =
+    typename error_feedback_compressor<TensorDataType>::ComputeType;
+
+  topk_compressor(double ratio) : m_ratio(ratio) {}
+
+  std::string get_type() const override {
+    return "top-k (ratio=" + std::to_string(m_ratio) + ")";
+  }
+
+protected:
+
+  size_t allreduce_local(CPUMatrixType& local_gradient,
+                         El::mpi::Comm const& redundant_comm,
+                         lbann_comm&) override {
+    const El::Int height = local_gradient.Height();
+    const El::Int width = local_gradient.Width();
+    const El::Int ldim = local_gradient.LDim();
+    const El::Int size = height * width;
+    auto& residual = this->add_to_residual(local_gradient);
+
+    // Find largest-magnitude entries
+    const El::Int k = std::min(
+      std::max(static_cast<El::Int>(std::ceil(m_ratio * size)), El::Int(1)),
+      size);
+    m_order.resize(size);
+    std::iota(m_order.begin(), m_order.end(), El::Int(0));
+    std::nth_element(m_order.begin(),
+                     m_order.begin() + (k - 1),
+                     m_order.end(),
+                     [&residual](El::Int a, El::Int b) {
+                       return std::fabs(residual[a]) > std::fabs(residual[b]);
+                     });
+    std::vector<El::Int> send_indices(m_order.begin(), m_order.begin() + k);
+    std::vector<ComputeType> send_values(k);
+    for (El::Int i = 0; i < k; ++i) {
+      send_values[i] = residual[send_indices[i]];
+      residual[send_indices[i]] = ComputeType(0);
+    }
+
+    // Exchange entries
+    const int comm_size = El::mpi::Size(redundant_comm);
+    std::vector<El::Int> indices(comm_size * k);
+    std::vector<ComputeType> values(comm_size * k);
+    El::mpi::AllGather(send_indices.data(), k, indices.data(), k,
+                       redundant_comm, El::SyncInfo<El::Device::CPU>{});
+    El::mpi::AllGather(send_values.data(), k, values.data(), k,
+                       redundant_comm, El::SyncInfo<El::Device::CPU>{});
+
+    // Sum entries into gradient
+    std::vector<ComputeType> sum(size, ComputeType(0));
+    for (size_t i = 0; i < indices.size(); ++i) {
+      sum[indices[i]] += values[i];
+    }
+    auto* __restrict__ buf = local_gradient.Buffer();
+    LBANN_OMP_PARALLEL_FOR
+    for (El::Int col = 0; col < width; ++col) {
+      for (El::Int row = 0; row < height; ++row) {
+        buf[row + col * ldim] = El::To<TensorDataType>(sum[row + col * height]);
+      }
+    }
+    return k * (sizeof(El::Int) + sizeof(ComputeType));
+  }
+
+private:
+  /** @brief Fraction of entries that are sent. */
+  double m_ratio;
+  /** @brief Workspace for entry selection. */
+  std::vector<El::Int> m_order;
+};
+
+/** @brief Quantization to 8 or 1 bits.
+ *
+ *  With 8 bits, entries are scaled by the largest magnitude and
+ *  rounded to integers in [-127,127]. With 1 bit, only the sign of
+ *  each entry is sent and all entries are given the mean magnitude
+ *  (1-bit SGD). Each rank also sends its scaling factor.
+ */
+template <typename TensorDataType>
+class quantization_compressor
+  : public error_feedback_compressor<TensorDataType> {
+public:
+  using CPUMatrixType =
+    typename error_feedback_compressor<TensorDataType>::CPUMatrixType;
+  using ComputeType =
+    typename error_feedback_compressor<TensorDataType>::ComputeType;
+
+  quantization_compressor(int bits) : m_bits(bits) {}
+
+  std::string get_type() const override {
+    return std::to_string(m_bits) + "-bit quantization";
+  }
+
+protected:
+
+  size_t allreduce_local(CPUMatrixType& local_gradient,
+                         El::mpi::Comm const& redundant_comm,
+                         lbann_comm&) override {
+    const El::Int height = local_gradient.Height();
+    const El::Int width = local_gradient.Width();
+    const El::Int ldim = local_gradient.LDim();
+    const El::Int size = height * width;
+    auto& residual = this->add_to_residual(local_gradient);
+    auto* __restrict__ res = residual.data();
+
+    // Quantize entries and update residual
+    const El::Int num_bytes = (m_bits == 1 ? (size + 7) / 8 : size);
+    std::vector<El::byte> send_codes(num_bytes, 0);
+    float scale = 0.f;
+    if (m_bits == 1) {
+      ComputeType sum_abs = 0;
+      for (El::Int i = 0; i < size; ++i) { sum_abs += std::fabs(res[i]); }
+      scale = static_cast<float>(sum_abs / size);
+      const auto s = static_cast<ComputeType>(scale);
+      LBANN_OMP_PARALLEL_FOR
+      for (El::Int byte = 0; byte < num_bytes; ++byte) {
+        El::byte code = 0;
+        const El::Int end = std::min((byte + 1) * 8, size);
+        for (El::Int i = byte * 8; i < end; ++i) {
+          if (res[i] >= ComputeType(0)) {
+            code |= El::byte(1) << (i - byte * 8);
+            res[i] -= s;
+          }
+          else {
+            res[i] += s;
+          }
+        }
+        send_codes[byte] = code;
+      }
+    }
+    else {
+      ComputeType max_abs = 0;
+      for (El::Int i = 0; i < size; ++i) {
+        max_abs = std::max(max_abs, ComputeType(std::fabs(res[i])));
+      }
+      scale = static_cast<float>(max_abs / 127);
+      const auto s = static_cast<ComputeType>(scale);
+      const auto inv_s = (s > ComputeType(0)
+                          ? ComputeType(1) / s
+                          : ComputeType(0));
+      LBANN_OMP_PARALLEL_FOR
+      for (El::Int i = 0; i < size; ++i) {
+        auto q = std::round(res[i] * inv_s);
+        q = std::min(std::max(q, ComputeType(-127)), ComputeType(127));
+        send_codes[i] = static_cast<El::byte>(static_cast<int>(q) + 127);
+        res[i] -= q * s;
+      }
+    }
+
+    // Exchange quantized entries
+    const int comm_size = El::mpi::Size(redundant_comm);
+    std::vector<float> scales(comm_size);
+    std::vector<El::byte> codes(comm_size * num_bytes);
+    El::mpi::AllGather(&scale, 1, scales.data(), 1,
+                       redundant_comm, El::SyncInfo<El::Device::CPU>{});
+    El::mpi::AllGather(send_codes.data(), num_bytes, codes.data(), num_bytes,
+                       redundant_comm, El::SyncInfo<El::Device::CPU>{});
+
+    // Dequantize and sum entries into gradient
+    auto* __restrict__ buf = local_gradient.Buffer();
+    LBANN_OMP_PARALLEL_FOR
+    for (El::Int col = 0; col < width; ++col) {
+      for (El::Int row = 0; row < height; ++row) {
+        const El::Int i = row + col * height;
+        ComputeType sum = 0;
+        for (int rank = 0; rank < comm_size; ++rank) {
+          const auto* rank_codes = &codes[rank * num_bytes];
+          const auto s = static_cast<ComputeType>(scales[rank]);
+          if (m_bits == 1) {
+            const bool positive = (rank_codes[i / 8] >> (i % 8)) & 1;
+            sum += positive ? s : -s;
+          }
+          else {
+            sum += (static_cast<int>(rank_codes[i]) - 127) * s;
+          }
+        }
+        buf[row + col * ldim] = El::To<TensorDataType>(sum);
+      }
+    }
+    return num_bytes + sizeof(float);
+  }
+
+private:
+  /** @brief Bits per entry. */
+  int m_bits;
+};
+
+/** @brief Low-rank compression with PowerSGD.
+ *
+ *  The local gradient @f$ M @f$ is approximated with one step of
+ *  subspace iteration:
+ *  @f[
+ *    P = \text{orth}\left(\sum M Q\right), \quad
+ *    Q = \sum M^T P, \quad
+ *    \sum M \approx P Q^T
+ *  @f]
+ *  so only the @f$ P @f$ and @f$ Q @f$ factors are allreduced. @f$
+ *  Q @f$ is reused as the starting point for the next step. Local
+ *  gradients that are too small to benefit fall back to an
+ *  uncompressed allreduce.
+ *
+ *  See Vogels et al. "PowerSGD: Practical low-rank gradient
+ *  compression for distributed optimization." NeurIPS 2019.
+ */
+template <typename TensorDataType>
+class powersgd_compressor : public error_feedback_compressor<TensorDataType> {
+public:
+  using CPUMatrixType =
+    typename error_feedback_compressor<TensorDataType>::CPUMatrixType;
+  using ComputeType =
+    typename error_feedback_compressor<TensorDataType>::ComputeType;
+
+  powersgd_compressor(int rank) : m_rank(rank) {}
+
+  std::string get_type() const override {
+    return "PowerSGD (rank=" + std::to_string(m_rank) + ")";
+  }
+
+protected:
+
+  size_t allreduce_local(CPUMatrixType& local_gradient,
+                         El::mpi::Comm const& redundant_comm,
+                         lbann_comm& comm) override {
+    const El::Int height = local_gradient.Height();
+    const El::Int width = local_gradient.Width();
+    const El::Int ldim = local_gradient.LDim();
+    const El::Int rank = m_rank;
+
+    // Uncompressed allreduce if low-rank factors are not smaller
+    if (rank * (height + width) >= height * width) {
+      comm.allreduce(static_cast<El::AbstractMatrix<TensorDataType>&>(
+                       local_gradient),
+                     redundant_comm);
+      return height * width * sizeof(TensorDataType);
+    }
+
+    // Initialize Q with Gaussian noise
+    // Note: Fixed seed so that Q matches over the redundant
+    // communicator.
+    if (m_q.size() != static_cast<size_t>(width * rank)) {
+      std::mt19937 gen(width * rank);
+      std::normal_distribution<ComputeType> dist;
+      m_q.resize(width * rank);
+      for (auto& x : m_q) { x = dist(gen); }
+    }
+
+    auto& residual = this->add_to_residual(local_gradient);
+    const auto* __restrict__ m = residual.data();
+    auto* __restrict__ q = m_q.data();
+    m_p.assign(height * rank, ComputeType(0));
+    auto* __restrict__ p = m_p.data();
+
+    // P = sum(M Q), orthonormalized
+    LBANN_OMP_PARALLEL_FOR
+    for (El::Int row = 0; row < height; ++row) {
+      for (El::Int j = 0; j < rank; ++j) {
+        ComputeType sum = 0;
+        for (El::Int col = 0; col < width; ++col) {
+          sum += m[row + col * height] * q[col + j * width];
+        }
+        p[row + j * height] = sum;
+      }
+    }
+    comm.allreduce(p, height * rank, redundant_comm);
+    orthonormalize(p, height, rank);
+
+    // Q = sum(M^T P)
+    LBANN_OMP_PARALLEL_FOR
+    for (El::Int col = 0; col < width; ++col) {
+      for (El::Int j = 0; j < rank; ++j) {
+        ComputeType sum = 0;
+        for (El::Int row = 0; row < height; ++row) {
+          sum += m[row + col * height] * p[row + j * height];
+        }
+        q[col + j * width] = sum;
+      }
+    }
+    comm.allreduce(q, width * rank, redundant_comm);
+
+    // Gradient is P Q^T. Residual is the local part that P Q^T does
+    // not capture, assuming each rank contributes equally.
+    const ComputeType inv_comm_size
+      = ComputeType(1) / El::mpi::Size(redundant_comm);
+    auto* __restrict__ res = residual.data();
+    auto* __restrict__ buf = local_gradient.Buffer();
+    LBANN_OMP_PARALLEL_FOR
+    for (El::Int col = 0; col < width; ++col) {
+      for (El::Int row = 0; row < height; ++row) {
+        ComputeType approx = 0;
+        for (El::Int j = 0; j < rank; ++j) {
+          approx += p[row + j * height] * q[col + j * width];
+        }
+        res[row + col * height] -= approx * inv_comm_size;
+        buf[row + col * ldim] = El::To<TensorDataType>(approx);
+      }
+    }
+    return rank * (height + width) * sizeof(ComputeType);
+  }
+
+private:
+
+  /** @brief Modified Gram-Schmidt on columns of a packed matrix.
+   *  @details Columns that are numerically zero after projection
+   *  are set to zero.
+   */
+  static void orthonormalize(ComputeType* p, El::Int height, El::Int width) {
+    const ComputeType eps = std::numeric_limits<ComputeType>::epsilon();
+    for (El::Int j = 0; j < width; ++j) {
+      auto* pj = &p[j * height];
+      for (El::Int k = 0; k < j; ++k) {
+        const auto* pk = &p[k * height];
+        ComputeType dot = 0;
+        for (El::Int i = 0; i < height; ++i) { dot += pj[i] * pk[i]; }
+        for (El::Int i = 0; i < height; ++i) { pj[i] -= dot * pk[i]; }
+      }
+      ComputeType norm = 0;
+      for (El::Int i = 0; i < height; ++i) { norm += pj[i] * pj[i]; }
+      norm = std::sqrt(norm);
+      const ComputeType scale = (norm > eps ? ComputeType(1) / norm
+                                 : ComputeType(0));
+      for (El::Int i = 0; i < height; ++i) { pj[i] *= scale; }
+    }
+  }
+
+  /** @brief Rank of approximation. */
+  int m_rank;
+  /** @brief Left factor of approximation. */
+  std::vector<ComputeType> m_p;
+  /** @brief Right factor of approximation.
+   *  @details Persistent since it is reused in the next step.
+   */
+  std::vector<ComputeType> m_q;
+};
+
+} // namespace
+
+template <typename TensorDataType>
+std::unique_ptr<data_type_gradient_compressor<TensorDataType>>
+make_gradient_compressor(gradient_compression_params const& params) {
+  switch (params.type) {
+  case gradient_compression_type::none:
+    return nullptr;
+  case gradient_compression_type::topk:
+    if (params.topk_ratio <= 0. || params.topk_ratio > 1.) {
+      LBANN_ERROR("top-k gradient compression ratio must be in (0,1] "
+                  "(got ", params.topk_ratio, ")");
+    }
+    return make_unique<topk_compressor<TensorDataType>>(params.topk_ratio);
+  case gradient_compression_type::quantize:
+    if (params.quantization_bits != 1 && params.quantization_bits != 8) {
+      LBANN_ERROR("gradient quantization must use 1 or 8 bits "
+                  "(got ", params.quantization_bits, ")");
+    }
+    return make_unique<quantization_compressor<TensorDataType>>(
+      params.quantization_bits);
+  case gradient_compression_type::powersgd:
+    if (params.powersgd_rank < 1) {
+      LBANN_ERROR("PowerSGD gradient compression rank must be positive "
+                  "(got ", params.powersgd_rank, ")");
+    }
+    return make_unique<powersgd_compressor<TensorDataType>>(
+      params.powersgd_rank);
+  default:
+    LBANN_ERROR("invalid gradient compression type");
+  }
+  return nullptr;
+}
+
+#define PROTO(T)                                                        \
+  template std::unique_ptr<data_type_gradient_compressor<T>>            \
+  make_gradient_compressor<T>(gradient_compression_params const&)
+
+#define LBANN_INSTANTIATE_CPU_HALF
+#define LBANN_INSTANTIATE_GPU_HALF
+#include "lbann/macros/instantiate.hpp"
+
+} // namespace lbann
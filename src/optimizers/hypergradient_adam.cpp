@@ -87,6 +87,17 @@ description hypergradient_adam<TensorDataType>::get_description() const {
   return desc;
 }
 
+template <typename TensorDataType>
+void hypergradient_adam<TensorDataType>::write_proto(lbann_data::Optimizer* proto) const {
+  proto->Clear();
+  auto* opt = proto->mutable_hypergradient_adam();
+  opt->set_init_learning_rate(this->get_learning_rate());
+  opt->set_hyper_learning_rate(El::To<double>(m_hyper_learning_rate));
+  opt->set_beta1(El::To<double>(m_beta1));
+  opt->set_beta2(El::To<double>(m_beta2));
+  opt->set_eps(El::To<double>(m_eps));
+}
+
 template <typename TensorDataType>
 void hypergradient_adam<TensorDataType>::setup(WeightsType* w) {
   OptimizerType::setup(w);
@@ -53,7 +53,10 @@ optimizer::optimizer(const optimizer& other)
   : m_comm(other.m_comm),
     m_gradient_sources(other.m_gradient_sources),
     m_gradient_status(other.m_gradient_status),
-    m_step_time(other.m_step_time) {
+    m_step_time(other.m_step_time),
+    m_allreduce_wait_time(other.m_allreduce_wait_time),
+    m_loss_scale(other.m_loss_scale),
+    m_gradient_compression(other.m_gradient_compression) {
   if (m_gradient_status == optimizer_gradient_status::allreduce_started) {
     LBANN_ERROR("attempted to copy optimizer while a "
                 "gradient allreduce is in progress");
@@ -65,6 +68,9 @@ optimizer& optimizer::operator=(const optimizer& other) {
   m_gradient_sources = other.m_gradient_sources;
   m_gradient_status = other.m_gradient_status;
   m_step_time = other.m_step_time;
+  m_allreduce_wait_time = other.m_allreduce_wait_time;
+  m_loss_scale = other.m_loss_scale;
+  m_gradient_compression = other.m_gradient_compression;
   if (m_gradient_status == optimizer_gradient_status::allreduce_started) {
     LBANN_ERROR("attempted to copy optimizer while a "
                 "gradient allreduce is in progress");
@@ -79,6 +85,9 @@ void optimizer::serialize(Archive & ar) {
 
 description optimizer::get_description() const {
   description desc(get_type() + " optimizer");
+  if (m_gradient_compression.type != gradient_compression_type::none) {
+    desc.add("Gradient compression", to_string(m_gradient_compression.type));
+  }
   return desc;
 }
 
@@ -92,10 +101,44 @@ void optimizer::add_gradient_source(const void* source) {
   }
 }
 
+void optimizer::set_gradient_bucket_manager(gradient_bucket_manager* buckets) {
+  for (auto& grad_mgr : gradients_) {
+    if (grad_mgr.second->get_status()
+        == optimizer_gradient_status::allreduce_started) {
+      grad_mgr.second->complete_allreduce(*m_comm);
+    }
+    grad_mgr.second->set_bucket_manager(buckets, this);
+  }
+  m_gradient_buckets = buckets;
+}
+
+void optimizer::set_gradient_compression(
+  gradient_compression_params const& params) {
+  for (auto& grad_mgr : gradients_) {
+    if (grad_mgr.second->get_status()
+        == optimizer_gradient_status::allreduce_started) {
+      grad_mgr.second->complete_allreduce(*m_comm);
+    }
+    grad_mgr.second->set_compression(params);
+  }
+  m_gradient_compression = params;
+}
+
+gradient_compression_statistics
+optimizer::get_gradient_compression_statistics() const {
+  gradient_compression_statistics stats;
+  for (const auto& grad_mgr : gradients_) {
+    if (const auto* compressor = grad_mgr.second->get_compressor()) {
+      stats += compressor->get_statistics();
+    }
+  }
+  return stats;
+}
+
 void optimizer::remove_gradient_source(const void* source) {
   m_gradient_sources.erase(nullptr);
   m_gradient_sources.erase(source);
-  if (get_gradient_sources().empty()) {
+  if (get_gradient_sources().empty() && !m_defer_gradient_allreduce) {
     start_gradient_allreduce();
   }
 }
@@ -62,6 +62,15 @@ description rmsprop<TensorDataType>::get_description() const {
   return desc;
 }
 
+template <typename TensorDataType>
+void rmsprop<TensorDataType>::write_proto(lbann_data::Optimizer* proto) const {
+  proto->Clear();
+  auto* opt = proto->mutable_rmsprop();
+  opt->set_learn_rate(this->get_learning_rate());
+  opt->set_decay_rate(El::To<double>(m_decay_rate));
+  opt->set_eps(El::To<double>(m_eps));
+}
+
 template <typename TensorDataType>
 void rmsprop<TensorDataType>::setup(WeightsType* w) {
   OptimizerType::setup(w);
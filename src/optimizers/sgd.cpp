@@ -65,6 +65,15 @@ description sgd<TensorDataType>::get_description() const {
   return desc;
 }
 
+template <typename TensorDataType>
+void sgd<TensorDataType>::write_proto(lbann_data::Optimizer* proto) const {
+  proto->Clear();
+  auto* opt = proto->mutable_sgd();
+  opt->set_learn_rate(this->get_learning_rate());
+  opt->set_momentum(El::To<double>(m_momentum));
+  opt->set_nesterov(m_nesterov);
+}
+
 template <typename TensorDataType>
 auto sgd<TensorDataType>::get_velocity() const -> const AbsDistMatrixType& {
   if (m_velocity == nullptr) {
@@ -179,6 +188,60 @@ void sgd<TensorDataType>::momentum_step_cpu(AbsDistMatrixType& values,
 
 }
 
+template <typename TensorDataType>
+void sgd<TensorDataType>::step_compute_sparse(AbsDistMatrixType& values,
+                                              const SparseGradientType& gradient) {
+  if (values.GetLocalDevice() != El::Device::CPU) {
+    OptimizerType::step_compute_sparse(values, gradient);
+    return;
+  }
+
+  // Get local matrix data
+  const El::Int local_height = values.LocalHeight();
+  const El::Int height = gradient.height();
+  const El::Int num_indices = gradient.num_indices();
+  const auto* __restrict__ indices = gradient.indices().data();
+  const auto* __restrict__ gradient_buffer = gradient.values().data();
+  auto* __restrict__ values_buffer = values.Buffer();
+  const El::Int values_ldim = values.LDim();
+  const auto learning_rate = El::To<TensorDataType>(this->get_learning_rate());
+
+  if (m_momentum == TensorDataType(0.)) {
+
+    // Vanilla SGD on nonzero columns
+    LBANN_OMP_PARALLEL_FOR
+    for (El::Int k = 0; k < num_indices; ++k) {
+      if (!values.IsLocalCol(indices[k])) { continue; }
+      const El::Int col = values.LocalCol(indices[k]);
+      for (El::Int row = 0; row < local_height; ++row) {
+        auto& x = values_buffer[row+col*values_ldim];
+        const auto& g = gradient_buffer[values.GlobalRow(row)+k*height];
+        x -= learning_rate * g;
+      }
+    }
+
+  } else {
+
+    // Momentum or Nesterov SGD on nonzero columns
+    auto* __restrict__ velocity_buffer = m_velocity->Buffer();
+    const El::Int velocity_ldim = m_velocity->LDim();
+    LBANN_OMP_PARALLEL_FOR
+    for (El::Int k = 0; k < num_indices; ++k) {
+      if (!values.IsLocalCol(indices[k])) { continue; }
+      const El::Int col = values.LocalCol(indices[k]);
+      for (El::Int row = 0; row < local_height; ++row) {
+        auto& x = values_buffer[row+col*values_ldim];
+        const auto& g = gradient_buffer[values.GlobalRow(row)+k*height];
+        auto& v = velocity_buffer[row+col*velocity_ldim];
+        v = m_momentum * v + g;
+        x -= learning_rate * (m_nesterov ? m_momentum * v + g : v);
+      }
+    }
+
+  }
+
+}
+
 template <typename TensorDataType>
 std::unique_ptr<optimizer>
 build_sgd_optimizer_from_pbuf(
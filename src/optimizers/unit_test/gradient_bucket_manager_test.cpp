@@ -0,0 +1,123 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <catch2/catch.hpp>
+
+#include "MPITestHelpers.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/comm_impl.hpp>
+#include <lbann/optimizers/gradient_bucket_manager.hpp>
+
+#include <vector>
+
+namespace {
+using DistMatType = El::DistMatrix<float, El::STAR, El::STAR,
+                                   El::ELEMENT, El::Device::CPU>;
+} // namespace
+
+TEST_CASE("Gradient bucket manager", "[mpi][optimizer][gradient_bucket]")
+{
+  auto& comm = ::unit_test::utilities::current_world_comm();
+  const auto& grid = comm.get_trainer_grid();
+  const El::Int num_procs = El::mpi::Size(comm.get_trainer_comm());
+  const El::Int rank = El::mpi::Rank(comm.get_trainer_comm());
+
+  // Gradients with rank-dependent values
+  const std::vector<El::Int> heights = {7, 1, 32, 5, 64};
+  auto make_gradients = [&]() {
+    std::vector<std::unique_ptr<DistMatType>> grads;
+    for (size_t i = 0; i < heights.size(); ++i) {
+      grads.emplace_back(lbann::make_unique<DistMatType>(grid));
+      grads.back()->Resize(heights[i], 3);
+      El::Fill(*grads.back(), float(rank + i));
+    }
+    return grads;
+  };
+  auto check_gradients = [&](const std::vector<std::unique_ptr<DistMatType>>& grads) {
+    for (size_t i = 0; i < grads.size(); ++i) {
+      const float expected = num_procs * (num_procs - 1) / 2.f + num_procs * i;
+      const auto& local = grads[i]->LockedMatrix();
+      for (El::Int col = 0; col < local.Width(); ++col) {
+        for (El::Int row = 0; row < local.Height(); ++row) {
+          CHECK(local(row, col) == Approx(expected));
+        }
+      }
+    }
+  };
+
+  SECTION("Backward order with small buckets")
+  {
+    // Buckets are launched once they reach 30 entries, so gradients
+    // are packed as {7x3, 1x3, 32x3} and {5x3, 64x3}
+    lbann::gradient_bucket_manager buckets(
+      comm, 10*3*sizeof(float), lbann::gradient_bucket_order::backward);
+    auto grads = make_gradients();
+    for (auto& g : grads) { buckets.enqueue(*g, g.get()); }
+    buckets.flush();
+    for (auto& g : grads) { buckets.wait(*g); }
+    check_gradients(grads);
+    buckets.reset();
+    CHECK(buckets.get_num_gradients() == grads.size());
+    CHECK(buckets.get_num_allreduces() == 2);
+    CHECK(buckets.get_num_bytes() == (7+1+32+5+64)*3*sizeof(float));
+  }
+
+  SECTION("Reverse weights order with one large bucket")
+  {
+    lbann::gradient_bucket_manager buckets(
+      comm, 1 << 20, lbann::gradient_bucket_order::reverse_weights);
+    auto grads = make_gradients();
+    std::vector<const void*> owners;
+    for (auto it = grads.rbegin(); it != grads.rend(); ++it) {
+      owners.push_back(it->get());
+    }
+    buckets.set_owner_order(owners);
+    for (auto& g : grads) { buckets.enqueue(*g, g.get()); }
+    // Waiting on a gradient launches pending buckets
+    for (auto& g : grads) { buckets.wait(*g); }
+    check_gradients(grads);
+
+    // Buffers are reused in the next step
+    buckets.reset();
+    CHECK(buckets.get_num_allreduces() == 1);
+    auto grads2 = make_gradients();
+    for (auto& g : grads2) { buckets.enqueue(*g, g.get()); }
+    buckets.reset();
+    check_gradients(grads2);
+    CHECK(buckets.get_num_allreduces() == 1);
+    CHECK(buckets.get_num_gradients() == grads2.size());
+  }
+
+  SECTION("Parse bucket order")
+  {
+    CHECK(lbann::gradient_bucket_order_from_string("")
+          == lbann::gradient_bucket_order::backward);
+    CHECK(lbann::gradient_bucket_order_from_string("reverse_weights")
+          == lbann::gradient_bucket_order::reverse_weights);
+    CHECK_THROWS(lbann::gradient_bucket_order_from_string("forward"));
+  }
+}
@@ -0,0 +1,139 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <catch2/catch.hpp>
+
+#include "MPITestHelpers.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/comm_impl.hpp>
+#include <lbann/optimizers/gradient_compressor.hpp>
+
+#include <vector>
+
+namespace {
+using DistMatType = El::DistMatrix<float, El::STAR, El::STAR,
+                                   El::ELEMENT, El::Device::CPU>;
+} // namespace
+
+TEST_CASE("Gradient compressors", "[mpi][optimizer][gradient_compression]")
+{
+  auto& comm = ::unit_test::utilities::current_world_comm();
+  const auto& grid = comm.get_trainer_grid();
+  const El::Int num_procs = El::mpi::Size(comm.get_trainer_comm());
+  const El::Int rank = El::mpi::Rank(comm.get_trainer_comm());
+
+  auto check_gradient = [](const DistMatType& grad, float expected) {
+    const auto& local = grad.LockedMatrix();
+    for (El::Int col = 0; col < local.Width(); ++col) {
+      for (El::Int row = 0; row < local.Height(); ++row) {
+        CHECK(local(row, col) == Approx(expected));
+      }
+    }
+  };
+
+  // Gradient with rank-dependent values
+  DistMatType grad(grid);
+  grad.Resize(8, 6);
+  El::Fill(grad, float(rank + 1));
+  const float expected_sum = num_procs * (num_procs + 1) / 2.f;
+  lbann::gradient_compression_params params;
+
+  SECTION("Top-k with all entries is exact")
+  {
+    params.type = lbann::gradient_compression_type::topk;
+    params.topk_ratio = 1.;
+    auto compressor = lbann::make_gradient_compressor<float>(params);
+    compressor->allreduce(grad, comm);
+    check_gradient(grad, expected_sum);
+  }
+
+  SECTION("8-bit quantization")
+  {
+    params.type = lbann::gradient_compression_type::quantize;
+    params.quantization_bits = 8;
+    auto compressor = lbann::make_gradient_compressor<float>(params);
+    compressor->allreduce(grad, comm);
+    check_gradient(grad, expected_sum);
+    if (num_procs > 1) {
+      const auto& stats = compressor->get_statistics();
+      CHECK(stats.uncompressed_bytes == 8 * 6 * sizeof(float));
+      CHECK(stats.compressed_bytes == 8 * 6 + sizeof(float));
+    }
+  }
+
+  SECTION("1-bit quantization")
+  {
+    params.type = lbann::gradient_compression_type::quantize;
+    params.quantization_bits = 1;
+    auto compressor = lbann::make_gradient_compressor<float>(params);
+    compressor->allreduce(grad, comm);
+    check_gradient(grad, expected_sum);
+  }
+
+  SECTION("PowerSGD recovers rank-1 gradient")
+  {
+    params.type = lbann::gradient_compression_type::powersgd;
+    params.powersgd_rank = 1;
+    auto compressor = lbann::make_gradient_compressor<float>(params);
+    compressor->allreduce(grad, comm);
+    check_gradient(grad, expected_sum);
+  }
+
+  SECTION("Top-k error feedback delays small entries")
+  {
+    // Each step sends one entry, so the residual drains over four
+    // steps and the total matches an uncompressed allreduce
+    params.type = lbann::gradient_compression_type::topk;
+    params.topk_ratio = 0.25;
+    auto compressor = lbann::make_gradient_compressor<float>(params);
+    DistMatType column(grid);
+    column.Resize(4, 1);
+    std::vector<float> total(4, 0.f);
+    for (int step = 0; step < 4; ++step) {
+      for (El::Int row = 0; row < 4; ++row) {
+        column.Set(row, 0, step == 0 ? float(4 - row) : 0.f);
+      }
+      compressor->allreduce(column, comm);
+      for (El::Int row = 0; row < 4; ++row) {
+        total[row] += column.Get(row, 0);
+      }
+      if (num_procs > 1) {
+        CHECK(column.Get(step, 0) == Approx(num_procs * (4 - step)));
+      }
+    }
+    for (El::Int row = 0; row < 4; ++row) {
+      CHECK(total[row] == Approx(num_procs * (4 - row)));
+    }
+  }
+
+  SECTION("Invalid parameters")
+  {
+    params.type = lbann::gradient_compression_type::quantize;
+    params.quantization_bits = 4;
+    CHECK_THROWS(lbann::make_gradient_compressor<float>(params));
+  }
+}
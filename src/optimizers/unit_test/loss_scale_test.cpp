@@ -0,0 +1,133 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <catch2/catch.hpp>
+
+#include "MPITestHelpers.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/optimizers/sgd.hpp>
+#include <lbann/utils/memory.hpp>
+#include <lbann/weights/data_type_weights.hpp>
+#include <lbann/weights/initializer.hpp>
+
+#include <limits>
+#include <memory>
+
+namespace {
+template <typename T>
+using AbsDistMatType = El::AbstractDistMatrix<T>;
+
+/** Gradient contribution with the same distribution as the weights. */
+template <typename T>
+std::unique_ptr<AbsDistMatType<T>> make_contribution(
+  const lbann::data_type_weights<float>& w, T value)
+{
+  std::unique_ptr<AbsDistMatType<T>> contrib(
+    AbsDistMatType<T>::Instantiate(w.get_values().DistData()));
+  contrib->Resize(w.get_matrix_height(), w.get_matrix_width());
+  El::Fill(*contrib, value);
+  return contrib;
+}
+} // namespace
+
+TEST_CASE("Loss-scaled gradients", "[mpi][optimizer][mixed_precision]")
+{
+  auto& comm = ::unit_test::utilities::current_world_comm();
+  constexpr float loss_scale = 1024.f;
+
+  // Weights initialized to one, updated with SGD without momentum
+  lbann::data_type_weights<float> w(comm);
+  w.set_dims({4}, {3});
+  w.set_initializer(
+    lbann::make_unique<lbann::constant_initializer<float>>(1.f));
+  w.set_optimizer(lbann::make_unique<lbann::sgd<float>>(1.f, 0.f, false));
+  w.setup();
+  auto& opt = *w.get_optimizer();
+  auto check_values = [&](float expected) {
+    const auto& local_values = w.get_values().LockedMatrix();
+    for (El::Int col = 0; col < local_values.Width(); ++col) {
+      for (El::Int row = 0; row < local_values.Height(); ++row) {
+        CHECK(local_values(row, col) == Approx(expected));
+      }
+    }
+  };
+
+  SECTION("Gradient is unscaled in optimization step")
+  {
+    auto contrib = make_contribution<float>(w, 0.5f * loss_scale);
+    opt.add_to_gradient(*contrib);
+    opt.set_loss_scale(loss_scale);
+    CHECK(opt.gradient_is_finite());
+    opt.step();
+    check_values(0.5f);
+  }
+
+  SECTION("Overflow is detected")
+  {
+    auto contrib = make_contribution<float>(
+      w, std::numeric_limits<float>::infinity());
+    opt.add_to_gradient(*contrib);
+    opt.set_loss_scale(loss_scale);
+    CHECK_FALSE(opt.gradient_is_finite());
+  }
+
+  SECTION("Gradients accumulated over deferred allreduces")
+  {
+    // Each micro-batch contributes a gradient of 0.5 after the
+    // allreduce; the optimization step uses their mean
+    constexpr int num_micro_batches = 3;
+    const float redundant_size = w.get_values().RedundantSize();
+    auto contrib = make_contribution<float>(w, 0.5f / redundant_size);
+    int source = 0;
+    opt.set_defer_gradient_allreduce(true);
+    for (int i = 0; i < num_micro_batches; ++i) {
+      if (i == num_micro_batches - 1) {
+        opt.set_defer_gradient_allreduce(false);
+      }
+      opt.add_gradient_source(&source);
+      opt.add_to_gradient(*contrib, 1.f, true);
+      opt.remove_gradient_source(&source);
+    }
+    opt.set_loss_scale(num_micro_batches);
+    opt.step();
+    check_values(0.5f);
+  }
+
+#ifdef LBANN_HAS_HALF
+  SECTION("16-bit gradient contributions")
+  {
+    using HalfType = lbann::cpu_fp16;
+    auto contrib = make_contribution<HalfType>(
+      w, El::To<HalfType>(0.25f * loss_scale));
+    opt.add_to_gradient(*contrib, El::To<HalfType>(1.f));
+    opt.set_loss_scale(loss_scale);
+    CHECK(opt.gradient_is_finite());
+    opt.step();
+    check_values(0.75f);
+  }
+#endif // LBANN_HAS_HALF
+}
@@ -0,0 +1,299 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <catch2/catch.hpp>
+
+#include "MPITestHelpers.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/comm_impl.hpp>
+#include <lbann/optimizers/adagrad.hpp>
+#include <lbann/optimizers/adam.hpp>
+#include <lbann/optimizers/sgd.hpp>
+#include <lbann/optimizers/sparse_gradient.hpp>
+#include <lbann/utils/memory.hpp>
+#include <lbann/weights/data_type_weights.hpp>
+#include <lbann/weights/initializer.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace {
+using SparseGradientType = lbann::sparse_gradient<float>;
+using StarMatType = El::DistMatrix<float, El::STAR, El::STAR,
+                                   El::ELEMENT, El::Device::CPU>;
+using MCMRMatType = El::DistMatrix<float, El::MC, El::MR,
+                                   El::ELEMENT, El::Device::CPU>;
+using WeightsType = lbann::data_type_weights<float>;
+using OptimizerFactory = std::function<std::unique_ptr<lbann::optimizer>()>;
+
+float initial_value(El::Int row, El::Int col) {
+  return 0.3f + 0.1f * row - 0.05f * col;
+}
+
+float gradient_value(int step, El::Int row, El::Int col) {
+  return 0.2f * (step + 1) - 0.1f * row + 0.03f * col;
+}
+
+void setup_weights(WeightsType& w,
+                   El::Int height,
+                   El::Int width,
+                   bool distributed,
+                   std::unique_ptr<lbann::optimizer> opt) {
+  w.set_dims({static_cast<size_t>(height)}, {static_cast<size_t>(width)});
+  if (distributed) {
+    auto dist = w.get_matrix_distribution();
+    dist.colDist = El::MC;
+    dist.rowDist = El::MR;
+    w.set_matrix_distribution(dist);
+  }
+  w.set_initializer(
+    lbann::make_unique<lbann::constant_initializer<float>>(0.f));
+  w.set_optimizer(std::move(opt));
+  w.setup();
+  StarMatType init(w.get_values().Grid());
+  init.Resize(height, width);
+  for (El::Int col = 0; col < width; ++col) {
+    for (El::Int row = 0; row < height; ++row) {
+      init.Set(row, col, initial_value(row, col));
+    }
+  }
+  w.set_values(init);
+}
+
+/** Take the same steps with dense and sparse gradients. Columns
+ *  without gradients must be untouched by the sparse steps and the
+ *  other columns must match the dense steps.
+ */
+void check_sparse_steps(lbann::lbann_comm& comm,
+                        const OptimizerFactory& make_optimizer,
+                        bool distributed) {
+  constexpr El::Int height = 3;
+  constexpr El::Int width = 16;
+  constexpr int num_steps = 3;
+  const std::vector<El::Int> touched = {2, 5, 11};
+
+  WeightsType dense_w(comm), sparse_w(comm);
+  setup_weights(dense_w, height, width, distributed, make_optimizer());
+  setup_weights(sparse_w, height, width, distributed, make_optimizer());
+  auto& dense_opt = *dense_w.get_optimizer();
+  auto& sparse_opt =
+    dynamic_cast<lbann::data_type_optimizer<float>&>(*sparse_w.get_optimizer());
+
+  for (int step = 0; step < num_steps; ++step) {
+    // Every rank contributes the same gradient, so both paths sum
+    // it over the redundant communicator
+    StarMatType dense_grad(dense_w.get_values().Grid());
+    El::Zeros(dense_grad, height, width);
+    auto& sparse_grad = sparse_opt.get_sparse_gradient_buffer();
+    std::vector<float> column(height);
+    for (const auto& col : touched) {
+      for (El::Int row = 0; row < height; ++row) {
+        column[row] = gradient_value(step, row, col);
+        dense_grad.Set(row, col, column[row]);
+      }
+      sparse_grad.add(col, column.data());
+    }
+    std::unique_ptr<El::AbstractDistMatrix<float>> contrib(
+      El::AbstractDistMatrix<float>::Instantiate(
+        dense_w.get_values().DistData()));
+    El::Copy(dense_grad, *contrib);
+    dense_opt.add_to_gradient(*contrib, 1.f, true);
+
+    dense_opt.step();
+    sparse_opt.step();
+    dense_opt.clear_gradient();
+    sparse_opt.clear_gradient();
+  }
+
+  const auto& dense_values = dense_w.get_values();
+  const auto& sparse_values = sparse_w.get_values();
+  for (El::Int col = 0; col < width; ++col) {
+    const bool is_touched =
+      std::find(touched.begin(), touched.end(), col) != touched.end();
+    for (El::Int row = 0; row < height; ++row) {
+      INFO("Entry (" << row << "," << col << ")");
+      const float value = sparse_values.Get(row, col);
+      if (is_touched) {
+        CHECK(value == Approx(dense_values.Get(row, col)));
+        CHECK(value != initial_value(row, col));
+      }
+      else {
+        CHECK(value == initial_value(row, col));
+      }
+    }
+  }
+}
+} // namespace
+
+TEST_CASE("Sparse gradient", "[mpi][optimizer][sparse_gradient]")
+{
+  auto& comm = ::unit_test::utilities::current_world_comm();
+  const auto& grid = comm.get_trainer_grid();
+  const auto& trainer_comm = comm.get_trainer_comm();
+  const El::Int num_procs = El::mpi::Size(trainer_comm);
+  const El::Int rank = El::mpi::Rank(trainer_comm);
+
+  constexpr El::Int height = 3;
+  constexpr El::Int width = 16;
+  const std::vector<float> ones(height, 1.f);
+
+  SparseGradientType grad;
+  grad.setup(height, width);
+  CHECK_FALSE(grad.has_contributions());
+
+  SECTION("Contributions to the same column are summed")
+  {
+    grad.add(5, ones.data());
+    grad.add(2, ones.data(), 2.f);
+    grad.add(5, ones.data(), 3.f);
+    CHECK(grad.has_contributions());
+    REQUIRE(grad.num_indices() == 2);
+    CHECK(grad.indices()[0] == 5);
+    CHECK(grad.indices()[1] == 2);
+    for (El::Int i = 0; i < height; ++i) {
+      CHECK(grad.values()[i] == 4.f);
+      CHECK(grad.values()[height+i] == 2.f);
+    }
+    CHECK_THROWS(grad.add(width, ones.data()));
+
+    grad.clear();
+    CHECK(grad.num_indices() == 0);
+    CHECK_FALSE(grad.has_contributions());
+  }
+
+  SECTION("Scale nonzero vectors")
+  {
+    grad.add(5, ones.data(), 4.f);
+    grad.add(2, ones.data());
+    grad.scale(0.25f);
+    REQUIRE(grad.num_indices() == 2);
+    for (El::Int i = 0; i < height; ++i) {
+      CHECK(grad.values()[i] == 1.f);
+      CHECK(grad.values()[height+i] == 0.25f);
+    }
+  }
+
+  SECTION("Add to dense matrix")
+  {
+    grad.add(0, ones.data());
+    grad.add(7, ones.data(), 2.f);
+    grad.add(width-1, ones.data(), -1.f);
+    StarMatType star(grid);
+    MCMRMatType mcmr(grid);
+    El::Zeros(star, height, width);
+    El::Zeros(mcmr, height, width);
+    grad.add_to(star);
+    grad.add_to(mcmr, 2.f);
+    for (El::Int col = 0; col < width; ++col) {
+      float expected = 0.f;
+      if (col == 0) { expected = 1.f; }
+      if (col == 7) { expected = 2.f; }
+      if (col == width-1) { expected = -1.f; }
+      for (El::Int row = 0; row < height; ++row) {
+        CHECK(star.Get(row, col) == expected);
+        CHECK(mcmr.Get(row, col) == 2.f * expected);
+      }
+    }
+  }
+
+  SECTION("Allgather sums contributions over ranks")
+  {
+    // Every rank touches column 1, plus a column of its own
+    grad.add(1, ones.data());
+    if (rank % 2 == 0) {
+      grad.add(2 + rank % (width-2), ones.data(), float(rank));
+    }
+    REQUIRE(grad.allgather(trainer_comm, width));
+    CHECK(grad.has_contributions());
+    CHECK(grad.indices()[0] == 1);
+
+    StarMatType dense(grid);
+    El::Zeros(dense, height, width);
+    grad.add_to(dense);
+    std::vector<float> expected(width, 0.f);
+    expected[1] = num_procs;
+    for (El::Int r = 0; r < num_procs; r += 2) {
+      expected[2 + r % (width-2)] += r;
+    }
+    for (El::Int col = 0; col < width; ++col) {
+      for (El::Int row = 0; row < height; ++row) {
+        CHECK(dense.Get(row, col) == expected[col]);
+      }
+    }
+  }
+
+  SECTION("Allgather is abandoned for dense gradients")
+  {
+    grad.add(1, ones.data());
+    grad.add(3, ones.data());
+    CHECK_FALSE(grad.allgather(trainer_comm, 2*num_procs - 1));
+    CHECK(grad.num_indices() == 2);
+    CHECK(grad.has_contributions());
+  }
+}
+
+TEST_CASE("Sparse optimization steps", "[mpi][optimizer][sparse_gradient]")
+{
+  auto& comm = ::unit_test::utilities::current_world_comm();
+  OptimizerFactory make_optimizer;
+
+  SECTION("SGD")
+  {
+    make_optimizer = [] {
+      return lbann::make_unique<lbann::sgd<float>>(0.1f, 0.f, false);
+    };
+  }
+  SECTION("SGD with momentum")
+  {
+    make_optimizer = [] {
+      return lbann::make_unique<lbann::sgd<float>>(0.1f, 0.9f, false);
+    };
+  }
+  SECTION("SGD with Nesterov momentum")
+  {
+    make_optimizer = [] {
+      return lbann::make_unique<lbann::sgd<float>>(0.1f, 0.9f, true);
+    };
+  }
+  SECTION("Adam")
+  {
+    make_optimizer = [] {
+      return lbann::make_unique<lbann::adam<float>>(0.1f);
+    };
+  }
+  SECTION("AdaGrad")
+  {
+    make_optimizer = [] {
+      return lbann::make_unique<lbann::adagrad<float>>(0.1f);
+    };
+  }
+
+  check_sparse_steps(comm, make_optimizer, false);
+  check_sparse_steps(comm, make_optimizer, true);
+}
@@ -67,6 +67,7 @@
 #include "lbann/callbacks/summary.hpp"
 #include "lbann/callbacks/sync_layers.hpp"
 #include "lbann/callbacks/timeline.hpp"
+#include "lbann/callbacks/trace.hpp"
 #include "lbann/callbacks/timer.hpp"
 #include "lbann/callbacks/variable_minibatch.hpp"
 #include "lbann/callbacks/set_weights_value.hpp"
@@ -198,6 +199,8 @@ void register_default_builders(factory_type& factory)
                            build_sync_layers_callback_from_pbuf);
   factory.register_builder("CallbackTimeline",
                            build_timeline_callback_from_pbuf);
+  factory.register_builder("CallbackTrace",
+                           build_trace_callback_from_pbuf);
   factory.register_builder("CallbackTimer",
                            build_timer_callback_from_pbuf);
   factory.register_builder("CallbackSetWeightsValue",
@@ -404,6 +404,7 @@ std::unique_ptr<Layer> construct_layer_legacy(
       }
       layer->setup_slice_points(params.axis(), slice_points);
     }
+    layer->set_zero_copy(params.zero_copy());
     return layer;
   }
   if (proto_layer.has_gaussian()) {
@@ -34,6 +34,7 @@
 
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace lbann {
@@ -106,6 +107,12 @@ std::vector<OwningLayerPtr> construct_layer_graph(
   // Map from names to layer pointers
   std::unordered_map<std::string, ViewingLayerPtr> names_to_layers;
 
+  // Layers kept in 32-bit in mixed-precision training
+  const auto& mixed_precision = proto_model.mixed_precision();
+  const std::unordered_set<std::string> float_layers(
+    mixed_precision.float_layers().begin(),
+    mixed_precision.float_layers().end());
+
   // Create each layer in prototext
   for (int i=0; i<proto_model.layer_size(); ++i) {
     const auto& proto_layer = proto_model.layer(i);
@@ -149,6 +156,29 @@ std::vector<OwningLayerPtr> construct_layer_graph(
 
     auto proto_datatype = proto_layer.datatype();
 
+    // Store activations in 16-bit for mixed-precision training
+    // Note: Input layers and evaluation layers are kept in 32-bit.
+    // The optimizers keep 32-bit master weights (see model::setup).
+    if (mixed_precision.enabled()
+        && proto_datatype == lbann_data::FLOAT
+        && !proto_layer.has_input()
+        && !proto_layer.has_evaluation()
+        && float_layers.count(name) == 0) {
+#ifndef LBANN_HAS_HALF
+      if (device == El::Device::CPU) {
+        LBANN_ERROR("mixed-precision training on CPU requires "
+                    "LBANN to be built with half-precision support");
+      }
+#endif // LBANN_HAS_HALF
+#ifndef LBANN_HAS_GPU_FP16
+      if (device != El::Device::CPU) {
+        LBANN_ERROR("mixed-precision training on GPU requires "
+                    "LBANN to be built with GPU FP16 support");
+      }
+#endif // LBANN_HAS_GPU_FP16
+      proto_datatype = lbann_data::FP16;
+    }
+
     // Construct layer
     OwningLayerPtr l;
 #define TEMPLATE_INSTANTIATION(TensorDataType, T_layout, T_device)      \
@@ -40,6 +40,7 @@
 #include <iostream>
 #include <map>
 #include <memory>
+#include <set>
 #include <sstream>
 #include <string>
 #include <unordered_map>
@@ -297,6 +298,52 @@ std::unique_ptr<model> construct_model(
   m->set_subgrid_communication_type(proto_model.subgraph_communication());
   m->set_subgrid_topology(proto_model.enable_subgraph_topology());
   m->set_subgraph_num_parent_resources(proto_model.subgraph_parent_grid_resources());
+  if (proto_model.has_gradient_bucketing()) {
+    const auto& params = proto_model.gradient_bucketing();
+    if (params.bucket_size() < 0) {
+      LBANN_ERROR("invalid gradient bucket size (", params.bucket_size(), ")");
+    }
+    m->set_gradient_bucketing(
+      params.bucket_size(),
+      gradient_bucket_order_from_string(params.order()));
+  }
+  m->set_elementwise_operator_fusion(proto_model.fuse_elementwise_operators());
+  m->set_layer_memory_planning(proto_model.plan_layer_memory());
+  if (proto_model.has_activation_recompute()) {
+    const auto& params = proto_model.activation_recompute();
+    if (params.every_n_layers() < 0) {
+      LBANN_ERROR("invalid activation recompute segment length "
+                  "(", params.every_n_layers(), ")");
+    }
+    m->set_activation_recompute(
+      params.every_n_layers(),
+      std::set<std::string>(params.checkpoint_layers().begin(),
+                            params.checkpoint_layers().end()));
+  }
+  if (proto_model.mixed_precision().enabled()) {
+    const auto& params = proto_model.mixed_precision();
+    const auto initial_loss_scale = (params.initial_loss_scale() > 0
+                                     ? params.initial_loss_scale()
+                                     : 65536.);
+    if (params.loss_scale_growth_interval() < 0) {
+      LBANN_ERROR("invalid loss scale growth interval "
+                  "(", params.loss_scale_growth_interval(), ")");
+    }
+    const auto growth_interval = (params.loss_scale_growth_interval() > 0
+                                  ? params.loss_scale_growth_interval()
+                                  : 2000);
+    m->set_mixed_precision(initial_loss_scale,
+                           growth_interval,
+                           !params.static_loss_scale());
+  }
+  if (proto_model.gradient_accumulation_steps() < 0) {
+    LBANN_ERROR("invalid number of gradient accumulation steps "
+                "(", proto_model.gradient_accumulation_steps(), ")");
+  }
+  if (proto_model.gradient_accumulation_steps() > 1) {
+    m->set_gradient_accumulation_steps(
+      proto_model.gradient_accumulation_steps());
+  }
 
   return m;
 
@@ -40,12 +40,20 @@ std::unique_ptr<trainer> construct_trainer(lbann_comm* comm,
                                            const lbann_data::Trainer& proto_trainer) {
 
   auto proto_datatype = proto_trainer.data_coordinator().datatype();
+  const auto proto_prefetch_depth =
+    proto_trainer.data_coordinator().prefetch_depth();
+  if (proto_prefetch_depth < 0) {
+    LBANN_ERROR("invalid data coordinator prefetch depth (",
+                proto_prefetch_depth, ")");
+  }
+  const size_t prefetch_depth =
+    (proto_prefetch_depth > 0 ? proto_prefetch_depth : 1);
   std::unique_ptr<data_coordinator> dc;
 #define TEMPLATE_INSTANTIATION(TensorDataType)                              \
     do {                                                                    \
       if (proto_datatype == TypeToProtoDataType<TensorDataType>::value) {   \
         dc = lbann::make_unique<buffered_data_coordinator<TensorDataType>>( \
-          comm);                                                            \
+          comm, prefetch_depth);                                            \
       }                                                                     \
     } while (0)
 
@@ -170,6 +170,28 @@ std::unique_ptr<weights> construct_weights(
 
   // Set weights initializer and optimizer
   w->set_initializer(std::move(init));
+  if (proto_weights.has_gradient_compression()) {
+    const auto& proto_compression = proto_weights.gradient_compression();
+    gradient_compression_params params;
+    params.type = gradient_compression_type_from_string(
+      proto_compression.type());
+    if (proto_compression.topk_ratio() > 0.) {
+      params.topk_ratio = proto_compression.topk_ratio();
+    }
+    if (proto_compression.quantization_bits() > 0) {
+      params.quantization_bits = proto_compression.quantization_bits();
+    }
+    if (proto_compression.powersgd_rank() > 0) {
+      params.powersgd_rank = proto_compression.powersgd_rank();
+    }
+    if (params.type != gradient_compression_type::none) {
+      if (opt == nullptr) {
+        LBANN_ERROR("weights \"", w->get_name(), "\" has gradient "
+                    "compression but no optimizer");
+      }
+      opt->set_gradient_compression(params);
+    }
+  }
   w->set_optimizer(std::move(opt));
 
   return w;
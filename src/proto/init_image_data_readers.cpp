@@ -33,6 +33,7 @@
 #include "lbann/data_readers/data_reader_jag_conduit.hpp"
 #ifdef LBANN_HAS_OPENCV
 #include "lbann/data_readers/data_reader_imagenet.hpp"
+#include "lbann/data_readers/data_reader_image_shards.hpp"
 #endif // LBANN_HAS_OPENCV
 #include "lbann/data_readers/data_reader_mnist.hpp"
 
@@ -91,6 +92,12 @@ void init_image_data_reader(const lbann_data::Reader& pb_readme, const lbann_dat
     reader = new imagenet_reader(shuffle);
 #else
     LBANN_ERROR("Imagenet reader not supported without OpenCV");
+#endif // LBANN_HAS_OPENCV
+  } else if (name == "image_shards") {
+#ifdef LBANN_HAS_OPENCV
+    reader = new image_shard_reader(shuffle);
+#else
+    LBANN_ERROR("Image shard reader not supported without OpenCV");
 #endif // LBANN_HAS_OPENCV
   } else if (name =="jag_conduit") {
     data_reader_jag_conduit* reader_jag = new data_reader_jag_conduit(shuffle);
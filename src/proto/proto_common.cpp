@@ -105,6 +105,9 @@ void init_data_readers(
       reader->set_data_sample_list(readme.sample_list());
       reader->keep_sample_order(readme.sample_list_keep_order());
       set_transform_pipeline = false;
+    } else if (name == "image_shards") {
+      init_image_data_reader(readme, pb_metadata, master, reader);
+      set_transform_pipeline = false;
     } else if (name == "jag_conduit") {
       init_image_data_reader(readme, pb_metadata, master, reader);
       set_transform_pipeline = false;
@@ -141,6 +144,10 @@ void init_data_readers(
       dr->keep_sample_order(readme.sample_list_keep_order());
       dr->set_experiment_schema_filename(readme.experiment_schema_filename());
       dr->set_data_schema_filename(readme.data_schema_filename());
+      dr->set_batched_reads(readme.hdf5_batched_reads());
+      dr->set_read_block_size(readme.hdf5_read_block_size());
+      dr->set_chunk_cache(readme.hdf5_chunk_cache_bytes(),
+                          readme.hdf5_chunk_cache_slots());
       dr->set_has_labels(readme.enable_labels());
       dr->set_has_responses(readme.enable_responses());
       reader = dr;
@@ -503,6 +510,12 @@ void init_data_readers(
             split_reader = new imagenet_reader(*dynamic_cast<const imagenet_reader*>(reader));
 #else
             LBANN_ERROR("imagenet reader not supported without OpenCV.");
+#endif // LBANN_HAS_OPENCV
+          } else if (name == "image_shards") {
+#ifdef LBANN_HAS_OPENCV
+            split_reader = new image_shard_reader(*dynamic_cast<const image_shard_reader*>(reader));
+#else
+            LBANN_ERROR("image shard reader not supported without OpenCV.");
 #endif // LBANN_HAS_OPENCV
           } else if (name == "smiles") {
             split_reader = new smiles_data_reader(*dynamic_cast<const smiles_data_reader*>(reader));
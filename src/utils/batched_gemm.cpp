@@ -0,0 +1,191 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#define LBANN_UTILS_BATCHED_GEMM_INSTANTIATE
+#include "lbann/utils/batched_gemm.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/omp_pragma.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace lbann {
+
+namespace {
+
+/** @brief Largest product (m*n*k) computed with the in-house kernel.
+ *  @details Above this, BLAS overhead is negligible compared to the
+ *  flops and its blocking pays off.
+ */
+constexpr El::Int small_gemm_max_flops = 96 * 96 * 96;
+
+/** @brief Largest op(A) (m*k) packed by the in-house kernel.
+ *  @details op(A) is streamed once per column of C, so it should stay
+ *  in L2 cache.
+ */
+constexpr El::Int small_gemm_max_packed_size = 32 * 1024;
+
+/** @brief C = alpha op(A) op(B) + beta C for one small product.
+ *
+ *  op(A) is packed into a contiguous m x k column-major buffer
+ *  (unless A already has that layout). Each column of C is then
+ *  accumulated as a sum of scaled columns of op(A), with unit-stride
+ *  inner loops that the compiler can vectorize.
+ */
+template <typename TensorDataType>
+void small_gemm(El::Orientation transA,
+                El::Orientation transB,
+                El::Int m, El::Int n, El::Int k,
+                TensorDataType alpha,
+                const TensorDataType* __restrict__ A, El::Int lda,
+                const TensorDataType* __restrict__ B, El::Int ldb,
+                TensorDataType beta,
+                TensorDataType* __restrict__ C, El::Int ldc,
+                TensorDataType* __restrict__ workspace) {
+  using T = TensorDataType;
+  const T zero = El::TypeTraits<T>::Zero();
+  const T one = El::TypeTraits<T>::One();
+
+  // Pack op(A)
+  const T* __restrict__ a = A;
+  if (transA != El::NORMAL) {
+    for (El::Int p = 0; p < k; ++p) {
+      for (El::Int i = 0; i < m; ++i) {
+        workspace[i + p * m] = A[p + i * lda];
+      }
+    }
+    a = workspace;
+  }
+  else if (lda != m) {
+    for (El::Int p = 0; p < k; ++p) {
+      std::copy(A + p * lda, A + p * lda + m, workspace + p * m);
+    }
+    a = workspace;
+  }
+
+  // Accumulate columns of C
+  for (El::Int j = 0; j < n; ++j) {
+    T* __restrict__ c = C + j * ldc;
+    if (beta == zero) {
+      std::fill(c, c + m, zero);
+    }
+    else if (beta != one) {
+      for (El::Int i = 0; i < m; ++i) { c[i] *= beta; }
+    }
+    for (El::Int p = 0; p < k; ++p) {
+      const T b = alpha * (transB == El::NORMAL
+                           ? B[p + j * ldb]
+                           : B[j + p * ldb]);
+      const T* __restrict__ a_col = a + p * m;
+      for (El::Int i = 0; i < m; ++i) {
+        c[i] += a_col[i] * b;
+      }
+    }
+  }
+
+}
+
+} // namespace
+
+bool use_small_gemm_kernel(El::Int m, El::Int n, El::Int k) noexcept {
+  return (m * n * k <= small_gemm_max_flops
+          && m * k <= small_gemm_max_packed_size);
+}
+
+template <typename TensorDataType>
+void gemm_strided_batched(El::Orientation transA,
+                          El::Orientation transB,
+                          El::Int m, El::Int n, El::Int k,
+                          TensorDataType alpha,
+                          const TensorDataType* A,
+                          El::Int lda, El::Int stride_A,
+                          const TensorDataType* B,
+                          El::Int ldb, El::Int stride_B,
+                          TensorDataType beta,
+                          TensorDataType* C,
+                          El::Int ldc, El::Int stride_C,
+                          El::Int batch_count) {
+  using LocalMat = El::Matrix<TensorDataType, El::Device::CPU>;
+  if (transA == El::ADJOINT || transB == El::ADJOINT) {
+    LBANN_ERROR("batched GEMM does not support adjoint operands");
+  }
+  if (m <= 0 || n <= 0 || batch_count <= 0) { return; }
+
+  // Operand dimensions
+  const El::Int A_height = (transA == El::NORMAL ? m : k);
+  const El::Int A_width = (transA == El::NORMAL ? k : m);
+  const El::Int B_height = (transB == El::NORMAL ? k : n);
+  const El::Int B_width = (transB == El::NORMAL ? n : k);
+
+  if (use_small_gemm_kernel(m, n, k)) {
+    // Small products: in-house kernel, parallel over batch
+    const El::Int workspace_size = m * k;
+    std::vector<TensorDataType> workspace(
+      workspace_size * omp_get_max_threads());
+    LBANN_OMP_PARALLEL_FOR
+    for (El::Int i = 0; i < batch_count; ++i) {
+      auto* thread_workspace = (workspace.data()
+                                + workspace_size * omp_get_thread_num());
+      small_gemm(transA, transB, m, n, k,
+                 alpha,
+                 A + i * stride_A, lda,
+                 B + i * stride_B, ldb,
+                 beta,
+                 C + i * stride_C, ldc,
+                 thread_workspace);
+    }
+  }
+  else {
+    // Large products: one BLAS call per product. Parallelize over
+    // the batch only if it can occupy every thread, otherwise let
+    // BLAS use the threads.
+    auto gemm = [&](El::Int i) {
+      LocalMat A_v, B_v, C_v;
+      A_v.LockedAttach(A_height, A_width, A + i * stride_A, lda);
+      B_v.LockedAttach(B_height, B_width, B + i * stride_B, ldb);
+      C_v.Attach(m, n, C + i * stride_C, ldc);
+      El::Gemm(transA, transB, alpha, A_v, B_v, beta, C_v);
+    };
+    if (batch_count >= omp_get_max_threads()) {
+      LBANN_OMP_PARALLEL_FOR
+      for (El::Int i = 0; i < batch_count; ++i) { gemm(i); }
+    }
+    else {
+      for (El::Int i = 0; i < batch_count; ++i) { gemm(i); }
+    }
+  }
+
+}
+
+#define PROTO(T)                                                        \
+  template void gemm_strided_batched<T>(                                \
+    El::Orientation, El::Orientation, El::Int, El::Int, El::Int,        \
+    T, const T*, El::Int, El::Int, const T*, El::Int, El::Int,          \
+    T, T*, El::Int, El::Int, El::Int)
+
+#include "lbann/macros/instantiate.hpp"
+
+} // namespace lbann
@@ -369,6 +369,210 @@ void col2im(const CPUMatDT<TensorDataType>& col,
 }
 
 
+namespace {
+
+/** Window positions and offsets for batched im2col and col2im. */
+struct im2col_geometry {
+  std::vector<int> offset_start;
+  std::vector<int> offset_stride;
+  std::vector<int> offset_num;
+  /** Total number of window offsets. */
+  int num_offsets;
+  /** Number of entries in window. */
+  int window_size;
+  /** Number of spatial positions in im tensor. */
+  int spatial_size;
+  /** Dilated window position for each window entry, in row-major
+   *  window_size x im_num_dims order. */
+  std::vector<int> window_pos;
+  /** Position of each window offset, in row-major num_offsets x
+   *  im_num_dims order. */
+  std::vector<int> offset_pos;
+};
+
+im2col_geometry get_im2col_geometry(const int im_num_dims,
+                                    const int * im_dims,
+                                    const int * im_pads,
+                                    const int * window_dims,
+                                    const int * window_strides,
+                                    const int * window_dilations) {
+  im2col_geometry geom;
+  geom.offset_start.resize(im_num_dims);
+  geom.offset_stride.resize(im_num_dims);
+  geom.offset_num.resize(im_num_dims);
+  geom.num_offsets = 1;
+  geom.window_size = 1;
+  geom.spatial_size = 1;
+  for(int d = 0; d < im_num_dims; ++d) {
+    const int dilated_window_dim = (window_dims[d] - 1) * window_dilations[d] + 1;
+    const int offset_end = im_dims[d] + im_pads[d] - dilated_window_dim + 1;
+    geom.offset_start[d] = -im_pads[d];
+    geom.offset_stride[d] = window_strides[d];
+    geom.offset_num[d] = std::max((offset_end - geom.offset_start[d] + window_strides[d] - 1) / window_strides[d], 0);
+    geom.num_offsets *= geom.offset_num[d];
+    geom.window_size *= window_dims[d];
+    geom.spatial_size *= im_dims[d];
+  }
+  geom.window_pos.resize(geom.window_size * im_num_dims);
+  for(int w = 0; w < geom.window_size; ++w) {
+    int remainder = w;
+    for(int d = im_num_dims-1; d >= 0; --d) {
+      geom.window_pos[d + w * im_num_dims] = (remainder % window_dims[d]) * window_dilations[d];
+      remainder /= window_dims[d];
+    }
+  }
+  geom.offset_pos.resize(geom.num_offsets * im_num_dims);
+  for(int offset = 0; offset < geom.num_offsets; ++offset) {
+    int remainder = offset;
+    for(int d = im_num_dims-1; d >= 0; --d) {
+      geom.offset_pos[d + offset * im_num_dims]
+        = geom.offset_start[d] + (remainder % geom.offset_num[d]) * geom.offset_stride[d];
+      remainder /= geom.offset_num[d];
+    }
+  }
+  return geom;
+}
+
+} // namespace <anon>
+
+template <typename TensorDataType>
+void im2col_batched(const CPUMatDT<TensorDataType>& im,
+                    CPUMatDT<TensorDataType>& col,
+                    const int num_channels,
+                    const int im_num_dims,
+                    const int * im_dims,
+                    const int * im_pads,
+                    const int * window_dims,
+                    const int * window_strides,
+                    const int * window_dilations) {
+
+  // im2col parameters
+  const auto geom = get_im2col_geometry(im_num_dims, im_dims, im_pads,
+                                        window_dims, window_strides,
+                                        window_dilations);
+  const El::Int num_samples = im.Width();
+  const El::Int col_height = num_channels * geom.window_size;
+  const El::Int num_offsets = geom.num_offsets;
+  if(im.Height() != num_channels * geom.spatial_size
+     || col.Height() != col_height
+     || col.Width() != num_offsets * num_samples) {
+    LBANN_ERROR("im2col_batched: invalid matrix dimensions "
+                "(im is ", im.Height(), " x ", im.Width(), ", "
+                "col is ", col.Height(), " x ", col.Width(), ", "
+                "expected ", num_channels * geom.spatial_size, " x ", num_samples,
+                " and ", col_height, " x ", num_offsets * num_samples, ")");
+  }
+
+  // Input and output parameters
+  const TensorDataType *__restrict__ im_buffer = im.LockedBuffer();
+  TensorDataType *__restrict__ col_buffer = col.Buffer();
+  const El::Int im_ldim = im.LDim();
+  const El::Int col_ldim = col.LDim();
+  const int *__restrict__ window_pos = geom.window_pos.data();
+  const int *__restrict__ offset_pos = geom.offset_pos.data();
+
+  // Iterate through col matrix columns
+  LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+  for(El::Int sample = 0; sample < num_samples; ++sample) {
+    for(El::Int offset = 0; offset < num_offsets; ++offset) {
+      const auto* im_sample = &im_buffer[sample * im_ldim];
+      auto* col_col = &col_buffer[(offset + sample * num_offsets) * col_ldim];
+      const auto* pos = &offset_pos[offset * im_num_dims];
+      for(El::Int col_row = 0; col_row < col_height; ++col_row) {
+        const int channel = col_row / geom.window_size;
+        const auto* wpos = &window_pos[(col_row % geom.window_size) * im_num_dims];
+        bool im_pos_valid = true;
+        int im_index = channel;
+        for(int d = 0; d < im_num_dims; ++d) {
+          const int im_pos = pos[d] + wpos[d];
+          im_pos_valid = im_pos_valid && 0 <= im_pos && im_pos < im_dims[d];
+          im_index = im_pos + im_index * im_dims[d];
+        }
+        col_col[col_row] = (im_pos_valid ?
+                            im_sample[im_index] : TensorDataType(0.));
+      }
+    }
+  }
+
+}
+
+template <typename TensorDataType>
+void col2im_batched(const CPUMatDT<TensorDataType>& col,
+                    CPUMatDT<TensorDataType>& im,
+                    const int num_channels,
+                    const int im_num_dims,
+                    const int * im_dims,
+                    const int * im_pads,
+                    const int * window_dims,
+                    const int * window_strides,
+                    const int * window_dilations) {
+
+  // col2im parameters
+  const auto geom = get_im2col_geometry(im_num_dims, im_dims, im_pads,
+                                        window_dims, window_strides,
+                                        window_dilations);
+  const El::Int num_samples = im.Width();
+  const El::Int col_height = num_channels * geom.window_size;
+  const El::Int num_offsets = geom.num_offsets;
+  const El::Int spatial_size = geom.spatial_size;
+  if(im.Height() != num_channels * spatial_size
+     || col.Height() != col_height
+     || col.Width() != num_offsets * num_samples) {
+    LBANN_ERROR("col2im_batched: invalid matrix dimensions "
+                "(col is ", col.Height(), " x ", col.Width(), ", "
+                "im is ", im.Height(), " x ", im.Width(), ", "
+                "expected ", col_height, " x ", num_offsets * num_samples,
+                " and ", num_channels * spatial_size, " x ", num_samples, ")");
+  }
+
+  // Input and output parameters
+  const TensorDataType *__restrict__ col_buffer = col.LockedBuffer();
+  TensorDataType *__restrict__ im_buffer = im.Buffer();
+  const El::Int col_ldim = col.LDim();
+  const El::Int im_ldim = im.LDim();
+  const int *__restrict__ window_pos = geom.window_pos.data();
+  const int *__restrict__ offset_start = geom.offset_start.data();
+  const int *__restrict__ offset_stride = geom.offset_stride.data();
+  const int *__restrict__ offset_num = geom.offset_num.data();
+
+  // Iterate through im matrix entries
+  // Note: Each entry gathers contributions from the window offsets
+  // that contain it, so there are no write conflicts.
+  LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+  for(El::Int sample = 0; sample < num_samples; ++sample) {
+    for(El::Int channel = 0; channel < num_channels; ++channel) {
+      const auto* col_sample = &col_buffer[sample * num_offsets * col_ldim];
+      auto* im_channel = &im_buffer[channel * spatial_size + sample * im_ldim];
+      for(El::Int spatial_index = 0; spatial_index < spatial_size; ++spatial_index) {
+        auto im_entry = El::TypeTraits<TensorDataType>::Zero();
+        for(int w = 0; w < geom.window_size; ++w) {
+          const auto* wpos = &window_pos[w * im_num_dims];
+          bool offset_valid = true;
+          int remainder = spatial_index;
+          int stride_prod = spatial_size;
+          int col_col = 0;
+          for(int d = 0; d < im_num_dims && offset_valid; ++d) {
+            stride_prod /= im_dims[d];
+            const int im_pos = remainder / stride_prod;
+            remainder %= stride_prod;
+            const int shift = im_pos - offset_start[d] - wpos[d];
+            offset_valid = (shift >= 0
+                            && shift % offset_stride[d] == 0
+                            && shift / offset_stride[d] < offset_num[d]);
+            col_col = shift / offset_stride[d] + col_col * offset_num[d];
+          }
+          if(offset_valid) {
+            const int col_row = w + channel * geom.window_size;
+            im_entry += col_sample[col_row + col_col * col_ldim];
+          }
+        }
+        im_channel[spatial_index] = im_entry;
+      }
+    }
+  }
+
+}
+
 template <typename TensorDataType>
 void im2col_1x1(const TensorDataType * __restrict__ input_buffer,
                 TensorDataType * __restrict__ output_buffer,
@@ -600,6 +804,16 @@ std::pair<size_t, size_t> get_im2col_output_size(
     const int*, const int*,                                         \
     const int*, const int*,                                         \
     std::function<T(T const&, T const&)>);                          \
+  template void im2col_batched<T>(                                  \
+    const CPUMatDT<T>&, CPUMatDT<T>&,                               \
+    int, int,                                                       \
+    const int*, const int*,                                         \
+    const int*, const int*, const int*);                            \
+  template void col2im_batched<T>(                                  \
+    const CPUMatDT<T>&, CPUMatDT<T>&,                               \
+    int, int,                                                       \
+    const int*, const int*,                                         \
+    const int*, const int*, const int*);                            \
   template void im2col_1x1<T>(                                      \
     const T*, T*, int, int, const int*);                            \
   template void im2col_2d(                                          \
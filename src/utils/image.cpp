@@ -26,6 +26,10 @@
 
 #include <stdio.h>
 #include <arpa/inet.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include <opencv2/imgcodecs.hpp>
 #include "lbann/utils/image.hpp"
 #include "lbann/utils/exception.hpp"
@@ -60,6 +64,68 @@ void read_file_to_buf(const std::string& filename, El::Matrix<uint8_t>& buf,
   fclose(f);
 }
 
+// Read an open file into buf and close it.
+void read_fd_to_buf(int fd, const std::string& filename,
+                    El::Matrix<uint8_t>& buf, size_t& size) {
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    LBANN_ERROR("Could not stat file " + filename);
+  }
+  size = static_cast<size_t>(st.st_size);
+  buf.Resize(size, 1);
+  size_t offset = 0;
+  while (offset < size) {
+    const ssize_t n = pread(fd, buf.Buffer() + offset, size - offset, offset);
+    if (n <= 0) {
+      close(fd);
+      LBANN_ERROR("Could not read file " + filename);
+    }
+    offset += static_cast<size_t>(n);
+  }
+  close(fd);
+}
+
+// Read-only memory map of a file. Unmapped on destruction.
+class mapped_file {
+public:
+  // Takes ownership of fd.
+  mapped_file(int fd, const std::string& filename) {
+    if (fd == -1) {
+      LBANN_ERROR("Could not open file " + filename);
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+      close(fd);
+      LBANN_ERROR("Could not stat file " + filename);
+    }
+    m_size = static_cast<size_t>(st.st_size);
+    if (m_size == 0) {
+      close(fd);
+      LBANN_ERROR("Empty image file " + filename);
+    }
+    m_data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping stays valid after the descriptor is closed
+    close(fd);
+    if (m_data == MAP_FAILED) {
+      LBANN_ERROR("Could not memory-map file " + filename);
+    }
+    // The decoder reads the whole file front to back
+    madvise(m_data, m_size, MADV_SEQUENTIAL);
+    madvise(m_data, m_size, MADV_WILLNEED);
+  }
+  ~mapped_file() { munmap(m_data, m_size); }
+  mapped_file(const mapped_file&) = delete;
+  mapped_file& operator=(const mapped_file&) = delete;
+
+  uint8_t* data() const { return static_cast<uint8_t*>(m_data); }
+  size_t size() const { return m_size; }
+
+private:
+  void* m_data = nullptr;
+  size_t m_size = 0;
+};
+
 // There are other SOFs, but these are the common ones.
 const bool is_jpg_sof[16] = {
   true, true, true, true, false, true, true, true,
@@ -191,6 +257,42 @@ void load_image(const std::string& filename, El::Matrix<uint8_t>& dst,
   opencv_decode(buf, dst, dims, filename);
 }
 
+void load_image(int fd, const std::string& filename,
+                El::Matrix<uint8_t>& dst, std::vector<size_t>& dims) {
+  if (fd == -1) {
+    LBANN_ERROR("Could not open file " + filename);
+  }
+  El::Matrix<uint8_t> buf;
+  size_t encoded_size;
+  read_fd_to_buf(fd, filename, buf, encoded_size);
+  opencv_decode(buf, dst, dims, filename);
+}
+
+void load_image_mmap(const std::string& filename, El::Matrix<uint8_t>& dst,
+                     std::vector<size_t>& dims) {
+  load_image_mmap(open(filename.c_str(), O_RDONLY), filename, dst, dims);
+}
+
+void load_image_mmap(int fd, const std::string& filename,
+                     El::Matrix<uint8_t>& dst, std::vector<size_t>& dims) {
+  mapped_file file(fd, filename);
+  // The mapping is read-only, but the decoder never writes to the
+  // encoded buffer.
+  El::Matrix<uint8_t> buf;
+  buf.Attach(file.size(), 1, file.data(), file.size());
+  opencv_decode(buf, dst, dims, filename);
+}
+
+int prefetch_image_file(const std::string& filename) {
+  const int fd = open(filename.c_str(), O_RDONLY);
+#ifdef POSIX_FADV_WILLNEED
+  if (fd != -1) {
+    posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+  }
+#endif // POSIX_FADV_WILLNEED
+  return fd;
+}
+
 void decode_image(El::Matrix<uint8_t>& src, El::Matrix<uint8_t>& dst,
                   std::vector<size_t>& dims) {
   opencv_decode(src, dst, dims, "encoded image");
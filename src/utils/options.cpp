@@ -87,6 +87,11 @@ void construct_std_options()
   arg_parser.add_flag(USE_DATA_STORE,
                       {"--use_data_store"},
                       "[STD] Enables the data store in-memory structure");
+  arg_parser.add_flag(USE_NATIVE_CPU_GRU,
+                      {"--use_native_cpu_gru"},
+                      utils::ENV("LBANN_USE_NATIVE_CPU_GRU"),
+                      "[STD] Use the native CPU implementation of the GRU "
+                      "layer even if oneDNN is available");
   arg_parser.add_flag(USE_LTFB, {"--ltfb"}, "[STD] TODO");
   arg_parser.add_flag(VERBOSE,
                       {"--verbose", "--verbose_print"},
@@ -223,6 +228,11 @@ void construct_datastore_options()
   arg_parser.add_flag(DATA_STORE_CACHE,
                       {"--data_store_cache"},
                       "[DATASTORE] TODO");
+  arg_parser.add_flag(DATA_STORE_COMPRESS,
+                      {"--data_store_compress"},
+                      "[DATASTORE] Losslessly compress samples held and "
+                      "exchanged by the data store; they are decompressed "
+                      "by the I/O threads when fetched");
   arg_parser.add_flag(DATA_STORE_DEBUG,
                       {"--data_store_debug"},
                       "[DATASTORE] TODO");
@@ -251,6 +261,25 @@ void construct_datastore_options()
                         {"--data_store_test_checkpoint"},
                         "[DATASTORE] TODO",
                         "");
+  arg_parser.add_option(DATA_STORE_TIERED_CACHE,
+                        {"--data_store_tiered_cache"},
+                        "[DATASTORE] Directory, ideally on node-local "
+                        "storage, for samples evicted from memory when "
+                        "the data store exceeds --data_store_memory_budget",
+                        "");
+  arg_parser.add_option(DATA_STORE_MEMORY_BUDGET,
+                        {"--data_store_memory_budget"},
+                        "[DATASTORE] Memory budget per rank, in MB, for "
+                        "samples held by the data store with "
+                        "--data_store_tiered_cache",
+                        0);
+  arg_parser.add_option(DATA_STORE_LOCALITY,
+                        {"--data_store_locality"},
+                        "[DATASTORE] Fraction, in [0,1], of mini-batch "
+                        "slots that are filled with a sample owned by the "
+                        "rank that consumes it; higher values reduce data "
+                        "store exchange traffic at the cost of randomness",
+                        (float)0);
 }
 
 void construct_datareader_options()
@@ -277,6 +306,10 @@ void construct_datareader_options()
   arg_parser.add_flag(GENERATE_MULTI_PROTO,
                       {"--generate_multi_proto"},
                       "[DATAREADER] TODO");
+  arg_parser.add_flag(IMAGE_MMAP,
+                      {"--image_mmap"},
+                      "[DATAREADER] Memory-map image files and decode them "
+                      "from the page cache");
   arg_parser.add_flag(KEEP_SAMPLE_ORDER,
                       {"--keep_sample_order"},
                       "[DATAREADER] TODO");
@@ -341,6 +374,11 @@ void construct_datareader_options()
                         "[DATAREADER] TODO",
                         (float)-1);
   arg_parser.add_option(DELIMITER, {"--delimiter"}, "[DATAREADER] TODO", "");
+  arg_parser.add_option(IMAGE_READAHEAD,
+                        {"--image_readahead"},
+                        "[DATAREADER] Number of mini-batches ahead in the "
+                        "shuffled order to prefetch image files for",
+                        0);
   arg_parser.add_option(IMAGE_SIZES_FILENAME,
                         {"--image_sizes_filename"},
                         "[DATAREADER] TODO",
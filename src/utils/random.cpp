@@ -29,11 +29,126 @@
 #include "lbann/utils/random.hpp"
 #include "lbann/io/file_io.hpp"
 #include "lbann/utils/hash.hpp"
+#include "lbann/utils/philox.hpp"
 #include <thread>
+#include <vector>
 
 
 namespace lbann {
 
+namespace {
+
+/** @brief Type used to generate random values for a tensor type.
+ *  @details Random values for half-precision tensors are generated in
+ *  single precision.
+ */
+#if defined(LBANN_HAS_GPU_FP16) && defined(LBANN_HAS_HALF)
+template <typename TensorDataType>
+using rand_data_type = typename std::conditional<
+  El::Or<std::is_same<TensorDataType,cpu_fp16>,
+         std::is_same<TensorDataType,fp16>>::value,
+  float, TensorDataType>::type;
+#elif defined(LBANN_HAS_GPU_FP16)
+template <typename TensorDataType>
+using rand_data_type = typename std::conditional<
+  std::is_same<TensorDataType,fp16>::value,
+  float, TensorDataType>::type;
+#elif defined(LBANN_HAS_HALF)
+template <typename TensorDataType>
+using rand_data_type = typename std::conditional<
+  std::is_same<TensorDataType,cpu_fp16>::value,
+  float, TensorDataType>::type;
+#else
+template <typename TensorDataType>
+using rand_data_type = TensorDataType;
+#endif // LBANN_HAS_GPU_FP16
+
+/** @brief Key for a counter-based random fill.
+ *  @details Drawn from the generator of the grid's root process and
+ *  broadcast, so that every process in the grid uses the same random
+ *  stream.
+ */
+uint64_t get_fill_key(El::Grid const& grid) {
+  uint64_t key = 0;
+  if (!grid.InGrid()) {
+    return key;
+  }
+  if (grid.Rank() == 0) {
+    auto& gen = get_generator();
+    key = (uint64_t(gen()) << 32) | uint64_t(gen());
+  }
+  El::mpi::Broadcast<El::byte>(reinterpret_cast<El::byte*>(&key),
+                               sizeof(key),
+                               0,
+                               grid.Comm(),
+                               El::SyncInfo<El::Device::CPU>{});
+  return key;
+}
+
+/** @brief Fill a matrix from a counter-based random stream.
+ *
+ *  Entry (i,j) of the global m x n matrix is computed from entry
+ *  i+j*m of a Philox stream, so every process and thread can
+ *  generate its local entries independently and the result does not
+ *  depend on the matrix distribution.
+ *
+ *  @param sample Maps a Philox output to a random value.
+ */
+template <typename TensorDataType, typename RandDataType, typename Sampler>
+void counter_based_fill(El::AbstractDistMatrix<TensorDataType>& mat,
+                        El::Int m,
+                        El::Int n,
+                        Sampler const& sample) {
+
+  // Every process needs the key, even if it has no local data
+  const uint64_t key = get_fill_key(mat.Grid());
+  mat.Resize(m, n);
+  if (mat.LockedMatrix().IsEmpty()) {
+    return;
+  }
+
+  // Generate directly into the local matrix if possible
+  using LocalMatType = El::Matrix<RandDataType, El::Device::CPU>;
+  LocalMatType local_vals;
+  if constexpr (std::is_same<TensorDataType,RandDataType>::value) {
+    if (mat.GetLocalDevice() == El::Device::CPU) {
+      El::View(local_vals, static_cast<LocalMatType&>(mat.Matrix()));
+    }
+  }
+  if (!local_vals.Viewing()) {
+    local_vals.Resize(mat.LocalHeight(), mat.LocalWidth());
+  }
+
+  // Global indices of local entries
+  const El::Int local_height = local_vals.Height();
+  const El::Int local_width = local_vals.Width();
+  std::vector<uint64_t> row_offsets(local_height), col_offsets(local_width);
+  for (El::Int i = 0; i < local_height; ++i) {
+    row_offsets[i] = mat.GlobalRow(i);
+  }
+  for (El::Int j = 0; j < local_width; ++j) {
+    col_offsets[j] = uint64_t(mat.GlobalCol(j)) * uint64_t(m);
+  }
+
+  auto* __restrict__ buffer = local_vals.Buffer();
+  const El::Int ldim = local_vals.LDim();
+  LBANN_OMP_PARALLEL_FOR_ARGS(collapse(2))
+  for (El::Int j = 0; j < local_width; ++j) {
+    for (El::Int i = 0; i < local_height; ++i) {
+      const uint64_t index = row_offsets[i] + col_offsets[j];
+      buffer[i + j * ldim] = sample(philox4x32::generate(key, index));
+    }
+  }
+
+  // Copy to output matrix if needed
+  if (!local_vals.Viewing()) {
+    El::Copy(local_vals, mat.Matrix());
+  }
+
+}
+
+} // namespace
+
 bool save_rng_to_checkpoint(persist& p, lbann_comm* comm, bool is_distributed) {
   std::string dirname = std::string(p.m_checkpoint_dir) + "/rng_state";
   std::string rank_in_trainer;
@@ -253,87 +368,40 @@ void uniform_fill(El::AbstractDistMatrix<TensorDataType>& mat, El::Int m, El::In
 template <typename TensorDataType>
 void gaussian_fill_procdet(El::AbstractDistMatrix<TensorDataType>& mat, El::Int m, El::Int n,
                            TensorDataType mean, TensorDataType stddev) {
-#if defined(LBANN_HAS_GPU_FP16) && defined(LBANN_HAS_HALF)
-  using RandDataType = typename std::conditional<
-    El::Or<std::is_same<TensorDataType,cpu_fp16>,
-           std::is_same<TensorDataType,fp16>>::value,
-    float, TensorDataType>::type;
-#elif defined(LBANN_HAS_GPU_FP16)
-  using RandDataType = typename std::conditional<
-    std::is_same<TensorDataType,fp16>::value,
-    float, TensorDataType>::type;
-#elif defined(LBANN_HAS_HALF)
-  using RandDataType = typename std::conditional<
-    std::is_same<TensorDataType,cpu_fp16>::value,
-    float, TensorDataType>::type;
-#else
-  using RandDataType = TensorDataType;
-#endif // LBANN_HAS_GPU_FP16
-
-  using CircMatType = El::DistMatrix<
-    RandDataType, El::CIRC, El::CIRC, El::ELEMENT, El::Device::CPU>;
-  CircMatType vals(m, n, mat.Grid(), 0);
-  if (vals.Participating()) {
-    auto* __restrict__ buffer = vals.Buffer(); // Should be contiguous
-    const size_t size = vals.LocalHeight() * vals.LocalWidth();
-    std::normal_distribution<RandDataType> dist(mean, stddev);
-    auto& gen = get_generator();
-    for (size_t i=0; i<size; ++i) {
-      buffer[i] = dist(gen);
-    }
-  }
-  El::Copy(vals, mat);
+  using RandDataType = rand_data_type<TensorDataType>;
+  const auto mean_ = static_cast<double>(static_cast<RandDataType>(mean));
+  const auto stddev_ = static_cast<double>(static_cast<RandDataType>(stddev));
+  counter_based_fill<TensorDataType, RandDataType>(
+    mat, m, n,
+    [mean_, stddev_](philox4x32::counter_type const& x) {
+      return static_cast<RandDataType>(mean_ + stddev_ * philox_normal(x));
+    });
 }
 
 template <typename TensorDataType>
 void bernoulli_fill_procdet(El::AbstractDistMatrix<TensorDataType>& mat, El::Int m, El::Int n, double p) {
-  CircMatDT<TensorDataType, El::Device::CPU> vals(m, n, mat.Grid(), 0);
-  if (vals.Participating()) {
-    auto& local_vals = vals.Matrix();
-    auto& gen = get_generator();
-    std::bernoulli_distribution dist(p);
-    for (El::Int col = 0; col < local_vals.Width(); ++col) {
-      for (El::Int row = 0; row < local_vals.Height(); ++row) {
-        local_vals(row, col) = El::To<TensorDataType>(dist(gen));
-      }
-    }
-  }
-  El::Copy(vals, mat);
+  using RandDataType = rand_data_type<TensorDataType>;
+  counter_based_fill<TensorDataType, RandDataType>(
+    mat, m, n,
+    [p](philox4x32::counter_type const& x) {
+      return (philox_uniform_double(x[0], x[1]) < p
+              ? RandDataType(1)
+              : RandDataType(0));
+    });
 }
 
 template <typename TensorDataType>
 void uniform_fill_procdet(El::AbstractDistMatrix<TensorDataType>& mat, El::Int m, El::Int n,
                           TensorDataType center, TensorDataType radius) {
-#if defined(LBANN_HAS_GPU_FP16) && defined(LBANN_HAS_HALF)
-  using RandDataType = typename std::conditional<
-    El::Or<std::is_same<TensorDataType,cpu_fp16>,
-           std::is_same<TensorDataType,fp16>>::value,
-    float, TensorDataType>::type;
-#elif defined(LBANN_HAS_GPU_FP16)
-  using RandDataType = typename std::conditional<
-    std::is_same<TensorDataType,fp16>::value,
-    float, TensorDataType>::type;
-#elif defined(LBANN_HAS_HALF)
-  using RandDataType = typename std::conditional<
-    std::is_same<TensorDataType,cpu_fp16>::value,
-    float, TensorDataType>::type;
-#else
-  using RandDataType = TensorDataType;
-#endif // LBANN_HAS_GPU_FP16
-
-  CircMatDT<RandDataType, El::Device::CPU> vals(m, n, mat.Grid(), 0);
-  if (vals.Participating()) {
-    auto& local_vals = vals.Matrix();
-    auto& gen = get_generator();
-    std::uniform_real_distribution<RandDataType> dist(center - radius,
-                                                      center + radius);
-    for (El::Int col = 0; col < local_vals.Width(); ++col) {
-      for (El::Int row = 0; row < local_vals.Height(); ++row) {
-        local_vals(row, col) = dist(gen);
-      }
-    }
-  }
-  El::Copy(vals, mat);
+  using RandDataType = rand_data_type<TensorDataType>;
+  const auto min = static_cast<double>(static_cast<RandDataType>(center - radius));
+  const auto range = 2 * static_cast<double>(static_cast<RandDataType>(radius));
+  counter_based_fill<TensorDataType, RandDataType>(
+    mat, m, n,
+    [min, range](philox4x32::counter_type const& x) {
+      return static_cast<RandDataType>(
+        min + range * philox_uniform_double(x[0], x[1]));
+    });
 }
 
 template <typename TensorDataType>
@@ -37,9 +37,18 @@ void check_hwloc_api_version() {
 
 namespace lbann {
 
+namespace {
+/** @brief Pool that owns the calling thread, if any */
+thread_local thread_pool const* local_thread_pool = nullptr;
+/** @brief Pool id of the calling thread */
+thread_local int local_thread_id = -1;
+} // namespace
+
 thread_pool::thread_pool()
   : thread_joiner_{threads_},
     all_work_done_{false},
+    m_num_pending_jobs{0},
+    m_num_stolen_jobs{0},
     m_threads_offset{0}
 {
 }
@@ -54,12 +63,16 @@ thread_pool::thread_pool(size_type max_threads)
 void thread_pool::launch_threads(size_type num_threads)
 {
   threads_.reserve(num_threads);
+  for (size_type cnt = 0; cnt < num_threads; ++cnt) {
+    m_local_queues.emplace_back(
+      make_unique<work_stealing_queue<type_erased_function>>());
+  }
 
   // Try to launch each worker thread
   try
   {
     for (size_type cnt = 0; cnt < num_threads; ++cnt) {
-      threads_.emplace_back(&thread_pool::do_thread_work_,this);
+      threads_.emplace_back(&thread_pool::do_thread_work_, this, cnt);
     }
   }
   catch(...)
@@ -86,7 +99,10 @@ void thread_pool::launch_pinned_threads(
 #if defined(LBANN_TOPO_AWARE)
   threads_.reserve(num_threads);
   m_work_group.reserve(num_threads);
-  m_thread_id_to_local_id_map.reserve(num_threads);
+  for (size_type cnt = 0; cnt < num_threads; ++cnt) {
+    m_local_queues.emplace_back(
+      make_unique<work_stealing_queue<type_erased_function>>());
+  }
 
   hwloc_topology_t topo;
   int err;
@@ -154,19 +170,20 @@ void thread_pool::reap_threads() {
   if (this->get_num_threads() == 0) {
     return;
   }
-  all_work_done_ = true;
-  do {
-    global_work_queue_.wake_all(true);
-  }while(!global_work_queue_.empty());
+  // Workers drain all queued jobs before exiting
+  {
+    std::lock_guard<std::mutex> lk(m_wake_mutex);
+    all_work_done_ = true;
+  }
+  m_wake.notify_all();
 
   for (auto& t : threads_) if (t.joinable()) t.join();
 
   m_work_group.clear();
-  m_thread_id_to_local_id_map.clear();
+  m_local_queues.clear();
   threads_.clear();
   /// Reset the flag so that new threads can be started
   all_work_done_ = false;
-  global_work_queue_.set_stop_threads(false);
   return;
 }
 
@@ -176,13 +193,87 @@ void thread_pool::relaunch_pinned_threads(size_type num_threads) {
   return;
 }
 
-void thread_pool::do_thread_work_()
+void thread_pool::push_job_(type_erased_function job)
 {
-  while (not all_work_done_)
   {
-    auto task = global_work_queue_.wait_and_pop();
-    if (task) {
-      (*task)();
+    std::lock_guard<std::mutex> lk(m_wake_mutex);
+    ++m_num_pending_jobs;
+  }
+  const int tid = get_worker_id_();
+  if (tid >= 0) {
+    m_local_queues[tid]->push(std::move(job));
+  }
+  else {
+    global_work_queue_.push(std::move(job));
+  }
+  m_wake.notify_one();
+}
+
+std::unique_ptr<type_erased_function> thread_pool::find_job_(int tid)
+{
+  // Most recent job from this worker's deque
+  auto job = m_local_queues[tid]->try_pop();
+  if (job) {
+    --m_num_pending_jobs;
+    return job;
+  }
+
+  // Oldest job submitted from outside the pool
+  job = global_work_queue_.try_pop();
+  if (job) {
+    --m_num_pending_jobs;
+    return job;
+  }
+
+  // Oldest job from another worker's deque
+  const int num_queues = m_local_queues.size();
+  for (int i = 1; i < num_queues; ++i) {
+    job = m_local_queues[(tid + i) % num_queues]->try_steal();
+    if (job) {
+      --m_num_pending_jobs;
+      ++m_num_stolen_jobs;
+      return job;
+    }
+  }
+  return nullptr;
+}
+
+std::unique_ptr<type_erased_function> thread_pool::try_pop_local_job_()
+{
+  const int tid = get_worker_id_();
+  if (tid < 0) {
+    return nullptr;
+  }
+  auto job = m_local_queues[tid]->try_pop();
+  if (job) {
+    --m_num_pending_jobs;
+  }
+  return job;
+}
+
+int thread_pool::get_worker_id_() const
+{
+  return (local_thread_pool == this ? local_thread_id : -1);
+}
+
+void thread_pool::do_thread_work_(int tid)
+{
+  local_thread_pool = this;
+  local_thread_id = tid;
+  while (true)
+  {
+    auto job = find_job_(tid);
+    if (job) {
+      (*job)();
+      continue;
+    }
+
+    // Sleep until there is work or the pool is shut down
+    std::unique_lock<std::mutex> lk(m_wake_mutex);
+    m_wake.wait(lk, [&]{ return (m_num_pending_jobs > 0
+                                 || all_work_done_); });
+    if (all_work_done_ && m_num_pending_jobs == 0) {
+      break;
     }
   }
 }
@@ -203,25 +294,13 @@ void thread_pool::do_thread_work_pinned_thread_(int tid, hwloc_topology_t topo,
   /* terminate this topology context */
   hwloc_topology_destroy(topo);
 
-  {
-    std::lock_guard<std::mutex> guard(m_thread_map_mutex);
-    // Establish a local thread id
-    std::thread::id this_id = std::this_thread::get_id();
-    m_thread_id_to_local_id_map[this_id] = tid;
-  }
-  while (not all_work_done_)
-  {
-    auto task = global_work_queue_.wait_and_pop();
-    if (task) {
-      (*task)();
-    }
-  }
+  do_thread_work_(tid);
 }
 #endif // LBANN_TOPO_AWARE
 
 int thread_pool::get_local_thread_id() {
-  std::thread::id this_id = std::this_thread::get_id();
-  return m_thread_id_to_local_id_map[this_id];
+  const int tid = get_worker_id_();
+  return (tid >= 0 ? tid : 0);
 }
 
 }// namespace lbann
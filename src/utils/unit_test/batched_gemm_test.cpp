@@ -0,0 +1,82 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <catch2/catch.hpp>
+
+#include "lbann/base.hpp"
+#include "lbann/utils/batched_gemm.hpp"
+
+#include <tuple>
+
+namespace {
+using MatType = lbann::CPUMatDT<double>;
+} // namespace
+
+TEST_CASE("Strided batched GEMM", "[gemm][utilities]")
+{
+  // Problem sizes that use the in-house kernel and BLAS
+  El::Int m, n, k;
+  std::tie(m, n, k) = GENERATE(std::make_tuple(El::Int(5), El::Int(3), El::Int(4)),
+                               std::make_tuple(El::Int(130), El::Int(70), El::Int(120)));
+  const auto transA = GENERATE(El::NORMAL, El::TRANSPOSE);
+  const auto transB = GENERATE(El::NORMAL, El::TRANSPOSE);
+  const El::Int batch_count = 3;
+  const double alpha = 1.5, beta = 0.5;
+
+  // Leading dimensions are padded to exercise strided access
+  const El::Int A_height = (transA == El::NORMAL ? m : k);
+  const El::Int A_width = (transA == El::NORMAL ? k : m);
+  const El::Int B_height = (transB == El::NORMAL ? k : n);
+  const El::Int B_width = (transB == El::NORMAL ? n : k);
+  const El::Int lda = A_height + 1, ldb = B_height + 2, ldc = m + 3;
+  MatType A, B, C;
+  El::Uniform(A, lda, A_width * batch_count);
+  El::Uniform(B, ldb, B_width * batch_count);
+  El::Uniform(C, ldc, n * batch_count);
+  MatType C_ref(C);
+
+  lbann::gemm_strided_batched(transA, transB, m, n, k,
+                              alpha,
+                              A.LockedBuffer(), lda, lda * A_width,
+                              B.LockedBuffer(), ldb, ldb * B_width,
+                              beta,
+                              C.Buffer(), ldc, ldc * n,
+                              batch_count);
+
+  for (El::Int i = 0; i < batch_count; ++i) {
+    const auto A_i = El::LockedView(A, El::IR(0, A_height),
+                                    El::IR(i * A_width, (i+1) * A_width));
+    const auto B_i = El::LockedView(B, El::IR(0, B_height),
+                                    El::IR(i * B_width, (i+1) * B_width));
+    auto C_ref_i = El::View(C_ref, El::IR(0, m), El::IR(i * n, (i+1) * n));
+    El::Gemm(transA, transB, alpha, A_i, B_i, beta, C_ref_i);
+  }
+  for (El::Int col = 0; col < C.Width(); ++col) {
+    for (El::Int row = 0; row < m; ++row) {
+      CHECK(C(row, col) == Approx(C_ref(row, col)));
+    }
+  }
+}
@@ -0,0 +1,133 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <catch2/catch.hpp>
+
+#include "lbann/base.hpp"
+#include "lbann/utils/im2col.hpp"
+
+#include <vector>
+
+namespace {
+using MatType = lbann::CPUMatDT<double>;
+} // namespace
+
+TEST_CASE("Batched im2col", "[im2col][utilities]")
+{
+  // 2 channels of 6 x 5 images, 3 x 2 window
+  const int num_channels = 2;
+  const std::vector<int> im_dims = {6, 5};
+  const std::vector<int> pads = {1, 2};
+  const std::vector<int> window_dims = {3, 2};
+  const std::vector<int> strides = {2, 1};
+  const std::vector<int> no_dilations = {1, 1};
+  const El::Int num_samples = 3;
+  const El::Int im_size = num_channels * im_dims[0] * im_dims[1];
+
+  MatType im;
+  El::Uniform(im, im_size, num_samples);
+
+  SECTION("Matches im2col without dilation")
+  {
+    const auto col_size = lbann::get_im2col_output_size(
+      1, num_channels, 2, im_dims.data(), pads.data(),
+      window_dims.data(), strides.data());
+    const El::Int col_height = col_size.first;
+    const El::Int num_offsets = col_size.second;
+    MatType col(col_height, num_offsets * num_samples);
+    lbann::im2col_batched(im, col, num_channels, 2, im_dims.data(),
+                          pads.data(), window_dims.data(), strides.data(),
+                          no_dilations.data());
+    MatType sample_col(col_height, num_offsets);
+    for (El::Int sample = 0; sample < num_samples; ++sample) {
+      const auto im_sample = El::LockedView(im, El::ALL, El::IR(sample));
+      lbann::im2col(im_sample, sample_col, num_channels, 2, im_dims.data(),
+                    pads.data(), window_dims.data(), strides.data());
+      for (El::Int j = 0; j < num_offsets; ++j) {
+        for (El::Int i = 0; i < col_height; ++i) {
+          CHECK(col(i, j + sample * num_offsets) == sample_col(i, j));
+        }
+      }
+    }
+  }
+
+  SECTION("Dilated window picks entries of a larger window")
+  {
+    // A 3 x 2 window with dilations (2, 3) covers a 5 x 4 window
+    const std::vector<int> dilations = {2, 3};
+    const std::vector<int> large_window_dims = {5, 4};
+    const auto col_size = lbann::get_im2col_output_size(
+      1, num_channels, 2, im_dims.data(), pads.data(),
+      large_window_dims.data(), strides.data());
+    const El::Int large_col_height = col_size.first;
+    const El::Int num_offsets = col_size.second;
+    const El::Int col_height = num_channels * window_dims[0] * window_dims[1];
+    MatType col(col_height, num_offsets * num_samples);
+    MatType large_col(large_col_height, num_offsets * num_samples);
+    lbann::im2col_batched(im, col, num_channels, 2, im_dims.data(),
+                          pads.data(), window_dims.data(), strides.data(),
+                          dilations.data());
+    lbann::im2col_batched(im, large_col, num_channels, 2, im_dims.data(),
+                          pads.data(), large_window_dims.data(),
+                          strides.data(), no_dilations.data());
+    for (El::Int j = 0; j < num_offsets * num_samples; ++j) {
+      for (int c = 0; c < num_channels; ++c) {
+        for (int y = 0; y < window_dims[0]; ++y) {
+          for (int x = 0; x < window_dims[1]; ++x) {
+            const El::Int row = x + window_dims[1] * (y + window_dims[0] * c);
+            const El::Int large_row = (x * dilations[1]
+                                       + large_window_dims[1]
+                                       * (y * dilations[0]
+                                          + large_window_dims[0] * c));
+            CHECK(col(row, j) == large_col(large_row, j));
+          }
+        }
+      }
+    }
+  }
+
+  SECTION("col2im is the adjoint of im2col")
+  {
+    // <im2col(x), y> == <x, col2im(y)>
+    const std::vector<int> dilations = {2, 1};
+    const auto large_window_dims = std::vector<int>{5, 2};
+    const auto col_size = lbann::get_im2col_output_size(
+      1, num_channels, 2, im_dims.data(), pads.data(),
+      large_window_dims.data(), strides.data());
+    const El::Int col_height = num_channels * window_dims[0] * window_dims[1];
+    const El::Int num_offsets = col_size.second;
+    MatType col(col_height, num_offsets * num_samples);
+    MatType y, col2im_y(im_size, num_samples);
+    El::Uniform(y, col_height, num_offsets * num_samples);
+    lbann::im2col_batched(im, col, num_channels, 2, im_dims.data(),
+                          pads.data(), window_dims.data(), strides.data(),
+                          dilations.data());
+    lbann::col2im_batched(y, col2im_y, num_channels, 2, im_dims.data(),
+                          pads.data(), window_dims.data(), strides.data(),
+                          dilations.data());
+    CHECK(El::Dot(col, y) == Approx(El::Dot(im, col2im_y)));
+  }
+}
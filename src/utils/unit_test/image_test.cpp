@@ -4,6 +4,10 @@
 // File being tested
 #include <lbann/utils/image.hpp>
 
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+
 // Hide by default because this will create a file.
 TEST_CASE("Testing image utils", "[.image-utils][utilities]") {
   SECTION("JPEG") {
@@ -49,3 +53,58 @@ TEST_CASE("Testing image utils", "[.image-utils][utilities]") {
     }
   }
 }
+
+TEST_CASE("Testing memory-mapped and prefetched image loading",
+          "[image-utils][utilities]") {
+  // Diagonal 3-channel 16x16 image in a temporary file
+  const std::string filename =
+    "/tmp/lbann_image_test_" + std::to_string(getpid()) + ".png";
+  lbann::CPUMat image;
+  image.Resize(3*16*16, 1);
+  for (El::Int i = 0; i < image.Height(); ++i) {
+    const El::Int pixel = i % (16*16);
+    image(i, 0) = (pixel % 16 == pixel / 16) ? 1.0f : 0.0f;
+  }
+  std::vector<size_t> dims = {3, 16, 16};
+  REQUIRE_NOTHROW(lbann::save_image(filename, image, dims));
+
+  El::Matrix<uint8_t> loaded_image;
+  REQUIRE_NOTHROW(lbann::load_image(filename, loaded_image, dims));
+
+  auto check_same = [&](const El::Matrix<uint8_t>& other,
+                        const std::vector<size_t>& other_dims) {
+    REQUIRE(other_dims == dims);
+    REQUIRE(other.Height() == loaded_image.Height());
+    for (El::Int i = 0; i < loaded_image.Height(); ++i) {
+      REQUIRE(other(i, 0) == loaded_image(i, 0));
+    }
+  };
+
+  SECTION("load image with mmap") {
+    El::Matrix<uint8_t> mapped_image;
+    std::vector<size_t> mapped_dims;
+    REQUIRE_NOTHROW(lbann::load_image_mmap(filename, mapped_image, mapped_dims));
+    check_same(mapped_image, mapped_dims);
+  }
+  SECTION("load prefetched image") {
+    El::Matrix<uint8_t> prefetched_image;
+    std::vector<size_t> prefetched_dims;
+    const int fd = lbann::prefetch_image_file(filename);
+    REQUIRE(fd != -1);
+    REQUIRE_NOTHROW(lbann::load_image(fd, filename, prefetched_image, prefetched_dims));
+    check_same(prefetched_image, prefetched_dims);
+  }
+  SECTION("load prefetched image with mmap") {
+    El::Matrix<uint8_t> mapped_image;
+    std::vector<size_t> mapped_dims;
+    const int fd = lbann::prefetch_image_file(filename);
+    REQUIRE(fd != -1);
+    REQUIRE_NOTHROW(lbann::load_image_mmap(fd, filename, mapped_image, mapped_dims));
+    check_same(mapped_image, mapped_dims);
+  }
+  SECTION("prefetching a missing file") {
+    CHECK(lbann::prefetch_image_file(filename + ".missing") == -1);
+  }
+
+  std::remove(filename.c_str());
+}
@@ -0,0 +1,101 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <catch2/catch.hpp>
+
+#include "lbann/utils/philox.hpp"
+
+#include <cmath>
+
+using lbann::philox4x32;
+
+TEST_CASE("Philox-4x32-10 known answers", "[random][utilities]")
+{
+  // Known-answer vectors from the Random123 distribution
+  SECTION("Zero counter and key")
+  {
+    auto const x = philox4x32::generate(philox4x32::counter_type{0, 0, 0, 0},
+                                        philox4x32::key_type{0, 0});
+    CHECK(x == philox4x32::counter_type{0x6627e8d5, 0xe169c58d,
+                                        0xbc57ac4c, 0x9b00dbd8});
+  }
+
+  SECTION("All ones")
+  {
+    auto const x = philox4x32::generate(
+      philox4x32::counter_type{0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff},
+      philox4x32::key_type{0xffffffff, 0xffffffff});
+    CHECK(x == philox4x32::counter_type{0x408f276d, 0x41c83b0e,
+                                        0xa20bc7c6, 0x6d5451fd});
+  }
+
+  SECTION("Digits of pi")
+  {
+    auto const x = philox4x32::generate(
+      philox4x32::counter_type{0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344},
+      philox4x32::key_type{0xa4093822, 0x299f31d0});
+    CHECK(x == philox4x32::counter_type{0xd16cfe09, 0x94fdcceb,
+                                        0x5001e420, 0x24126ea1});
+  }
+}
+
+TEST_CASE("Philox random streams", "[random][utilities]")
+{
+  constexpr uint64_t seed = 0x0123456789abcdefull;
+
+  SECTION("Entries are reproducible and depend on seed and index")
+  {
+    CHECK(philox4x32::generate(seed, 12) == philox4x32::generate(seed, 12));
+    CHECK(philox4x32::generate(seed, 12) != philox4x32::generate(seed, 13));
+    CHECK(philox4x32::generate(seed, 12) != philox4x32::generate(seed + 1, 12));
+    CHECK(philox4x32::generate(seed, 1ull << 32) !=
+          philox4x32::generate(seed, 0));
+  }
+
+  SECTION("Uniform values are in [0, 1)")
+  {
+    CHECK(lbann::philox_uniform_float(0u) == 0.f);
+    CHECK(lbann::philox_uniform_float(0xffffffffu) < 1.f);
+    CHECK(lbann::philox_uniform_double(0u, 0u) == 0.);
+    CHECK(lbann::philox_uniform_double(0xffffffffu, 0xffffffffu) < 1.);
+  }
+
+  SECTION("Normal values have zero mean and unit variance")
+  {
+    constexpr size_t num_samples = 100000;
+    double sum = 0., sqsum = 0.;
+    for (size_t i = 0; i < num_samples; ++i) {
+      const double z = lbann::philox_normal(philox4x32::generate(seed, i));
+      REQUIRE(std::isfinite(z));
+      sum += z;
+      sqsum += z * z;
+    }
+    const double mean = sum / num_samples;
+    const double var = sqsum / num_samples - mean * mean;
+    CHECK(std::abs(mean) < 0.02);
+    CHECK(std::abs(var - 1.) < 0.02);
+  }
+}
@@ -162,6 +162,13 @@ struct TensorDataTypeStruct<El::DistMatrix<T,ColDist,RowDist,Wrap,D>>
 };
 template <typename DistMat>
 using TensorDataType = typename TensorDataTypeStruct<DistMat>::type;
+template <typename DistMat>
+struct TensorDeviceStruct;
+template <typename T, El::Dist ColDist, El::Dist RowDist, El::DistWrap Wrap, El::Device D>
+struct TensorDeviceStruct<El::DistMatrix<T,ColDist,RowDist,Wrap,D>>
+{
+  static constexpr El::Device value = D;
+};
 
 TEMPLATE_LIST_TEST_CASE(
   "Testing gaussian_fill",
@@ -388,3 +395,71 @@ TEMPLATE_LIST_TEST_CASE(
   }
 
 }
+
+TEMPLATE_LIST_TEST_CASE(
+  "Testing process-deterministic fills",
+  "[random][utilities][mpi]",
+  AllDistMatrixTypes)
+{
+
+  // Typedefs
+  using DistMatType = TestType;
+  using DataType = TensorDataType<DistMatType>;
+  using RefMatType = El::DistMatrix<DataType, El::STAR, El::STAR, El::ELEMENT,
+                                    TensorDeviceStruct<DistMatType>::value>;
+  using StarMatType = El::DistMatrix<double, El::STAR, El::STAR, El::ELEMENT, El::Device::CPU>;
+
+  // Parameters
+  const El::Int height = 41;
+  const El::Int width = 31;
+  const int seed = 20211103;
+
+  // Initialization
+  auto& comm = ::unit_test::utilities::current_world_comm();
+  const auto& grid = comm.get_trainer_grid();
+
+  // Check that a fill matches the same fill into a matrix with
+  // every entry on every process
+  auto check_fill = [&](auto const& fill) {
+    DistMatType mat(grid);
+    RefMatType ref(grid);
+    lbann::init_random(seed, 0, &comm);
+    REQUIRE_NOTHROW(fill(mat));
+    lbann::init_random(seed, 0, &comm);
+    REQUIRE_NOTHROW(fill(ref));
+    REQUIRE(mat.Height() == height);
+    REQUIRE(mat.Width() == width);
+    StarMatType mat_copy(grid), ref_copy(grid);
+    El::Copy(mat, mat_copy);
+    El::Copy(ref, ref_copy);
+    for (El::Int col = 0; col < width; ++col) {
+      for (El::Int row = 0; row < height; ++row) {
+        CHECK(mat_copy.Get(row, col) == ref_copy.Get(row, col));
+      }
+    }
+  };
+
+  SECTION("Gaussian")
+  {
+    check_fill([&](auto& m) {
+      lbann::gaussian_fill_procdet(m, height, width,
+                                   DataType(1.5f), DataType(2.f));
+    });
+  }
+
+  SECTION("Bernoulli")
+  {
+    check_fill([&](auto& m) {
+      lbann::bernoulli_fill_procdet(m, height, width, 0.3);
+    });
+  }
+
+  SECTION("Uniform")
+  {
+    check_fill([&](auto& m) {
+      lbann::uniform_fill_procdet(m, height, width,
+                                  DataType(-1.f), DataType(3.f));
+    });
+  }
+
+}
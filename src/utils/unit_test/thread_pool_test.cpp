@@ -0,0 +1,104 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <catch2/catch.hpp>
+
+#include "lbann/utils/threads/thread_pool.hpp"
+
+#include <atomic>
+#include <functional>
+#include <future>
+#include <vector>
+
+TEST_CASE("Thread pool runs submitted jobs", "[utils][thread_pool]")
+{
+  lbann::thread_pool pool(4);
+  REQUIRE(pool.get_num_threads() == 4);
+
+  SECTION("Jobs submitted from outside the pool")
+  {
+    std::vector<std::future<int>> results;
+    for (int i = 0; i < 100; ++i) {
+      results.emplace_back(pool.submit_job([i]() { return i * i; }));
+    }
+    for (int i = 0; i < 100; ++i) {
+      CHECK(results[i].get() == i * i);
+    }
+  }
+
+  SECTION("Work groups submitted from a worker")
+  {
+    // A worker forks jobs onto its own deque, the other workers
+    // steal them, and the worker helps until the group is done
+    constexpr int num_jobs = 64;
+    std::vector<int> touched(num_jobs, 0);
+    auto fork_join = [&]() {
+      for (int i = 1; i < num_jobs; ++i) {
+        pool.submit_job_to_work_group([&touched, i]() {
+          touched[i] += 1;
+          return true;
+        });
+      }
+      touched[0] += 1;
+      return pool.finish_work_group();
+    };
+    CHECK(pool.submit_job(fork_join).get());
+    for (int i = 0; i < num_jobs; ++i) {
+      CHECK(touched[i] == 1);
+    }
+  }
+
+  SECTION("Local thread ids")
+  {
+    std::vector<std::future<int>> ids;
+    for (int i = 0; i < 16; ++i) {
+      ids.emplace_back(
+        pool.submit_job([&pool]() { return pool.get_local_thread_id(); }));
+    }
+    for (auto& id : ids) {
+      const int tid = id.get();
+      CHECK(tid >= 0);
+      CHECK(tid < 4);
+    }
+    CHECK(pool.get_local_thread_id() == 0);
+  }
+}
+
+TEST_CASE("Thread pool drains jobs when reaped", "[utils][thread_pool]")
+{
+  std::atomic<int> count{0};
+  lbann::thread_pool pool(2);
+  for (int i = 0; i < 50; ++i) {
+    pool.submit_job([&count]() { ++count; });
+  }
+  pool.reap_threads();
+  CHECK(count == 50);
+  CHECK(pool.get_num_threads() == 0);
+
+  // The pool may be relaunched after reaping
+  pool.launch_threads(3);
+  CHECK(pool.submit_job([]() { return 7; }).get() == 7);
+}
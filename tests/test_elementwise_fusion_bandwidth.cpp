@@ -0,0 +1,178 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+//
+// test_elementwise_fusion_bandwidth.cpp - Entry-wise fusion benchmark
+//
+// Times the chain scale -> add constant -> clamp -> max constant
+// (i.e. ReLU) on CPU, first with one full pass over memory per
+// operator, the way separate operator layers run it, and then as a
+// fused chain. The reported bandwidth counts the bytes each version
+// streams through memory:
+//
+//   forward:  unfused reads and writes one tensor per operator,
+//             fused reads the input and writes the output once
+//   backward: unfused reads a value and a gradient and writes a
+//             gradient per operator, fused does so once overall
+//
+// Usage: test_elementwise_fusion_bandwidth [height] [width] [iterations]
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/lbann.hpp"
+#include "lbann/operators/math/binary_with_constant.hpp"
+#include "lbann/operators/math/clamp.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace lbann;
+
+namespace {
+
+using DataT = float;
+constexpr auto Dev = El::Device::CPU;
+using OpType = ElementwiseOperator<DataT, DataT, Dev>;
+using MatType = El::DistMatrix<DataT,
+                               El::STAR,
+                               El::VC,
+                               El::ELEMENT,
+                               Dev>;
+using clock_type = std::chrono::steady_clock;
+
+double elapsed(clock_type::time_point start) {
+  return std::chrono::duration<double>(clock_type::now() - start).count();
+}
+
+void report(const std::string& name,
+            double time,
+            size_t iterations,
+            double bytes) {
+  std::cout << "  " << std::left << std::setw(18) << name << std::right
+            << std::fixed << std::setprecision(3)
+            << std::setw(9) << time / iterations * 1e3 << " ms, "
+            << std::setprecision(1)
+            << std::setw(7) << bytes * iterations / time / 1e9
+            << " GB/s effective, "
+            << std::setw(9) << bytes / 1e6 << " MB moved"
+            << std::defaultfloat << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  world_comm_ptr comm = initialize(argc, argv);
+  const El::Int height = (argc > 1 ? std::stol(argv[1]) : 4096);
+  const El::Int width = (argc > 2 ? std::stol(argv[2]) : 1024);
+  const size_t iterations = (argc > 3 ? std::stoul(argv[3]) : 20);
+
+  ScaleOperator<DataT, Dev> scale(2.);
+  AddConstantOperator<DataT, Dev> add(-0.5);
+  ClampOperator<DataT, Dev> clamp(-4., 4.);
+  MaxConstantOperator<DataT, Dev> relu(0.);
+  const std::vector<OpType const*> ops = {&scale, &add, &clamp, &relu};
+  const size_t num_ops = ops.size();
+
+  const auto& grid = comm->get_trainer_grid();
+  MatType input(height, width, grid, 0), output(height, width, grid, 0);
+  MatType grad_wrt_output(height, width, grid, 0);
+  MatType grad_wrt_input(height, width, grid, 0);
+  std::vector<MatType> values(num_ops, MatType(height, width, grid, 0));
+  std::vector<MatType> grads(num_ops, MatType(height, width, grid, 0));
+  El::MakeUniform(input);
+  El::MakeUniform(grad_wrt_output);
+
+  const double tensor_bytes =
+    double(input.LocalHeight()) * input.LocalWidth() * sizeof(DataT);
+  if (comm->am_world_master()) {
+    std::cout << "Entry-wise fusion benchmark: " << num_ops
+              << " operators on a " << height << " x " << width
+              << " tensor, " << omp_get_max_threads() << " threads"
+              << std::endl;
+  }
+
+  // Warm up
+  ops[0]->fp_compute({input}, {values[0]});
+  OpType::fp_compute_chain(ops, {input}, output);
+
+  // Unfused forward prop
+  auto start = clock_type::now();
+  for (size_t it = 0; it < iterations; ++it) {
+    for (size_t i = 0; i < num_ops; ++i) {
+      ops[i]->fp_compute({i == 0 ? input : values[i - 1]}, {values[i]});
+    }
+  }
+  const double unfused_fp_time = elapsed(start);
+
+  // Fused forward prop
+  start = clock_type::now();
+  for (size_t it = 0; it < iterations; ++it) {
+    OpType::fp_compute_chain(ops, {input}, output);
+  }
+  const double fused_fp_time = elapsed(start);
+
+  // Unfused backward prop
+  start = clock_type::now();
+  for (size_t it = 0; it < iterations; ++it) {
+    for (size_t i = num_ops; i-- > 0;) {
+      ops[i]->bp_compute({i == 0 ? input : values[i - 1]},
+                         {i + 1 == num_ops ? grad_wrt_output : grads[i + 1]},
+                         {grads[i]});
+    }
+  }
+  const double unfused_bp_time = elapsed(start);
+
+  // Fused backward prop
+  start = clock_type::now();
+  for (size_t it = 0; it < iterations; ++it) {
+    OpType::bp_compute_chain(ops, {input}, grad_wrt_output, {grad_wrt_input});
+  }
+  const double fused_bp_time = elapsed(start);
+
+  if (comm->am_world_master()) {
+    report("forward unfused", unfused_fp_time, iterations,
+           2 * num_ops * tensor_bytes);
+    report("forward fused", fused_fp_time, iterations, 2 * tensor_bytes);
+    report("backward unfused", unfused_bp_time, iterations,
+           3 * num_ops * tensor_bytes);
+    report("backward fused", fused_bp_time, iterations, 3 * tensor_bytes);
+    std::cout << std::fixed << std::setprecision(2)
+              << "  speedup: forward " << unfused_fp_time / fused_fp_time
+              << "x, backward " << unfused_bp_time / fused_bp_time << "x"
+              << std::defaultfloat << std::endl;
+  }
+
+  // Check that both versions agree
+  El::Axpy(DataT(-1), values.back(), output);
+  El::Axpy(DataT(-1), grads.front(), grad_wrt_input);
+  if (El::MaxAbs(output) != DataT(0) || El::MaxAbs(grad_wrt_input) != DataT(0)) {
+    LBANN_ERROR("fused and unfused results differ");
+  }
+
+  return EXIT_SUCCESS;
+}
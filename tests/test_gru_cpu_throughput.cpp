@@ -0,0 +1,283 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+//
+// test_gru_cpu_throughput.cpp - CPU GRU benchmark
+//
+// Times forward and backward prop of a stacked GRU with the native
+// CPU implementation. If LBANN is built with oneDNN, the oneDNN
+// linear-before-reset GRU primitives are timed on the same problem
+// for comparison. oneDNN requires input_size == hidden_size for
+// stacked GRU cells, so a single size is used for both.
+//
+// Usage: test_gru_cpu_throughput [sequence_length] [mini_batch_size]
+//                                [hidden_size] [num_layers] [iterations]
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/lbann.hpp"
+#include "lbann/layers/learning/gru_cpu.hpp"
+#ifdef LBANN_HAS_ONEDNN_CPU
+#include "lbann/utils/dnn_lib/onednn.hpp"
+#include "lbann/utils/sync_info_helpers.hpp"
+#endif // LBANN_HAS_ONEDNN_CPU
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace lbann;
+
+namespace {
+
+using DataT = float;
+using LocalMat = El::Matrix<DataT, El::Device::CPU>;
+using clock_type = std::chrono::steady_clock;
+
+double elapsed(clock_type::time_point start) {
+  return std::chrono::duration<double>(clock_type::now() - start).count();
+}
+
+void report(const std::string& name,
+            double time,
+            size_t iterations,
+            double flops) {
+  std::cout << "  " << std::left << std::setw(18) << name << std::right
+            << std::fixed << std::setprecision(3)
+            << std::setw(9) << time / iterations * 1e3 << " ms, "
+            << std::setprecision(1)
+            << std::setw(7) << flops * iterations / time / 1e9
+            << " GFLOP/s"
+            << std::defaultfloat << std::endl;
+}
+
+#ifdef LBANN_HAS_ONEDNN_CPU
+/** @brief Time the oneDNN GRU primitives.
+ *  @returns Forward and backward prop times
+ */
+std::pair<double, double> time_onednn(int sequence_length,
+                                      int mini_batch_size,
+                                      int hidden_size,
+                                      int num_layers,
+                                      size_t iterations) {
+  using Memory = ::dnnl::memory;
+  using Tag = Memory::format_tag;
+  const auto data_type = Memory::data_type::f32;
+  auto& engine = onednn::get_device_engine<El::Device::CPU>();
+  LocalMat dummy;
+  auto stream = onednn::get_stream<El::Device::CPU>(engine,
+                                                    get_sync_info(dummy));
+
+  // Memory descriptors
+  auto make_desc = [&] (Memory::dims dims, Tag tag) {
+    return Memory::desc(std::move(dims), data_type, tag);
+  };
+  const auto seq_desc = make_desc(
+    {sequence_length, mini_batch_size, hidden_size}, Tag::tnc);
+  const auto hidden_desc = make_desc(
+    {num_layers, 1, mini_batch_size, hidden_size}, Tag::ldnc);
+  const auto fwd_weights_desc = make_desc(
+    {num_layers, 1, hidden_size, 3, hidden_size}, Tag::ldigo);
+  const auto bwd_weights_desc = make_desc(
+    {num_layers, 1, hidden_size, 3, hidden_size}, Tag::ldgoi);
+  const auto bias_desc = make_desc(
+    {num_layers, 1, 4, hidden_size}, Tag::ldgo);
+  const Memory::desc empty_desc;
+
+  // Memory
+  Memory src(seq_desc, engine), dst(seq_desc, engine);
+  Memory src_grad(seq_desc, engine), dst_grad(seq_desc, engine);
+  Memory init_hidden(hidden_desc, engine), init_hidden_grad(hidden_desc, engine);
+  Memory fwd_ih(fwd_weights_desc, engine), fwd_hh(fwd_weights_desc, engine);
+  Memory bwd_ih(bwd_weights_desc, engine), bwd_hh(bwd_weights_desc, engine);
+  Memory ih_grad(fwd_weights_desc, engine), hh_grad(fwd_weights_desc, engine);
+  Memory bias(bias_desc, engine), bias_grad(bias_desc, engine);
+  for (auto* mem : {&src, &dst_grad, &init_hidden, &fwd_ih, &fwd_hh,
+                    &bwd_ih, &bwd_hh, &bias}) {
+    auto* buf = static_cast<DataT*>(mem->get_data_handle());
+    const auto size = mem->get_desc().get_size() / sizeof(DataT);
+    std::fill(buf, buf+size, DataT(0.01));
+  }
+
+  // Primitives
+  ::dnnl::lbr_gru_forward::desc fwd_desc(
+    ::dnnl::prop_kind::forward_training,
+    ::dnnl::rnn_direction::unidirectional_left2right,
+    seq_desc, hidden_desc, fwd_weights_desc, fwd_weights_desc,
+    bias_desc, seq_desc, empty_desc);
+  ::dnnl::lbr_gru_forward::primitive_desc fwd_pd(fwd_desc, engine);
+  ::dnnl::lbr_gru_backward::desc bwd_desc(
+    ::dnnl::prop_kind::backward,
+    ::dnnl::rnn_direction::unidirectional_left2right,
+    seq_desc, hidden_desc, bwd_weights_desc, bwd_weights_desc,
+    bias_desc, seq_desc, empty_desc,
+    seq_desc, hidden_desc, fwd_weights_desc, fwd_weights_desc,
+    bias_desc, seq_desc, empty_desc);
+  ::dnnl::lbr_gru_backward::primitive_desc bwd_pd(bwd_desc, engine, fwd_pd);
+  Memory workspace(fwd_pd.workspace_desc(), engine);
+  ::dnnl::lbr_gru_forward fwd(fwd_pd);
+  ::dnnl::lbr_gru_backward bwd(bwd_pd);
+  auto run_fwd = [&] () {
+    fwd.execute(stream,
+                { {DNNL_ARG_SRC_LAYER, src},
+                  {DNNL_ARG_SRC_ITER, init_hidden},
+                  {DNNL_ARG_WEIGHTS_LAYER, fwd_ih},
+                  {DNNL_ARG_WEIGHTS_ITER, fwd_hh},
+                  {DNNL_ARG_BIAS, bias},
+                  {DNNL_ARG_DST_LAYER, dst},
+                  {DNNL_ARG_WORKSPACE, workspace} });
+    stream.wait();
+  };
+  auto run_bwd = [&] () {
+    bwd.execute(stream,
+                { {DNNL_ARG_SRC_LAYER, src},
+                  {DNNL_ARG_SRC_ITER, init_hidden},
+                  {DNNL_ARG_WEIGHTS_LAYER, bwd_ih},
+                  {DNNL_ARG_WEIGHTS_ITER, bwd_hh},
+                  {DNNL_ARG_BIAS, bias},
+                  {DNNL_ARG_DST_LAYER, dst},
+                  {DNNL_ARG_DIFF_SRC_LAYER, src_grad},
+                  {DNNL_ARG_DIFF_SRC_ITER, init_hidden_grad},
+                  {DNNL_ARG_DIFF_DST_LAYER, dst_grad},
+                  {DNNL_ARG_DIFF_WEIGHTS_LAYER, ih_grad},
+                  {DNNL_ARG_DIFF_WEIGHTS_ITER, hh_grad},
+                  {DNNL_ARG_DIFF_BIAS, bias_grad},
+                  {DNNL_ARG_WORKSPACE, workspace} });
+    stream.wait();
+  };
+
+  // Warm up
+  run_fwd();
+  run_bwd();
+
+  auto start = clock_type::now();
+  for (size_t it = 0; it < iterations; ++it) {
+    run_fwd();
+  }
+  const double fp_time = elapsed(start);
+  start = clock_type::now();
+  for (size_t it = 0; it < iterations; ++it) {
+    run_bwd();
+  }
+  const double bp_time = elapsed(start);
+  return {fp_time, bp_time};
+}
+#endif // LBANN_HAS_ONEDNN_CPU
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  world_comm_ptr comm = initialize(argc, argv);
+  const El::Int sequence_length = (argc > 1 ? std::stol(argv[1]) : 64);
+  const El::Int mini_batch_size = (argc > 2 ? std::stol(argv[2]) : 64);
+  const El::Int hidden_size = (argc > 3 ? std::stol(argv[3]) : 256);
+  const El::Int num_layers = (argc > 4 ? std::stol(argv[4]) : 2);
+  const size_t iterations = (argc > 5 ? std::stoul(argv[5]) : 10);
+  const El::Int input_size = hidden_size;
+
+  // Matrices
+  LocalMat input_sequence, init_hidden, output_sequence;
+  LocalMat output_sequence_grad, input_sequence_grad, init_hidden_grad;
+  El::Uniform(input_sequence, sequence_length*input_size, mini_batch_size);
+  El::Uniform(init_hidden, num_layers*hidden_size, mini_batch_size);
+  El::Uniform(output_sequence_grad, sequence_length*hidden_size, mini_batch_size);
+  output_sequence.Resize(sequence_length*hidden_size, mini_batch_size);
+  input_sequence_grad.Resize(sequence_length*input_size, mini_batch_size);
+  init_hidden_grad.Resize(num_layers*hidden_size, mini_batch_size);
+  std::vector<LocalMat> weights(4*num_layers), weights_grad;
+  const DataT scale = 1. / std::sqrt(hidden_size);
+  for (El::Int layer = 0; layer < num_layers; ++layer) {
+    El::Uniform(weights[4*layer], 3*hidden_size, input_size, DataT(0), scale);
+    El::Uniform(weights[4*layer+1], 3*hidden_size, hidden_size, DataT(0), scale);
+    El::Uniform(weights[4*layer+2], 3*hidden_size, 1, DataT(0), scale);
+    El::Uniform(weights[4*layer+3], 3*hidden_size, 1, DataT(0), scale);
+  }
+  gru_cpu::workspace<DataT> ws;
+
+  // Each GRU cell does two 3*hidden_size x hidden_size matrix
+  // products per time step and sample in forward prop, and twice as
+  // many in back prop
+  const double fp_flops = 2. * num_layers * sequence_length * mini_batch_size
+                          * 2 * 3 * hidden_size * hidden_size;
+  const double bp_flops = 2 * fp_flops;
+  if (comm->am_world_master()) {
+    std::cout << "CPU GRU benchmark: sequence_length=" << sequence_length
+              << ", mini_batch_size=" << mini_batch_size
+              << ", hidden_size=" << hidden_size
+              << ", num_layers=" << num_layers
+              << ", " << omp_get_max_threads() << " threads"
+              << std::endl;
+  }
+
+  // Warm up
+  gru_cpu::fp_compute(input_sequence, init_hidden, weights,
+                      output_sequence, ws);
+  gru_cpu::bp_compute(input_sequence, init_hidden, weights,
+                      output_sequence_grad, input_sequence_grad,
+                      init_hidden_grad, weights_grad, ws);
+
+  // Native forward prop
+  auto start = clock_type::now();
+  for (size_t it = 0; it < iterations; ++it) {
+    gru_cpu::fp_compute(input_sequence, init_hidden, weights,
+                        output_sequence, ws);
+  }
+  const double native_fp_time = elapsed(start);
+
+  // Native backward prop
+  start = clock_type::now();
+  for (size_t it = 0; it < iterations; ++it) {
+    gru_cpu::bp_compute(input_sequence, init_hidden, weights,
+                        output_sequence_grad, input_sequence_grad,
+                        init_hidden_grad, weights_grad, ws);
+  }
+  const double native_bp_time = elapsed(start);
+
+  if (comm->am_world_master()) {
+    report("forward native", native_fp_time, iterations, fp_flops);
+    report("backward native", native_bp_time, iterations, bp_flops);
+  }
+
+#ifdef LBANN_HAS_ONEDNN_CPU
+  const auto onednn_times = time_onednn(sequence_length,
+                                        mini_batch_size,
+                                        hidden_size,
+                                        num_layers,
+                                        iterations);
+  if (comm->am_world_master()) {
+    report("forward oneDNN", onednn_times.first, iterations, fp_flops);
+    report("backward oneDNN", onednn_times.second, iterations, bp_flops);
+    std::cout << std::fixed << std::setprecision(2)
+              << "  native/oneDNN time: forward "
+              << native_fp_time / onednn_times.first << "x, backward "
+              << native_bp_time / onednn_times.second << "x"
+              << std::defaultfloat << std::endl;
+  }
+#endif // LBANN_HAS_ONEDNN_CPU
+
+  return EXIT_SUCCESS;
+}
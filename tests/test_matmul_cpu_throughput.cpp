@@ -0,0 +1,183 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+//
+// test_matmul_cpu_throughput.cpp - CPU matmul layer benchmark
+//
+// Times the forward and backward products of the matmul layer on
+// attention-style shapes, comparing one El::Gemm per matrix against
+// the strided batched GEMM used by the CPU matmul layer.
+//
+// Usage: test_matmul_cpu_throughput [mini_batch_size] [iterations]
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/lbann.hpp"
+#include "lbann/utils/batched_gemm.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace lbann;
+
+namespace {
+
+using DataT = float;
+using LocalMat = El::Matrix<DataT, El::Device::CPU>;
+using clock_type = std::chrono::steady_clock;
+
+double elapsed(clock_type::time_point start) {
+  return std::chrono::duration<double>(clock_type::now() - start).count();
+}
+
+/** @brief Batched matmul problem, (batch x m x k) times (batch x k x n).
+ *  @details Dimensions follow the C-layout tensor convention of the
+ *  matmul layer.
+ */
+struct problem {
+  std::string name;
+  El::Int num_heads;
+  El::Int m, n, k;
+};
+
+/** @brief Compute the three products in matmul fp and bp:
+ *  Y = X0 X1, dX0 = dY X1^T, dX1 = X0^T dY.
+ */
+void run_products(const problem& p,
+                  El::Int num_matrices,
+                  const LocalMat& x0, const LocalMat& x1, const LocalMat& dy,
+                  LocalMat& y, LocalMat& dx0, LocalMat& dx1,
+                  bool batched) {
+  const DataT one = 1, zero = 0;
+  const El::Int x0_stride = p.m * p.k;
+  const El::Int x1_stride = p.k * p.n;
+  const El::Int y_stride = p.m * p.n;
+  struct gemm_args {
+    El::Orientation transA, transB;
+    El::Int m, n, k;
+    const DataT* A; El::Int lda, stride_A;
+    const DataT* B; El::Int ldb, stride_B;
+    DataT* C; El::Int ldc, stride_C;
+  };
+  // Fortran-layout views of the C-layout tensors
+  const std::vector<gemm_args> products = {
+    {El::NORMAL, El::NORMAL, p.n, p.m, p.k,
+     x1.LockedBuffer(), p.n, x1_stride, x0.LockedBuffer(), p.k, x0_stride,
+     y.Buffer(), p.n, y_stride},
+    {El::TRANSPOSE, El::NORMAL, p.k, p.m, p.n,
+     x1.LockedBuffer(), p.n, x1_stride, dy.LockedBuffer(), p.n, y_stride,
+     dx0.Buffer(), p.k, x0_stride},
+    {El::NORMAL, El::TRANSPOSE, p.n, p.k, p.m,
+     dy.LockedBuffer(), p.n, y_stride, x0.LockedBuffer(), p.k, x0_stride,
+     dx1.Buffer(), p.n, x1_stride},
+  };
+  for (const auto& g : products) {
+    if (batched) {
+      gemm_strided_batched(g.transA, g.transB, g.m, g.n, g.k,
+                           one, g.A, g.lda, g.stride_A,
+                           g.B, g.ldb, g.stride_B,
+                           zero, g.C, g.ldc, g.stride_C,
+                           num_matrices);
+    }
+    else {
+      // Previous CPU implementation: one GEMM per matrix
+      const El::Int A_height = (g.transA == El::NORMAL ? g.m : g.k);
+      const El::Int A_width = (g.transA == El::NORMAL ? g.k : g.m);
+      const El::Int B_height = (g.transB == El::NORMAL ? g.k : g.n);
+      const El::Int B_width = (g.transB == El::NORMAL ? g.n : g.k);
+      LBANN_OMP_PARALLEL_FOR
+      for (El::Int i = 0; i < num_matrices; ++i) {
+        LocalMat A_v, B_v, C_v;
+        A_v.LockedAttach(A_height, A_width, g.A + i * g.stride_A, g.lda);
+        B_v.LockedAttach(B_height, B_width, g.B + i * g.stride_B, g.ldb);
+        C_v.Attach(g.m, g.n, g.C + i * g.stride_C, g.ldc);
+        El::Gemm(g.transA, g.transB, one, A_v, B_v, zero, C_v);
+      }
+    }
+  }
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  world_comm_ptr comm = initialize(argc, argv);
+  const El::Int mini_batch_size = (argc > 1 ? std::stol(argv[1]) : 32);
+  const size_t iterations = (argc > 2 ? std::stoul(argv[2]) : 10);
+
+  // Attention score (Q K^T) and context (S V) products
+  const std::vector<problem> problems = {
+    {"QK^T s=64 d=64", 8, 64, 64, 64},
+    {"SV s=64 d=64", 8, 64, 64, 64},
+    {"QK^T s=128 d=64", 12, 128, 128, 64},
+    {"SV s=128 d=64", 12, 128, 64, 128},
+    {"QK^T s=256 d=32", 16, 256, 256, 32},
+    {"SV s=256 d=32", 16, 256, 32, 256},
+    {"QK^T s=512 d=64", 16, 512, 512, 64},
+  };
+
+  if (comm->am_world_master()) {
+    std::cout << "mini-batch size " << mini_batch_size << ", "
+              << iterations << " iterations" << std::endl;
+  }
+  for (const auto& p : problems) {
+    const El::Int num_matrices = p.num_heads * mini_batch_size;
+    LocalMat x0, x1, dy, y, dx0, dx1;
+    El::Uniform(x0, p.num_heads * p.m * p.k, mini_batch_size);
+    El::Uniform(x1, p.num_heads * p.k * p.n, mini_batch_size);
+    El::Uniform(dy, p.num_heads * p.m * p.n, mini_batch_size);
+    El::Zeros(y, dy.Height(), dy.Width());
+    El::Zeros(dx0, x0.Height(), x0.Width());
+    El::Zeros(dx1, x1.Height(), x1.Width());
+    const double flops = 3 * 2. * p.m * p.n * p.k * num_matrices;
+
+    double times[2];
+    for (int batched = 0; batched < 2; ++batched) {
+      run_products(p, num_matrices, x0, x1, dy, y, dx0, dx1, batched);
+      const auto start = clock_type::now();
+      for (size_t it = 0; it < iterations; ++it) {
+        run_products(p, num_matrices, x0, x1, dy, y, dx0, dx1, batched);
+      }
+      times[batched] = elapsed(start) / iterations;
+    }
+    if (comm->am_world_master()) {
+      std::cout << "  " << std::left << std::setw(18) << p.name << std::right
+                << " (" << (use_small_gemm_kernel(p.m, p.n, p.k)
+                            ? "kernel" : "BLAS") << ")"
+                << std::fixed << std::setprecision(3)
+                << "  per-matrix " << std::setw(8) << times[0] * 1e3 << " ms"
+                << "  batched " << std::setw(8) << times[1] * 1e3 << " ms"
+                << std::setprecision(1)
+                << " (" << std::setw(6) << flops / times[1] / 1e9
+                << " GFLOP/s, " << std::setprecision(2)
+                << times[0] / times[1] << "x)"
+                << std::defaultfloat << std::endl;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
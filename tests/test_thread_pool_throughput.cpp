@@ -0,0 +1,219 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+//
+// test_thread_pool_throughput.cpp - I/O thread pool micro-benchmark
+//
+// Compares the work-stealing lbann::thread_pool against a pool that
+// funnels every job through a single thread_safe_queue (the scheduler
+// the I/O thread pool used previously). Two workloads are timed:
+//
+//   submit:    many empty jobs submitted from the main thread
+//   fork-join: a job running on a worker forks a mini-batch worth of
+//              samples with uneven costs and waits for them, the way
+//              generic_data_reader::fetch does
+//
+// Usage: test_thread_pool_throughput [num_threads] [num_jobs]
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/utils/threads/thread_pool.hpp"
+#include "lbann/utils/threads/thread_safe_queue.hpp"
+#include "lbann/utils/threads/type_erased_function.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+/** @brief Pool with one global FIFO queue and no work stealing */
+class global_queue_pool {
+public:
+  global_queue_pool(size_t num_threads) {
+    for (size_t i = 0; i < num_threads; ++i) {
+      m_threads.emplace_back([this]() {
+        while (!m_done) {
+          auto task = m_queue.wait_and_pop();
+          if (task) { (*task)(); }
+        }
+      });
+    }
+  }
+  ~global_queue_pool() {
+    m_done = true;
+    m_queue.wake_all(true);
+    for (auto& t : m_threads) { t.join(); }
+  }
+  template <typename FunctionT>
+  std::future<typename std::result_of<FunctionT()>::type>
+  submit_job(FunctionT func) {
+    using return_type = typename std::result_of<FunctionT()>::type;
+    std::packaged_task<return_type()> task(std::move(func));
+    auto future = task.get_future();
+    m_queue.push(std::move(task));
+    return future;
+  }
+private:
+  lbann::thread_safe_queue<lbann::type_erased_function> m_queue;
+  std::vector<std::thread> m_threads;
+  std::atomic<bool> m_done{false};
+};
+
+/** @brief Busy-wait to emulate decoding a sample */
+void spin(std::chrono::microseconds duration) {
+  const auto end = clock_type::now() + duration;
+  while (clock_type::now() < end) {}
+}
+
+/** @brief Uneven per-sample cost: most samples are cheap, a few are
+ *  expensive (e.g. large images). */
+std::chrono::microseconds sample_cost(size_t sample) {
+  return std::chrono::microseconds((sample % 16 == 0) ? 400 : 20);
+}
+
+double elapsed(clock_type::time_point start) {
+  return std::chrono::duration<double>(clock_type::now() - start).count();
+}
+
+/** @brief Time submitting empty jobs from outside the pool */
+template <typename PoolT>
+double time_submit(PoolT& pool, size_t num_jobs) {
+  std::vector<std::future<void>> futures;
+  futures.reserve(num_jobs);
+  const auto start = clock_type::now();
+  for (size_t i = 0; i < num_jobs; ++i) {
+    futures.emplace_back(pool.submit_job([]() {}));
+  }
+  for (auto& f : futures) { f.get(); }
+  return elapsed(start);
+}
+
+/** @brief Time one worker fetching a mini-batch with strided blocks
+ *  on a pool without work stealing.
+ *
+ *  The forking job waits on a future, so the remaining num_threads-1
+ *  workers handle the other blocks. */
+double time_fork_join_baseline(global_queue_pool& pool,
+                               size_t num_threads,
+                               size_t mb_size,
+                               size_t num_mini_batches) {
+  const auto start = clock_type::now();
+  for (size_t mb = 0; mb < num_mini_batches; ++mb) {
+    pool.submit_job([&pool, num_threads, mb_size]() {
+      std::vector<std::future<void>> blocks;
+      for (size_t t = 1; t < num_threads; ++t) {
+        blocks.emplace_back(pool.submit_job([t, num_threads, mb_size]() {
+          for (size_t s = t; s < mb_size; s += num_threads) {
+            spin(sample_cost(s));
+          }
+        }));
+      }
+      for (size_t s = 0; s < mb_size; s += num_threads) {
+        spin(sample_cost(s));
+      }
+      for (auto& b : blocks) { b.get(); }
+    }).get();
+  }
+  return elapsed(start);
+}
+
+/** @brief Time one worker fetching a mini-batch with chunks claimed
+ *  from a shared counter on the work-stealing pool */
+double time_fork_join_chunked(lbann::thread_pool& pool,
+                              size_t num_threads,
+                              size_t mb_size,
+                              size_t num_mini_batches) {
+  const size_t chunk_size = std::max(mb_size / (4 * num_threads), size_t{1});
+  const auto start = clock_type::now();
+  for (size_t mb = 0; mb < num_mini_batches; ++mb) {
+    pool.submit_job([&pool, num_threads, mb_size, chunk_size]() {
+      std::atomic<size_t> next_sample{0};
+      auto fetch_chunks = [&next_sample, mb_size, chunk_size]() {
+        for (size_t begin = next_sample.fetch_add(chunk_size);
+             begin < mb_size;
+             begin = next_sample.fetch_add(chunk_size)) {
+          const size_t end = std::min(begin + chunk_size, mb_size);
+          for (size_t s = begin; s < end; ++s) {
+            spin(sample_cost(s));
+          }
+        }
+        return true;
+      };
+      for (size_t t = 1; t < num_threads; ++t) {
+        pool.submit_job_to_work_group(fetch_chunks);
+      }
+      fetch_chunks();
+      pool.finish_work_group();
+    }).get();
+  }
+  return elapsed(start);
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  const size_t num_threads = (argc > 1
+                              ? std::stoul(argv[1])
+                              : std::max(std::thread::hardware_concurrency(), 2u));
+  const size_t num_jobs = (argc > 2 ? std::stoul(argv[2]) : 100000);
+  const size_t mb_size = 256;
+  const size_t num_mini_batches = 20;
+
+  std::cout << "Thread pool micro-benchmark: " << num_threads << " threads"
+            << std::endl;
+
+  {
+    global_queue_pool pool(num_threads);
+    const double submit_time = time_submit(pool, num_jobs);
+    const double fork_join_time =
+      time_fork_join_baseline(pool, num_threads, mb_size, num_mini_batches);
+    std::cout << "  global queue:   "
+              << num_jobs / submit_time << " jobs/s, "
+              << fork_join_time / num_mini_batches * 1e3
+              << " ms per mini-batch" << std::endl;
+  }
+
+  {
+    lbann::thread_pool pool(num_threads);
+    const double submit_time = time_submit(pool, num_jobs);
+    const double fork_join_time =
+      time_fork_join_chunked(pool, num_threads, mb_size, num_mini_batches);
+    std::cout << "  work stealing:  "
+              << num_jobs / submit_time << " jobs/s, "
+              << fork_join_time / num_mini_batches * 1e3
+              << " ms per mini-batch ("
+              << pool.get_num_stolen_jobs() << " jobs stolen)" << std::endl;
+  }
+
+  return EXIT_SUCCESS;
+}
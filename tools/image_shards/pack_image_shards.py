@@ -0,0 +1,104 @@
+#!/usr/bin/env python3
+
+"""
+Pack encoded image files into shards for the image_shards data reader.
+
+The input is an image list with one "<image path> <label>" per line,
+the same format used for ImageNet label files. Encoded image bytes are
+copied as-is (no decoding) into shard files of roughly --shard-size
+bytes, and an index is written that records the shard, byte offset,
+byte size, and label of every image:
+
+  LBANN_IMAGE_SHARDS 1
+  <num shards> <num samples>
+  <shard file>            (one line per shard, relative to the index)
+  <shard> <offset> <size> <label>    (one line per sample)
+
+Point the reader's data_filedir and data_filename at the index, e.g.
+
+  reader {
+    name: "image_shards"
+    role: "train"
+    data_filedir: "/path/to/shards/"
+    data_filename: "train.index"
+    ...
+  }
+"""
+
+import argparse
+import os
+import random
+import sys
+
+def read_image_list(list_file):
+    """Return a list of (path, label) pairs from an image list file."""
+    images = []
+    with open(list_file) as f:
+        for line_num, line in enumerate(f, 1):
+            line = line.strip()
+            if not line or line.startswith('#'):
+                continue
+            path, sep, label = line.rpartition(' ')
+            if not sep:
+                sys.exit('{}:{}: expected "<path> <label>"'.format(list_file, line_num))
+            images.append((path, int(label)))
+    return images
+
+def pack_image_shards(images, image_dir, output_dir, prefix, shard_size):
+    """Write shard files and an index. Returns the index path."""
+    os.makedirs(output_dir, exist_ok=True)
+    shard_names = []
+    samples = []
+    shard = None
+    shard_bytes = 0
+    try:
+        for path, label in images:
+            if shard is None or shard_bytes >= shard_size:
+                if shard is not None:
+                    shard.close()
+                shard_names.append('{}.{:05d}.shard'.format(prefix, len(shard_names)))
+                shard = open(os.path.join(output_dir, shard_names[-1]), 'wb')
+                shard_bytes = 0
+            with open(os.path.join(image_dir, path), 'rb') as f:
+                data = f.read()
+            shard.write(data)
+            samples.append((len(shard_names) - 1, shard_bytes, len(data), label))
+            shard_bytes += len(data)
+    finally:
+        if shard is not None:
+            shard.close()
+
+    index_path = os.path.join(output_dir, prefix + '.index')
+    with open(index_path, 'w') as f:
+        f.write('LBANN_IMAGE_SHARDS 1\n')
+        f.write('{} {}\n'.format(len(shard_names), len(samples)))
+        for name in shard_names:
+            f.write(name + '\n')
+        for sample in samples:
+            f.write('{} {} {} {}\n'.format(*sample))
+    return index_path
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(
+        description='Pack encoded images into shards for the image_shards data reader')
+    parser.add_argument('image_list',
+                        help='file with one "<image path> <label>" per line')
+    parser.add_argument('output_dir', help='directory for shards and index')
+    parser.add_argument('--image-dir', default='',
+                        help='directory that image paths are relative to')
+    parser.add_argument('--prefix', default='images',
+                        help='name prefix for shard and index files (default: images)')
+    parser.add_argument('--shard-size', type=float, default=1024,
+                        help='target shard size in MiB (default: 1024)')
+    parser.add_argument('--shuffle', action='store_true',
+                        help='shuffle images before packing')
+    parser.add_argument('--seed', type=int, default=20211007,
+                        help='random seed for --shuffle')
+    args = parser.parse_args()
+
+    images = read_image_list(args.image_list)
+    if args.shuffle:
+        random.Random(args.seed).shuffle(images)
+    index_path = pack_image_shards(images, args.image_dir, args.output_dir,
+                                   args.prefix, int(args.shard_size * 2**20))
+    print('Packed {} images into {}'.format(len(images), index_path))